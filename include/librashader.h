@@ -95,18 +95,36 @@ typedef struct _filter_chain_vk _filter_chain_vk;
 /// The error type for librashader.
 typedef struct _libra_error _libra_error;
 
+/// A Vulkan filter chain that is loading in the background.
+///
+/// Dropping a pending filter chain before it is finished cancels loading.
+typedef struct _pending_filter_chain_vk _pending_filter_chain_vk;
+
 /// A shader preset including all specified parameters, textures, and paths to specified shaders.
 ///
 /// A shader preset can be used to create a filter chain runtime instance, or reflected to get
 /// parameter metadata.
 typedef struct _shader_preset _shader_preset;
 
+/// A Vulkan device and the objects that are shared between filter chains on it.
+///
+/// Filter chains created from the same context share the allocator, samplers and vertex buffer of
+/// the context. Identical passes share their compiled pipeline, and identical LUTs share their
+/// texture, for as long as any filter chain is using them.
+///
+/// A LUT texture is uploaded with the command buffer of the filter chain that first loaded it,
+/// so that command buffer must be executed before any filter chain using the LUT draws a frame.
+typedef struct _vk_context _vk_context;
+
 /// A handle to a librashader error object.
 typedef struct _libra_error *libra_error_t;
 
 /// A handle to a shader preset object.
 typedef struct _shader_preset *libra_shader_preset_t;
 
+/// A handle to a shader parameter of a filter chain.
+typedef uint32_t libra_param_handle_t;
+
 /// A preset parameter.
 typedef struct libra_preset_param_t {
   /// The name of the parameter
@@ -158,6 +176,22 @@ typedef struct filter_chain_gl_opt_t {
   /// Disable the shader object cache. Shaders will be
   /// recompiled rather than loaded from the cache.
   bool disable_cache;
+  /// Defer compiling passes until they are enabled and first drawn.
+  ///
+  /// Every pass is enabled when the filter chain is created, so the number of enabled passes
+  /// must be lowered with `libra_gl_filter_chain_set_active_pass_count` before the first frame,
+  /// or every pass is compiled when the first frame is drawn.
+  bool defer_passes;
+  /// Compile deferred passes in the background ahead of when they are needed.
+  /// Only applies if `defer_passes` is enabled.
+  bool prefetch_passes;
+  /// Bind the input images of previous frames as history instead of copying them.
+  /// The caller must keep each input texture alive and unmodified for the number of frames
+  /// given by `libra_gl_filter_chain_get_history_len` after it is drawn.
+  bool zero_copy_history;
+  /// Measure the GPU time spent drawing each pass with timer queries.
+  /// The results are available from `libra_gl_filter_chain_get_pass_timings`.
+  bool time_passes;
 } filter_chain_gl_opt_t;
 #endif
 
@@ -192,6 +226,28 @@ typedef struct libra_viewport_t {
   uint32_t height;
 } libra_viewport_t;
 
+/// The GPU time spent drawing a shader pass.
+typedef struct libra_pass_timing_t {
+  /// The index of the pass in the preset.
+  size_t index;
+  /// The alias of the pass, or null if the pass has no alias.
+  /// The alias is not null terminated, and is valid until the filter chain is freed.
+  const char *alias;
+  /// The length of the alias in bytes.
+  size_t alias_len;
+  /// The GPU time spent drawing the pass, in nanoseconds.
+  uint64_t nanoseconds;
+} libra_pass_timing_t;
+
+/// The progress of a filter chain that is loading in the background.
+typedef struct libra_load_progress_t {
+  /// The number of passes that have been compiled.
+  size_t passes_loaded;
+  /// The number of passes that will be compiled, or zero if the preset has not been parsed yet.
+  /// Deferred passes are not counted, since they are compiled when they are first drawn.
+  size_t pass_count;
+} libra_load_progress_t;
+
 #if defined(LIBRA_RUNTIME_OPENGL)
 /// OpenGL parameters for the output framebuffer.
 typedef struct libra_output_framebuffer_gl_t {
@@ -214,6 +270,10 @@ typedef struct frame_gl_opt_t {
   /// The direction of rendering.
   /// -1 indicates that the frames are played in reverse order.
   int32_t frame_direction;
+  /// Whether the input image is the same as in the last frame.
+  /// Passes that do not read the frame count, history or feedback keep their
+  /// output from the last frame instead of being drawn again.
+  bool input_unchanged;
 } frame_gl_opt_t;
 #endif
 
@@ -249,6 +309,26 @@ typedef struct filter_chain_vk_opt_t {
   /// Disable the shader object cache. Shaders will be
   /// recompiled rather than loaded from the cache.
   bool disable_cache;
+  /// Defer compiling passes and creating their pipelines until they are enabled and first drawn.
+  ///
+  /// Every pass is enabled when the filter chain is created, so the number of enabled passes
+  /// must be lowered with `libra_vk_filter_chain_set_active_pass_count` before the first frame,
+  /// or every pass is compiled when the first frame is drawn.
+  bool defer_passes;
+  /// Compile deferred passes in the background ahead of when they are needed.
+  /// Only applies if `defer_passes` is enabled.
+  bool prefetch_passes;
+  /// Bind the input images of previous frames as history instead of copying them.
+  /// The caller must keep each input image alive and unmodified for the number of frames
+  /// given by `libra_vk_filter_chain_get_history_len` after it is drawn.
+  bool zero_copy_history;
+  /// Round the memory of intermediate framebuffers up to size buckets, so that they can be
+  /// resized within a bucket without reallocating. Memory is only shrunk after the
+  /// framebuffer has been smaller for a number of frames.
+  bool resize_hysteresis;
+  /// Measure the GPU time spent drawing each pass with timestamp queries.
+  /// The results are available from `libra_vk_filter_chain_get_pass_timings`.
+  bool time_passes;
 } filter_chain_vk_opt_t;
 #endif
 
@@ -257,6 +337,16 @@ typedef struct filter_chain_vk_opt_t {
 typedef struct _filter_chain_vk *libra_vk_filter_chain_t;
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// A handle to a Vulkan device context that can be shared between filter chains.
+typedef struct _vk_context *libra_vk_context_t;
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// A handle to a Vulkan filter chain that is loading in the background.
+typedef struct _pending_filter_chain_vk *libra_vk_filter_chain_pending_t;
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Vulkan parameters for the source image.
 typedef struct libra_source_image_vk_t {
@@ -291,6 +381,10 @@ typedef struct frame_vk_opt_t {
   /// The direction of rendering.
   /// -1 indicates that the frames are played in reverse order.
   int32_t frame_direction;
+  /// Whether the input image is the same as in the last frame.
+  /// Passes that do not read the frame count, history or feedback keep their
+  /// output from the last frame instead of being drawn again.
+  bool input_unchanged;
 } frame_vk_opt_t;
 #endif
 
@@ -335,6 +429,10 @@ typedef struct frame_d3d11_opt_t {
   /// The direction of rendering.
   /// -1 indicates that the frames are played in reverse order.
   int32_t frame_direction;
+  /// Whether the input image is the same as in the last frame.
+  /// Passes that do not read the frame count, history or feedback keep their
+  /// output from the last frame instead of being drawn again.
+  bool input_unchanged;
 } frame_d3d11_opt_t;
 #endif
 
@@ -396,6 +494,10 @@ typedef struct frame_d3d12_opt_t {
   /// The direction of rendering.
   /// -1 indicates that the frames are played in reverse order.
   int32_t frame_direction;
+  /// Whether the input image is the same as in the last frame.
+  /// Passes that do not read the frame count, history or feedback keep their
+  /// output from the last frame instead of being drawn again.
+  bool input_unchanged;
 } frame_d3d12_opt_t;
 #endif
 
@@ -436,6 +538,13 @@ typedef libra_error_t (*PFN_libra_preset_print)(libra_shader_preset_t *preset);
 typedef libra_error_t (*PFN_libra_preset_get_runtime_params)(libra_shader_preset_t *preset,
                                                              struct libra_preset_param_list_t *out);
 
+/// Function pointer definition for
+///libra_preset_get_runtime_params_into
+typedef libra_error_t (*PFN_libra_preset_get_runtime_params_into)(libra_shader_preset_t *preset,
+                                                                  void *buffer,
+                                                                  size_t *size,
+                                                                  struct libra_preset_param_list_t *out);
+
 /// Function pointer definition for
 ///libra_preset_free_runtime_params
 typedef libra_error_t (*PFN_libra_preset_free_runtime_params)(struct libra_preset_param_list_t preset);
@@ -481,6 +590,19 @@ typedef libra_error_t (*PFN_libra_gl_filter_chain_frame)(libra_gl_filter_chain_t
                                                          const struct frame_gl_opt_t *opt);
 #endif
 
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_frame_batch
+typedef libra_error_t (*PFN_libra_gl_filter_chain_frame_batch)(libra_gl_filter_chain_t *chain,
+                                                               size_t frame_count,
+                                                               size_t count,
+                                                               const struct libra_source_image_gl_t *images,
+                                                               const struct libra_viewport_t *viewports,
+                                                               const struct libra_output_framebuffer_gl_t *outputs,
+                                                               const float *mvp,
+                                                               const struct frame_gl_opt_t *opt);
+#endif
+
 #if defined(LIBRA_RUNTIME_OPENGL)
 /// Function pointer definition for
 ///libra_gl_filter_chain_set_param
@@ -497,6 +619,66 @@ typedef libra_error_t (*PFN_libra_gl_filter_chain_get_param)(libra_gl_filter_cha
                                                              float *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_get_param_handle
+typedef libra_error_t (*PFN_libra_gl_filter_chain_get_param_handle)(libra_gl_filter_chain_t *chain,
+                                                                    const char *param_name,
+                                                                    libra_param_handle_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_set_param_by_handle
+typedef libra_error_t (*PFN_libra_gl_filter_chain_set_param_by_handle)(libra_gl_filter_chain_t *chain,
+                                                                       libra_param_handle_t handle,
+                                                                       float value);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_get_param_by_handle
+typedef libra_error_t (*PFN_libra_gl_filter_chain_get_param_by_handle)(libra_gl_filter_chain_t *chain,
+                                                                       libra_param_handle_t handle,
+                                                                       float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_set_params
+typedef libra_error_t (*PFN_libra_gl_filter_chain_set_params)(libra_gl_filter_chain_t *chain,
+                                                              const char *const *names,
+                                                              const float *values,
+                                                              size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_get_params
+typedef libra_error_t (*PFN_libra_gl_filter_chain_get_params)(libra_gl_filter_chain_t *chain,
+                                                              const char *const *names,
+                                                              float *out,
+                                                              size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_set_params_by_handle
+typedef libra_error_t (*PFN_libra_gl_filter_chain_set_params_by_handle)(libra_gl_filter_chain_t *chain,
+                                                                        const libra_param_handle_t *handles,
+                                                                        const float *values,
+                                                                        size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_get_params_by_handle
+typedef libra_error_t (*PFN_libra_gl_filter_chain_get_params_by_handle)(libra_gl_filter_chain_t *chain,
+                                                                        const libra_param_handle_t *handles,
+                                                                        float *out,
+                                                                        size_t count);
+#endif
+
 #if defined(LIBRA_RUNTIME_OPENGL)
 /// Function pointer definition for
 ///libra_gl_filter_chain_set_active_pass_count
@@ -511,6 +693,42 @@ typedef libra_error_t (*PFN_libra_gl_filter_chain_get_active_pass_count)(libra_g
                                                                          uint32_t *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_get_history_len
+typedef libra_error_t (*PFN_libra_gl_filter_chain_get_history_len)(libra_gl_filter_chain_t *chain,
+                                                                   uint32_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_get_pass_timings
+typedef libra_error_t (*PFN_libra_gl_filter_chain_get_pass_timings)(libra_gl_filter_chain_t *chain,
+                                                                   struct libra_pass_timing_t *out,
+                                                                   size_t *count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_set_frame_time_budget
+typedef libra_error_t (*PFN_libra_gl_filter_chain_set_frame_time_budget)(libra_gl_filter_chain_t *chain,
+                                                                         uint64_t nanoseconds);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_get_viewport_scale
+typedef libra_error_t (*PFN_libra_gl_filter_chain_get_viewport_scale)(libra_gl_filter_chain_t *chain,
+                                                                      float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Function pointer definition for
+///libra_gl_filter_chain_set_viewport_scale
+typedef libra_error_t (*PFN_libra_gl_filter_chain_set_viewport_scale)(libra_gl_filter_chain_t *chain,
+                                                                      float scale);
+#endif
+
 #if defined(LIBRA_RUNTIME_OPENGL)
 /// Function pointer definition for
 ///libra_gl_filter_chain_free
@@ -536,6 +754,77 @@ typedef libra_error_t (*PFN_libra_vk_filter_chain_create_deferred)(libra_shader_
                                                                    libra_vk_filter_chain_t *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_context_create
+typedef libra_error_t (*PFN_libra_vk_context_create)(struct libra_device_vk_t vulkan,
+                                                     libra_vk_context_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_create_with_context
+typedef libra_error_t (*PFN_libra_vk_filter_chain_create_with_context)(libra_shader_preset_t *preset,
+                                                                       const libra_vk_context_t *context,
+                                                                       const struct filter_chain_vk_opt_t *options,
+                                                                       libra_vk_filter_chain_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_create_deferred_with_context
+typedef libra_error_t (*PFN_libra_vk_filter_chain_create_deferred_with_context)(libra_shader_preset_t *preset,
+                                                                                const libra_vk_context_t *context,
+                                                                                VkCommandBuffer command_buffer,
+                                                                                const struct filter_chain_vk_opt_t *options,
+                                                                                libra_vk_filter_chain_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_create_async
+typedef libra_error_t (*PFN_libra_vk_filter_chain_create_async)(libra_shader_preset_t *preset,
+                                                                const libra_vk_context_t *context,
+                                                                const struct filter_chain_vk_opt_t *options,
+                                                                libra_vk_filter_chain_pending_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_pending_poll
+typedef libra_error_t (*PFN_libra_vk_filter_chain_pending_poll)(libra_vk_filter_chain_pending_t *pending,
+                                                                bool *ready,
+                                                                struct libra_load_progress_t *progress);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_pending_cancel
+typedef libra_error_t (*PFN_libra_vk_filter_chain_pending_cancel)(libra_vk_filter_chain_pending_t *pending);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_pending_finish
+typedef libra_error_t (*PFN_libra_vk_filter_chain_pending_finish)(libra_vk_filter_chain_pending_t *pending,
+                                                                  VkCommandBuffer command_buffer,
+                                                                  libra_vk_filter_chain_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_swap
+typedef libra_error_t (*PFN_libra_vk_filter_chain_swap)(libra_vk_filter_chain_t *chain,
+                                                        libra_vk_filter_chain_pending_t *pending,
+                                                        VkCommandBuffer command_buffer);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_pending_free
+typedef libra_error_t (*PFN_libra_vk_filter_chain_pending_free)(libra_vk_filter_chain_pending_t *pending);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Function pointer definition for
 ///libra_vk_filter_chain_frame
@@ -549,6 +838,20 @@ typedef libra_error_t (*PFN_libra_vk_filter_chain_frame)(libra_vk_filter_chain_t
                                                          const struct frame_vk_opt_t *opt);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_frame_batch
+typedef libra_error_t (*PFN_libra_vk_filter_chain_frame_batch)(libra_vk_filter_chain_t *chain,
+                                                               VkCommandBuffer command_buffer,
+                                                               size_t frame_count,
+                                                               size_t count,
+                                                               const struct libra_source_image_vk_t *images,
+                                                               const struct libra_viewport_t *viewports,
+                                                               const struct libra_output_image_vk_t *outputs,
+                                                               const float *mvp,
+                                                               const struct frame_vk_opt_t *opt);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Function pointer definition for
 ///libra_vk_filter_chain_set_param
@@ -565,6 +868,66 @@ typedef libra_error_t (*PFN_libra_vk_filter_chain_get_param)(libra_vk_filter_cha
                                                              float *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_get_param_handle
+typedef libra_error_t (*PFN_libra_vk_filter_chain_get_param_handle)(libra_vk_filter_chain_t *chain,
+                                                                    const char *param_name,
+                                                                    libra_param_handle_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_set_param_by_handle
+typedef libra_error_t (*PFN_libra_vk_filter_chain_set_param_by_handle)(libra_vk_filter_chain_t *chain,
+                                                                       libra_param_handle_t handle,
+                                                                       float value);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_get_param_by_handle
+typedef libra_error_t (*PFN_libra_vk_filter_chain_get_param_by_handle)(libra_vk_filter_chain_t *chain,
+                                                                       libra_param_handle_t handle,
+                                                                       float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_set_params
+typedef libra_error_t (*PFN_libra_vk_filter_chain_set_params)(libra_vk_filter_chain_t *chain,
+                                                              const char *const *names,
+                                                              const float *values,
+                                                              size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_get_params
+typedef libra_error_t (*PFN_libra_vk_filter_chain_get_params)(libra_vk_filter_chain_t *chain,
+                                                              const char *const *names,
+                                                              float *out,
+                                                              size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_set_params_by_handle
+typedef libra_error_t (*PFN_libra_vk_filter_chain_set_params_by_handle)(libra_vk_filter_chain_t *chain,
+                                                                        const libra_param_handle_t *handles,
+                                                                        const float *values,
+                                                                        size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_get_params_by_handle
+typedef libra_error_t (*PFN_libra_vk_filter_chain_get_params_by_handle)(libra_vk_filter_chain_t *chain,
+                                                                        const libra_param_handle_t *handles,
+                                                                        float *out,
+                                                                        size_t count);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Function pointer definition for
 ///libra_vk_filter_chain_set_active_pass_count
@@ -579,12 +942,54 @@ typedef libra_error_t (*PFN_libra_vk_filter_chain_get_active_pass_count)(libra_v
                                                                          uint32_t *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_get_history_len
+typedef libra_error_t (*PFN_libra_vk_filter_chain_get_history_len)(libra_vk_filter_chain_t *chain,
+                                                                   uint32_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_get_pass_timings
+typedef libra_error_t (*PFN_libra_vk_filter_chain_get_pass_timings)(libra_vk_filter_chain_t *chain,
+                                                                   struct libra_pass_timing_t *out,
+                                                                   size_t *count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_set_frame_time_budget
+typedef libra_error_t (*PFN_libra_vk_filter_chain_set_frame_time_budget)(libra_vk_filter_chain_t *chain,
+                                                                         uint64_t nanoseconds);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_get_viewport_scale
+typedef libra_error_t (*PFN_libra_vk_filter_chain_get_viewport_scale)(libra_vk_filter_chain_t *chain,
+                                                                      float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_filter_chain_set_viewport_scale
+typedef libra_error_t (*PFN_libra_vk_filter_chain_set_viewport_scale)(libra_vk_filter_chain_t *chain,
+                                                                      float scale);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Function pointer definition for
 ///libra_vk_filter_chain_free
 typedef libra_error_t (*PFN_libra_vk_filter_chain_free)(libra_vk_filter_chain_t *chain);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Function pointer definition for
+///libra_vk_context_free
+typedef libra_error_t (*PFN_libra_vk_context_free)(libra_vk_context_t *context);
+#endif
+
 #if defined(LIBRA_RUNTIME_D3D11)
 /// Function pointer definition for
 ///libra_d3d11_filter_chain_create
@@ -633,6 +1038,66 @@ typedef libra_error_t (*PFN_libra_d3d11_filter_chain_get_param)(libra_d3d11_filt
                                                                 float *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Function pointer definition for
+///libra_d3d11_filter_chain_get_param_handle
+typedef libra_error_t (*PFN_libra_d3d11_filter_chain_get_param_handle)(libra_d3d11_filter_chain_t *chain,
+                                                                       const char *param_name,
+                                                                       libra_param_handle_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Function pointer definition for
+///libra_d3d11_filter_chain_set_param_by_handle
+typedef libra_error_t (*PFN_libra_d3d11_filter_chain_set_param_by_handle)(libra_d3d11_filter_chain_t *chain,
+                                                                          libra_param_handle_t handle,
+                                                                          float value);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Function pointer definition for
+///libra_d3d11_filter_chain_get_param_by_handle
+typedef libra_error_t (*PFN_libra_d3d11_filter_chain_get_param_by_handle)(libra_d3d11_filter_chain_t *chain,
+                                                                          libra_param_handle_t handle,
+                                                                          float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Function pointer definition for
+///libra_d3d11_filter_chain_set_params
+typedef libra_error_t (*PFN_libra_d3d11_filter_chain_set_params)(libra_d3d11_filter_chain_t *chain,
+                                                                 const char *const *names,
+                                                                 const float *values,
+                                                                 size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Function pointer definition for
+///libra_d3d11_filter_chain_get_params
+typedef libra_error_t (*PFN_libra_d3d11_filter_chain_get_params)(libra_d3d11_filter_chain_t *chain,
+                                                                 const char *const *names,
+                                                                 float *out,
+                                                                 size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Function pointer definition for
+///libra_d3d11_filter_chain_set_params_by_handle
+typedef libra_error_t (*PFN_libra_d3d11_filter_chain_set_params_by_handle)(libra_d3d11_filter_chain_t *chain,
+                                                                           const libra_param_handle_t *handles,
+                                                                           const float *values,
+                                                                           size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Function pointer definition for
+///libra_d3d11_filter_chain_get_params_by_handle
+typedef libra_error_t (*PFN_libra_d3d11_filter_chain_get_params_by_handle)(libra_d3d11_filter_chain_t *chain,
+                                                                           const libra_param_handle_t *handles,
+                                                                           float *out,
+                                                                           size_t count);
+#endif
+
 #if defined(LIBRA_RUNTIME_D3D11)
 /// Function pointer definition for
 ///libra_d3d11_filter_chain_set_active_pass_count
@@ -701,6 +1166,66 @@ typedef libra_error_t (*PFN_libra_d3d12_filter_chain_get_param)(libra_d3d12_filt
                                                                 float *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Function pointer definition for
+///libra_d3d12_filter_chain_get_param_handle
+typedef libra_error_t (*PFN_libra_d3d12_filter_chain_get_param_handle)(libra_d3d12_filter_chain_t *chain,
+                                                                       const char *param_name,
+                                                                       libra_param_handle_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Function pointer definition for
+///libra_d3d12_filter_chain_set_param_by_handle
+typedef libra_error_t (*PFN_libra_d3d12_filter_chain_set_param_by_handle)(libra_d3d12_filter_chain_t *chain,
+                                                                          libra_param_handle_t handle,
+                                                                          float value);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Function pointer definition for
+///libra_d3d12_filter_chain_get_param_by_handle
+typedef libra_error_t (*PFN_libra_d3d12_filter_chain_get_param_by_handle)(libra_d3d12_filter_chain_t *chain,
+                                                                          libra_param_handle_t handle,
+                                                                          float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Function pointer definition for
+///libra_d3d12_filter_chain_set_params
+typedef libra_error_t (*PFN_libra_d3d12_filter_chain_set_params)(libra_d3d12_filter_chain_t *chain,
+                                                                 const char *const *names,
+                                                                 const float *values,
+                                                                 size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Function pointer definition for
+///libra_d3d12_filter_chain_get_params
+typedef libra_error_t (*PFN_libra_d3d12_filter_chain_get_params)(libra_d3d12_filter_chain_t *chain,
+                                                                 const char *const *names,
+                                                                 float *out,
+                                                                 size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Function pointer definition for
+///libra_d3d12_filter_chain_set_params_by_handle
+typedef libra_error_t (*PFN_libra_d3d12_filter_chain_set_params_by_handle)(libra_d3d12_filter_chain_t *chain,
+                                                                           const libra_param_handle_t *handles,
+                                                                           const float *values,
+                                                                           size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Function pointer definition for
+///libra_d3d12_filter_chain_get_params_by_handle
+typedef libra_error_t (*PFN_libra_d3d12_filter_chain_get_params_by_handle)(libra_d3d12_filter_chain_t *chain,
+                                                                           const libra_param_handle_t *handles,
+                                                                           float *out,
+                                                                           size_t count);
+#endif
+
 #if defined(LIBRA_RUNTIME_D3D12)
 /// Function pointer definition for
 ///libra_d3d12_filter_chain_set_active_pass_count
@@ -721,6 +1246,18 @@ typedef libra_error_t (*PFN_libra_d3d12_filter_chain_get_active_pass_count)(libr
 typedef libra_error_t (*PFN_libra_d3d12_filter_chain_free)(libra_d3d12_filter_chain_t *chain);
 #endif
 
+#if defined(LIBRA_TRACING)
+/// Function pointer definition for
+///libra_trace_begin
+typedef libra_error_t (*PFN_libra_trace_begin)(const char *path);
+#endif
+
+#if defined(LIBRA_TRACING)
+/// Function pointer definition for
+///libra_trace_end
+typedef libra_error_t (*PFN_libra_trace_end)(void);
+#endif
+
 /// The current version of the librashader API.
 /// Pass this into `version` for config structs.
 ///
@@ -730,7 +1267,28 @@ typedef libra_error_t (*PFN_libra_d3d12_filter_chain_free)(libra_d3d12_filter_ch
 /// versions must remain backwards compatible.
 /// ## API Versions
 /// - API version 0: 0.1.0
-#define LIBRASHADER_CURRENT_VERSION 0
+/// - API version 1: 0.2.0
+///     - Added deferred pass compilation options to OpenGL and Vulkan filter chain options.
+///     - Added parameter handles to filter chains.
+///     - Added batched parameter access to filter chains.
+///     - Added `libra_preset_get_runtime_params_into`.
+///     - Added `input_unchanged` to frame options.
+///     - Added `zero_copy_history` to OpenGL and Vulkan filter chain options.
+///     - Added `resize_hysteresis` to Vulkan filter chain options.
+///     - Added `time_passes` to OpenGL and Vulkan filter chain options, and `libra_pass_timing_t`.
+///     - Added `libra_trace_begin` and `libra_trace_end` when built with the `tracing` feature.
+///     - Added `libra_vk_context_t`, `libra_vk_context_create`, `libra_vk_context_free`, `libra_vk_filter_chain_create_with_context`
+///       and `libra_vk_filter_chain_create_deferred_with_context`.
+///     - Added `libra_vk_filter_chain_create_async`, `libra_vk_filter_chain_pending_t` and `libra_load_progress_t`
+///       for loading Vulkan filter chains in the background.
+///     - Added `libra_vk_filter_chain_swap` to replace the passes of a Vulkan filter chain without
+///       losing its history.
+///     - Added `libra_gl_filter_chain_set_frame_time_budget`, `libra_vk_filter_chain_set_frame_time_budget`
+///       and the `get_viewport_scale` and `set_viewport_scale` functions to scale viewport-sized passes
+///       to a GPU time budget.
+///     - Added `libra_gl_filter_chain_frame_batch` and `libra_vk_filter_chain_frame_batch` to draw several
+///       frames in one call.
+#define LIBRASHADER_CURRENT_VERSION 1
 
 /// The current version of the librashader ABI.
 /// Used by the loader to check ABI compatibility.
@@ -830,6 +1388,9 @@ libra_error_t libra_preset_print(libra_shader_preset_t *preset);
 
 /// Get a list of runtime parameters.
 ///
+/// The parameter list and all of its strings are stored in a single allocation,
+/// which is freed with `libra_preset_free_runtime_params`.
+///
 /// ## Safety
 /// - `preset` must be null or a valid and aligned pointer to a shader preset.
 /// - `out` must be an aligned pointer to a `libra_preset_parameter_list_t`.
@@ -841,6 +1402,26 @@ libra_error_t libra_preset_print(libra_shader_preset_t *preset);
 libra_error_t libra_preset_get_runtime_params(libra_shader_preset_t *preset,
                                               struct libra_preset_param_list_t *out);
 
+/// Get a list of runtime parameters, written into a buffer provided by the caller.
+///
+/// If `buffer` is null, the number of bytes needed to hold the parameter list is written
+/// to `size`, and `out` is not written to. Otherwise, `size` must point to the size of `buffer`
+/// in bytes, and is updated with the number of bytes needed. If `buffer` is too small,
+/// returns `LIBRA_ERR_INVALID_PARAMETER`.
+///
+/// The parameter list points into `buffer`, and is only valid as long as `buffer` is.
+/// It must not be freed with `libra_preset_free_runtime_params`.
+///
+/// ## Safety
+/// - `preset` must be null or a valid and aligned pointer to a shader preset.
+/// - `buffer` must be null, or valid for writes of `size` bytes and aligned to `libra_preset_param_t`.
+/// - `size` must be a valid and aligned pointer to a `size_t`.
+/// - `out` must be an aligned pointer to a `libra_preset_parameter_list_t` if `buffer` is not null.
+libra_error_t libra_preset_get_runtime_params_into(libra_shader_preset_t *preset,
+                                                   void *buffer,
+                                                   size_t *size,
+                                                   struct libra_preset_param_list_t *out);
+
 /// Free the runtime parameters.
 ///
 /// Unlike the other `free` functions provided by librashader,
@@ -914,6 +1495,29 @@ libra_error_t libra_gl_filter_chain_frame(libra_gl_filter_chain_t *chain,
                                           const struct frame_gl_opt_t *opt);
 #endif
 
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Draw a batch of frames with the given parameters for the given filter chain, as if
+/// `libra_gl_filter_chain_frame` was called for each of them in order.
+///
+/// Frame `i` draws `images[i]` to `outputs[i]` with `viewports[i]` and a frame count of
+/// `frame_count + i`, so history and feedback advance between frames. The MVP and options
+/// apply to every frame, except that history is only cleared before the first frame.
+/// Nothing is flushed between frames.
+///
+/// ## Safety
+/// - The requirements of `libra_gl_filter_chain_frame` apply to every frame.
+/// - `images`, `viewports` and `outputs` must be valid and aligned pointers to `count`
+///   consecutive values each.
+libra_error_t libra_gl_filter_chain_frame_batch(libra_gl_filter_chain_t *chain,
+                                                size_t frame_count,
+                                                size_t count,
+                                                const struct libra_source_image_gl_t *images,
+                                                const struct libra_viewport_t *viewports,
+                                                const struct libra_output_framebuffer_gl_t *outputs,
+                                                const float *mvp,
+                                                const struct frame_gl_opt_t *opt);
+#endif
+
 #if defined(LIBRA_RUNTIME_OPENGL)
 /// Sets a parameter for the filter chain.
 ///
@@ -939,37 +1543,200 @@ libra_error_t libra_gl_filter_chain_get_param(libra_gl_filter_chain_t *chain,
 #endif
 
 #if defined(LIBRA_RUNTIME_OPENGL)
-/// Sets the number of active passes for this chain.
+/// Gets a handle to a parameter of the filter chain.
+///
+/// The handle can be used with `libra_gl_filter_chain_set_param_by_handle` and
+/// `libra_gl_filter_chain_get_param_by_handle` to access the parameter without
+/// looking up its name. A handle is only valid for the filter chain it was retrieved from.
 ///
+/// If the parameter does not exist, returns an error.
 /// ## Safety
 /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
-libra_error_t libra_gl_filter_chain_set_active_pass_count(libra_gl_filter_chain_t *chain,
-                                                          uint32_t value);
+/// - `param_name` must be either null or a null terminated string.
+libra_error_t libra_gl_filter_chain_get_param_handle(libra_gl_filter_chain_t *chain,
+                                                     const char *param_name,
+                                                     libra_param_handle_t *out);
 #endif
 
 #if defined(LIBRA_RUNTIME_OPENGL)
-/// Gets the number of active passes for this chain.
+/// Sets a parameter for the filter chain by its handle.
 ///
+/// If the handle is not valid for this filter chain, returns an error.
 /// ## Safety
 /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
-libra_error_t libra_gl_filter_chain_get_active_pass_count(libra_gl_filter_chain_t *chain,
-                                                          uint32_t *out);
+libra_error_t libra_gl_filter_chain_set_param_by_handle(libra_gl_filter_chain_t *chain,
+                                                        libra_param_handle_t handle,
+                                                        float value);
 #endif
 
 #if defined(LIBRA_RUNTIME_OPENGL)
-/// Free a GL filter chain.
+/// Gets a parameter for the filter chain by its handle.
 ///
-/// The resulting value in `chain` then becomes null.
+/// If the handle is not valid for this filter chain, returns an error.
 /// ## Safety
 /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
-libra_error_t libra_gl_filter_chain_free(libra_gl_filter_chain_t *chain);
+libra_error_t libra_gl_filter_chain_get_param_by_handle(libra_gl_filter_chain_t *chain,
+                                                        libra_param_handle_t handle,
+                                                        float *out);
 #endif
 
-#if defined(LIBRA_RUNTIME_VULKAN)
-/// Create the filter chain given the shader preset.
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Sets multiple parameters for the filter chain.
 ///
-/// The shader preset is immediately invalidated and must be recreated after
-/// the filter chain is created.
+/// `names` and `values` must both have `count` elements. If any parameter does not exist,
+/// returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_gl_filter_chain_set_params(libra_gl_filter_chain_t *chain,
+                                               const char *const *names,
+                                               const float *values,
+                                               size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Gets multiple parameters for the filter chain.
+///
+/// The value of the parameter named by each element of `names` is written to the same
+/// index of `out`. If any parameter does not exist, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_gl_filter_chain_get_params(libra_gl_filter_chain_t *chain,
+                                               const char *const *names,
+                                               float *out,
+                                               size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Sets multiple parameters for the filter chain by their handles.
+///
+/// `handles` and `values` must both have `count` elements. If any handle is not valid
+/// for this filter chain, returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_gl_filter_chain_set_params_by_handle(libra_gl_filter_chain_t *chain,
+                                                         const libra_param_handle_t *handles,
+                                                         const float *values,
+                                                         size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Gets multiple parameters for the filter chain by their handles.
+///
+/// The value of the parameter for each element of `handles` is written to the same
+/// index of `out`. If any handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_gl_filter_chain_get_params_by_handle(libra_gl_filter_chain_t *chain,
+                                                         const libra_param_handle_t *handles,
+                                                         float *out,
+                                                         size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Sets the number of active passes for this chain.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+libra_error_t libra_gl_filter_chain_set_active_pass_count(libra_gl_filter_chain_t *chain,
+                                                          uint32_t value);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Gets the number of active passes for this chain.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+libra_error_t libra_gl_filter_chain_get_active_pass_count(libra_gl_filter_chain_t *chain,
+                                                          uint32_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Gets the number of previous input textures that are bound as history.
+///
+/// If `zero_copy_history` is enabled, each input texture must stay alive and unmodified
+/// for this many frames after it is drawn.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+libra_error_t libra_gl_filter_chain_get_history_len(libra_gl_filter_chain_t *chain,
+                                                    uint32_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Gets the GPU time spent drawing each pass of an earlier frame.
+///
+/// If `out` is null, the number of timings is written to `count`. Otherwise, `count` must
+/// point to the length of `out`, and is updated with the number of timings written.
+/// Timings are only available if `time_passes` was enabled when the filter chain was created.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+/// - `out` must be either null, or valid for writes of `count` `libra_pass_timing_t`.
+/// - `count` must be a valid and aligned pointer to a `size_t`.
+libra_error_t libra_gl_filter_chain_get_pass_timings(libra_gl_filter_chain_t *chain,
+                                                    struct libra_pass_timing_t *out,
+                                                    size_t *count);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Sets the GPU time budget of a frame, in nanoseconds. A budget of 0 disables it.
+///
+/// With a budget, passes with viewport scaling are drawn at a lower resolution while frames
+/// take longer than the budget, and at full resolution again once they are well within it.
+/// The final pass is always drawn to the full viewport. The budget only has an effect if
+/// `time_passes` is enabled.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+libra_error_t libra_gl_filter_chain_set_frame_time_budget(libra_gl_filter_chain_t *chain,
+                                                          uint64_t nanoseconds);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Gets the scale of the viewport that passes with viewport scaling are sized against.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+libra_error_t libra_gl_filter_chain_get_viewport_scale(libra_gl_filter_chain_t *chain,
+                                                       float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Overrides the scale of the viewport that passes with viewport scaling are sized against.
+///
+/// The scale is clamped between 0.25 and 1. A scale of 0 removes the override, so that the
+/// scale is chosen from the frame time budget again.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+libra_error_t libra_gl_filter_chain_set_viewport_scale(libra_gl_filter_chain_t *chain,
+                                                       float scale);
+#endif
+
+#if defined(LIBRA_RUNTIME_OPENGL)
+/// Free a GL filter chain.
+///
+/// The resulting value in `chain` then becomes null.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+libra_error_t libra_gl_filter_chain_free(libra_gl_filter_chain_t *chain);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Create the filter chain given the shader preset.
+///
+/// The shader preset is immediately invalidated and must be recreated after
+/// the filter chain is created.
 ///
 /// ## Safety:
 /// - The handles provided in `vulkan` must be valid for the command buffers that
@@ -1009,6 +1776,168 @@ libra_error_t libra_vk_filter_chain_create_deferred(libra_shader_preset_t *prese
                                                     libra_vk_filter_chain_t *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Create a device context that filter chains created with
+/// `libra_vk_filter_chain_create_with_context` share samplers, vertex buffers,
+/// compiled pipelines and LUT textures through.
+///
+/// ## Safety:
+/// - The handles provided in `vulkan` must be valid for as long as the context or any filter
+///   chain created from it is alive.
+/// - `out` must be aligned, but may be null, invalid, or uninitialized.
+libra_error_t libra_vk_context_create(struct libra_device_vk_t vulkan,
+                                      libra_vk_context_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Create the filter chain given the shader preset, sharing device objects with the other
+/// filter chains created from the context.
+///
+/// The shader preset is immediately invalidated and must be recreated after
+/// the filter chain is created. The filter chain keeps the objects it uses from the context
+/// alive, so the context may be freed before the filter chain.
+///
+/// ## Safety:
+/// - `context` must be either null, or a valid and aligned pointer to a `libra_vk_context_t`
+///   created with `libra_vk_context_create`.
+/// - `preset` must be either null, or valid and aligned.
+/// - `options` must be either null, or valid and aligned.
+/// - `out` must be aligned, but may be null, invalid, or uninitialized.
+libra_error_t libra_vk_filter_chain_create_with_context(libra_shader_preset_t *preset,
+                                                        const libra_vk_context_t *context,
+                                                        const struct filter_chain_vk_opt_t *options,
+                                                        libra_vk_filter_chain_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Create the filter chain given the shader preset, sharing device objects with the other
+/// filter chains created from the context, and deferring GPU-side initialization to the caller.
+///
+/// The shader preset is immediately invalidated and must be recreated after
+/// the filter chain is created.
+///
+/// ## Safety:
+/// - `context` must be either null, or a valid and aligned pointer to a `libra_vk_context_t`
+///   created with `libra_vk_context_create`.
+/// - `preset` must be either null, or valid and aligned.
+/// - `options` must be either null, or valid and aligned.
+/// - `out` must be aligned, but may be null, invalid, or uninitialized.
+///
+/// The provided command buffer must be ready for recording and contain no prior commands.
+/// The caller is responsible for ending the command buffer and immediately submitting it to a
+/// graphics queue. The command buffer must be completely executed before calling `libra_vk_filter_chain_frame`
+/// on this or any other filter chain created from the context, since LUT textures may be shared.
+libra_error_t libra_vk_filter_chain_create_deferred_with_context(libra_shader_preset_t *preset,
+                                                                 const libra_vk_context_t *context,
+                                                                 VkCommandBuffer command_buffer,
+                                                                 const struct filter_chain_vk_opt_t *options,
+                                                                 libra_vk_filter_chain_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Start loading the filter chain given the shader preset in the background.
+///
+/// The passes are compiled and their pipelines created on other threads. Poll the pending
+/// filter chain with `libra_vk_filter_chain_pending_poll`, and finish it into a filter chain
+/// with `libra_vk_filter_chain_pending_finish`.
+///
+/// The shader preset is immediately invalidated and must be recreated after
+/// the pending filter chain is created.
+///
+/// ## Safety:
+/// - `context` must be either null, or a valid and aligned pointer to a `libra_vk_context_t`
+///   created with `libra_vk_context_create`.
+/// - `preset` must be either null, or valid and aligned.
+/// - `options` must be either null, or valid and aligned.
+/// - `out` must be aligned, but may be null, invalid, or uninitialized.
+libra_error_t libra_vk_filter_chain_create_async(libra_shader_preset_t *preset,
+                                                 const libra_vk_context_t *context,
+                                                 const struct filter_chain_vk_opt_t *options,
+                                                 libra_vk_filter_chain_pending_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Check whether a pending filter chain has finished loading, and get its progress.
+///
+/// ## Safety
+/// - `pending` must be either null or a valid and aligned pointer to an initialized
+///   `libra_vk_filter_chain_pending_t`.
+/// - `ready` must be a valid and aligned pointer to a `bool`.
+/// - `progress` must be either null, or an aligned pointer to a `libra_load_progress_t`.
+libra_error_t libra_vk_filter_chain_pending_poll(libra_vk_filter_chain_pending_t *pending,
+                                                 bool *ready,
+                                                 struct libra_load_progress_t *progress);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Cancel loading a pending filter chain.
+///
+/// Finishing a cancelled filter chain returns an error, unless loading had already finished.
+/// The pending filter chain must still be freed with `libra_vk_filter_chain_pending_free`.
+///
+/// ## Safety
+/// - `pending` must be either null or a valid and aligned pointer to an initialized
+///   `libra_vk_filter_chain_pending_t`.
+libra_error_t libra_vk_filter_chain_pending_cancel(libra_vk_filter_chain_pending_t *pending);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Finish loading a pending filter chain, waiting for the background work if it is not
+/// ready yet. Only the lookup textures are uploaded with the command buffer.
+///
+/// The pending filter chain is consumed, and the resulting value in `pending` becomes null
+/// whether or not the filter chain could be loaded.
+///
+/// ## Safety
+/// - `pending` must be either null or a valid and aligned pointer to an initialized
+///   `libra_vk_filter_chain_pending_t`.
+/// - `out` must be aligned, but may be null, invalid, or uninitialized.
+///
+/// The provided command buffer must be ready for recording.
+/// The caller is responsible for submitting the command buffer to a graphics queue.
+/// The command buffer must be completely executed before calling `libra_vk_filter_chain_frame`
+/// on this or any other filter chain created from the same context.
+libra_error_t libra_vk_filter_chain_pending_finish(libra_vk_filter_chain_pending_t *pending,
+                                                   VkCommandBuffer command_buffer,
+                                                   libra_vk_filter_chain_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Replace the passes of a filter chain with those of a pending filter chain, waiting for the
+/// background work if it is not ready yet. Only the lookup textures of the new passes are
+/// uploaded with the command buffer.
+///
+/// The new passes are drawn from the next frame on. History is kept, and a new pass keeps the
+/// feedback of the pass it replaces if both use the same shader. Resources of the old passes
+/// are released once the last frame that was drawn is no longer in flight.
+///
+/// The pending filter chain must have been created for the same device, with the same
+/// `frames_in_flight` as the filter chain. It is consumed, and the resulting value in
+/// `pending` becomes null whether or not the swap succeeded.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+/// - `pending` must be either null or a valid and aligned pointer to an initialized
+///   `libra_vk_filter_chain_pending_t`.
+///
+/// The provided command buffer must be ready for recording.
+/// The caller is responsible for submitting the command buffer to a graphics queue
+/// before the next call to `libra_vk_filter_chain_frame` on this filter chain is executed.
+libra_error_t libra_vk_filter_chain_swap(libra_vk_filter_chain_t *chain,
+                                         libra_vk_filter_chain_pending_t *pending,
+                                         VkCommandBuffer command_buffer);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Free a pending Vulkan filter chain, cancelling it if it is still loading.
+///
+/// The resulting value in `pending` then becomes null.
+/// ## Safety
+/// - `pending` must be either null or a valid and aligned pointer to an initialized
+///   `libra_vk_filter_chain_pending_t`.
+libra_error_t libra_vk_filter_chain_pending_free(libra_vk_filter_chain_pending_t *pending);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Records rendering commands for a frame with the given parameters for the given filter chain
 /// to the input command buffer.
@@ -1041,6 +1970,33 @@ libra_error_t libra_vk_filter_chain_frame(libra_vk_filter_chain_t *chain,
                                           const struct frame_vk_opt_t *opt);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Records rendering commands for a batch of frames to the input command buffer, as if
+/// `libra_vk_filter_chain_frame` was called for each of them in order.
+///
+/// Frame `i` draws `images[i]` to `outputs[i]` with `viewports[i]` and a frame count of
+/// `frame_count + i`, so history and feedback advance between frames. The MVP and options
+/// apply to every frame, except that history is only cleared before the first frame.
+///
+/// Every frame of a batch uses one of the frames in flight of the filter chain, so `count`
+/// can not be larger than `frames_in_flight`. The command buffer must be completely executed
+/// before those frames in flight are used again.
+///
+/// ## Safety
+/// - The requirements of `libra_vk_filter_chain_frame` apply to every frame.
+/// - `images`, `viewports` and `outputs` must be valid and aligned pointers to `count`
+///   consecutive values each.
+libra_error_t libra_vk_filter_chain_frame_batch(libra_vk_filter_chain_t *chain,
+                                                VkCommandBuffer command_buffer,
+                                                size_t frame_count,
+                                                size_t count,
+                                                const struct libra_source_image_vk_t *images,
+                                                const struct libra_viewport_t *viewports,
+                                                const struct libra_output_image_vk_t *outputs,
+                                                const float *mvp,
+                                                const struct frame_vk_opt_t *opt);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Sets a parameter for the filter chain.
 ///
@@ -1065,6 +2021,106 @@ libra_error_t libra_vk_filter_chain_get_param(libra_vk_filter_chain_t *chain,
                                               float *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Gets a handle to a parameter of the filter chain.
+///
+/// The handle can be used with `libra_vk_filter_chain_set_param_by_handle` and
+/// `libra_vk_filter_chain_get_param_by_handle` to access the parameter without
+/// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+///
+/// If the parameter does not exist, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+/// - `param_name` must be either null or a null terminated string.
+libra_error_t libra_vk_filter_chain_get_param_handle(libra_vk_filter_chain_t *chain,
+                                                     const char *param_name,
+                                                     libra_param_handle_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Sets a parameter for the filter chain by its handle.
+///
+/// If the handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+libra_error_t libra_vk_filter_chain_set_param_by_handle(libra_vk_filter_chain_t *chain,
+                                                        libra_param_handle_t handle,
+                                                        float value);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Gets a parameter for the filter chain by its handle.
+///
+/// If the handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+libra_error_t libra_vk_filter_chain_get_param_by_handle(libra_vk_filter_chain_t *chain,
+                                                        libra_param_handle_t handle,
+                                                        float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Sets multiple parameters for the filter chain.
+///
+/// `names` and `values` must both have `count` elements. If any parameter does not exist,
+/// returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_vk_filter_chain_set_params(libra_vk_filter_chain_t *chain,
+                                               const char *const *names,
+                                               const float *values,
+                                               size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Gets multiple parameters for the filter chain.
+///
+/// The value of the parameter named by each element of `names` is written to the same
+/// index of `out`. If any parameter does not exist, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_vk_filter_chain_get_params(libra_vk_filter_chain_t *chain,
+                                               const char *const *names,
+                                               float *out,
+                                               size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Sets multiple parameters for the filter chain by their handles.
+///
+/// `handles` and `values` must both have `count` elements. If any handle is not valid
+/// for this filter chain, returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_vk_filter_chain_set_params_by_handle(libra_vk_filter_chain_t *chain,
+                                                         const libra_param_handle_t *handles,
+                                                         const float *values,
+                                                         size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Gets multiple parameters for the filter chain by their handles.
+///
+/// The value of the parameter for each element of `handles` is written to the same
+/// index of `out`. If any handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_vk_filter_chain_get_params_by_handle(libra_vk_filter_chain_t *chain,
+                                                         const libra_param_handle_t *handles,
+                                                         float *out,
+                                                         size_t count);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Sets the number of active passes for this chain.
 ///
@@ -1083,6 +2139,69 @@ libra_error_t libra_vk_filter_chain_get_active_pass_count(libra_vk_filter_chain_
                                                           uint32_t *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Gets the number of previous input images that are bound as history.
+///
+/// If `zero_copy_history` is enabled, each input image must stay alive and unmodified
+/// for this many frames after it is drawn.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+libra_error_t libra_vk_filter_chain_get_history_len(libra_vk_filter_chain_t *chain,
+                                                    uint32_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Gets the GPU time spent drawing each pass of an earlier frame.
+///
+/// If `out` is null, the number of timings is written to `count`. Otherwise, `count` must
+/// point to the length of `out`, and is updated with the number of timings written.
+/// Timings are only available if `time_passes` was enabled when the filter chain was created.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+/// - `out` must be either null, or valid for writes of `count` `libra_pass_timing_t`.
+/// - `count` must be a valid and aligned pointer to a `size_t`.
+libra_error_t libra_vk_filter_chain_get_pass_timings(libra_vk_filter_chain_t *chain,
+                                                    struct libra_pass_timing_t *out,
+                                                    size_t *count);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Sets the GPU time budget of a frame, in nanoseconds. A budget of 0 disables it.
+///
+/// With a budget, passes with viewport scaling are drawn at a lower resolution while frames
+/// take longer than the budget, and at full resolution again once they are well within it.
+/// The final pass is always drawn to the full viewport. The budget only has an effect if
+/// `time_passes` is enabled and supported by the device.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+libra_error_t libra_vk_filter_chain_set_frame_time_budget(libra_vk_filter_chain_t *chain,
+                                                          uint64_t nanoseconds);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Gets the scale of the viewport that passes with viewport scaling are sized against.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+libra_error_t libra_vk_filter_chain_get_viewport_scale(libra_vk_filter_chain_t *chain,
+                                                       float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Overrides the scale of the viewport that passes with viewport scaling are sized against.
+///
+/// The scale is clamped between 0.25 and 1. A scale of 0 removes the override, so that the
+/// scale is chosen from the frame time budget again.
+///
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+libra_error_t libra_vk_filter_chain_set_viewport_scale(libra_vk_filter_chain_t *chain,
+                                                       float scale);
+#endif
+
 #if defined(LIBRA_RUNTIME_VULKAN)
 /// Free a Vulkan filter chain.
 ///
@@ -1092,6 +2211,18 @@ libra_error_t libra_vk_filter_chain_get_active_pass_count(libra_vk_filter_chain_
 libra_error_t libra_vk_filter_chain_free(libra_vk_filter_chain_t *chain);
 #endif
 
+#if defined(LIBRA_RUNTIME_VULKAN)
+/// Free a Vulkan device context.
+///
+/// Filter chains created from the context keep the objects they use alive, and
+/// may still be used after the context is freed.
+///
+/// The resulting value in `context` then becomes null.
+/// ## Safety
+/// - `context` must be either null or a valid and aligned pointer to an initialized `libra_vk_context_t`.
+libra_error_t libra_vk_context_free(libra_vk_context_t *context);
+#endif
+
 #if defined(LIBRA_RUNTIME_D3D11)
 /// Create the filter chain given the shader preset.
 ///
@@ -1196,6 +2327,106 @@ libra_error_t libra_d3d11_filter_chain_get_param(libra_d3d11_filter_chain_t *cha
                                                  float *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Gets a handle to a parameter of the filter chain.
+///
+/// The handle can be used with `libra_d3d11_filter_chain_set_param_by_handle` and
+/// `libra_d3d11_filter_chain_get_param_by_handle` to access the parameter without
+/// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+///
+/// If the parameter does not exist, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+/// - `param_name` must be either null or a null terminated string.
+libra_error_t libra_d3d11_filter_chain_get_param_handle(libra_d3d11_filter_chain_t *chain,
+                                                        const char *param_name,
+                                                        libra_param_handle_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Sets a parameter for the filter chain by its handle.
+///
+/// If the handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+libra_error_t libra_d3d11_filter_chain_set_param_by_handle(libra_d3d11_filter_chain_t *chain,
+                                                           libra_param_handle_t handle,
+                                                           float value);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Gets a parameter for the filter chain by its handle.
+///
+/// If the handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+libra_error_t libra_d3d11_filter_chain_get_param_by_handle(libra_d3d11_filter_chain_t *chain,
+                                                           libra_param_handle_t handle,
+                                                           float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Sets multiple parameters for the filter chain.
+///
+/// `names` and `values` must both have `count` elements. If any parameter does not exist,
+/// returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d11_filter_chain_set_params(libra_d3d11_filter_chain_t *chain,
+                                                  const char *const *names,
+                                                  const float *values,
+                                                  size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Gets multiple parameters for the filter chain.
+///
+/// The value of the parameter named by each element of `names` is written to the same
+/// index of `out`. If any parameter does not exist, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d11_filter_chain_get_params(libra_d3d11_filter_chain_t *chain,
+                                                  const char *const *names,
+                                                  float *out,
+                                                  size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Sets multiple parameters for the filter chain by their handles.
+///
+/// `handles` and `values` must both have `count` elements. If any handle is not valid
+/// for this filter chain, returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d11_filter_chain_set_params_by_handle(libra_d3d11_filter_chain_t *chain,
+                                                            const libra_param_handle_t *handles,
+                                                            const float *values,
+                                                            size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D11)
+/// Gets multiple parameters for the filter chain by their handles.
+///
+/// The value of the parameter for each element of `handles` is written to the same
+/// index of `out`. If any handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d11_filter_chain_get_params_by_handle(libra_d3d11_filter_chain_t *chain,
+                                                            const libra_param_handle_t *handles,
+                                                            float *out,
+                                                            size_t count);
+#endif
+
 #if defined(LIBRA_RUNTIME_D3D11)
 /// Sets the number of active passes for this chain.
 ///
@@ -1322,6 +2553,106 @@ libra_error_t libra_d3d12_filter_chain_get_param(libra_d3d12_filter_chain_t *cha
                                                  float *out);
 #endif
 
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Gets a handle to a parameter of the filter chain.
+///
+/// The handle can be used with `libra_d3d12_filter_chain_set_param_by_handle` and
+/// `libra_d3d12_filter_chain_get_param_by_handle` to access the parameter without
+/// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+///
+/// If the parameter does not exist, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d12_filter_chain_t`.
+/// - `param_name` must be either null or a null terminated string.
+libra_error_t libra_d3d12_filter_chain_get_param_handle(libra_d3d12_filter_chain_t *chain,
+                                                        const char *param_name,
+                                                        libra_param_handle_t *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Sets a parameter for the filter chain by its handle.
+///
+/// If the handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d12_filter_chain_t`.
+libra_error_t libra_d3d12_filter_chain_set_param_by_handle(libra_d3d12_filter_chain_t *chain,
+                                                           libra_param_handle_t handle,
+                                                           float value);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Gets a parameter for the filter chain by its handle.
+///
+/// If the handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d12_filter_chain_t`.
+libra_error_t libra_d3d12_filter_chain_get_param_by_handle(libra_d3d12_filter_chain_t *chain,
+                                                           libra_param_handle_t handle,
+                                                           float *out);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Sets multiple parameters for the filter chain.
+///
+/// `names` and `values` must both have `count` elements. If any parameter does not exist,
+/// returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d12_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d12_filter_chain_set_params(libra_d3d12_filter_chain_t *chain,
+                                                  const char *const *names,
+                                                  const float *values,
+                                                  size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Gets multiple parameters for the filter chain.
+///
+/// The value of the parameter named by each element of `names` is written to the same
+/// index of `out`. If any parameter does not exist, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d12_filter_chain_t`.
+/// - `names` must be either null or a valid and aligned pointer to an array of `count`
+///   null terminated strings.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d12_filter_chain_get_params(libra_d3d12_filter_chain_t *chain,
+                                                  const char *const *names,
+                                                  float *out,
+                                                  size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Sets multiple parameters for the filter chain by their handles.
+///
+/// `handles` and `values` must both have `count` elements. If any handle is not valid
+/// for this filter chain, returns an error and no parameters are changed.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d12_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d12_filter_chain_set_params_by_handle(libra_d3d12_filter_chain_t *chain,
+                                                            const libra_param_handle_t *handles,
+                                                            const float *values,
+                                                            size_t count);
+#endif
+
+#if defined(LIBRA_RUNTIME_D3D12)
+/// Gets multiple parameters for the filter chain by their handles.
+///
+/// The value of the parameter for each element of `handles` is written to the same
+/// index of `out`. If any handle is not valid for this filter chain, returns an error.
+/// ## Safety
+/// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d12_filter_chain_t`.
+/// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+/// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+libra_error_t libra_d3d12_filter_chain_get_params_by_handle(libra_d3d12_filter_chain_t *chain,
+                                                            const libra_param_handle_t *handles,
+                                                            float *out,
+                                                            size_t count);
+#endif
+
 #if defined(LIBRA_RUNTIME_D3D12)
 /// Sets the number of active passes for this chain.
 ///
@@ -1349,6 +2680,28 @@ libra_error_t libra_d3d12_filter_chain_get_active_pass_count(libra_d3d12_filter_
 libra_error_t libra_d3d12_filter_chain_free(libra_d3d12_filter_chain_t *chain);
 #endif
 
+#if defined(LIBRA_TRACING)
+/// Start recording a trace of librashader to the file at `path`, in the Chrome trace event format.
+///
+/// Spans are recorded for preset parsing, preprocessing, shader compilation, reflection,
+/// pass and LUT loading, and frame recording. If a trace is already being recorded,
+/// it is finished before the new trace is started.
+///
+/// This installs a global `tracing` subscriber the first time it is called, and fails if
+/// another subscriber was already installed in the process.
+///
+/// ## Safety
+///  - `path` must be either null or a valid, aligned pointer to a string path to the trace file.
+libra_error_t libra_trace_begin(const char *path);
+#endif
+
+#if defined(LIBRA_TRACING)
+/// Finish recording the current trace and flush it to its file.
+///
+/// If no trace is being recorded, this function does nothing.
+libra_error_t libra_trace_end(void);
+#endif
+
 /// Get the ABI version of the loaded instance.
 LIBRASHADER_ABI_VERSION libra_instance_abi_version(void);
 
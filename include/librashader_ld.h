@@ -109,6 +109,11 @@ libra_error_t __librashader__noop_preset_get_runtime_params(
     libra_shader_preset_t *preset, struct libra_preset_param_list_t *out) {
     return NULL;
 }
+libra_error_t __librashader__noop_preset_get_runtime_params_into(
+    libra_shader_preset_t *preset, void *buffer, size_t *size,
+    struct libra_preset_param_list_t *out) {
+    return NULL;
+}
 libra_error_t __librashader__noop_preset_free_runtime_params(struct libra_preset_param_list_t out) {
     return NULL;
 }
@@ -132,6 +137,15 @@ libra_error_t __librashader__noop_gl_filter_chain_frame(
     return NULL;
 }
 
+libra_error_t __librashader__noop_gl_filter_chain_frame_batch(
+    libra_gl_filter_chain_t *chain, size_t frame_count, size_t count,
+    const struct libra_source_image_gl_t *images,
+    const struct libra_viewport_t *viewports,
+    const struct libra_output_framebuffer_gl_t *outputs, const float *mvp,
+    const struct frame_gl_opt_t *opt) {
+    return NULL;
+}
+
 libra_error_t __librashader__noop_gl_filter_chain_free(
     libra_gl_filter_chain_t *chain) {
     return NULL;
@@ -147,6 +161,45 @@ libra_error_t __librashader__noop_gl_filter_chain_get_param(
     return NULL;
 }
 
+libra_error_t __librashader__noop_gl_filter_chain_get_param_handle(
+    libra_gl_filter_chain_t *chain, const char *param_name, libra_param_handle_t *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_set_param_by_handle(
+    libra_gl_filter_chain_t *chain, libra_param_handle_t handle, float value) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_get_param_by_handle(
+    libra_gl_filter_chain_t *chain, libra_param_handle_t handle, float *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_set_params(
+    libra_gl_filter_chain_t *chain, const char *const *names,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_get_params(
+    libra_gl_filter_chain_t *chain, const char *const *names,
+    float *out, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_set_params_by_handle(
+    libra_gl_filter_chain_t *chain, const libra_param_handle_t *handles,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_get_params_by_handle(
+    libra_gl_filter_chain_t *chain, const libra_param_handle_t *handles,
+    float *out, size_t count) {
+    return NULL;
+}
+
 libra_error_t __librashader__noop_gl_filter_chain_set_active_pass_count(
     libra_gl_filter_chain_t *chain, uint32_t value) {
     return NULL;
@@ -156,6 +209,32 @@ libra_error_t __librashader__noop_gl_filter_chain_get_active_pass_count(
     libra_gl_filter_chain_t *chain, uint32_t *out) {
     return NULL;
 }
+
+libra_error_t __librashader__noop_gl_filter_chain_get_history_len(
+    libra_gl_filter_chain_t *chain, uint32_t *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_get_pass_timings(
+    libra_gl_filter_chain_t *chain, struct libra_pass_timing_t *out,
+    size_t *count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_set_frame_time_budget(
+    libra_gl_filter_chain_t *chain, uint64_t nanoseconds) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_get_viewport_scale(
+    libra_gl_filter_chain_t *chain, float *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_gl_filter_chain_set_viewport_scale(
+    libra_gl_filter_chain_t *chain, float scale) {
+    return NULL;
+}
 #endif
 
 #if defined(LIBRA_RUNTIME_VULKAN)
@@ -182,6 +261,16 @@ libra_error_t __librashader__noop_vk_filter_chain_frame(
     return NULL;
 }
 
+libra_error_t __librashader__noop_vk_filter_chain_frame_batch(
+    libra_vk_filter_chain_t *chain, VkCommandBuffer command_buffer,
+    size_t frame_count, size_t count,
+    const struct libra_source_image_vk_t *images,
+    const struct libra_viewport_t *viewports,
+    const struct libra_output_image_vk_t *outputs, const float *mvp,
+    const struct frame_vk_opt_t *opt) {
+    return NULL;
+}
+
 libra_error_t __librashader__noop_vk_filter_chain_free(
     libra_vk_filter_chain_t *chain) {
     return NULL;
@@ -197,6 +286,45 @@ libra_error_t __librashader__noop_vk_filter_chain_get_param(
     return NULL;
 }
 
+libra_error_t __librashader__noop_vk_filter_chain_get_param_handle(
+    libra_vk_filter_chain_t *chain, const char *param_name, libra_param_handle_t *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_set_param_by_handle(
+    libra_vk_filter_chain_t *chain, libra_param_handle_t handle, float value) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_get_param_by_handle(
+    libra_vk_filter_chain_t *chain, libra_param_handle_t handle, float *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_set_params(
+    libra_vk_filter_chain_t *chain, const char *const *names,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_get_params(
+    libra_vk_filter_chain_t *chain, const char *const *names,
+    float *out, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_set_params_by_handle(
+    libra_vk_filter_chain_t *chain, const libra_param_handle_t *handles,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_get_params_by_handle(
+    libra_vk_filter_chain_t *chain, const libra_param_handle_t *handles,
+    float *out, size_t count) {
+    return NULL;
+}
+
 libra_error_t __librashader__noop_vk_filter_chain_set_active_pass_count(
     libra_vk_filter_chain_t *chain, uint32_t value) {
     return NULL;
@@ -206,6 +334,95 @@ libra_error_t __librashader__noop_vk_filter_chain_get_active_pass_count(
     libra_vk_filter_chain_t *chain, uint32_t *out) {
     return NULL;
 }
+
+libra_error_t __librashader__noop_vk_filter_chain_get_history_len(
+    libra_vk_filter_chain_t *chain, uint32_t *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_get_pass_timings(
+    libra_vk_filter_chain_t *chain, struct libra_pass_timing_t *out,
+    size_t *count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_set_frame_time_budget(
+    libra_vk_filter_chain_t *chain, uint64_t nanoseconds) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_get_viewport_scale(
+    libra_vk_filter_chain_t *chain, float *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_set_viewport_scale(
+    libra_vk_filter_chain_t *chain, float scale) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_context_create(
+    struct libra_device_vk_t vulkan, libra_vk_context_t *out) {
+    *out = NULL;
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_context_free(libra_vk_context_t *context) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_create_with_context(
+    libra_shader_preset_t *preset, const libra_vk_context_t *context,
+    const struct filter_chain_vk_opt_t *options,
+    libra_vk_filter_chain_t *out) {
+    *out = NULL;
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_create_deferred_with_context(
+    libra_shader_preset_t *preset, const libra_vk_context_t *context,
+    VkCommandBuffer command_buffer, const struct filter_chain_vk_opt_t *options,
+    libra_vk_filter_chain_t *out) {
+    *out = NULL;
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_create_async(
+    libra_shader_preset_t *preset, const libra_vk_context_t *context,
+    const struct filter_chain_vk_opt_t *options,
+    libra_vk_filter_chain_pending_t *out) {
+    *out = NULL;
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_pending_poll(
+    libra_vk_filter_chain_pending_t *pending, bool *ready,
+    struct libra_load_progress_t *progress) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_pending_cancel(
+    libra_vk_filter_chain_pending_t *pending) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_pending_finish(
+    libra_vk_filter_chain_pending_t *pending, VkCommandBuffer command_buffer,
+    libra_vk_filter_chain_t *out) {
+    *out = NULL;
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_swap(
+    libra_vk_filter_chain_t *chain, libra_vk_filter_chain_pending_t *pending,
+    VkCommandBuffer command_buffer) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_vk_filter_chain_pending_free(
+    libra_vk_filter_chain_pending_t *pending) {
+    return NULL;
+}
 #endif
 
 #if defined(LIBRA_RUNTIME_D3D11)
@@ -249,6 +466,45 @@ libra_error_t __librashader__noop_d3d11_filter_chain_get_param(
     return NULL;
 }
 
+libra_error_t __librashader__noop_d3d11_filter_chain_get_param_handle(
+    libra_d3d11_filter_chain_t *chain, const char *param_name, libra_param_handle_t *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d11_filter_chain_set_param_by_handle(
+    libra_d3d11_filter_chain_t *chain, libra_param_handle_t handle, float value) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d11_filter_chain_get_param_by_handle(
+    libra_d3d11_filter_chain_t *chain, libra_param_handle_t handle, float *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d11_filter_chain_set_params(
+    libra_d3d11_filter_chain_t *chain, const char *const *names,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d11_filter_chain_get_params(
+    libra_d3d11_filter_chain_t *chain, const char *const *names,
+    float *out, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d11_filter_chain_set_params_by_handle(
+    libra_d3d11_filter_chain_t *chain, const libra_param_handle_t *handles,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d11_filter_chain_get_params_by_handle(
+    libra_d3d11_filter_chain_t *chain, const libra_param_handle_t *handles,
+    float *out, size_t count) {
+    return NULL;
+}
+
 libra_error_t __librashader__noop_d3d11_filter_chain_set_active_pass_count(
     libra_d3d11_filter_chain_t *chain, uint32_t value) {
     return NULL;
@@ -303,6 +559,45 @@ libra_error_t __librashader__noop_d3d12_filter_chain_get_param(
     return NULL;
 }
 
+libra_error_t __librashader__noop_d3d12_filter_chain_get_param_handle(
+    libra_d3d12_filter_chain_t *chain, const char *param_name, libra_param_handle_t *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d12_filter_chain_set_param_by_handle(
+    libra_d3d12_filter_chain_t *chain, libra_param_handle_t handle, float value) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d12_filter_chain_get_param_by_handle(
+    libra_d3d12_filter_chain_t *chain, libra_param_handle_t handle, float *out) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d12_filter_chain_set_params(
+    libra_d3d12_filter_chain_t *chain, const char *const *names,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d12_filter_chain_get_params(
+    libra_d3d12_filter_chain_t *chain, const char *const *names,
+    float *out, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d12_filter_chain_set_params_by_handle(
+    libra_d3d12_filter_chain_t *chain, const libra_param_handle_t *handles,
+    const float *values, size_t count) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_d3d12_filter_chain_get_params_by_handle(
+    libra_d3d12_filter_chain_t *chain, const libra_param_handle_t *handles,
+    float *out, size_t count) {
+    return NULL;
+}
+
 libra_error_t __librashader__noop_d3d12_filter_chain_set_active_pass_count(
     libra_d3d12_filter_chain_t *chain, uint32_t value) {
     return NULL;
@@ -313,6 +608,14 @@ libra_error_t __librashader__noop_d3d12_filter_chain_get_active_pass_count(
     return NULL;
 }
 #endif
+
+#if defined(LIBRA_TRACING)
+libra_error_t __librashader__noop_trace_begin(const char *path) {
+    return NULL;
+}
+
+libra_error_t __librashader__noop_trace_end() { return NULL; }
+#endif
 typedef struct libra_instance_t {
     /// Get the supported ABI version of the loaded instance.
     ///
@@ -376,6 +679,9 @@ typedef struct libra_instance_t {
 
     /// Get a list of runtime parameter names.
     ///
+    /// The parameter list and all of its strings are stored in a single
+    /// allocation, which is freed with `libra_preset_free_runtime_params`.
+    ///
     /// ## Safety
     /// - `preset` must be null or a valid and aligned pointer to a shader
     /// preset.
@@ -389,6 +695,23 @@ typedef struct libra_instance_t {
     ///   the output struct must only be freed once per call.
     PFN_libra_preset_get_runtime_params preset_get_runtime_params;
 
+    /// Get a list of runtime parameters, written into a buffer provided by the caller.
+    ///
+    /// If `buffer` is null, the number of bytes needed to hold the parameter list is written
+    /// to `size`, and `out` is not written to. Otherwise, `size` must point to the size of `buffer`
+    /// in bytes, and is updated with the number of bytes needed. If `buffer` is too small,
+    /// returns `LIBRA_ERR_INVALID_PARAMETER`.
+    ///
+    /// The parameter list points into `buffer`, and is only valid as long as `buffer` is.
+    /// It must not be freed with `libra_preset_free_runtime_params`.
+    ///
+    /// ## Safety
+    /// - `preset` must be null or a valid and aligned pointer to a shader preset.
+    /// - `buffer` must be null, or valid for writes of `size` bytes and aligned to `libra_preset_param_t`.
+    /// - `size` must be a valid and aligned pointer to a `size_t`.
+    /// - `out` must be an aligned pointer to a `libra_preset_parameter_list_t` if `buffer` is not null.
+    PFN_libra_preset_get_runtime_params_into preset_get_runtime_params_into;
+
     /// Free the runtime parameters.
     ///
     /// Unlike the other `free` functions provided by librashader,
@@ -499,6 +822,23 @@ typedef struct libra_instance_t {
     ///    struct.
     PFN_libra_gl_filter_chain_frame gl_filter_chain_frame;
 
+    /// Draw a batch of frames with the given parameters for the given filter
+    /// chain, as if `libra_gl_filter_chain_frame` was called for each of them
+    /// in order.
+    ///
+    /// Frame `i` draws `images[i]` to `outputs[i]` with `viewports[i]` and a
+    /// frame count of `frame_count + i`, so history and feedback advance
+    /// between frames. The MVP and options apply to every frame, except that
+    /// history is only cleared before the first frame. Nothing is flushed
+    /// between frames.
+    ///
+    /// ## Safety
+    /// - The requirements of `libra_gl_filter_chain_frame` apply to every
+    /// frame.
+    /// - `images`, `viewports` and `outputs` must be valid and aligned pointers
+    /// to `count` consecutive values each.
+    PFN_libra_gl_filter_chain_frame_batch gl_filter_chain_frame_batch;
+
     /// Free a GL filter chain.
     ///
     /// The resulting value in `chain` then becomes null.
@@ -515,6 +855,63 @@ typedef struct libra_instance_t {
     PFN_libra_gl_filter_chain_get_active_pass_count
         gl_filter_chain_get_active_pass_count;
 
+    /// Gets the number of previous input textures that are bound as history.
+    ///
+    /// If `zero_copy_history` is enabled, each input texture must stay alive and unmodified
+    /// for this many frames after it is drawn.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    PFN_libra_gl_filter_chain_get_history_len
+        gl_filter_chain_get_history_len;
+
+    /// Gets the GPU time spent drawing each pass of an earlier frame.
+    ///
+    /// If `out` is null, the number of timings is written to `count`. Otherwise,
+    /// `count` must point to the length of `out`, and is updated with the number
+    /// of timings written. Timings are only available if `time_passes` was
+    /// enabled when the filter chain was created.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    /// - `out` must be either null, or valid for writes of `count`
+    /// `libra_pass_timing_t`.
+    /// - `count` must be a valid and aligned pointer to a `size_t`.
+    PFN_libra_gl_filter_chain_get_pass_timings
+        gl_filter_chain_get_pass_timings;
+
+    /// Sets the GPU time budget of a frame, in nanoseconds. A budget of 0
+    /// disables it.
+    ///
+    /// With a budget, passes with viewport scaling are drawn at a lower
+    /// resolution while frames take longer than the budget.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    PFN_libra_gl_filter_chain_set_frame_time_budget
+        gl_filter_chain_set_frame_time_budget;
+
+    /// Gets the scale of the viewport that passes with viewport scaling are
+    /// sized against.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    PFN_libra_gl_filter_chain_get_viewport_scale
+        gl_filter_chain_get_viewport_scale;
+
+    /// Overrides the scale of the viewport that passes with viewport scaling
+    /// are sized against. A scale of 0 removes the override.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    PFN_libra_gl_filter_chain_set_viewport_scale
+        gl_filter_chain_set_viewport_scale;
+
     /// Sets the number of active passes for this chain.
     ///
     /// ## Safety
@@ -532,6 +929,81 @@ typedef struct libra_instance_t {
     /// - `param_name` must be either null or a null terminated string.
     PFN_libra_gl_filter_chain_get_param gl_filter_chain_get_param;
 
+    /// Gets a handle to a parameter of the filter chain.
+    ///
+    /// The handle can be used with `libra_gl_filter_chain_set_param_by_handle` and
+    /// `libra_gl_filter_chain_get_param_by_handle` to access the parameter without
+    /// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+    ///
+    /// If the parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    /// - `param_name` must be either null or a null terminated string.
+    PFN_libra_gl_filter_chain_get_param_handle gl_filter_chain_get_param_handle;
+
+    /// Sets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    PFN_libra_gl_filter_chain_set_param_by_handle gl_filter_chain_set_param_by_handle;
+
+    /// Gets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    PFN_libra_gl_filter_chain_get_param_by_handle gl_filter_chain_get_param_by_handle;
+
+    /// Sets multiple parameters for the filter chain.
+    ///
+    /// `names` and `values` must both have `count` elements. If any parameter does not exist,
+    /// returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_gl_filter_chain_set_params gl_filter_chain_set_params;
+
+    /// Gets multiple parameters for the filter chain.
+    ///
+    /// The value of the parameter named by each element of `names` is written to the same
+    /// index of `out`. If any parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_gl_filter_chain_get_params gl_filter_chain_get_params;
+
+    /// Sets multiple parameters for the filter chain by their handles.
+    ///
+    /// `handles` and `values` must both have `count` elements. If any handle is not valid
+    /// for this filter chain, returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_gl_filter_chain_set_params_by_handle gl_filter_chain_set_params_by_handle;
+
+    /// Gets multiple parameters for the filter chain by their handles.
+    ///
+    /// The value of the parameter for each element of `handles` is written to the same
+    /// index of `out`. If any handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_gl_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_gl_filter_chain_get_params_by_handle gl_filter_chain_get_params_by_handle;
+
     /// Sets a parameter for the filter chain.
     ///
     /// If the parameter does not exist, returns an error.
@@ -591,6 +1063,111 @@ typedef struct libra_instance_t {
     /// `libra_vk_filter_chain_frame`.
     PFN_libra_vk_filter_chain_create_deferred vk_filter_chain_create_deferred;
 
+    /// Create a device context that filter chains created with
+    /// `libra_vk_filter_chain_create_with_context` share samplers, vertex
+    /// buffers, compiled pipelines and LUT textures through.
+    ///
+    /// ## Safety:
+    /// - The handles provided in `vulkan` must be valid for as long as the
+    /// context or any filter chain created from it is alive.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    PFN_libra_vk_context_create vk_context_create;
+
+    /// Free a Vulkan device context.
+    ///
+    /// Filter chains created from the context keep the objects they use
+    /// alive, and may still be used after the context is freed.
+    ///
+    /// The resulting value in `context` then becomes null.
+    /// ## Safety
+    /// - `context` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_context_t`.
+    PFN_libra_vk_context_free vk_context_free;
+
+    /// Create the filter chain given the shader preset, sharing device objects
+    /// with the other filter chains created from the context.
+    ///
+    /// The shader preset is immediately invalidated and must be recreated after
+    /// the filter chain is created.
+    ///
+    /// ## Safety:
+    /// - `context` must be either null, or a valid and aligned pointer to a
+    /// `libra_vk_context_t` created with `libra_vk_context_create`.
+    /// - `preset` must be either null, or valid and aligned.
+    /// - `options` must be either null, or valid and aligned.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    PFN_libra_vk_filter_chain_create_with_context
+        vk_filter_chain_create_with_context;
+
+    /// Create the filter chain given the shader preset, sharing device objects
+    /// with the other filter chains created from the context, and deferring
+    /// GPU-side initialization to the caller.
+    ///
+    /// The command buffer must be completely executed before calling
+    /// `libra_vk_filter_chain_frame` on this or any other filter chain created
+    /// from the context.
+    PFN_libra_vk_filter_chain_create_deferred_with_context
+        vk_filter_chain_create_deferred_with_context;
+
+    /// Start loading the filter chain given the shader preset in the
+    /// background.
+    ///
+    /// The passes are compiled and their pipelines created on other threads.
+    ///
+    /// If this function is not loaded, `out` will unconditionally be set to
+    /// null.
+    ///
+    /// ## Safety:
+    /// - `context` must be either null, or a valid and aligned pointer to a
+    /// `libra_vk_context_t` created with `libra_vk_context_create`.
+    /// - `preset` must be either null, or valid and aligned.
+    /// - `options` must be either null, or valid and aligned.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    PFN_libra_vk_filter_chain_create_async vk_filter_chain_create_async;
+
+    /// Check whether a pending filter chain has finished loading, and get its
+    /// progress.
+    ///
+    /// ## Safety
+    /// - `pending` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_pending_t`.
+    /// - `ready` must be a valid and aligned pointer to a `bool`.
+    /// - `progress` must be either null, or an aligned pointer to a
+    /// `libra_load_progress_t`.
+    PFN_libra_vk_filter_chain_pending_poll vk_filter_chain_pending_poll;
+
+    /// Cancel loading a pending filter chain.
+    ///
+    /// ## Safety
+    /// - `pending` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_pending_t`.
+    PFN_libra_vk_filter_chain_pending_cancel vk_filter_chain_pending_cancel;
+
+    /// Finish loading a pending filter chain, waiting for the background work
+    /// if it is not ready yet.
+    ///
+    /// The pending filter chain is consumed, and the resulting value in
+    /// `pending` becomes null.
+    ///
+    /// If this function is not loaded, `out` will unconditionally be set to
+    /// null.
+    PFN_libra_vk_filter_chain_pending_finish vk_filter_chain_pending_finish;
+
+    /// Replace the passes of a filter chain with those of a pending filter
+    /// chain, waiting for the background work if it is not ready yet.
+    ///
+    /// The pending filter chain is consumed, and the resulting value in
+    /// `pending` becomes null.
+    PFN_libra_vk_filter_chain_swap vk_filter_chain_swap;
+
+    /// Free a pending Vulkan filter chain, cancelling it if it is still
+    /// loading.
+    ///
+    /// ## Safety
+    /// - `pending` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_pending_t`.
+    PFN_libra_vk_filter_chain_pending_free vk_filter_chain_pending_free;
+
     /// Records rendering commands for a frame with the given parameters for the
     /// given filter chain
     /// to the input command buffer.
@@ -613,6 +1190,27 @@ typedef struct libra_instance_t {
     ///    struct.
     PFN_libra_vk_filter_chain_frame vk_filter_chain_frame;
 
+    /// Records rendering commands for a batch of frames to the input command
+    /// buffer, as if `libra_vk_filter_chain_frame` was called for each of them
+    /// in order.
+    ///
+    /// Frame `i` draws `images[i]` to `outputs[i]` with `viewports[i]` and a
+    /// frame count of `frame_count + i`, so history and feedback advance
+    /// between frames. The MVP and options apply to every frame, except that
+    /// history is only cleared before the first frame.
+    ///
+    /// Every frame of a batch uses one of the frames in flight of the filter
+    /// chain, so `count` can not be larger than `frames_in_flight`. The command
+    /// buffer must be completely executed before those frames in flight are
+    /// used again.
+    ///
+    /// ## Safety
+    /// - The requirements of `libra_vk_filter_chain_frame` apply to every
+    /// frame.
+    /// - `images`, `viewports` and `outputs` must be valid and aligned pointers
+    /// to `count` consecutive values each.
+    PFN_libra_vk_filter_chain_frame_batch vk_filter_chain_frame_batch;
+
     /// Free a Vulkan filter chain.
     ///
     /// The resulting value in `chain` then becomes null.
@@ -629,6 +1227,63 @@ typedef struct libra_instance_t {
     PFN_libra_vk_filter_chain_get_active_pass_count
         vk_filter_chain_get_active_pass_count;
 
+    /// Gets the number of previous input images that are bound as history.
+    ///
+    /// If `zero_copy_history` is enabled, each input image must stay alive and unmodified
+    /// for this many frames after it is drawn.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    PFN_libra_vk_filter_chain_get_history_len
+        vk_filter_chain_get_history_len;
+
+    /// Gets the GPU time spent drawing each pass of an earlier frame.
+    ///
+    /// If `out` is null, the number of timings is written to `count`. Otherwise,
+    /// `count` must point to the length of `out`, and is updated with the number
+    /// of timings written. Timings are only available if `time_passes` was
+    /// enabled when the filter chain was created.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    /// - `out` must be either null, or valid for writes of `count`
+    /// `libra_pass_timing_t`.
+    /// - `count` must be a valid and aligned pointer to a `size_t`.
+    PFN_libra_vk_filter_chain_get_pass_timings
+        vk_filter_chain_get_pass_timings;
+
+    /// Sets the GPU time budget of a frame, in nanoseconds. A budget of 0
+    /// disables it.
+    ///
+    /// With a budget, passes with viewport scaling are drawn at a lower
+    /// resolution while frames take longer than the budget.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    PFN_libra_vk_filter_chain_set_frame_time_budget
+        vk_filter_chain_set_frame_time_budget;
+
+    /// Gets the scale of the viewport that passes with viewport scaling are
+    /// sized against.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    PFN_libra_vk_filter_chain_get_viewport_scale
+        vk_filter_chain_get_viewport_scale;
+
+    /// Overrides the scale of the viewport that passes with viewport scaling
+    /// are sized against. A scale of 0 removes the override.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    PFN_libra_vk_filter_chain_set_viewport_scale
+        vk_filter_chain_set_viewport_scale;
+
     /// Sets the number of active passes for this chain.
     ///
     /// ## Safety
@@ -646,6 +1301,81 @@ typedef struct libra_instance_t {
     /// - `param_name` must be either null or a null terminated string.
     PFN_libra_vk_filter_chain_get_param vk_filter_chain_get_param;
 
+    /// Gets a handle to a parameter of the filter chain.
+    ///
+    /// The handle can be used with `libra_vk_filter_chain_set_param_by_handle` and
+    /// `libra_vk_filter_chain_get_param_by_handle` to access the parameter without
+    /// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+    ///
+    /// If the parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    /// - `param_name` must be either null or a null terminated string.
+    PFN_libra_vk_filter_chain_get_param_handle vk_filter_chain_get_param_handle;
+
+    /// Sets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    PFN_libra_vk_filter_chain_set_param_by_handle vk_filter_chain_set_param_by_handle;
+
+    /// Gets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    PFN_libra_vk_filter_chain_get_param_by_handle vk_filter_chain_get_param_by_handle;
+
+    /// Sets multiple parameters for the filter chain.
+    ///
+    /// `names` and `values` must both have `count` elements. If any parameter does not exist,
+    /// returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_vk_filter_chain_set_params vk_filter_chain_set_params;
+
+    /// Gets multiple parameters for the filter chain.
+    ///
+    /// The value of the parameter named by each element of `names` is written to the same
+    /// index of `out`. If any parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_vk_filter_chain_get_params vk_filter_chain_get_params;
+
+    /// Sets multiple parameters for the filter chain by their handles.
+    ///
+    /// `handles` and `values` must both have `count` elements. If any handle is not valid
+    /// for this filter chain, returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_vk_filter_chain_set_params_by_handle vk_filter_chain_set_params_by_handle;
+
+    /// Gets multiple parameters for the filter chain by their handles.
+    ///
+    /// The value of the parameter for each element of `handles` is written to the same
+    /// index of `out`. If any handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_vk_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_vk_filter_chain_get_params_by_handle vk_filter_chain_get_params_by_handle;
+
     /// Sets a parameter for the filter chain.
     ///
     /// If the parameter does not exist, returns an error.
@@ -756,6 +1486,81 @@ typedef struct libra_instance_t {
     /// - `param_name` must be either null or a null terminated string.
     PFN_libra_d3d11_filter_chain_get_param d3d11_filter_chain_get_param;
 
+    /// Gets a handle to a parameter of the filter chain.
+    ///
+    /// The handle can be used with `libra_d3d11_filter_chain_set_param_by_handle` and
+    /// `libra_d3d11_filter_chain_get_param_by_handle` to access the parameter without
+    /// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+    ///
+    /// If the parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d11_filter_chain_t`.
+    /// - `param_name` must be either null or a null terminated string.
+    PFN_libra_d3d11_filter_chain_get_param_handle d3d11_filter_chain_get_param_handle;
+
+    /// Sets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d11_filter_chain_t`.
+    PFN_libra_d3d11_filter_chain_set_param_by_handle d3d11_filter_chain_set_param_by_handle;
+
+    /// Gets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d11_filter_chain_t`.
+    PFN_libra_d3d11_filter_chain_get_param_by_handle d3d11_filter_chain_get_param_by_handle;
+
+    /// Sets multiple parameters for the filter chain.
+    ///
+    /// `names` and `values` must both have `count` elements. If any parameter does not exist,
+    /// returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d11_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d11_filter_chain_set_params d3d11_filter_chain_set_params;
+
+    /// Gets multiple parameters for the filter chain.
+    ///
+    /// The value of the parameter named by each element of `names` is written to the same
+    /// index of `out`. If any parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d11_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d11_filter_chain_get_params d3d11_filter_chain_get_params;
+
+    /// Sets multiple parameters for the filter chain by their handles.
+    ///
+    /// `handles` and `values` must both have `count` elements. If any handle is not valid
+    /// for this filter chain, returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d11_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d11_filter_chain_set_params_by_handle d3d11_filter_chain_set_params_by_handle;
+
+    /// Gets multiple parameters for the filter chain by their handles.
+    ///
+    /// The value of the parameter for each element of `handles` is written to the same
+    /// index of `out`. If any handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d11_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d11_filter_chain_get_params_by_handle d3d11_filter_chain_get_params_by_handle;
+
     /// Sets a parameter for the filter chain.
     ///
     /// If the parameter does not exist, returns an error.
@@ -854,6 +1659,81 @@ typedef struct libra_instance_t {
     /// - `param_name` must be either null or a null terminated string.
     PFN_libra_d3d12_filter_chain_get_param d3d12_filter_chain_get_param;
 
+    /// Gets a handle to a parameter of the filter chain.
+    ///
+    /// The handle can be used with `libra_d3d12_filter_chain_set_param_by_handle` and
+    /// `libra_d3d12_filter_chain_get_param_by_handle` to access the parameter without
+    /// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+    ///
+    /// If the parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d12_filter_chain_t`.
+    /// - `param_name` must be either null or a null terminated string.
+    PFN_libra_d3d12_filter_chain_get_param_handle d3d12_filter_chain_get_param_handle;
+
+    /// Sets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d12_filter_chain_t`.
+    PFN_libra_d3d12_filter_chain_set_param_by_handle d3d12_filter_chain_set_param_by_handle;
+
+    /// Gets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d12_filter_chain_t`.
+    PFN_libra_d3d12_filter_chain_get_param_by_handle d3d12_filter_chain_get_param_by_handle;
+
+    /// Sets multiple parameters for the filter chain.
+    ///
+    /// `names` and `values` must both have `count` elements. If any parameter does not exist,
+    /// returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d12_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d12_filter_chain_set_params d3d12_filter_chain_set_params;
+
+    /// Gets multiple parameters for the filter chain.
+    ///
+    /// The value of the parameter named by each element of `names` is written to the same
+    /// index of `out`. If any parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d12_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d12_filter_chain_get_params d3d12_filter_chain_get_params;
+
+    /// Sets multiple parameters for the filter chain by their handles.
+    ///
+    /// `handles` and `values` must both have `count` elements. If any handle is not valid
+    /// for this filter chain, returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d12_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d12_filter_chain_set_params_by_handle d3d12_filter_chain_set_params_by_handle;
+
+    /// Gets multiple parameters for the filter chain by their handles.
+    ///
+    /// The value of the parameter for each element of `handles` is written to the same
+    /// index of `out`. If any handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an
+    /// initialized `libra_d3d12_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    PFN_libra_d3d12_filter_chain_get_params_by_handle d3d12_filter_chain_get_params_by_handle;
+
     /// Sets a parameter for the filter chain.
     ///
     /// If the parameter does not exist, returns an error.
@@ -864,6 +1744,30 @@ typedef struct libra_instance_t {
     PFN_libra_d3d12_filter_chain_set_param d3d12_filter_chain_set_param;
 #endif
 
+#if defined(LIBRA_TRACING)
+    /// Start recording a trace of librashader to the file at `path`, in the
+    /// Chrome trace event format.
+    ///
+    /// Spans are recorded for preset parsing, preprocessing, shader
+    /// compilation, reflection, pass and LUT loading, and frame recording. If
+    /// a trace is already being recorded, it is finished before the new trace
+    /// is started.
+    ///
+    /// This installs a global `tracing` subscriber the first time it is
+    /// called, and fails if another subscriber was already installed in the
+    /// process.
+    ///
+    /// ## Safety
+    ///  - `path` must be either null or a valid, aligned pointer to a string
+    ///  path to the trace file.
+    PFN_libra_trace_begin trace_begin;
+
+    /// Finish recording the current trace and flush it to its file.
+    ///
+    /// If no trace is being recorded, this function does nothing.
+    PFN_libra_trace_end trace_end;
+#endif
+
     /// Helper flag for if the librashader instance was loaded.
     ///
     /// This flag is not indicative of whether any functions were loaded
@@ -898,6 +1802,8 @@ libra_instance_t __librashader_make_null_instance() {
         .preset_print = __librashader__noop_preset_print,
         .preset_get_runtime_params =
             __librashader__noop_preset_get_runtime_params,
+        .preset_get_runtime_params_into =
+            __librashader__noop_preset_get_runtime_params_into,
         .preset_free_runtime_params =
             __librashader__noop_preset_free_runtime_params,
 
@@ -911,13 +1817,39 @@ libra_instance_t __librashader_make_null_instance() {
         .gl_init_context = __librashader__noop_gl_init_context,
         .gl_filter_chain_create = __librashader__noop_gl_filter_chain_create,
         .gl_filter_chain_frame = __librashader__noop_gl_filter_chain_frame,
+        .gl_filter_chain_frame_batch =
+            __librashader__noop_gl_filter_chain_frame_batch,
         .gl_filter_chain_free = __librashader__noop_gl_filter_chain_free,
         .gl_filter_chain_get_active_pass_count =
             __librashader__noop_gl_filter_chain_get_active_pass_count,
+        .gl_filter_chain_get_history_len =
+            __librashader__noop_gl_filter_chain_get_history_len,
+        .gl_filter_chain_get_pass_timings =
+            __librashader__noop_gl_filter_chain_get_pass_timings,
+        .gl_filter_chain_set_frame_time_budget =
+            __librashader__noop_gl_filter_chain_set_frame_time_budget,
+        .gl_filter_chain_get_viewport_scale =
+            __librashader__noop_gl_filter_chain_get_viewport_scale,
+        .gl_filter_chain_set_viewport_scale =
+            __librashader__noop_gl_filter_chain_set_viewport_scale,
         .gl_filter_chain_set_active_pass_count =
             __librashader__noop_gl_filter_chain_set_active_pass_count,
         .gl_filter_chain_get_param =
             __librashader__noop_gl_filter_chain_get_param,
+        .gl_filter_chain_get_param_handle =
+            __librashader__noop_gl_filter_chain_get_param_handle,
+        .gl_filter_chain_set_param_by_handle =
+            __librashader__noop_gl_filter_chain_set_param_by_handle,
+        .gl_filter_chain_get_param_by_handle =
+            __librashader__noop_gl_filter_chain_get_param_by_handle,
+        .gl_filter_chain_set_params =
+            __librashader__noop_gl_filter_chain_set_params,
+        .gl_filter_chain_get_params =
+            __librashader__noop_gl_filter_chain_get_params,
+        .gl_filter_chain_set_params_by_handle =
+            __librashader__noop_gl_filter_chain_set_params_by_handle,
+        .gl_filter_chain_get_params_by_handle =
+            __librashader__noop_gl_filter_chain_get_params_by_handle,
         .gl_filter_chain_set_param =
             __librashader__noop_gl_filter_chain_set_param,
 #endif
@@ -925,14 +1857,57 @@ libra_instance_t __librashader_make_null_instance() {
 #if defined(LIBRA_RUNTIME_VULKAN)
         .vk_filter_chain_create = __librashader__noop_vk_filter_chain_create,
         .vk_filter_chain_create_deferred = __librashader__noop_vk_filter_chain_create_deferred,
+        .vk_context_create = __librashader__noop_vk_context_create,
+        .vk_context_free = __librashader__noop_vk_context_free,
+        .vk_filter_chain_create_with_context =
+            __librashader__noop_vk_filter_chain_create_with_context,
+        .vk_filter_chain_create_deferred_with_context =
+            __librashader__noop_vk_filter_chain_create_deferred_with_context,
+        .vk_filter_chain_create_async =
+            __librashader__noop_vk_filter_chain_create_async,
+        .vk_filter_chain_pending_poll =
+            __librashader__noop_vk_filter_chain_pending_poll,
+        .vk_filter_chain_pending_cancel =
+            __librashader__noop_vk_filter_chain_pending_cancel,
+        .vk_filter_chain_pending_finish =
+            __librashader__noop_vk_filter_chain_pending_finish,
+        .vk_filter_chain_swap = __librashader__noop_vk_filter_chain_swap,
+        .vk_filter_chain_pending_free =
+            __librashader__noop_vk_filter_chain_pending_free,
         .vk_filter_chain_frame = __librashader__noop_vk_filter_chain_frame,
+        .vk_filter_chain_frame_batch =
+            __librashader__noop_vk_filter_chain_frame_batch,
         .vk_filter_chain_free = __librashader__noop_vk_filter_chain_free,
         .vk_filter_chain_get_active_pass_count =
             __librashader__noop_vk_filter_chain_get_active_pass_count,
+        .vk_filter_chain_get_history_len =
+            __librashader__noop_vk_filter_chain_get_history_len,
+        .vk_filter_chain_get_pass_timings =
+            __librashader__noop_vk_filter_chain_get_pass_timings,
+        .vk_filter_chain_set_frame_time_budget =
+            __librashader__noop_vk_filter_chain_set_frame_time_budget,
+        .vk_filter_chain_get_viewport_scale =
+            __librashader__noop_vk_filter_chain_get_viewport_scale,
+        .vk_filter_chain_set_viewport_scale =
+            __librashader__noop_vk_filter_chain_set_viewport_scale,
         .vk_filter_chain_set_active_pass_count =
             __librashader__noop_vk_filter_chain_set_active_pass_count,
         .vk_filter_chain_get_param =
             __librashader__noop_vk_filter_chain_get_param,
+        .vk_filter_chain_get_param_handle =
+            __librashader__noop_vk_filter_chain_get_param_handle,
+        .vk_filter_chain_set_param_by_handle =
+            __librashader__noop_vk_filter_chain_set_param_by_handle,
+        .vk_filter_chain_get_param_by_handle =
+            __librashader__noop_vk_filter_chain_get_param_by_handle,
+        .vk_filter_chain_set_params =
+            __librashader__noop_vk_filter_chain_set_params,
+        .vk_filter_chain_get_params =
+            __librashader__noop_vk_filter_chain_get_params,
+        .vk_filter_chain_set_params_by_handle =
+            __librashader__noop_vk_filter_chain_set_params_by_handle,
+        .vk_filter_chain_get_params_by_handle =
+            __librashader__noop_vk_filter_chain_get_params_by_handle,
         .vk_filter_chain_set_param =
             __librashader__noop_vk_filter_chain_set_param,
 #endif
@@ -951,6 +1926,20 @@ libra_instance_t __librashader_make_null_instance() {
             __librashader__noop_d3d11_filter_chain_set_active_pass_count,
         .d3d11_filter_chain_get_param =
             __librashader__noop_d3d11_filter_chain_get_param,
+        .d3d11_filter_chain_get_param_handle =
+            __librashader__noop_d3d11_filter_chain_get_param_handle,
+        .d3d11_filter_chain_set_param_by_handle =
+            __librashader__noop_d3d11_filter_chain_set_param_by_handle,
+        .d3d11_filter_chain_get_param_by_handle =
+            __librashader__noop_d3d11_filter_chain_get_param_by_handle,
+        .d3d11_filter_chain_set_params =
+            __librashader__noop_d3d11_filter_chain_set_params,
+        .d3d11_filter_chain_get_params =
+            __librashader__noop_d3d11_filter_chain_get_params,
+        .d3d11_filter_chain_set_params_by_handle =
+            __librashader__noop_d3d11_filter_chain_set_params_by_handle,
+        .d3d11_filter_chain_get_params_by_handle =
+            __librashader__noop_d3d11_filter_chain_get_params_by_handle,
         .d3d11_filter_chain_set_param =
             __librashader__noop_d3d11_filter_chain_set_param,
 #endif
@@ -969,9 +1958,28 @@ libra_instance_t __librashader_make_null_instance() {
             __librashader__noop_d3d12_filter_chain_set_active_pass_count,
         .d3d12_filter_chain_get_param =
             __librashader__noop_d3d12_filter_chain_get_param,
+        .d3d12_filter_chain_get_param_handle =
+            __librashader__noop_d3d12_filter_chain_get_param_handle,
+        .d3d12_filter_chain_set_param_by_handle =
+            __librashader__noop_d3d12_filter_chain_set_param_by_handle,
+        .d3d12_filter_chain_get_param_by_handle =
+            __librashader__noop_d3d12_filter_chain_get_param_by_handle,
+        .d3d12_filter_chain_set_params =
+            __librashader__noop_d3d12_filter_chain_set_params,
+        .d3d12_filter_chain_get_params =
+            __librashader__noop_d3d12_filter_chain_get_params,
+        .d3d12_filter_chain_set_params_by_handle =
+            __librashader__noop_d3d12_filter_chain_set_params_by_handle,
+        .d3d12_filter_chain_get_params_by_handle =
+            __librashader__noop_d3d12_filter_chain_get_params_by_handle,
         .d3d12_filter_chain_set_param =
             __librashader__noop_d3d12_filter_chain_set_param,
 #endif
+
+#if defined(LIBRA_TRACING)
+        .trace_begin = __librashader__noop_trace_begin,
+        .trace_end = __librashader__noop_trace_end,
+#endif
         .instance_loaded = false,
     };
 }
@@ -1013,6 +2021,8 @@ libra_instance_t librashader_load_instance() {
     _LIBRASHADER_ASSIGN(librashader, instance, preset_print);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 preset_get_runtime_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                                preset_get_runtime_params_into);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 preset_free_runtime_params);
 
@@ -1026,13 +2036,38 @@ libra_instance_t librashader_load_instance() {
     _LIBRASHADER_ASSIGN(librashader, instance, gl_init_context);
     _LIBRASHADER_ASSIGN(librashader, instance, gl_filter_chain_create);
     _LIBRASHADER_ASSIGN(librashader, instance, gl_filter_chain_frame);
+    _LIBRASHADER_ASSIGN(librashader, instance, gl_filter_chain_frame_batch);
     _LIBRASHADER_ASSIGN(librashader, instance, gl_filter_chain_free);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 gl_filter_chain_get_param);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_get_param_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_set_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_get_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_set_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_get_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_set_params_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_get_params_by_handle);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 gl_filter_chain_set_param);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 gl_filter_chain_get_active_pass_count);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_get_history_len);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_get_pass_timings);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_set_frame_time_budget);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_get_viewport_scale);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        gl_filter_chain_set_viewport_scale);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 gl_filter_chain_set_active_pass_count);
 
@@ -1041,14 +2076,51 @@ libra_instance_t librashader_load_instance() {
 #if defined(LIBRA_RUNTIME_VULKAN)
     _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_create);
     _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_create_deferred);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_context_create);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_context_free);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_create_with_context);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_create_deferred_with_context);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_create_async);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_pending_poll);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_pending_cancel);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_pending_finish);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_swap);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_pending_free);
     _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_frame);
+    _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_frame_batch);
     _LIBRASHADER_ASSIGN(librashader, instance, vk_filter_chain_free);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 vk_filter_chain_get_param);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_get_param_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_set_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_get_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_set_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_get_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_set_params_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_get_params_by_handle);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 vk_filter_chain_set_param);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 vk_filter_chain_get_active_pass_count);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_get_history_len);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_get_pass_timings);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_set_frame_time_budget);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_get_viewport_scale);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        vk_filter_chain_set_viewport_scale);
     _LIBRASHADER_ASSIGN(librashader, instance,
                                 vk_filter_chain_set_active_pass_count);
 #endif
@@ -1059,6 +2131,20 @@ libra_instance_t librashader_load_instance() {
     _LIBRASHADER_ASSIGN(librashader, instance, d3d11_filter_chain_frame);
     _LIBRASHADER_ASSIGN(librashader, instance, d3d11_filter_chain_free);
     _LIBRASHADER_ASSIGN(librashader, instance, d3d11_filter_chain_get_param);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d11_filter_chain_get_param_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d11_filter_chain_set_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d11_filter_chain_get_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d11_filter_chain_set_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d11_filter_chain_get_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d11_filter_chain_set_params_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d11_filter_chain_get_params_by_handle);
     _LIBRASHADER_ASSIGN(librashader, instance, d3d11_filter_chain_set_param);
     _LIBRASHADER_ASSIGN(librashader, instance,
                         d3d11_filter_chain_get_active_pass_count);
@@ -1072,12 +2158,31 @@ libra_instance_t librashader_load_instance() {
     _LIBRASHADER_ASSIGN(librashader, instance, d3d12_filter_chain_frame);
     _LIBRASHADER_ASSIGN(librashader, instance, d3d12_filter_chain_free);
     _LIBRASHADER_ASSIGN(librashader, instance, d3d12_filter_chain_get_param);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d12_filter_chain_get_param_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d12_filter_chain_set_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d12_filter_chain_get_param_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d12_filter_chain_set_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d12_filter_chain_get_params);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d12_filter_chain_set_params_by_handle);
+    _LIBRASHADER_ASSIGN(librashader, instance,
+                        d3d12_filter_chain_get_params_by_handle);
     _LIBRASHADER_ASSIGN(librashader, instance, d3d12_filter_chain_set_param);
     _LIBRASHADER_ASSIGN(librashader, instance,
                         d3d12_filter_chain_get_active_pass_count);
     _LIBRASHADER_ASSIGN(librashader, instance,
                         d3d12_filter_chain_set_active_pass_count);
 #endif
+
+#if defined(LIBRA_TRACING)
+    _LIBRASHADER_ASSIGN(librashader, instance, trace_begin);
+    _LIBRASHADER_ASSIGN(librashader, instance, trace_end);
+#endif
     instance.instance_loaded = true;
     return instance;
 }
@@ -12,6 +12,7 @@ pub struct CachedCompilation<T> {
 impl<T: ShaderCompilation + for<'de> serde::Deserialize<'de> + serde::Serialize + Clone>
     ShaderCompilation for CachedCompilation<T>
 {
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
     fn compile(source: &ShaderSource) -> Result<Self, ShaderCompileError> {
         let cache = crate::cache::internal::get_cache();
 
@@ -1,6 +1,7 @@
 //! Binding types for the librashader C API.
 use crate::error::LibrashaderError;
 use librashader::presets::ShaderPreset;
+use std::ffi::c_char;
 use std::mem::MaybeUninit;
 use std::ptr::NonNull;
 
@@ -10,6 +11,9 @@ pub type libra_shader_preset_t = Option<NonNull<ShaderPreset>>;
 /// A handle to a librashader error object.
 pub type libra_error_t = Option<NonNull<LibrashaderError>>;
 
+/// A handle to a shader parameter of a filter chain.
+pub type libra_param_handle_t = u32;
+
 /// A handle to a OpenGL filter chain.
 #[cfg(feature = "runtime-opengl")]
 #[doc(cfg(feature = "runtime-opengl"))]
@@ -33,6 +37,17 @@ pub type libra_d3d12_filter_chain_t =
 pub type libra_vk_filter_chain_t =
     Option<NonNull<librashader::runtime::vk::capi::FilterChainVulkan>>;
 
+/// A handle to a Vulkan device context that can be shared between filter chains.
+#[cfg(feature = "runtime-vulkan")]
+#[doc(cfg(feature = "runtime-vulkan"))]
+pub type libra_vk_context_t = Option<NonNull<librashader::runtime::vk::capi::VulkanContext>>;
+
+/// A handle to a Vulkan filter chain that is loading in the background.
+#[cfg(feature = "runtime-vulkan")]
+#[doc(cfg(feature = "runtime-vulkan"))]
+pub type libra_vk_filter_chain_pending_t =
+    Option<NonNull<librashader::runtime::vk::capi::PendingFilterChainVulkan>>;
+
 /// Defines the output viewport for a rendered frame.
 #[repr(C)]
 pub struct libra_viewport_t {
@@ -46,6 +61,30 @@ pub struct libra_viewport_t {
     pub height: u32,
 }
 
+/// The GPU time spent drawing a shader pass.
+#[repr(C)]
+pub struct libra_pass_timing_t {
+    /// The index of the pass in the preset.
+    pub index: usize,
+    /// The alias of the pass, or null if the pass has no alias.
+    /// The alias is not null terminated, and is valid until the filter chain is freed.
+    pub alias: *const c_char,
+    /// The length of the alias in bytes.
+    pub alias_len: usize,
+    /// The GPU time spent drawing the pass, in nanoseconds.
+    pub nanoseconds: u64,
+}
+
+/// The progress of a filter chain that is loading in the background.
+#[repr(C)]
+pub struct libra_load_progress_t {
+    /// The number of passes that have been compiled.
+    pub passes_loaded: usize,
+    /// The number of passes that will be compiled, or zero if the preset has not been parsed yet.
+    /// Deferred passes are not counted, since they are compiled when they are first drawn.
+    pub pass_count: usize,
+}
+
 pub(crate) trait FromUninit<T>
 where
     Self: Sized,
@@ -25,6 +25,8 @@ pub enum LibrashaderError {
     ShaderReflectError(#[from] librashader::reflect::ShaderReflectError),
     #[error("The provided parameter name was invalid.")]
     UnknownShaderParameter(*const c_char),
+    #[error("The provided parameter handle was invalid.")]
+    UnknownShaderParameterHandle(u32),
     #[cfg(feature = "runtime-opengl")]
     #[doc(cfg(feature = "runtime-opengl"))]
     #[error("There was an error in the OpenGL filter chain.")]
@@ -178,7 +180,10 @@ impl LibrashaderError {
             LibrashaderError::ShaderCompileError(_) | LibrashaderError::ShaderReflectError(_) => {
                 LIBRA_ERRNO::REFLECT_ERROR
             }
-            LibrashaderError::UnknownShaderParameter(_) => LIBRA_ERRNO::SHADER_PARAMETER_ERROR,
+            LibrashaderError::UnknownShaderParameter(_)
+            | LibrashaderError::UnknownShaderParameterHandle(_) => {
+                LIBRA_ERRNO::SHADER_PARAMETER_ERROR
+            }
             #[cfg(feature = "runtime-opengl")]
             LibrashaderError::OpenGlFilterError(_) => LIBRA_ERRNO::RUNTIME_ERROR,
             #[cfg(all(target_os = "windows", feature = "runtime-d3d11"))]
@@ -79,6 +79,11 @@ pub mod presets;
 pub mod reflect;
 
 pub mod runtime;
+
+#[doc(cfg(feature = "tracing"))]
+#[cfg(feature = "tracing")]
+pub mod trace;
+
 pub mod version;
 
 pub use version::LIBRASHADER_ABI_VERSION;
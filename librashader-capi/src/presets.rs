@@ -2,8 +2,10 @@
 use crate::ctypes::libra_shader_preset_t;
 use crate::error::{assert_non_null, assert_some_ptr, LibrashaderError};
 use crate::ffi::extern_fn;
+use librashader::preprocess::ShaderParameter;
 use librashader::presets::ShaderPreset;
-use std::ffi::{c_char, CStr, CString};
+use std::alloc::Layout;
+use std::ffi::{c_char, c_void, CStr};
 use std::mem::MaybeUninit;
 use std::ptr::NonNull;
 
@@ -38,6 +40,75 @@ pub struct libra_preset_param_t {
     pub step: f32,
 }
 
+/// Runtime parameters packed into a single block of memory.
+///
+/// The parameter structs come first, followed by the null terminated names
+/// and descriptions that they point to.
+struct PackedParams {
+    params: Vec<ShaderParameter>,
+    size: usize,
+}
+
+impl PackedParams {
+    const LAYOUT: Layout = Layout::new::<libra_preset_param_t>();
+
+    fn new(preset: &ShaderPreset) -> Result<Self, LibrashaderError> {
+        let params: Vec<ShaderParameter> =
+            librashader::presets::get_parameter_meta(preset)?.collect();
+
+        let mut size = params.len() * Self::LAYOUT.size();
+        for param in &params {
+            for string in [&param.id, &param.description] {
+                if string.as_bytes().contains(&0) {
+                    return Err(LibrashaderError::UnknownError(Box::new(format!(
+                        "parameter string {string:?} contains a null byte"
+                    ))));
+                }
+                size += string.len() + 1;
+            }
+        }
+
+        Ok(PackedParams { params, size })
+    }
+
+    /// Write the parameters into the buffer, returning the parameter list.
+    ///
+    /// ## Safety
+    /// `buffer` must be valid for writes of `self.size` bytes, and aligned to `libra_preset_param_t`.
+    unsafe fn write(&self, buffer: NonNull<u8>, owned: bool) -> libra_preset_param_list_t {
+        unsafe fn write_str(cursor: &mut *mut u8, string: &str) -> *const c_char {
+            let start = *cursor;
+            unsafe {
+                std::ptr::copy_nonoverlapping(string.as_ptr(), start, string.len());
+                start.add(string.len()).write(0);
+                *cursor = start.add(string.len() + 1);
+            }
+            start.cast_const().cast()
+        }
+
+        let parameters = buffer.as_ptr().cast::<libra_preset_param_t>();
+        unsafe {
+            let mut strings = buffer.as_ptr().add(self.params.len() * Self::LAYOUT.size());
+            for (index, param) in self.params.iter().enumerate() {
+                parameters.add(index).write(libra_preset_param_t {
+                    name: write_str(&mut strings, &param.id),
+                    description: write_str(&mut strings, &param.description),
+                    initial: param.initial,
+                    minimum: param.minimum,
+                    maximum: param.maximum,
+                    step: param.step,
+                });
+            }
+        }
+
+        libra_preset_param_list_t {
+            parameters,
+            length: self.params.len() as u64,
+            _internal_alloc: if owned { self.size as u64 } else { 0 },
+        }
+    }
+}
+
 extern_fn! {
     /// Load a preset.
     ///
@@ -145,6 +216,9 @@ extern_fn! {
 extern_fn! {
     /// Get a list of runtime parameters.
     ///
+    /// The parameter list and all of its strings are stored in a single allocation,
+    /// which is freed with `libra_preset_free_runtime_params`.
+    ///
     /// ## Safety
     /// - `preset` must be null or a valid and aligned pointer to a shader preset.
     /// - `out` must be an aligned pointer to a `libra_preset_parameter_list_t`.
@@ -160,29 +234,63 @@ extern_fn! {
         assert_some_ptr!(preset);
         assert_non_null!(out);
 
-        let iter = librashader::presets::get_parameter_meta(preset)?;
-        let mut values = Vec::new();
-        for param in iter {
-            let name = CString::new(param.id)
-            .map_err(|err| LibrashaderError::UnknownError(Box::new(err)))?;
-            let description = CString::new(param.description)
-            .map_err(|err| LibrashaderError::UnknownError(Box::new(err)))?;
-            values.push(libra_preset_param_t {
-                name: name.into_raw().cast_const(),
-                description: description.into_raw().cast_const(),
-                initial: param.initial,
-                minimum: param.minimum,
-                maximum: param.maximum,
-                step: param.step
-            })
+        let packed = PackedParams::new(preset)?;
+        let buffer = if packed.size == 0 {
+            NonNull::dangling()
+        } else {
+            let layout = Layout::from_size_align(packed.size, PackedParams::LAYOUT.align())
+                .map_err(|err| LibrashaderError::UnknownError(Box::new(err)))?;
+            let Some(buffer) = NonNull::new(unsafe { std::alloc::alloc(layout) }) else {
+                std::alloc::handle_alloc_error(layout)
+            };
+            buffer
+        };
+
+        unsafe {
+            out.write(MaybeUninit::new(packed.write(buffer, true)));
         }
-        let (parts, len, cap) = values.into_raw_parts();
+    }
+}
+
+extern_fn! {
+    /// Get a list of runtime parameters, written into a buffer provided by the caller.
+    ///
+    /// If `buffer` is null, the number of bytes needed to hold the parameter list is written
+    /// to `size`, and `out` is not written to. Otherwise, `size` must point to the size of `buffer`
+    /// in bytes, and is updated with the number of bytes needed. If `buffer` is too small,
+    /// returns `LIBRA_ERR_INVALID_PARAMETER`.
+    ///
+    /// The parameter list points into `buffer`, and is only valid as long as `buffer` is.
+    /// It must not be freed with `libra_preset_free_runtime_params`.
+    ///
+    /// ## Safety
+    /// - `preset` must be null or a valid and aligned pointer to a shader preset.
+    /// - `buffer` must be null, or valid for writes of `size` bytes and aligned to `libra_preset_param_t`.
+    /// - `size` must be a valid and aligned pointer to a `size_t`.
+    /// - `out` must be an aligned pointer to a `libra_preset_parameter_list_t` if `buffer` is not null.
+    fn libra_preset_get_runtime_params_into(
+        preset: *mut libra_shader_preset_t,
+        buffer: *mut c_void,
+        size: *mut usize,
+        out: *mut MaybeUninit<libra_preset_param_list_t>
+    ) |preset| {
+        assert_some_ptr!(preset);
+        assert_non_null!(size);
+
+        let packed = PackedParams::new(preset)?;
+        let capacity = unsafe { size.replace(packed.size) };
+
+        let Some(buffer) = NonNull::new(buffer.cast::<u8>()) else {
+            return LibrashaderError::ok();
+        };
+
+        assert_non_null!(out);
+        if capacity < packed.size || !buffer.as_ptr().cast::<libra_preset_param_t>().is_aligned() {
+            return LibrashaderError::InvalidParameter("buffer").export();
+        }
+
         unsafe {
-            out.write(MaybeUninit::new(libra_preset_param_list_t {
-                parameters: parts,
-                length: len as u64,
-                _internal_alloc: cap as u64,
-            }));
+            out.write(MaybeUninit::new(packed.write(buffer, false)));
         }
     }
 }
@@ -208,18 +316,14 @@ extern_fn! {
     ///   their values given after `libra_preset_get_runtime_params`, this may result
     ///   in undefined behaviour.
     fn libra_preset_free_runtime_params(preset: libra_preset_param_list_t) {
-        unsafe {
-            let values = Vec::from_raw_parts(preset.parameters.cast_mut(),
-                                             preset.length as usize,
-                                            preset._internal_alloc as usize);
-
-            for value in values {
-                let name = CString::from_raw(value.name.cast_mut());
-                let description = CString::from_raw(value.description.cast_mut());
+        let size = preset._internal_alloc as usize;
+        if size == 0 {
+            return LibrashaderError::ok();
+        }
 
-                drop(name);
-                drop(description)
-            }
+        unsafe {
+            let layout = Layout::from_size_align_unchecked(size, PackedParams::LAYOUT.align());
+            std::alloc::dealloc(preset.parameters.cast_mut().cast(), layout);
         }
     }
 }
@@ -1,8 +1,10 @@
 use crate::ctypes::{
-    config_struct, libra_d3d11_filter_chain_t, libra_shader_preset_t, libra_viewport_t, FromUninit,
+    config_struct, libra_d3d11_filter_chain_t, libra_param_handle_t, libra_shader_preset_t,
+    libra_viewport_t, FromUninit,
 };
 use crate::error::{assert_non_null, assert_some_ptr, LibrashaderError};
 use crate::ffi::extern_fn;
+use crate::runtime::parameters;
 use librashader::runtime::d3d11::{D3D11InputView, D3D11OutputView};
 use std::ffi::c_char;
 use std::ffi::CStr;
@@ -17,7 +19,7 @@ use librashader::runtime::d3d11::capi::options::FilterChainOptionsD3D11;
 use librashader::runtime::d3d11::capi::options::FrameOptionsD3D11;
 
 use crate::LIBRASHADER_API_VERSION;
-use librashader::runtime::{FilterChainParameters, Size, Viewport};
+use librashader::runtime::{FilterChainParameters, ParameterHandle, Size, Viewport};
 
 /// Direct3D 11 parameters for the source image.
 #[repr(C)]
@@ -74,11 +76,16 @@ pub struct frame_d3d11_opt_t {
     /// The direction of rendering.
     /// -1 indicates that the frames are played in reverse order.
     pub frame_direction: i32,
+    /// Whether the input image is the same as in the last frame.
+    /// Passes that do not read the frame count, history or feedback keep their
+    /// output from the last frame instead of being drawn again.
+    pub input_unchanged: bool,
 }
 
 config_struct! {
     impl FrameOptionsD3D11 => frame_d3d11_opt_t {
         0 => [clear_history, frame_direction];
+        1 => [input_unchanged];
     }
 }
 
@@ -314,6 +321,167 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Gets a handle to a parameter of the filter chain.
+    ///
+    /// The handle can be used with `libra_d3d11_filter_chain_set_param_by_handle` and
+    /// `libra_d3d11_filter_chain_get_param_by_handle` to access the parameter without
+    /// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+    ///
+    /// If the parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+    /// - `param_name` must be either null or a null terminated string.
+    fn libra_d3d11_filter_chain_get_param_handle(
+        chain: *mut libra_d3d11_filter_chain_t,
+        param_name: *const c_char,
+        out: *mut MaybeUninit<libra_param_handle_t>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        assert_non_null!(param_name);
+        unsafe {
+            let name = CStr::from_ptr(param_name);
+            let name = name.to_str()?;
+
+            let Some(handle) = chain.get_parameter_handle(name) else {
+                return LibrashaderError::UnknownShaderParameter(param_name).export()
+            };
+
+            out.write(MaybeUninit::new(handle.as_raw()));
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+    fn libra_d3d11_filter_chain_set_param_by_handle(
+        chain: *mut libra_d3d11_filter_chain_t,
+        handle: libra_param_handle_t,
+        value: f32
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        if chain.set_parameter_by_handle(ParameterHandle::from_raw(handle), value).is_none() {
+            return LibrashaderError::UnknownShaderParameterHandle(handle).export()
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+    fn libra_d3d11_filter_chain_get_param_by_handle(
+        chain: *mut libra_d3d11_filter_chain_t,
+        handle: libra_param_handle_t,
+        out: *mut MaybeUninit<f32>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let Some(value) = chain.get_parameter_by_handle(ParameterHandle::from_raw(handle)) else {
+            return LibrashaderError::UnknownShaderParameterHandle(handle).export()
+        };
+
+        unsafe {
+            out.write(MaybeUninit::new(value));
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets multiple parameters for the filter chain.
+    ///
+    /// `names` and `values` must both have `count` elements. If any parameter does not exist,
+    /// returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_d3d11_filter_chain_set_params(
+        chain: *mut libra_d3d11_filter_chain_t,
+        names: *const *const c_char,
+        values: *const f32,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::set_params(chain, names, values, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets multiple parameters for the filter chain.
+    ///
+    /// The value of the parameter named by each element of `names` is written to the same
+    /// index of `out`. If any parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_d3d11_filter_chain_get_params(
+        chain: *mut libra_d3d11_filter_chain_t,
+        names: *const *const c_char,
+        out: *mut MaybeUninit<f32>,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::get_params(chain, names, out, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets multiple parameters for the filter chain by their handles.
+    ///
+    /// `handles` and `values` must both have `count` elements. If any handle is not valid
+    /// for this filter chain, returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_d3d11_filter_chain_set_params_by_handle(
+        chain: *mut libra_d3d11_filter_chain_t,
+        handles: *const libra_param_handle_t,
+        values: *const f32,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::set_params_by_handle(chain, handles, values, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets multiple parameters for the filter chain by their handles.
+    ///
+    /// The value of the parameter for each element of `handles` is written to the same
+    /// index of `out`. If any handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_d3d11_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_d3d11_filter_chain_get_params_by_handle(
+        chain: *mut libra_d3d11_filter_chain_t,
+        handles: *const libra_param_handle_t,
+        out: *mut MaybeUninit<f32>,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::get_params_by_handle(chain, handles, out, count)?;
+        }
+    }
+}
+
 extern_fn! {
     /// Sets the number of active passes for this chain.
     ///
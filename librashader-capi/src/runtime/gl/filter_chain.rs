@@ -1,19 +1,22 @@
 use crate::ctypes::{
-    config_struct, libra_gl_filter_chain_t, libra_shader_preset_t, libra_viewport_t, FromUninit,
+    config_struct, libra_gl_filter_chain_t, libra_param_handle_t, libra_pass_timing_t,
+    libra_shader_preset_t, libra_viewport_t, FromUninit,
 };
 use crate::error::{assert_non_null, assert_some_ptr, LibrashaderError};
 use crate::ffi::extern_fn;
+use crate::runtime::{parameters, timing};
 use librashader::runtime::gl::{GLFramebuffer, GLImage};
 use std::ffi::CStr;
 use std::ffi::{c_char, c_void, CString};
 use std::mem::MaybeUninit;
 use std::ptr::NonNull;
 use std::slice;
+use std::time::Duration;
 
 use crate::LIBRASHADER_API_VERSION;
 use librashader::runtime::gl::capi::options::FilterChainOptionsGL;
 use librashader::runtime::gl::capi::options::FrameOptionsGL;
-use librashader::runtime::FilterChainParameters;
+use librashader::runtime::{FilterChainParameters, ParameterHandle};
 use librashader::runtime::{Size, Viewport};
 
 /// A GL function loader that librashader needs to be initialized with.
@@ -64,11 +67,16 @@ pub struct frame_gl_opt_t {
     /// The direction of rendering.
     /// -1 indicates that the frames are played in reverse order.
     pub frame_direction: i32,
+    /// Whether the input image is the same as in the last frame.
+    /// Passes that do not read the frame count, history or feedback keep their
+    /// output from the last frame instead of being drawn again.
+    pub input_unchanged: bool,
 }
 
 config_struct! {
     impl FrameOptionsGL => frame_gl_opt_t {
         0 => [clear_history, frame_direction];
+        1 => [input_unchanged];
     }
 }
 
@@ -89,11 +97,28 @@ pub struct filter_chain_gl_opt_t {
     /// Disable the shader object cache. Shaders will be
     /// recompiled rather than loaded from the cache.
     pub disable_cache: bool,
+    /// Defer compiling passes until they are enabled and first drawn.
+    ///
+    /// Every pass is enabled when the filter chain is created, so the number of enabled passes
+    /// must be lowered with `libra_gl_filter_chain_set_active_pass_count` before the first frame,
+    /// or every pass is compiled when the first frame is drawn.
+    pub defer_passes: bool,
+    /// Compile deferred passes in the background ahead of when they are needed.
+    /// Only applies if `defer_passes` is enabled.
+    pub prefetch_passes: bool,
+    /// Bind the input images of previous frames as history instead of copying them.
+    /// The caller must keep each input texture alive and unmodified for the number of frames
+    /// given by `libra_gl_filter_chain_get_history_len` after it is drawn.
+    pub zero_copy_history: bool,
+    /// Measure the GPU time spent drawing each pass with timer queries.
+    /// The results are available from `libra_gl_filter_chain_get_pass_timings`.
+    pub time_passes: bool,
 }
 
 config_struct! {
     impl FilterChainOptionsGL => filter_chain_gl_opt_t {
         0 => [glsl_version, use_dsa, force_no_mipmaps, disable_cache];
+        1 => [defer_passes, prefetch_passes, zero_copy_history, time_passes];
     }
 }
 
@@ -209,6 +234,76 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Draw a batch of frames with the given parameters for the given filter chain, as if
+    /// `libra_gl_filter_chain_frame` was called for each of them in order.
+    ///
+    /// Frame `i` draws `images[i]` to `outputs[i]` with `viewports[i]` and a frame count of
+    /// `frame_count + i`, so history and feedback advance between frames. The MVP and options
+    /// apply to every frame, except that history is only cleared before the first frame.
+    /// Nothing is flushed between frames.
+    ///
+    /// ## Safety
+    /// - The requirements of `libra_gl_filter_chain_frame` apply to every frame.
+    /// - `images`, `viewports` and `outputs` must be valid and aligned pointers to `count`
+    ///   consecutive values each.
+    nopanic fn libra_gl_filter_chain_frame_batch(
+        chain: *mut libra_gl_filter_chain_t,
+        frame_count: usize,
+        count: usize,
+        images: *const libra_source_image_gl_t,
+        viewports: *const libra_viewport_t,
+        outputs: *const libra_output_framebuffer_gl_t,
+        mvp: *const f32,
+        opt: *const MaybeUninit<frame_gl_opt_t>,
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        assert_non_null!(images);
+        assert_non_null!(viewports);
+        assert_non_null!(outputs);
+
+        let mvp = if mvp.is_null() {
+            None
+        } else {
+            Some(<&[f32; 16]>::try_from(unsafe { slice::from_raw_parts(mvp, 16) }).unwrap())
+        };
+        let opt = if opt.is_null() {
+            None
+        } else {
+            Some(unsafe { opt.read() })
+        };
+        let opt = opt.map(FromUninit::from_uninit);
+
+        let mut inputs = Vec::with_capacity(count);
+        let mut framebuffers = Vec::with_capacity(count);
+        for index in 0..count {
+            let (image, viewport, out) = unsafe {
+                (images.add(index).read(), viewports.add(index).read(), outputs.add(index).read())
+            };
+
+            inputs.push(GLImage::from(image));
+            framebuffers.push((
+                GLFramebuffer::new_from_raw(out.texture, out.fbo, out.format, Size::new(viewport.width, viewport.height), 1),
+                viewport,
+            ));
+        }
+        let targets: Vec<_> = framebuffers
+            .iter()
+            .map(|(framebuffer, viewport)| Viewport {
+                x: viewport.x,
+                y: viewport.y,
+                output: framebuffer,
+                mvp,
+            })
+            .collect();
+        let frames: Vec<_> = inputs.iter().zip(targets.iter()).collect();
+
+        unsafe {
+            chain.frame_batch(&frames, frame_count, opt.as_ref())?;
+        }
+    }
+}
+
 extern_fn! {
     /// Sets a parameter for the filter chain.
     ///
@@ -261,6 +356,167 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Gets a handle to a parameter of the filter chain.
+    ///
+    /// The handle can be used with `libra_gl_filter_chain_set_param_by_handle` and
+    /// `libra_gl_filter_chain_get_param_by_handle` to access the parameter without
+    /// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+    ///
+    /// If the parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    /// - `param_name` must be either null or a null terminated string.
+    fn libra_gl_filter_chain_get_param_handle(
+        chain: *mut libra_gl_filter_chain_t,
+        param_name: *const c_char,
+        out: *mut MaybeUninit<libra_param_handle_t>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        assert_non_null!(param_name);
+        unsafe {
+            let name = CStr::from_ptr(param_name);
+            let name = name.to_str()?;
+
+            let Some(handle) = chain.get_parameter_handle(name) else {
+                return LibrashaderError::UnknownShaderParameter(param_name).export()
+            };
+
+            out.write(MaybeUninit::new(handle.as_raw()));
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    fn libra_gl_filter_chain_set_param_by_handle(
+        chain: *mut libra_gl_filter_chain_t,
+        handle: libra_param_handle_t,
+        value: f32
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        if chain.set_parameter_by_handle(ParameterHandle::from_raw(handle), value).is_none() {
+            return LibrashaderError::UnknownShaderParameterHandle(handle).export()
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    fn libra_gl_filter_chain_get_param_by_handle(
+        chain: *mut libra_gl_filter_chain_t,
+        handle: libra_param_handle_t,
+        out: *mut MaybeUninit<f32>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let Some(value) = chain.get_parameter_by_handle(ParameterHandle::from_raw(handle)) else {
+            return LibrashaderError::UnknownShaderParameterHandle(handle).export()
+        };
+
+        unsafe {
+            out.write(MaybeUninit::new(value));
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets multiple parameters for the filter chain.
+    ///
+    /// `names` and `values` must both have `count` elements. If any parameter does not exist,
+    /// returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_gl_filter_chain_set_params(
+        chain: *mut libra_gl_filter_chain_t,
+        names: *const *const c_char,
+        values: *const f32,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::set_params(chain, names, values, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets multiple parameters for the filter chain.
+    ///
+    /// The value of the parameter named by each element of `names` is written to the same
+    /// index of `out`. If any parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_gl_filter_chain_get_params(
+        chain: *mut libra_gl_filter_chain_t,
+        names: *const *const c_char,
+        out: *mut MaybeUninit<f32>,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::get_params(chain, names, out, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets multiple parameters for the filter chain by their handles.
+    ///
+    /// `handles` and `values` must both have `count` elements. If any handle is not valid
+    /// for this filter chain, returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_gl_filter_chain_set_params_by_handle(
+        chain: *mut libra_gl_filter_chain_t,
+        handles: *const libra_param_handle_t,
+        values: *const f32,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::set_params_by_handle(chain, handles, values, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets multiple parameters for the filter chain by their handles.
+    ///
+    /// The value of the parameter for each element of `handles` is written to the same
+    /// index of `out`. If any handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_gl_filter_chain_get_params_by_handle(
+        chain: *mut libra_gl_filter_chain_t,
+        handles: *const libra_param_handle_t,
+        out: *mut MaybeUninit<f32>,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::get_params_by_handle(chain, handles, out, count)?;
+        }
+    }
+}
+
 extern_fn! {
     /// Sets the number of active passes for this chain.
     ///
@@ -292,6 +548,103 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Gets the number of previous input images that are bound as history.
+    ///
+    /// If `zero_copy_history` is enabled, each input texture must stay alive and unmodified
+    /// for this many frames after it is drawn.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    fn libra_gl_filter_chain_get_history_len(
+        chain: *mut libra_gl_filter_chain_t,
+        out: *mut MaybeUninit<u32>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let value = chain.history_len();
+        unsafe {
+            out.write(MaybeUninit::new(value as u32))
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets the GPU time spent drawing each pass of an earlier frame.
+    ///
+    /// If `out` is null, the number of timings is written to `count`. Otherwise, `count` must
+    /// point to the length of `out`, and is updated with the number of timings written.
+    /// Timings are only available if `time_passes` was enabled when the filter chain was created.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    /// - `out` must be either null, or valid for writes of `count` `libra_pass_timing_t`.
+    /// - `count` must be a valid and aligned pointer to a `size_t`.
+    fn libra_gl_filter_chain_get_pass_timings(
+        chain: *mut libra_gl_filter_chain_t,
+        out: *mut MaybeUninit<libra_pass_timing_t>,
+        count: *mut usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            timing::get_pass_timings(chain.pass_timings(), out, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets the GPU time budget of a frame, in nanoseconds. A budget of 0 disables it.
+    ///
+    /// With a budget, passes with viewport scaling are drawn at a lower resolution while frames
+    /// take longer than the budget, and at full resolution again once they are well within it.
+    /// The final pass is always drawn to the full viewport. The budget only has an effect if
+    /// `time_passes` is enabled.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    fn libra_gl_filter_chain_set_frame_time_budget(
+        chain: *mut libra_gl_filter_chain_t,
+        nanoseconds: u64
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let budget = (nanoseconds != 0).then(|| Duration::from_nanos(nanoseconds));
+        chain.set_frame_time_budget(budget);
+    }
+}
+
+extern_fn! {
+    /// Gets the scale of the viewport that passes with viewport scaling are sized against.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    fn libra_gl_filter_chain_get_viewport_scale(
+        chain: *mut libra_gl_filter_chain_t,
+        out: *mut MaybeUninit<f32>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let value = chain.viewport_scale();
+        unsafe {
+            out.write(MaybeUninit::new(value))
+        }
+    }
+}
+
+extern_fn! {
+    /// Overrides the scale of the viewport that passes with viewport scaling are sized against.
+    ///
+    /// The scale is clamped between 0.25 and 1. A scale of 0 removes the override, so that the
+    /// scale is chosen from the frame time budget again.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_gl_filter_chain_t`.
+    fn libra_gl_filter_chain_set_viewport_scale(
+        chain: *mut libra_gl_filter_chain_t,
+        scale: f32
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        chain.set_viewport_scale((scale > 0.0).then_some(scale));
+    }
+}
+
 extern_fn! {
     /// Free a GL filter chain.
     ///
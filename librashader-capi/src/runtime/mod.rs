@@ -14,3 +14,14 @@ pub mod d3d11;
 #[doc(cfg(all(target_os = "windows", feature = "runtime-d3d12")))]
 #[cfg(all(target_os = "windows", feature = "runtime-d3d12"))]
 pub mod d3d12;
+
+#[cfg(any(
+    feature = "runtime-opengl",
+    feature = "runtime-vulkan",
+    all(target_os = "windows", feature = "runtime-d3d11"),
+    all(target_os = "windows", feature = "runtime-d3d12")
+))]
+mod parameters;
+
+#[cfg(any(feature = "runtime-opengl", feature = "runtime-vulkan"))]
+mod timing;
@@ -0,0 +1,161 @@
+//! Batched shader parameter access shared by the runtime C APIs.
+use crate::ctypes::libra_param_handle_t;
+use crate::error::LibrashaderError;
+use librashader::runtime::{FilterChainParameters, ParameterHandle};
+use std::ffi::{c_char, CStr};
+use std::mem::MaybeUninit;
+use std::slice;
+
+/// Get a slice from a pointer and a length, allowing the pointer to be null if the length is 0.
+unsafe fn array<'a, T>(
+    ptr: *const T,
+    count: usize,
+    name: &'static str,
+) -> Result<&'a [T], LibrashaderError> {
+    if count == 0 {
+        return Ok(&[]);
+    }
+
+    if ptr.is_null() || !ptr.is_aligned() {
+        return Err(LibrashaderError::InvalidParameter(name));
+    }
+
+    Ok(unsafe { slice::from_raw_parts(ptr, count) })
+}
+
+/// Get a mutable slice from a pointer and a length, allowing the pointer to be null if the length is 0.
+unsafe fn array_mut<'a, T>(
+    ptr: *mut T,
+    count: usize,
+    name: &'static str,
+) -> Result<&'a mut [T], LibrashaderError> {
+    if count == 0 {
+        return Ok(&mut []);
+    }
+
+    if ptr.is_null() || !ptr.is_aligned() {
+        return Err(LibrashaderError::InvalidParameter(name));
+    }
+
+    Ok(unsafe { slice::from_raw_parts_mut(ptr, count) })
+}
+
+/// Get a parameter name from a null terminated string.
+unsafe fn param_name<'a>(name: *const c_char) -> Result<&'a str, LibrashaderError> {
+    if name.is_null() {
+        return Err(LibrashaderError::InvalidParameter("names"));
+    }
+
+    Ok(unsafe { CStr::from_ptr(name) }.to_str()?)
+}
+
+/// Look up the handle of a parameter by its name.
+unsafe fn handle_of(
+    chain: &impl FilterChainParameters,
+    name: *const c_char,
+) -> Result<ParameterHandle, LibrashaderError> {
+    chain
+        .get_parameter_handle(unsafe { param_name(name)? })
+        .ok_or(LibrashaderError::UnknownShaderParameter(name))
+}
+
+/// Check that a raw handle refers to a parameter of the filter chain.
+fn checked_handle(
+    chain: &impl FilterChainParameters,
+    handle: libra_param_handle_t,
+) -> Result<ParameterHandle, LibrashaderError> {
+    let checked = ParameterHandle::from_raw(handle);
+    match chain.get_parameter_by_handle(checked) {
+        Some(_) => Ok(checked),
+        None => Err(LibrashaderError::UnknownShaderParameterHandle(handle)),
+    }
+}
+
+/// Set the named parameters to the given values.
+///
+/// Every name is resolved before any parameter is set, so no parameters are changed
+/// if any name is invalid.
+pub(crate) unsafe fn set_params(
+    chain: &mut impl FilterChainParameters,
+    names: *const *const c_char,
+    values: *const f32,
+    count: usize,
+) -> Result<(), LibrashaderError> {
+    let names = unsafe { array(names, count, "names")? };
+    let values = unsafe { array(values, count, "values")? };
+
+    let handles = names
+        .iter()
+        .map(|&name| unsafe { handle_of(chain, name) })
+        .collect::<Result<Vec<_>, _>>()?;
+
+    for (handle, &value) in handles.into_iter().zip(values) {
+        chain.set_parameter_by_handle(handle, value);
+    }
+
+    Ok(())
+}
+
+/// Get the values of the named parameters.
+pub(crate) unsafe fn get_params(
+    chain: &impl FilterChainParameters,
+    names: *const *const c_char,
+    out: *mut MaybeUninit<f32>,
+    count: usize,
+) -> Result<(), LibrashaderError> {
+    let names = unsafe { array(names, count, "names")? };
+    let out = unsafe { array_mut(out, count, "out")? };
+
+    for (&name, out) in names.iter().zip(out) {
+        let Some(value) = chain.get_parameter(unsafe { param_name(name)? }) else {
+            return Err(LibrashaderError::UnknownShaderParameter(name));
+        };
+        out.write(value);
+    }
+
+    Ok(())
+}
+
+/// Set the parameters with the given handles to the given values.
+///
+/// Every handle is checked before any parameter is set, so no parameters are changed
+/// if any handle is invalid.
+pub(crate) unsafe fn set_params_by_handle(
+    chain: &mut impl FilterChainParameters,
+    handles: *const libra_param_handle_t,
+    values: *const f32,
+    count: usize,
+) -> Result<(), LibrashaderError> {
+    let handles = unsafe { array(handles, count, "handles")? };
+    let values = unsafe { array(values, count, "values")? };
+
+    for &handle in handles {
+        checked_handle(chain, handle)?;
+    }
+
+    for (&handle, &value) in handles.iter().zip(values) {
+        chain.set_parameter_by_handle(ParameterHandle::from_raw(handle), value);
+    }
+
+    Ok(())
+}
+
+/// Get the values of the parameters with the given handles.
+pub(crate) unsafe fn get_params_by_handle(
+    chain: &impl FilterChainParameters,
+    handles: *const libra_param_handle_t,
+    out: *mut MaybeUninit<f32>,
+    count: usize,
+) -> Result<(), LibrashaderError> {
+    let handles = unsafe { array(handles, count, "handles")? };
+    let out = unsafe { array_mut(out, count, "out")? };
+
+    for (&handle, out) in handles.iter().zip(out) {
+        let Some(value) = chain.get_parameter_by_handle(ParameterHandle::from_raw(handle)) else {
+            return Err(LibrashaderError::UnknownShaderParameterHandle(handle));
+        };
+        out.write(value);
+    }
+
+    Ok(())
+}
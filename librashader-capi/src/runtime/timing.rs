@@ -0,0 +1,48 @@
+//! Per-pass GPU timings shared by the runtime C APIs.
+use crate::ctypes::libra_pass_timing_t;
+use crate::error::LibrashaderError;
+use librashader::runtime::PassTiming;
+use std::mem::MaybeUninit;
+use std::slice;
+
+/// Write pass timings into a buffer provided by the caller.
+///
+/// If `out` is null, the number of timings is written to `count`. Otherwise, `count` holds the
+/// length of `out`, and is updated with the number of timings that were written.
+pub(crate) unsafe fn get_pass_timings(
+    timings: &[PassTiming],
+    out: *mut MaybeUninit<libra_pass_timing_t>,
+    count: *mut usize,
+) -> Result<(), LibrashaderError> {
+    if count.is_null() || !count.is_aligned() {
+        return Err(LibrashaderError::InvalidParameter("count"));
+    }
+
+    if out.is_null() {
+        unsafe { count.write(timings.len()) };
+        return Ok(());
+    }
+
+    if !out.is_aligned() {
+        return Err(LibrashaderError::InvalidParameter("out"));
+    }
+
+    let len = std::cmp::min(unsafe { count.read() }, timings.len());
+    let out = unsafe { slice::from_raw_parts_mut(out, len) };
+    for (timing, out) in timings.iter().zip(out) {
+        let (alias, alias_len) = match &timing.alias {
+            Some(alias) => (alias.as_ptr().cast(), alias.len()),
+            None => (std::ptr::null(), 0),
+        };
+
+        out.write(libra_pass_timing_t {
+            index: timing.index,
+            alias,
+            alias_len,
+            nanoseconds: timing.gpu_time.as_nanos() as u64,
+        });
+    }
+
+    unsafe { count.write(len) };
+    Ok(())
+}
@@ -1,18 +1,23 @@
 use crate::ctypes::{
-    config_struct, libra_shader_preset_t, libra_viewport_t, libra_vk_filter_chain_t, FromUninit,
+    config_struct, libra_load_progress_t, libra_param_handle_t, libra_pass_timing_t,
+    libra_shader_preset_t, libra_viewport_t, libra_vk_context_t, libra_vk_filter_chain_pending_t,
+    libra_vk_filter_chain_t, FromUninit,
 };
 use crate::error::{assert_non_null, assert_some_ptr, LibrashaderError};
 use crate::ffi::extern_fn;
-use librashader::runtime::vk::{VulkanImage, VulkanInstance};
+use crate::runtime::{parameters, timing};
+use librashader::runtime::vk::{VulkanContext, VulkanImage, VulkanInstance};
 use std::ffi::CStr;
 use std::ffi::{c_char, c_void};
 use std::mem::MaybeUninit;
 use std::ptr::NonNull;
 use std::slice;
+use std::sync::Arc;
+use std::time::Duration;
 
 use librashader::runtime::vk::capi::options::FilterChainOptionsVulkan;
 use librashader::runtime::vk::capi::options::FrameOptionsVulkan;
-use librashader::runtime::FilterChainParameters;
+use librashader::runtime::{FilterChainParameters, ParameterHandle};
 use librashader::runtime::{Size, Viewport};
 
 use ash::vk;
@@ -93,11 +98,16 @@ pub struct frame_vk_opt_t {
     /// The direction of rendering.
     /// -1 indicates that the frames are played in reverse order.
     pub frame_direction: i32,
+    /// Whether the input image is the same as in the last frame.
+    /// Passes that do not read the frame count, history or feedback keep their
+    /// output from the last frame instead of being drawn again.
+    pub input_unchanged: bool,
 }
 
 config_struct! {
     impl FrameOptionsVulkan => frame_vk_opt_t {
         0 => [clear_history, frame_direction];
+        1 => [input_unchanged];
     }
 }
 
@@ -117,11 +127,32 @@ pub struct filter_chain_vk_opt_t {
     /// Disable the shader object cache. Shaders will be
     /// recompiled rather than loaded from the cache.
     pub disable_cache: bool,
+    /// Defer compiling passes and creating their pipelines until they are enabled and first drawn.
+    ///
+    /// Every pass is enabled when the filter chain is created, so the number of enabled passes
+    /// must be lowered with `libra_vk_filter_chain_set_active_pass_count` before the first frame,
+    /// or every pass is compiled when the first frame is drawn.
+    pub defer_passes: bool,
+    /// Compile deferred passes in the background ahead of when they are needed.
+    /// Only applies if `defer_passes` is enabled.
+    pub prefetch_passes: bool,
+    /// Bind the input images of previous frames as history instead of copying them.
+    /// The caller must keep each input image alive and unmodified for the number of frames
+    /// given by `libra_vk_filter_chain_get_history_len` after it is drawn.
+    pub zero_copy_history: bool,
+    /// Round the memory of intermediate framebuffers up to size buckets, so that they can be
+    /// resized within a bucket without reallocating. Memory is only shrunk after the
+    /// framebuffer has been smaller for a number of frames.
+    pub resize_hysteresis: bool,
+    /// Measure the GPU time spent drawing each pass with timestamp queries.
+    /// The results are available from `libra_vk_filter_chain_get_pass_timings`.
+    pub time_passes: bool,
 }
 
 config_struct! {
     impl FilterChainOptionsVulkan => filter_chain_vk_opt_t {
         0 => [frames_in_flight, force_no_mipmaps, use_render_pass, disable_cache];
+        1 => [defer_passes, prefetch_passes, zero_copy_history, resize_hysteresis, time_passes];
     }
 }
 
@@ -224,6 +255,348 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Create a device context that filter chains created with
+    /// `libra_vk_filter_chain_create_with_context` share samplers, vertex buffers,
+    /// compiled pipelines and LUT textures through.
+    ///
+    /// ## Safety:
+    /// - The handles provided in `vulkan` must be valid for as long as the context or any filter
+    ///   chain created from it is alive.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    fn libra_vk_context_create(
+        vulkan: libra_device_vk_t,
+        out: *mut MaybeUninit<libra_vk_context_t>
+    ) {
+        assert_non_null!(out);
+        let vulkan: VulkanInstance = vulkan.into();
+        let context = VulkanContext::new(vulkan)?;
+
+        unsafe {
+            out.write(MaybeUninit::new(NonNull::new(Arc::into_raw(context).cast_mut())))
+        }
+    }
+}
+
+extern_fn! {
+    /// Create the filter chain given the shader preset, sharing device objects with the other
+    /// filter chains created from the context.
+    ///
+    /// The shader preset is immediately invalidated and must be recreated after
+    /// the filter chain is created. The filter chain keeps the objects it uses from the context
+    /// alive, so the context may be freed before the filter chain.
+    ///
+    /// ## Safety:
+    /// - `context` must be either null, or a valid and aligned pointer to a `libra_vk_context_t`
+    ///   created with `libra_vk_context_create`.
+    /// - `preset` must be either null, or valid and aligned.
+    /// - `options` must be either null, or valid and aligned.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    fn libra_vk_filter_chain_create_with_context(
+        preset: *mut libra_shader_preset_t,
+        context: *const libra_vk_context_t,
+        options: *const MaybeUninit<filter_chain_vk_opt_t>,
+        out: *mut MaybeUninit<libra_vk_filter_chain_t>
+    ) |context| {
+        assert_some_ptr!(context);
+        assert_non_null!(preset);
+
+        let preset = unsafe {
+            let preset_ptr = &mut *preset;
+            let preset = preset_ptr.take();
+            Box::from_raw(preset.unwrap().as_ptr())
+        };
+
+        let options = if options.is_null() {
+            None
+        } else {
+            Some(unsafe { options.read() })
+        };
+
+        let options = options.map(FromUninit::from_uninit);
+
+        unsafe {
+            let context = shared_context(context);
+            let chain = librashader::runtime::vk::capi::FilterChainVulkan::load_from_preset_shared(*preset, &context, options.as_ref())?;
+
+            out.write(MaybeUninit::new(NonNull::new(Box::into_raw(Box::new(
+                chain,
+            )))))
+        }
+    }
+}
+
+extern_fn! {
+    /// Create the filter chain given the shader preset, sharing device objects with the other
+    /// filter chains created from the context, and deferring GPU-side initialization to the caller.
+    ///
+    /// The shader preset is immediately invalidated and must be recreated after
+    /// the filter chain is created.
+    ///
+    /// ## Safety:
+    /// - `context` must be either null, or a valid and aligned pointer to a `libra_vk_context_t`
+    ///   created with `libra_vk_context_create`.
+    /// - `preset` must be either null, or valid and aligned.
+    /// - `options` must be either null, or valid and aligned.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    ///
+    /// The provided command buffer must be ready for recording and contain no prior commands.
+    /// The caller is responsible for ending the command buffer and immediately submitting it to a
+    /// graphics queue. The command buffer must be completely executed before calling `libra_vk_filter_chain_frame`
+    /// on this or any other filter chain created from the context, since LUT textures may be shared.
+    fn libra_vk_filter_chain_create_deferred_with_context(
+        preset: *mut libra_shader_preset_t,
+        context: *const libra_vk_context_t,
+        command_buffer: vk::CommandBuffer,
+        options: *const MaybeUninit<filter_chain_vk_opt_t>,
+        out: *mut MaybeUninit<libra_vk_filter_chain_t>
+    ) |context| {
+        assert_some_ptr!(context);
+        assert_non_null!(preset);
+
+        let preset = unsafe {
+            let preset_ptr = &mut *preset;
+            let preset = preset_ptr.take();
+            Box::from_raw(preset.unwrap().as_ptr())
+        };
+
+        let options = if options.is_null() {
+            None
+        } else {
+            Some(unsafe { options.read() })
+        };
+
+        let options = options.map(FromUninit::from_uninit);
+
+        unsafe {
+            let context = shared_context(context);
+            let chain = librashader::runtime::vk::capi::FilterChainVulkan::load_from_preset_deferred_shared(*preset,
+                &context,
+                command_buffer,
+                options.as_ref())?;
+
+            out.write(MaybeUninit::new(NonNull::new(Box::into_raw(Box::new(
+                chain,
+            )))))
+        }
+    }
+}
+
+extern_fn! {
+    /// Start loading the filter chain given the shader preset in the background.
+    ///
+    /// The passes are compiled and their pipelines created on other threads. Poll the pending
+    /// filter chain with `libra_vk_filter_chain_pending_poll`, and finish it into a filter chain
+    /// with `libra_vk_filter_chain_pending_finish`.
+    ///
+    /// The shader preset is immediately invalidated and must be recreated after
+    /// the pending filter chain is created.
+    ///
+    /// ## Safety:
+    /// - `context` must be either null, or a valid and aligned pointer to a `libra_vk_context_t`
+    ///   created with `libra_vk_context_create`.
+    /// - `preset` must be either null, or valid and aligned.
+    /// - `options` must be either null, or valid and aligned.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    fn libra_vk_filter_chain_create_async(
+        preset: *mut libra_shader_preset_t,
+        context: *const libra_vk_context_t,
+        options: *const MaybeUninit<filter_chain_vk_opt_t>,
+        out: *mut MaybeUninit<libra_vk_filter_chain_pending_t>
+    ) |context| {
+        assert_some_ptr!(context);
+        assert_non_null!(preset);
+
+        let preset = unsafe {
+            let preset_ptr = &mut *preset;
+            let preset = preset_ptr.take();
+            Box::from_raw(preset.unwrap().as_ptr())
+        };
+
+        let options = if options.is_null() {
+            None
+        } else {
+            Some(unsafe { options.read() })
+        };
+
+        let options = options.map(FromUninit::from_uninit);
+
+        unsafe {
+            let context = shared_context(context);
+            let pending = librashader::runtime::vk::capi::FilterChainVulkan::load_from_preset_async(*preset, &context, options.as_ref());
+
+            out.write(MaybeUninit::new(NonNull::new(Box::into_raw(Box::new(
+                pending,
+            )))))
+        }
+    }
+}
+
+extern_fn! {
+    /// Check whether a pending filter chain has finished loading, and get its progress.
+    ///
+    /// ## Safety
+    /// - `pending` must be either null or a valid and aligned pointer to an initialized
+    ///   `libra_vk_filter_chain_pending_t`.
+    /// - `ready` must be a valid and aligned pointer to a `bool`.
+    /// - `progress` must be either null, or an aligned pointer to a `libra_load_progress_t`.
+    fn libra_vk_filter_chain_pending_poll(
+        pending: *mut libra_vk_filter_chain_pending_t,
+        ready: *mut bool,
+        progress: *mut MaybeUninit<libra_load_progress_t>
+    ) |pending| {
+        assert_some_ptr!(pending);
+        assert_non_null!(ready);
+
+        unsafe {
+            ready.write(pending.is_ready());
+        }
+
+        if !progress.is_null() {
+            let current = pending.progress();
+            unsafe {
+                progress.write(MaybeUninit::new(libra_load_progress_t {
+                    passes_loaded: current.passes_loaded,
+                    pass_count: current.pass_count,
+                }))
+            }
+        }
+    }
+}
+
+extern_fn! {
+    /// Cancel loading a pending filter chain.
+    ///
+    /// Finishing a cancelled filter chain returns an error, unless loading had already finished.
+    /// The pending filter chain must still be freed with `libra_vk_filter_chain_pending_free`.
+    ///
+    /// ## Safety
+    /// - `pending` must be either null or a valid and aligned pointer to an initialized
+    ///   `libra_vk_filter_chain_pending_t`.
+    fn libra_vk_filter_chain_pending_cancel(
+        pending: *mut libra_vk_filter_chain_pending_t
+    ) |pending| {
+        assert_some_ptr!(pending);
+        pending.cancel();
+    }
+}
+
+extern_fn! {
+    /// Finish loading a pending filter chain, waiting for the background work if it is not
+    /// ready yet. Only the lookup textures are uploaded with the command buffer.
+    ///
+    /// The pending filter chain is consumed, and the resulting value in `pending` becomes null
+    /// whether or not the filter chain could be loaded.
+    ///
+    /// ## Safety
+    /// - `pending` must be either null or a valid and aligned pointer to an initialized
+    ///   `libra_vk_filter_chain_pending_t`.
+    /// - `out` must be aligned, but may be null, invalid, or uninitialized.
+    ///
+    /// The provided command buffer must be ready for recording.
+    /// The caller is responsible for submitting the command buffer to a graphics queue.
+    /// The command buffer must be completely executed before calling `libra_vk_filter_chain_frame`
+    /// on this or any other filter chain created from the same context.
+    fn libra_vk_filter_chain_pending_finish(
+        pending: *mut libra_vk_filter_chain_pending_t,
+        command_buffer: vk::CommandBuffer,
+        out: *mut MaybeUninit<libra_vk_filter_chain_t>
+    ) {
+        assert_non_null!(pending);
+        let pending = unsafe {
+            let pending_ptr = &mut *pending;
+            let Some(pending) = pending_ptr.take() else {
+                return LibrashaderError::InvalidParameter("pending").export();
+            };
+            Box::from_raw(pending.as_ptr())
+        };
+
+        unsafe {
+            let chain = pending.finish(command_buffer)?;
+
+            out.write(MaybeUninit::new(NonNull::new(Box::into_raw(Box::new(
+                chain,
+            )))))
+        }
+    }
+}
+
+extern_fn! {
+    /// Replace the passes of a filter chain with those of a pending filter chain, waiting for the
+    /// background work if it is not ready yet. Only the lookup textures of the new passes are
+    /// uploaded with the command buffer.
+    ///
+    /// The new passes are drawn from the next frame on. History is kept, and a new pass keeps the
+    /// feedback of the pass it replaces if both use the same shader. Resources of the old passes
+    /// are released once the last frame that was drawn is no longer in flight.
+    ///
+    /// The pending filter chain must have been created for the same device, with the same
+    /// `frames_in_flight` as the filter chain. It is consumed, and the resulting value in
+    /// `pending` becomes null whether or not the swap succeeded.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    /// - `pending` must be either null or a valid and aligned pointer to an initialized
+    ///   `libra_vk_filter_chain_pending_t`.
+    ///
+    /// The provided command buffer must be ready for recording.
+    /// The caller is responsible for submitting the command buffer to a graphics queue
+    /// before the next call to `libra_vk_filter_chain_frame` on this filter chain is executed.
+    fn libra_vk_filter_chain_swap(
+        chain: *mut libra_vk_filter_chain_t,
+        pending: *mut libra_vk_filter_chain_pending_t,
+        command_buffer: vk::CommandBuffer
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        assert_non_null!(pending);
+        let pending = unsafe {
+            let pending_ptr = &mut *pending;
+            let Some(pending) = pending_ptr.take() else {
+                return LibrashaderError::InvalidParameter("pending").export();
+            };
+            Box::from_raw(pending.as_ptr())
+        };
+
+        unsafe {
+            chain.swap(*pending, command_buffer)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Free a pending Vulkan filter chain, cancelling it if it is still loading.
+    ///
+    /// If it is still loading, this blocks until the passes being compiled in the background
+    /// have finished, so that the device is no longer in use once this returns.
+    ///
+    /// The resulting value in `pending` then becomes null.
+    /// ## Safety
+    /// - `pending` must be either null or a valid and aligned pointer to an initialized
+    ///   `libra_vk_filter_chain_pending_t`.
+    fn libra_vk_filter_chain_pending_free(
+        pending: *mut libra_vk_filter_chain_pending_t
+    ) {
+        assert_non_null!(pending);
+        unsafe {
+            let pending_ptr = &mut *pending;
+            let pending = pending_ptr.take();
+            drop(Box::from_raw(pending.unwrap().as_ptr()))
+        };
+    }
+}
+
+/// Take a new reference to a context that was created by `libra_vk_context_create`.
+///
+/// ## Safety
+/// `context` must have been returned by `Arc::into_raw` and not yet freed.
+unsafe fn shared_context(context: &VulkanContext) -> Arc<VulkanContext> {
+    let context: *const VulkanContext = context;
+    unsafe {
+        Arc::increment_strong_count(context);
+        Arc::from_raw(context)
+    }
+}
+
 extern_fn! {
     /// Records rendering commands for a frame with the given parameters for the given filter chain
     /// to the input command buffer.
@@ -287,6 +660,77 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Records rendering commands for a batch of frames to the input command buffer, as if
+    /// `libra_vk_filter_chain_frame` was called for each of them in order.
+    ///
+    /// Frame `i` draws `images[i]` to `outputs[i]` with `viewports[i]` and a frame count of
+    /// `frame_count + i`, so history and feedback advance between frames. The MVP and options
+    /// apply to every frame, except that history is only cleared before the first frame.
+    ///
+    /// Every frame of a batch uses one of the frames in flight of the filter chain, so `count`
+    /// can not be larger than `frames_in_flight`. The command buffer must be completely executed
+    /// before those frames in flight are used again.
+    ///
+    /// ## Safety
+    /// - The requirements of `libra_vk_filter_chain_frame` apply to every frame.
+    /// - `images`, `viewports` and `outputs` must be valid and aligned pointers to `count`
+    ///   consecutive values each.
+    nopanic fn libra_vk_filter_chain_frame_batch(
+        chain: *mut libra_vk_filter_chain_t,
+        command_buffer: vk::CommandBuffer,
+        frame_count: usize,
+        count: usize,
+        images: *const libra_source_image_vk_t,
+        viewports: *const libra_viewport_t,
+        outputs: *const libra_output_image_vk_t,
+        mvp: *const f32,
+        opt: *const MaybeUninit<frame_vk_opt_t>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        assert_non_null!(images);
+        assert_non_null!(viewports);
+        assert_non_null!(outputs);
+
+        let mvp = if mvp.is_null() {
+            None
+        } else {
+            Some(<&[f32; 16]>::try_from(unsafe { slice::from_raw_parts(mvp, 16) }).unwrap())
+        };
+        let opt = if opt.is_null() {
+            None
+        } else {
+            Some(unsafe { opt.read() })
+        };
+        let opt = opt.map(FromUninit::from_uninit);
+
+        let mut inputs = Vec::with_capacity(count);
+        let mut targets = Vec::with_capacity(count);
+        for index in 0..count {
+            let (image, viewport, out) = unsafe {
+                (images.add(index).read(), viewports.add(index).read(), outputs.add(index).read())
+            };
+
+            inputs.push(VulkanImage::from(image));
+            targets.push(Viewport {
+                x: viewport.x,
+                y: viewport.y,
+                output: VulkanImage {
+                    image: out.handle,
+                    size: Size::new(viewport.width, viewport.height),
+                    format: out.format
+                },
+                mvp,
+            });
+        }
+        let frames: Vec<_> = inputs.iter().zip(targets.iter()).collect();
+
+        unsafe {
+            chain.frame_batch(&frames, command_buffer, frame_count, opt.as_ref())?;
+        }
+    }
+}
+
 extern_fn! {
     /// Sets a parameter for the filter chain.
     ///
@@ -339,6 +783,167 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Gets a handle to a parameter of the filter chain.
+    ///
+    /// The handle can be used with `libra_vk_filter_chain_set_param_by_handle` and
+    /// `libra_vk_filter_chain_get_param_by_handle` to access the parameter without
+    /// looking up its name. A handle is only valid for the filter chain it was retrieved from.
+    ///
+    /// If the parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    /// - `param_name` must be either null or a null terminated string.
+    fn libra_vk_filter_chain_get_param_handle(
+        chain: *mut libra_vk_filter_chain_t,
+        param_name: *const c_char,
+        out: *mut MaybeUninit<libra_param_handle_t>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        assert_non_null!(param_name);
+        unsafe {
+            let name = CStr::from_ptr(param_name);
+            let name = name.to_str()?;
+
+            let Some(handle) = chain.get_parameter_handle(name) else {
+                return LibrashaderError::UnknownShaderParameter(param_name).export()
+            };
+
+            out.write(MaybeUninit::new(handle.as_raw()));
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    fn libra_vk_filter_chain_set_param_by_handle(
+        chain: *mut libra_vk_filter_chain_t,
+        handle: libra_param_handle_t,
+        value: f32
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        if chain.set_parameter_by_handle(ParameterHandle::from_raw(handle), value).is_none() {
+            return LibrashaderError::UnknownShaderParameterHandle(handle).export()
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets a parameter for the filter chain by its handle.
+    ///
+    /// If the handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    fn libra_vk_filter_chain_get_param_by_handle(
+        chain: *mut libra_vk_filter_chain_t,
+        handle: libra_param_handle_t,
+        out: *mut MaybeUninit<f32>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let Some(value) = chain.get_parameter_by_handle(ParameterHandle::from_raw(handle)) else {
+            return LibrashaderError::UnknownShaderParameterHandle(handle).export()
+        };
+
+        unsafe {
+            out.write(MaybeUninit::new(value));
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets multiple parameters for the filter chain.
+    ///
+    /// `names` and `values` must both have `count` elements. If any parameter does not exist,
+    /// returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_vk_filter_chain_set_params(
+        chain: *mut libra_vk_filter_chain_t,
+        names: *const *const c_char,
+        values: *const f32,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::set_params(chain, names, values, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets multiple parameters for the filter chain.
+    ///
+    /// The value of the parameter named by each element of `names` is written to the same
+    /// index of `out`. If any parameter does not exist, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    /// - `names` must be either null or a valid and aligned pointer to an array of `count`
+    ///   null terminated strings.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_vk_filter_chain_get_params(
+        chain: *mut libra_vk_filter_chain_t,
+        names: *const *const c_char,
+        out: *mut MaybeUninit<f32>,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::get_params(chain, names, out, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets multiple parameters for the filter chain by their handles.
+    ///
+    /// `handles` and `values` must both have `count` elements. If any handle is not valid
+    /// for this filter chain, returns an error and no parameters are changed.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `values` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_vk_filter_chain_set_params_by_handle(
+        chain: *mut libra_vk_filter_chain_t,
+        handles: *const libra_param_handle_t,
+        values: *const f32,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::set_params_by_handle(chain, handles, values, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets multiple parameters for the filter chain by their handles.
+    ///
+    /// The value of the parameter for each element of `handles` is written to the same
+    /// index of `out`. If any handle is not valid for this filter chain, returns an error.
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    /// - `handles` must be either null or a valid and aligned pointer to an array of `count` handles.
+    /// - `out` must be either null or a valid and aligned pointer to an array of `count` floats.
+    fn libra_vk_filter_chain_get_params_by_handle(
+        chain: *mut libra_vk_filter_chain_t,
+        handles: *const libra_param_handle_t,
+        out: *mut MaybeUninit<f32>,
+        count: usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            parameters::get_params_by_handle(chain, handles, out, count)?;
+        }
+    }
+}
+
 extern_fn! {
     /// Sets the number of active passes for this chain.
     ///
@@ -370,6 +975,103 @@ extern_fn! {
     }
 }
 
+extern_fn! {
+    /// Gets the number of previous input images that are bound as history.
+    ///
+    /// If `zero_copy_history` is enabled, each input image must stay alive and unmodified
+    /// for this many frames after it is drawn.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    fn libra_vk_filter_chain_get_history_len(
+        chain: *mut libra_vk_filter_chain_t,
+        out: *mut MaybeUninit<u32>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let value = chain.history_len();
+        unsafe {
+            out.write(MaybeUninit::new(value as u32))
+        }
+    }
+}
+
+extern_fn! {
+    /// Gets the GPU time spent drawing each pass of an earlier frame.
+    ///
+    /// If `out` is null, the number of timings is written to `count`. Otherwise, `count` must
+    /// point to the length of `out`, and is updated with the number of timings written.
+    /// Timings are only available if `time_passes` was enabled when the filter chain was created.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    /// - `out` must be either null, or valid for writes of `count` `libra_pass_timing_t`.
+    /// - `count` must be a valid and aligned pointer to a `size_t`.
+    fn libra_vk_filter_chain_get_pass_timings(
+        chain: *mut libra_vk_filter_chain_t,
+        out: *mut MaybeUninit<libra_pass_timing_t>,
+        count: *mut usize
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        unsafe {
+            timing::get_pass_timings(chain.pass_timings(), out, count)?;
+        }
+    }
+}
+
+extern_fn! {
+    /// Sets the GPU time budget of a frame, in nanoseconds. A budget of 0 disables it.
+    ///
+    /// With a budget, passes with viewport scaling are drawn at a lower resolution while frames
+    /// take longer than the budget, and at full resolution again once they are well within it.
+    /// The final pass is always drawn to the full viewport. The budget only has an effect if
+    /// `time_passes` is enabled and supported by the device.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    fn libra_vk_filter_chain_set_frame_time_budget(
+        chain: *mut libra_vk_filter_chain_t,
+        nanoseconds: u64
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let budget = (nanoseconds != 0).then(|| Duration::from_nanos(nanoseconds));
+        chain.set_frame_time_budget(budget);
+    }
+}
+
+extern_fn! {
+    /// Gets the scale of the viewport that passes with viewport scaling are sized against.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    fn libra_vk_filter_chain_get_viewport_scale(
+        chain: *mut libra_vk_filter_chain_t,
+        out: *mut MaybeUninit<f32>
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        let value = chain.viewport_scale();
+        unsafe {
+            out.write(MaybeUninit::new(value))
+        }
+    }
+}
+
+extern_fn! {
+    /// Overrides the scale of the viewport that passes with viewport scaling are sized against.
+    ///
+    /// The scale is clamped between 0.25 and 1. A scale of 0 removes the override, so that the
+    /// scale is chosen from the frame time budget again.
+    ///
+    /// ## Safety
+    /// - `chain` must be either null or a valid and aligned pointer to an initialized `libra_vk_filter_chain_t`.
+    fn libra_vk_filter_chain_set_viewport_scale(
+        chain: *mut libra_vk_filter_chain_t,
+        scale: f32
+    ) mut |chain| {
+        assert_some_ptr!(mut chain);
+        chain.set_viewport_scale((scale > 0.0).then_some(scale));
+    }
+}
+
 extern_fn! {
     /// Free a Vulkan filter chain.
     ///
@@ -387,3 +1089,24 @@ extern_fn! {
         };
     }
 }
+
+extern_fn! {
+    /// Free a Vulkan device context.
+    ///
+    /// Filter chains created from the context keep the objects they use alive, and
+    /// may still be used after the context is freed.
+    ///
+    /// The resulting value in `context` then becomes null.
+    /// ## Safety
+    /// - `context` must be either null or a valid and aligned pointer to an initialized `libra_vk_context_t`.
+    fn libra_vk_context_free(
+        context: *mut libra_vk_context_t
+    ) {
+        assert_non_null!(context);
+        unsafe {
+            let context_ptr = &mut *context;
+            let context = context_ptr.take();
+            drop(Arc::from_raw(context.unwrap().as_ptr().cast_const()))
+        };
+    }
+}
@@ -0,0 +1,252 @@
+//! librashader tracing C API (`libra_trace_*`).
+//!
+//! Spans from preset loading, shader compilation and frame recording are written to a file in the
+//! Chrome trace event format, which can be opened in Perfetto or `chrome://tracing`, or imported
+//! into Tracy with `import-chrome`.
+use crate::error::{assert_non_null, LibrashaderError};
+use crate::ffi::extern_fn;
+use std::ffi::{c_char, CStr};
+use std::fmt::Write as _;
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::path::Path;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Mutex, OnceLock};
+use std::time::Instant;
+use tracing::field::{Field, Visit};
+use tracing::span::{Attributes, Id, Record};
+use tracing::Subscriber;
+use tracing_subscriber::layer::{Context, Layer, SubscriberExt};
+use tracing_subscriber::registry::LookupSpan;
+
+/// The trace that is being recorded, if any.
+static TRACE: Mutex<Option<ChromeTrace>> = Mutex::new(None);
+
+/// Whether a trace is being recorded, to skip collecting span fields when it is not.
+static RECORDING: AtomicBool = AtomicBool::new(false);
+
+/// Whether the global subscriber was installed.
+static SUBSCRIBER: OnceLock<bool> = OnceLock::new();
+
+static NEXT_THREAD_ID: AtomicU64 = AtomicU64::new(1);
+
+thread_local! {
+    static THREAD_ID: u64 = NEXT_THREAD_ID.fetch_add(1, Ordering::Relaxed);
+}
+
+/// A trace file in the Chrome trace event format.
+struct ChromeTrace {
+    writer: BufWriter<File>,
+    epoch: Instant,
+    empty: bool,
+}
+
+impl ChromeTrace {
+    fn create(path: &Path) -> std::io::Result<Self> {
+        let mut writer = BufWriter::new(File::create(path)?);
+        writer.write_all(b"[")?;
+        Ok(ChromeTrace {
+            writer,
+            epoch: Instant::now(),
+            empty: true,
+        })
+    }
+
+    fn write_span(&mut self, name: &str, target: &str, args: &str, start: Instant, end: Instant) {
+        let ts = start.saturating_duration_since(self.epoch).as_nanos() as f64 / 1000.0;
+        let dur = end.saturating_duration_since(start).as_nanos() as f64 / 1000.0;
+        let separator = if self.empty { "\n" } else { ",\n" };
+        let pid = std::process::id();
+        let tid = THREAD_ID.with(|id| *id);
+
+        // Errors are only reported when the trace is finished, since spans can not fail.
+        let _ = write!(
+            self.writer,
+            r#"{separator}{{"name":"{name}","cat":"{target}","ph":"X","ts":{ts:.3},"dur":{dur:.3},"pid":{pid},"tid":{tid},"args":{{{args}}}}}"#
+        );
+        self.empty = false;
+    }
+
+    fn finish(mut self) -> std::io::Result<()> {
+        self.writer.write_all(b"\n]\n")?;
+        self.writer.flush()
+    }
+}
+
+/// The fields of a span as the members of a JSON object, and when the span was last entered.
+#[derive(Default)]
+struct SpanData {
+    args: String,
+    entered: Option<Instant>,
+}
+
+impl SpanData {
+    fn push_field(&mut self, field: &Field, value: std::fmt::Arguments) {
+        if !self.args.is_empty() {
+            self.args.push(',');
+        }
+        let _ = write!(self.args, "\"{}\":{value}", field.name());
+    }
+}
+
+impl Visit for SpanData {
+    fn record_i64(&mut self, field: &Field, value: i64) {
+        self.push_field(field, format_args!("{value}"))
+    }
+
+    fn record_u64(&mut self, field: &Field, value: u64) {
+        self.push_field(field, format_args!("{value}"))
+    }
+
+    fn record_bool(&mut self, field: &Field, value: bool) {
+        self.push_field(field, format_args!("{value}"))
+    }
+
+    fn record_debug(&mut self, field: &Field, value: &dyn std::fmt::Debug) {
+        let mut escaped = String::new();
+        for c in format!("{value:?}").chars() {
+            match c {
+                '"' => escaped.push_str("\\\""),
+                '\\' => escaped.push_str("\\\\"),
+                c if c.is_control() => {
+                    let _ = write!(escaped, "\\u{:04x}", c as u32);
+                }
+                c => escaped.push(c),
+            }
+        }
+        self.push_field(field, format_args!("\"{escaped}\""))
+    }
+}
+
+/// Writes every span to the trace that is being recorded, as one event for each time it is entered.
+struct ChromeTraceLayer;
+
+impl<S> Layer<S> for ChromeTraceLayer
+where
+    S: Subscriber + for<'a> LookupSpan<'a>,
+{
+    fn on_new_span(&self, attrs: &Attributes<'_>, id: &Id, ctx: Context<'_, S>) {
+        if !RECORDING.load(Ordering::Relaxed) {
+            return;
+        }
+
+        let Some(span) = ctx.span(id) else {
+            return;
+        };
+
+        let mut data = SpanData::default();
+        attrs.record(&mut data);
+        span.extensions_mut().insert(data);
+    }
+
+    fn on_record(&self, id: &Id, values: &Record<'_>, ctx: Context<'_, S>) {
+        let Some(span) = ctx.span(id) else {
+            return;
+        };
+
+        if let Some(data) = span.extensions_mut().get_mut::<SpanData>() {
+            values.record(data);
+        }
+    }
+
+    fn on_enter(&self, id: &Id, ctx: Context<'_, S>) {
+        let Some(span) = ctx.span(id) else {
+            return;
+        };
+
+        if let Some(data) = span.extensions_mut().get_mut::<SpanData>() {
+            data.entered = Some(Instant::now());
+        }
+    }
+
+    fn on_exit(&self, id: &Id, ctx: Context<'_, S>) {
+        let end = Instant::now();
+        let Some(span) = ctx.span(id) else {
+            return;
+        };
+
+        let mut extensions = span.extensions_mut();
+        let Some(data) = extensions.get_mut::<SpanData>() else {
+            return;
+        };
+
+        let Some(start) = data.entered.take() else {
+            return;
+        };
+
+        let Ok(mut trace) = TRACE.lock() else {
+            return;
+        };
+
+        if let Some(trace) = trace.as_mut() {
+            let metadata = span.metadata();
+            trace.write_span(metadata.name(), metadata.target(), &data.args, start, end);
+        }
+    }
+}
+
+fn install_subscriber() -> bool {
+    *SUBSCRIBER.get_or_init(|| {
+        let subscriber = tracing_subscriber::registry().with(ChromeTraceLayer);
+        tracing::subscriber::set_global_default(subscriber).is_ok()
+    })
+}
+
+/// Finish the current trace if there is one, and start a new trace if `path` is not `None`.
+fn replace_trace(path: Option<&Path>) -> Result<(), LibrashaderError> {
+    let mut trace = TRACE
+        .lock()
+        .map_err(|_| LibrashaderError::UnknownError(Box::new("the trace lock was poisoned")))?;
+
+    RECORDING.store(false, Ordering::Relaxed);
+    if let Some(trace) = trace.take() {
+        trace
+            .finish()
+            .map_err(|e| LibrashaderError::UnknownError(Box::new(e)))?;
+    }
+
+    if let Some(path) = path {
+        *trace = Some(
+            ChromeTrace::create(path).map_err(|e| LibrashaderError::UnknownError(Box::new(e)))?,
+        );
+        RECORDING.store(true, Ordering::Relaxed);
+    }
+
+    Ok(())
+}
+
+extern_fn! {
+    /// Start recording a trace of librashader to the file at `path`, in the Chrome trace event format.
+    ///
+    /// Spans are recorded for preset parsing, preprocessing, shader compilation, reflection,
+    /// pass and LUT loading, and frame recording. If a trace is already being recorded,
+    /// it is finished before the new trace is started.
+    ///
+    /// This installs a global `tracing` subscriber the first time it is called, and fails if
+    /// another subscriber was already installed in the process.
+    ///
+    /// ## Safety
+    ///  - `path` must be either null or a valid, aligned pointer to a string path to the trace file.
+    fn libra_trace_begin(path: *const c_char) {
+        assert_non_null!(path);
+        let path = unsafe { CStr::from_ptr(path) }.to_str()?;
+
+        if !install_subscriber() {
+            return LibrashaderError::UnknownError(Box::new(
+                "a tracing subscriber is already installed",
+            ))
+            .export();
+        }
+
+        replace_trace(Some(Path::new(path)))?;
+    }
+}
+
+extern_fn! {
+    /// Finish recording the current trace and flush it to its file.
+    ///
+    /// If no trace is being recorded, this function does nothing.
+    fn libra_trace_end() {
+        replace_trace(None)?;
+    }
+}
@@ -13,7 +13,28 @@ pub type LIBRASHADER_ABI_VERSION = usize;
 /// versions must remain backwards compatible.
 /// ## API Versions
 /// - API version 0: 0.1.0
-pub const LIBRASHADER_CURRENT_VERSION: LIBRASHADER_API_VERSION = 0;
+/// - API version 1: 0.2.0
+///     - Added deferred pass compilation options to OpenGL and Vulkan filter chain options.
+///     - Added parameter handles to filter chains.
+///     - Added batched parameter access to filter chains.
+///     - Added `libra_preset_get_runtime_params_into`.
+///     - Added `input_unchanged` to frame options.
+///     - Added `zero_copy_history` to OpenGL and Vulkan filter chain options.
+///     - Added `resize_hysteresis` to Vulkan filter chain options.
+///     - Added `time_passes` to OpenGL and Vulkan filter chain options, and `libra_pass_timing_t`.
+///     - Added `libra_trace_begin` and `libra_trace_end` when built with the `tracing` feature.
+///     - Added `libra_vk_context_t`, `libra_vk_context_create`, `libra_vk_context_free`, `libra_vk_filter_chain_create_with_context`
+///       and `libra_vk_filter_chain_create_deferred_with_context`.
+///     - Added `libra_vk_filter_chain_create_async`, `libra_vk_filter_chain_pending_t` and `libra_load_progress_t`
+///       for loading Vulkan filter chains in the background.
+///     - Added `libra_vk_filter_chain_swap` to replace the passes of a Vulkan filter chain without
+///       losing its history.
+///     - Added `libra_gl_filter_chain_set_frame_time_budget`, `libra_vk_filter_chain_set_frame_time_budget`
+///       and the `get_viewport_scale` and `set_viewport_scale` functions to scale viewport-sized passes
+///       to a GPU time budget.
+///     - Added `libra_gl_filter_chain_frame_batch` and `libra_vk_filter_chain_frame_batch` to draw several
+///       frames in one call.
+pub const LIBRASHADER_CURRENT_VERSION: LIBRASHADER_API_VERSION = 1;
 
 /// The current version of the librashader ABI.
 /// Used by the loader to check ABI compatibility.
@@ -0,0 +1,160 @@
+use crate::Result;
+use librashader::runtime::Size;
+use std::fs;
+use std::io::{BufWriter, ErrorKind, Read, Write};
+use std::path::PathBuf;
+use std::sync::mpsc::{Receiver, SyncSender};
+
+/// A frame of tightly packed RGBA8 pixels, with the first row at the top.
+pub struct Frame {
+    /// The index of the frame in the sequence.
+    pub index: usize,
+    /// The name to write the output of the frame to, if it was read from an image.
+    pub name: Option<PathBuf>,
+    pub size: Size<u32>,
+    pub pixels: Vec<u8>,
+}
+
+impl Frame {
+    /// The output of this frame, with pixels read back from the renderer.
+    pub fn output(&self, size: Size<u32>, pixels: Vec<u8>) -> Frame {
+        Frame {
+            index: self.index,
+            name: self.name.clone(),
+            size,
+            pixels,
+        }
+    }
+}
+
+/// The length in bytes of an RGBA8 frame of the given size.
+pub fn frame_len(size: Size<u32>) -> usize {
+    size.width as usize * size.height as usize * 4
+}
+
+/// Reads and decodes the input frames.
+pub enum FrameReader {
+    Images(Vec<PathBuf>),
+    Raw(Size<u32>),
+}
+
+impl FrameReader {
+    pub fn images(paths: Vec<PathBuf>) -> Self {
+        FrameReader::Images(paths)
+    }
+
+    pub fn raw(size: Size<u32>) -> Self {
+        FrameReader::Raw(size)
+    }
+
+    /// Send every frame in order, or the first error, until the receiver hangs up.
+    pub fn run(self, frames: SyncSender<Result<Frame>>) {
+        match self {
+            FrameReader::Images(paths) => {
+                for (index, path) in paths.into_iter().enumerate() {
+                    let frame: Result<Frame> = image::open(&path)
+                        .map(|image| {
+                            let image = image.into_rgba8();
+                            Frame {
+                                index,
+                                size: Size::new(image.width(), image.height()),
+                                name: path.file_stem().map(PathBuf::from),
+                                pixels: image.into_raw(),
+                            }
+                        })
+                        .map_err(|e| format!("could not read {}: {e}", path.display()).into());
+
+                    let failed = frame.is_err();
+                    if frames.send(frame).is_err() || failed {
+                        return;
+                    }
+                }
+            }
+            FrameReader::Raw(size) => {
+                let mut stdin = std::io::stdin().lock();
+                for index in 0.. {
+                    let mut pixels = vec![0u8; frame_len(size)];
+                    let frame = match read_frame(&mut stdin, &mut pixels) {
+                        Ok(true) => Ok(Frame {
+                            index,
+                            name: None,
+                            size,
+                            pixels,
+                        }),
+                        Ok(false) => return,
+                        Err(e) => Err(e),
+                    };
+
+                    let failed = frame.is_err();
+                    if frames.send(frame).is_err() || failed {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Read a whole frame, or return false if the input ended before it.
+fn read_frame(input: &mut impl Read, pixels: &mut [u8]) -> Result<bool> {
+    let mut read = 0;
+    while read < pixels.len() {
+        match input.read(&mut pixels[read..]) {
+            Ok(0) if read == 0 => return Ok(false),
+            Ok(0) => return Err("the input ended in the middle of a frame".into()),
+            Ok(len) => read += len,
+            Err(e) if e.kind() == ErrorKind::Interrupted => continue,
+            Err(e) => return Err(e.into()),
+        }
+    }
+    Ok(true)
+}
+
+/// Encodes and writes the output frames.
+pub enum FrameWriter {
+    Images(PathBuf),
+    Raw,
+}
+
+impl FrameWriter {
+    pub fn images(directory: PathBuf) -> Result<Self> {
+        fs::create_dir_all(&directory)?;
+        Ok(FrameWriter::Images(directory))
+    }
+
+    pub fn raw() -> Self {
+        FrameWriter::Raw
+    }
+
+    /// Write every frame until the sender hangs up.
+    pub fn run(self, frames: Receiver<Frame>) -> Result<()> {
+        match self {
+            FrameWriter::Images(directory) => {
+                for frame in frames {
+                    let mut name = frame.name.map_or_else(
+                        || format!("{:06}", frame.index).into(),
+                        PathBuf::into_os_string,
+                    );
+                    name.push(".png");
+                    let path = directory.join(name);
+                    image::save_buffer(
+                        &path,
+                        &frame.pixels,
+                        frame.size.width,
+                        frame.size.height,
+                        image::ColorType::Rgba8,
+                    )
+                    .map_err(|e| format!("could not write {}: {e}", path.display()))?;
+                }
+            }
+            FrameWriter::Raw => {
+                let mut stdout = BufWriter::new(std::io::stdout().lock());
+                for frame in frames {
+                    stdout.write_all(&frame.pixels)?;
+                }
+                stdout.flush()?;
+            }
+        }
+        Ok(())
+    }
+}
@@ -0,0 +1,501 @@
+use crate::frame::{frame_len, Frame};
+use crate::{Renderer, Result};
+use gl::types::{GLenum, GLsync, GLuint};
+use libloading::Library;
+use librashader::runtime::gl::{FilterChain, FilterChainOptions, GLFramebuffer, GLImage};
+use librashader::runtime::{Size, Viewport};
+use std::ffi::{c_char, c_void, CString};
+use std::path::Path;
+
+type EGLDisplay = *mut c_void;
+type EGLConfig = *mut c_void;
+type EGLContext = *mut c_void;
+type EGLSurface = *mut c_void;
+type EGLint = i32;
+type EGLenum = u32;
+type EGLBoolean = u32;
+
+const EGL_NONE: EGLint = 0x3038;
+const EGL_SURFACE_TYPE: EGLint = 0x3033;
+const EGL_PBUFFER_BIT: EGLint = 0x0001;
+const EGL_RENDERABLE_TYPE: EGLint = 0x3040;
+const EGL_OPENGL_BIT: EGLint = 0x0008;
+const EGL_OPENGL_API: EGLenum = 0x30A2;
+const EGL_CONTEXT_MAJOR_VERSION: EGLint = 0x3098;
+const EGL_CONTEXT_MINOR_VERSION: EGLint = 0x30FB;
+const EGL_CONTEXT_OPENGL_PROFILE_MASK: EGLint = 0x30FD;
+const EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT: EGLint = 0x0001;
+const EGL_PLATFORM_SURFACELESS_MESA: EGLenum = 0x31DD;
+
+type PfnGetProcAddress = unsafe extern "C" fn(*const c_char) -> *const c_void;
+type PfnGetPlatformDisplay =
+    unsafe extern "C" fn(EGLenum, *mut c_void, *const EGLint) -> EGLDisplay;
+type PfnInitialize = unsafe extern "C" fn(EGLDisplay, *mut EGLint, *mut EGLint) -> EGLBoolean;
+type PfnTerminate = unsafe extern "C" fn(EGLDisplay) -> EGLBoolean;
+type PfnBindApi = unsafe extern "C" fn(EGLenum) -> EGLBoolean;
+type PfnChooseConfig = unsafe extern "C" fn(
+    EGLDisplay,
+    *const EGLint,
+    *mut EGLConfig,
+    EGLint,
+    *mut EGLint,
+) -> EGLBoolean;
+type PfnCreateContext =
+    unsafe extern "C" fn(EGLDisplay, EGLConfig, EGLContext, *const EGLint) -> EGLContext;
+type PfnDestroyContext = unsafe extern "C" fn(EGLDisplay, EGLContext) -> EGLBoolean;
+type PfnMakeCurrent =
+    unsafe extern "C" fn(EGLDisplay, EGLSurface, EGLSurface, EGLContext) -> EGLBoolean;
+type PfnGetError = unsafe extern "C" fn() -> EGLint;
+
+/// An OpenGL context on the EGL surfaceless platform, which needs no window or display server.
+///
+/// EGL is loaded at runtime, so the tool can still render with Vulkan where EGL is missing.
+struct EglContext {
+    display: EGLDisplay,
+    context: EGLContext,
+    terminate: PfnTerminate,
+    destroy_context: PfnDestroyContext,
+    make_current: PfnMakeCurrent,
+    _library: Library,
+}
+
+impl EglContext {
+    /// Create an OpenGL 3.3 core context, make it current on this thread, and load `gl` from it.
+    unsafe fn new() -> Result<EglContext> {
+        let library = unsafe { Library::new("libEGL.so.1")? };
+
+        unsafe {
+            let get_proc_address: PfnGetProcAddress = *library.get(b"eglGetProcAddress\0")?;
+            let initialize: PfnInitialize = *library.get(b"eglInitialize\0")?;
+            let terminate: PfnTerminate = *library.get(b"eglTerminate\0")?;
+            let bind_api: PfnBindApi = *library.get(b"eglBindAPI\0")?;
+            let choose_config: PfnChooseConfig = *library.get(b"eglChooseConfig\0")?;
+            let create_context: PfnCreateContext = *library.get(b"eglCreateContext\0")?;
+            let destroy_context: PfnDestroyContext = *library.get(b"eglDestroyContext\0")?;
+            let make_current: PfnMakeCurrent = *library.get(b"eglMakeCurrent\0")?;
+            let get_error: PfnGetError = *library.get(b"eglGetError\0")?;
+
+            let egl_error = |what: &str| format!("{what} failed with EGL error {:#x}", get_error());
+
+            let get_platform_display = std::mem::transmute::<_, Option<PfnGetPlatformDisplay>>(
+                get_proc_address(b"eglGetPlatformDisplayEXT\0".as_ptr().cast()),
+            )
+            .ok_or("EGL does not support EGL_EXT_platform_base")?;
+
+            let display = get_platform_display(
+                EGL_PLATFORM_SURFACELESS_MESA,
+                std::ptr::null_mut(),
+                std::ptr::null(),
+            );
+            if display.is_null() {
+                return Err(
+                    egl_error("eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA)").into(),
+                );
+            }
+
+            let (mut major, mut minor) = (0, 0);
+            if initialize(display, &mut major, &mut minor) == 0 {
+                return Err(egl_error("eglInitialize").into());
+            }
+
+            if bind_api(EGL_OPENGL_API) == 0 {
+                terminate(display);
+                return Err(egl_error("eglBindAPI(EGL_OPENGL_API)").into());
+            }
+
+            let config_attribs = [
+                EGL_SURFACE_TYPE,
+                EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE,
+                EGL_OPENGL_BIT,
+                EGL_NONE,
+            ];
+            let mut config = std::ptr::null_mut();
+            let mut config_count = 0;
+            if choose_config(
+                display,
+                config_attribs.as_ptr(),
+                &mut config,
+                1,
+                &mut config_count,
+            ) == 0
+                || config_count == 0
+            {
+                terminate(display);
+                return Err(egl_error("eglChooseConfig").into());
+            }
+
+            let context_attribs = [
+                EGL_CONTEXT_MAJOR_VERSION,
+                3,
+                EGL_CONTEXT_MINOR_VERSION,
+                3,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE,
+            ];
+            let context = create_context(
+                display,
+                config,
+                std::ptr::null_mut(),
+                context_attribs.as_ptr(),
+            );
+            if context.is_null() {
+                terminate(display);
+                return Err(egl_error("eglCreateContext").into());
+            }
+
+            // The framebuffers are all FBOs, so the context does not need a surface.
+            if make_current(display, std::ptr::null_mut(), std::ptr::null_mut(), context) == 0 {
+                destroy_context(display, context);
+                terminate(display);
+                return Err(egl_error("eglMakeCurrent").into());
+            }
+
+            gl::load_with(|symbol| {
+                let symbol = CString::new(symbol).unwrap();
+                get_proc_address(symbol.as_ptr())
+            });
+
+            Ok(EglContext {
+                display,
+                context,
+                terminate,
+                destroy_context,
+                make_current,
+                _library: library,
+            })
+        }
+    }
+}
+
+impl Drop for EglContext {
+    fn drop(&mut self) {
+        unsafe {
+            (self.make_current)(
+                self.display,
+                std::ptr::null_mut(),
+                std::ptr::null_mut(),
+                std::ptr::null_mut(),
+            );
+            (self.destroy_context)(self.display, self.context);
+            (self.terminate)(self.display);
+        }
+    }
+}
+
+/// The objects of one frame in flight.
+///
+/// Pixels are uploaded through a PBO to the input texture, and the output texture is read back
+/// into another PBO, which is only mapped once its fence has signalled.
+struct GlSlot {
+    input: GLuint,
+    upload: GLuint,
+    output: GLuint,
+    fbo: GLuint,
+    framebuffer: GLFramebuffer,
+    readback: GLuint,
+    fence: Option<GLsync>,
+    pending: Option<Frame>,
+}
+
+unsafe fn create_texture(size: Size<u32>) -> GLuint {
+    let mut texture = 0;
+    unsafe {
+        gl::GenTextures(1, &mut texture);
+        gl::BindTexture(gl::TEXTURE_2D, texture);
+        gl::TexParameteri(gl::TEXTURE_2D, gl::TEXTURE_MAX_LEVEL, 0);
+        gl::TexParameteri(gl::TEXTURE_2D, gl::TEXTURE_MIN_FILTER, gl::LINEAR as i32);
+        gl::TexParameteri(gl::TEXTURE_2D, gl::TEXTURE_MAG_FILTER, gl::LINEAR as i32);
+        gl::TexImage2D(
+            gl::TEXTURE_2D,
+            0,
+            gl::RGBA8 as i32,
+            size.width as i32,
+            size.height as i32,
+            0,
+            gl::RGBA,
+            gl::UNSIGNED_BYTE,
+            std::ptr::null(),
+        );
+        gl::BindTexture(gl::TEXTURE_2D, 0);
+    }
+    texture
+}
+
+unsafe fn create_pbo(target: GLenum, len: usize, usage: GLenum) -> GLuint {
+    let mut buffer = 0;
+    unsafe {
+        gl::GenBuffers(1, &mut buffer);
+        gl::BindBuffer(target, buffer);
+        gl::BufferData(target, len as isize, std::ptr::null(), usage);
+        gl::BindBuffer(target, 0);
+    }
+    buffer
+}
+
+impl GlSlot {
+    unsafe fn new(input_size: Size<u32>, output_size: Size<u32>) -> Result<GlSlot> {
+        unsafe {
+            let input = create_texture(input_size);
+            let output = create_texture(output_size);
+            let upload = create_pbo(
+                gl::PIXEL_UNPACK_BUFFER,
+                frame_len(input_size),
+                gl::STREAM_DRAW,
+            );
+            let readback = create_pbo(
+                gl::PIXEL_PACK_BUFFER,
+                frame_len(output_size),
+                gl::STREAM_READ,
+            );
+
+            let mut fbo = 0;
+            gl::GenFramebuffers(1, &mut fbo);
+            gl::BindFramebuffer(gl::FRAMEBUFFER, fbo);
+            gl::FramebufferTexture2D(
+                gl::FRAMEBUFFER,
+                gl::COLOR_ATTACHMENT0,
+                gl::TEXTURE_2D,
+                output,
+                0,
+            );
+            let status = gl::CheckFramebufferStatus(gl::FRAMEBUFFER);
+            gl::BindFramebuffer(gl::FRAMEBUFFER, 0);
+
+            let slot = GlSlot {
+                input,
+                upload,
+                output,
+                fbo,
+                framebuffer: GLFramebuffer::new_from_raw(output, fbo, gl::RGBA8, output_size, 1),
+                readback,
+                fence: None,
+                pending: None,
+            };
+
+            if status != gl::FRAMEBUFFER_COMPLETE {
+                return Err(format!("the output framebuffer is incomplete ({status:#x})").into());
+            }
+
+            Ok(slot)
+        }
+    }
+
+    /// Copy the pixels of a frame to the input texture through the upload PBO.
+    unsafe fn upload(&mut self, size: Size<u32>, pixels: &[u8]) -> Result<()> {
+        unsafe {
+            gl::BindBuffer(gl::PIXEL_UNPACK_BUFFER, self.upload);
+            // Invalidating the buffer lets the driver hand out fresh memory if the last upload
+            // has not been consumed yet, instead of waiting for it.
+            let mapped = gl::MapBufferRange(
+                gl::PIXEL_UNPACK_BUFFER,
+                0,
+                pixels.len() as isize,
+                gl::MAP_WRITE_BIT | gl::MAP_INVALIDATE_BUFFER_BIT,
+            );
+            if mapped.is_null() {
+                gl::BindBuffer(gl::PIXEL_UNPACK_BUFFER, 0);
+                return Err("the upload buffer could not be mapped".into());
+            }
+
+            std::ptr::copy_nonoverlapping(pixels.as_ptr(), mapped.cast(), pixels.len());
+            gl::UnmapBuffer(gl::PIXEL_UNPACK_BUFFER);
+
+            gl::BindTexture(gl::TEXTURE_2D, self.input);
+            gl::PixelStorei(gl::UNPACK_ALIGNMENT, 4);
+            gl::TexSubImage2D(
+                gl::TEXTURE_2D,
+                0,
+                0,
+                0,
+                size.width as i32,
+                size.height as i32,
+                gl::RGBA,
+                gl::UNSIGNED_BYTE,
+                std::ptr::null(),
+            );
+            gl::BindTexture(gl::TEXTURE_2D, 0);
+            gl::BindBuffer(gl::PIXEL_UNPACK_BUFFER, 0);
+        }
+        Ok(())
+    }
+
+    /// Start copying the output texture to the readback PBO, and fence it.
+    unsafe fn start_read_back(&mut self, size: Size<u32>) {
+        unsafe {
+            gl::BindFramebuffer(gl::READ_FRAMEBUFFER, self.fbo);
+            gl::ReadBuffer(gl::COLOR_ATTACHMENT0);
+            gl::BindBuffer(gl::PIXEL_PACK_BUFFER, self.readback);
+            gl::PixelStorei(gl::PACK_ALIGNMENT, 4);
+            gl::ReadPixels(
+                0,
+                0,
+                size.width as i32,
+                size.height as i32,
+                gl::RGBA,
+                gl::UNSIGNED_BYTE,
+                std::ptr::null_mut(),
+            );
+            gl::BindBuffer(gl::PIXEL_PACK_BUFFER, 0);
+            gl::BindFramebuffer(gl::READ_FRAMEBUFFER, 0);
+
+            self.fence = Some(gl::FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0));
+            gl::Flush();
+        }
+    }
+
+    /// Wait for the frame in this slot to finish, and return its output.
+    unsafe fn finish_read_back(&mut self, size: Size<u32>) -> Result<Option<Frame>> {
+        let Some(pending) = self.pending.take() else {
+            return Ok(None);
+        };
+
+        unsafe {
+            if let Some(fence) = self.fence.take() {
+                let status = loop {
+                    match gl::ClientWaitSync(fence, gl::SYNC_FLUSH_COMMANDS_BIT, 1_000_000_000) {
+                        gl::TIMEOUT_EXPIRED => continue,
+                        status => break status,
+                    }
+                };
+                gl::DeleteSync(fence);
+                if status == gl::WAIT_FAILED {
+                    return Err("waiting for a frame to finish failed".into());
+                }
+            }
+
+            let len = frame_len(size);
+            gl::BindBuffer(gl::PIXEL_PACK_BUFFER, self.readback);
+            let mapped =
+                gl::MapBufferRange(gl::PIXEL_PACK_BUFFER, 0, len as isize, gl::MAP_READ_BIT);
+            if mapped.is_null() {
+                gl::BindBuffer(gl::PIXEL_PACK_BUFFER, 0);
+                return Err("the readback buffer could not be mapped".into());
+            }
+
+            let pixels = std::slice::from_raw_parts(mapped.cast::<u8>(), len).to_vec();
+            gl::UnmapBuffer(gl::PIXEL_PACK_BUFFER);
+            gl::BindBuffer(gl::PIXEL_PACK_BUFFER, 0);
+
+            Ok(Some(pending.output(size, pixels)))
+        }
+    }
+}
+
+impl Drop for GlSlot {
+    fn drop(&mut self) {
+        unsafe {
+            if let Some(fence) = self.fence.take() {
+                gl::DeleteSync(fence);
+            }
+            gl::DeleteFramebuffers(1, &self.fbo);
+            gl::DeleteTextures(2, [self.input, self.output].as_ptr());
+            gl::DeleteBuffers(2, [self.upload, self.readback].as_ptr());
+        }
+    }
+}
+
+/// Renders with the OpenGL runtime.
+pub struct GlRenderer {
+    // The filter chain and slots must be dropped while the context is still current.
+    chain: FilterChain,
+    slots: Vec<GlSlot>,
+    input_size: Size<u32>,
+    output_size: Size<u32>,
+    submitted: usize,
+    _context: EglContext,
+}
+
+impl GlRenderer {
+    pub fn new(
+        preset: &Path,
+        input_size: Size<u32>,
+        output_size: Size<u32>,
+        frames_in_flight: usize,
+    ) -> Result<GlRenderer> {
+        unsafe {
+            let context = EglContext::new()?;
+            let chain = FilterChain::load_from_path(
+                preset,
+                Some(&FilterChainOptions {
+                    glsl_version: 330,
+                    ..Default::default()
+                }),
+            )?;
+
+            let slots = (0..frames_in_flight)
+                .map(|_| GlSlot::new(input_size, output_size))
+                .collect::<Result<Vec<_>>>()?;
+
+            Ok(GlRenderer {
+                chain,
+                slots,
+                input_size,
+                output_size,
+                submitted: 0,
+                _context: context,
+            })
+        }
+    }
+}
+
+impl Renderer for GlRenderer {
+    fn submit(
+        &mut self,
+        mut frame: Frame,
+        emit: &mut dyn FnMut(Frame) -> Result<()>,
+    ) -> Result<()> {
+        if frame.size != self.input_size {
+            return Err(format!(
+                "frame {} is {}x{}, but the first frame was {}x{}",
+                frame.index,
+                frame.size.width,
+                frame.size.height,
+                self.input_size.width,
+                self.input_size.height
+            )
+            .into());
+        }
+
+        let slot = &mut self.slots[self.submitted % self.slots.len()];
+        unsafe {
+            if let Some(output) = slot.finish_read_back(self.output_size)? {
+                emit(output)?;
+            }
+
+            slot.upload(self.input_size, &frame.pixels)?;
+
+            let input = GLImage {
+                handle: slot.input,
+                format: gl::RGBA8,
+                size: self.input_size,
+            };
+            let viewport = Viewport {
+                x: 0.0,
+                y: 0.0,
+                mvp: None,
+                output: &slot.framebuffer,
+            };
+            self.chain.frame(&input, &viewport, self.submitted, None)?;
+
+            slot.start_read_back(self.output_size);
+        }
+
+        frame.pixels = Vec::new();
+        slot.pending = Some(frame);
+        self.submitted += 1;
+        Ok(())
+    }
+
+    fn finish(&mut self, emit: &mut dyn FnMut(Frame) -> Result<()>) -> Result<()> {
+        // The oldest frame in flight is in the slot the next frame would use.
+        for offset in 0..self.slots.len() {
+            let slot = &mut self.slots[(self.submitted + offset) % self.slots.len()];
+            if let Some(output) = unsafe { slot.finish_read_back(self.output_size)? } {
+                emit(output)?;
+            }
+        }
+        Ok(())
+    }
+}
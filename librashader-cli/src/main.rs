@@ -0,0 +1,166 @@
+//! Render RetroArch shader presets offline, without a window or a display server.
+//!
+//! Frames are read from an image sequence or as raw RGBA8 frames from stdin, drawn with
+//! the OpenGL runtime on an EGL surfaceless context or with the Vulkan runtime, and written
+//! out as PNG images or raw RGBA8 frames. Decoding, rendering and encoding run on separate
+//! threads, and several frames are kept in flight on the GPU so that uploads and readbacks
+//! overlap with drawing.
+mod frame;
+mod gl;
+mod vk;
+
+use crate::frame::{Frame, FrameReader, FrameWriter};
+use clap::{Parser, ValueEnum};
+use librashader::runtime::Size;
+use std::path::PathBuf;
+use std::sync::mpsc;
+use std::time::Instant;
+
+pub type Result<T> = std::result::Result<T, Box<dyn std::error::Error + Send + Sync>>;
+
+#[derive(Copy, Clone, Debug, ValueEnum)]
+enum Runtime {
+    /// OpenGL 3.3 on an EGL surfaceless context, such as llvmpipe.
+    Gl,
+    /// Vulkan on the first device with a graphics queue, such as lavapipe.
+    Vk,
+}
+
+#[derive(Parser, Debug)]
+#[command(version, about)]
+struct Args {
+    /// The shader preset to render with.
+    #[arg(long)]
+    preset: PathBuf,
+    /// The runtime to render with.
+    #[arg(long, value_enum, default_value = "gl")]
+    runtime: Runtime,
+    /// Read raw RGBA8 frames of the given size, as `WIDTHxHEIGHT`, from stdin instead of
+    /// reading the input images.
+    #[arg(long, value_parser = parse_size)]
+    raw: Option<Size<u32>>,
+    /// Write the frames as PNG images to this directory instead of writing raw RGBA8 frames
+    /// to stdout.
+    #[arg(long, short)]
+    output: Option<PathBuf>,
+    /// The size of the output, as `WIDTHxHEIGHT`. Defaults to the size of the input times `scale`.
+    #[arg(long, value_parser = parse_size)]
+    size: Option<Size<u32>>,
+    /// The factor to scale the input by, if no output size is given.
+    #[arg(long, default_value_t = 1)]
+    scale: u32,
+    /// The number of frames in flight on the GPU.
+    #[arg(long, default_value_t = 3, value_parser = clap::value_parser!(u32).range(1..=4))]
+    frames_in_flight: u32,
+    /// The images to render, in order.
+    inputs: Vec<PathBuf>,
+}
+
+fn parse_size(size: &str) -> std::result::Result<Size<u32>, String> {
+    let Some((width, height)) = size.split_once('x') else {
+        return Err(String::from("expected a size as WIDTHxHEIGHT"));
+    };
+
+    let width = width.parse::<u32>().map_err(|e| e.to_string())?;
+    let height = height.parse::<u32>().map_err(|e| e.to_string())?;
+    if width == 0 || height == 0 {
+        return Err(String::from("the size can not be zero"));
+    }
+    Ok(Size::new(width, height))
+}
+
+/// Renders frames with several frames in flight.
+pub trait Renderer {
+    /// Submit a frame for rendering.
+    ///
+    /// Once all frames in flight are in use, this waits for the oldest one to finish and
+    /// passes its output to `emit`, so outputs are emitted in the order frames were submitted.
+    fn submit(&mut self, frame: Frame, emit: &mut dyn FnMut(Frame) -> Result<()>) -> Result<()>;
+
+    /// Wait for every frame in flight to finish and pass their outputs to `emit`.
+    fn finish(&mut self, emit: &mut dyn FnMut(Frame) -> Result<()>) -> Result<()>;
+}
+
+fn main() -> Result<()> {
+    let args = Args::parse();
+    if args.raw.is_none() && args.inputs.is_empty() {
+        return Err("no input images were given, and --raw was not set".into());
+    }
+
+    let in_flight = args.frames_in_flight as usize;
+    let reader = match args.raw {
+        Some(size) => FrameReader::raw(size),
+        None => FrameReader::images(args.inputs),
+    };
+    let writer = match args.output {
+        Some(directory) => FrameWriter::images(directory)?,
+        None => FrameWriter::raw(),
+    };
+
+    // Decoding and encoding happen on their own threads, each a few frames ahead of or behind
+    // the GPU, so that the frames in flight are kept busy.
+    let (input_tx, input_rx) = mpsc::sync_channel(in_flight);
+    let reader = std::thread::spawn(move || reader.run(input_tx));
+    let (output_tx, output_rx) = mpsc::sync_channel::<Frame>(in_flight);
+    let writer = std::thread::spawn(move || writer.run(output_rx));
+
+    let mut inputs = input_rx.into_iter();
+    let Some(first) = inputs.next().transpose()? else {
+        return Err("there are no frames to render".into());
+    };
+
+    let input_size = first.size;
+    let output_size = args.size.unwrap_or(Size::new(
+        input_size.width * args.scale,
+        input_size.height * args.scale,
+    ));
+
+    let mut renderer: Box<dyn Renderer> = match args.runtime {
+        Runtime::Gl => Box::new(gl::GlRenderer::new(
+            &args.preset,
+            input_size,
+            output_size,
+            in_flight,
+        )?),
+        Runtime::Vk => Box::new(vk::VulkanRenderer::new(
+            &args.preset,
+            input_size,
+            output_size,
+            in_flight,
+        )?),
+    };
+
+    let mut emit = |frame: Frame| -> Result<()> {
+        output_tx
+            .send(frame)
+            .map_err(|_| "the output could not be written".into())
+    };
+
+    let start = Instant::now();
+    let mut count = 0usize;
+    for frame in std::iter::once(Ok(first)).chain(inputs) {
+        renderer.submit(frame?, &mut emit)?;
+        count += 1;
+    }
+    renderer.finish(&mut emit)?;
+    let elapsed = start.elapsed();
+
+    drop(renderer);
+    drop(emit);
+    drop(output_tx);
+
+    // The reader is done once the inputs have run out, so this does not block.
+    reader.join().expect("the reader thread panicked");
+    writer.join().expect("the writer thread panicked")?;
+
+    eprintln!(
+        "rendered {count} frames of {}x{} to {}x{} in {elapsed:.2?} ({:.1} frames per second)",
+        input_size.width,
+        input_size.height,
+        output_size.width,
+        output_size.height,
+        count as f64 / elapsed.as_secs_f64()
+    );
+
+    Ok(())
+}
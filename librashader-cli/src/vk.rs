@@ -0,0 +1,598 @@
+use crate::frame::{frame_len, Frame};
+use crate::{Renderer, Result};
+use ash::vk;
+use librashader::runtime::vk::{FilterChain, FilterChainOptions, VulkanImage};
+use librashader::runtime::{Size, Viewport};
+use std::ffi::CStr;
+use std::path::Path;
+
+const APPLICATION_NAME: &[u8] = b"librashader-cli\0";
+const FORMAT: vk::Format = vk::Format::R8G8B8A8_UNORM;
+
+/// Find a memory type for the requirements with all of the given properties.
+fn find_memory_type(
+    memory_properties: &vk::PhysicalDeviceMemoryProperties,
+    requirements: &vk::MemoryRequirements,
+    flags: vk::MemoryPropertyFlags,
+) -> Option<u32> {
+    (0..memory_properties.memory_type_count).find(|&index| {
+        requirements.memory_type_bits & (1 << index) != 0
+            && memory_properties.memory_types[index as usize]
+                .property_flags
+                .contains(flags)
+    })
+}
+
+unsafe fn allocate_memory(
+    device: &ash::Device,
+    memory_properties: &vk::PhysicalDeviceMemoryProperties,
+    requirements: vk::MemoryRequirements,
+    preferred: vk::MemoryPropertyFlags,
+    required: vk::MemoryPropertyFlags,
+) -> Result<vk::DeviceMemory> {
+    let memory_type = find_memory_type(memory_properties, &requirements, preferred)
+        .or_else(|| find_memory_type(memory_properties, &requirements, required))
+        .ok_or("there is no suitable memory type")?;
+
+    let alloc_info = vk::MemoryAllocateInfo::builder()
+        .allocation_size(requirements.size)
+        .memory_type_index(memory_type);
+    Ok(unsafe { device.allocate_memory(&alloc_info, None)? })
+}
+
+/// A host visible buffer that stays mapped for as long as it lives.
+struct MappedBuffer {
+    buffer: vk::Buffer,
+    memory: vk::DeviceMemory,
+    mapped: *mut u8,
+    len: usize,
+}
+
+impl MappedBuffer {
+    unsafe fn new(
+        device: &ash::Device,
+        memory_properties: &vk::PhysicalDeviceMemoryProperties,
+        usage: vk::BufferUsageFlags,
+        preferred: vk::MemoryPropertyFlags,
+        len: usize,
+    ) -> Result<MappedBuffer> {
+        unsafe {
+            let buffer_info = vk::BufferCreateInfo::builder()
+                .size(len as vk::DeviceSize)
+                .usage(usage)
+                .sharing_mode(vk::SharingMode::EXCLUSIVE);
+            let buffer = device.create_buffer(&buffer_info, None)?;
+
+            let required =
+                vk::MemoryPropertyFlags::HOST_VISIBLE | vk::MemoryPropertyFlags::HOST_COHERENT;
+            let memory = allocate_memory(
+                device,
+                memory_properties,
+                device.get_buffer_memory_requirements(buffer),
+                preferred | required,
+                required,
+            )?;
+            device.bind_buffer_memory(buffer, memory, 0)?;
+            let mapped =
+                device.map_memory(memory, 0, vk::WHOLE_SIZE, vk::MemoryMapFlags::empty())?;
+
+            Ok(MappedBuffer {
+                buffer,
+                memory,
+                mapped: mapped.cast(),
+                len,
+            })
+        }
+    }
+
+    unsafe fn destroy(&self, device: &ash::Device) {
+        unsafe {
+            device.unmap_memory(self.memory);
+            device.destroy_buffer(self.buffer, None);
+            device.free_memory(self.memory, None);
+        }
+    }
+}
+
+/// An image in device local memory.
+struct DeviceImage {
+    image: vk::Image,
+    memory: vk::DeviceMemory,
+}
+
+impl DeviceImage {
+    unsafe fn new(
+        device: &ash::Device,
+        memory_properties: &vk::PhysicalDeviceMemoryProperties,
+        size: Size<u32>,
+        usage: vk::ImageUsageFlags,
+    ) -> Result<DeviceImage> {
+        unsafe {
+            let image_info = vk::ImageCreateInfo::builder()
+                .image_type(vk::ImageType::TYPE_2D)
+                .format(FORMAT)
+                .extent(size.into())
+                .mip_levels(1)
+                .array_layers(1)
+                .samples(vk::SampleCountFlags::TYPE_1)
+                .tiling(vk::ImageTiling::OPTIMAL)
+                .usage(usage)
+                .sharing_mode(vk::SharingMode::EXCLUSIVE)
+                .initial_layout(vk::ImageLayout::UNDEFINED);
+            let image = device.create_image(&image_info, None)?;
+
+            let memory = allocate_memory(
+                device,
+                memory_properties,
+                device.get_image_memory_requirements(image),
+                vk::MemoryPropertyFlags::DEVICE_LOCAL,
+                vk::MemoryPropertyFlags::empty(),
+            )?;
+            device.bind_image_memory(image, memory, 0)?;
+
+            Ok(DeviceImage { image, memory })
+        }
+    }
+
+    unsafe fn destroy(&self, device: &ash::Device) {
+        unsafe {
+            device.destroy_image(self.image, None);
+            device.free_memory(self.memory, None);
+        }
+    }
+}
+
+#[allow(clippy::too_many_arguments)]
+unsafe fn image_barrier(
+    device: &ash::Device,
+    cmd: vk::CommandBuffer,
+    image: vk::Image,
+    old_layout: vk::ImageLayout,
+    new_layout: vk::ImageLayout,
+    src_access: vk::AccessFlags,
+    dst_access: vk::AccessFlags,
+    src_stage: vk::PipelineStageFlags,
+    dst_stage: vk::PipelineStageFlags,
+) {
+    let barrier = vk::ImageMemoryBarrier::builder()
+        .src_access_mask(src_access)
+        .dst_access_mask(dst_access)
+        .old_layout(old_layout)
+        .new_layout(new_layout)
+        .src_queue_family_index(vk::QUEUE_FAMILY_IGNORED)
+        .dst_queue_family_index(vk::QUEUE_FAMILY_IGNORED)
+        .image(image)
+        .subresource_range(vk::ImageSubresourceRange {
+            aspect_mask: vk::ImageAspectFlags::COLOR,
+            base_mip_level: 0,
+            level_count: 1,
+            base_array_layer: 0,
+            layer_count: 1,
+        });
+
+    unsafe {
+        device.cmd_pipeline_barrier(
+            cmd,
+            src_stage,
+            dst_stage,
+            vk::DependencyFlags::empty(),
+            &[],
+            &[],
+            &[*barrier],
+        );
+    }
+}
+
+fn buffer_image_copy(size: Size<u32>) -> vk::BufferImageCopy {
+    vk::BufferImageCopy {
+        buffer_offset: 0,
+        buffer_row_length: 0,
+        buffer_image_height: 0,
+        image_subresource: vk::ImageSubresourceLayers {
+            aspect_mask: vk::ImageAspectFlags::COLOR,
+            mip_level: 0,
+            base_array_layer: 0,
+            layer_count: 1,
+        },
+        image_offset: vk::Offset3D::default(),
+        image_extent: size.into(),
+    }
+}
+
+/// The objects of one frame in flight.
+///
+/// Pixels are copied to a staging buffer and uploaded to the input image, and the output image
+/// is copied back to a readback buffer, all in the command buffer of the frame. The buffers are
+/// only touched from the host once the fence of the frame has signalled.
+struct VulkanSlot {
+    input: DeviceImage,
+    output: DeviceImage,
+    upload: MappedBuffer,
+    readback: MappedBuffer,
+    cmd: vk::CommandBuffer,
+    fence: vk::Fence,
+    pending: Option<Frame>,
+}
+
+impl VulkanSlot {
+    unsafe fn new(
+        device: &ash::Device,
+        memory_properties: &vk::PhysicalDeviceMemoryProperties,
+        cmd: vk::CommandBuffer,
+        input_size: Size<u32>,
+        output_size: Size<u32>,
+    ) -> Result<VulkanSlot> {
+        unsafe {
+            let fence_info = vk::FenceCreateInfo::builder().flags(vk::FenceCreateFlags::SIGNALED);
+            Ok(VulkanSlot {
+                input: DeviceImage::new(
+                    device,
+                    memory_properties,
+                    input_size,
+                    vk::ImageUsageFlags::SAMPLED
+                        | vk::ImageUsageFlags::TRANSFER_DST
+                        | vk::ImageUsageFlags::TRANSFER_SRC,
+                )?,
+                output: DeviceImage::new(
+                    device,
+                    memory_properties,
+                    output_size,
+                    vk::ImageUsageFlags::COLOR_ATTACHMENT | vk::ImageUsageFlags::TRANSFER_SRC,
+                )?,
+                upload: MappedBuffer::new(
+                    device,
+                    memory_properties,
+                    vk::BufferUsageFlags::TRANSFER_SRC,
+                    vk::MemoryPropertyFlags::empty(),
+                    frame_len(input_size),
+                )?,
+                // Cached memory is much faster to read from the host, where it is available.
+                readback: MappedBuffer::new(
+                    device,
+                    memory_properties,
+                    vk::BufferUsageFlags::TRANSFER_DST,
+                    vk::MemoryPropertyFlags::HOST_CACHED,
+                    frame_len(output_size),
+                )?,
+                cmd,
+                fence: device.create_fence(&fence_info, None)?,
+                pending: None,
+            })
+        }
+    }
+
+    /// Wait for the frame in this slot to finish, and return its output.
+    unsafe fn finish_read_back(
+        &mut self,
+        device: &ash::Device,
+        size: Size<u32>,
+    ) -> Result<Option<Frame>> {
+        unsafe {
+            device.wait_for_fences(&[self.fence], true, u64::MAX)?;
+        }
+
+        let Some(pending) = self.pending.take() else {
+            return Ok(None);
+        };
+
+        let pixels =
+            unsafe { std::slice::from_raw_parts(self.readback.mapped, self.readback.len) }.to_vec();
+        Ok(Some(pending.output(size, pixels)))
+    }
+
+    unsafe fn destroy(&self, device: &ash::Device) {
+        unsafe {
+            device.destroy_fence(self.fence, None);
+            self.input.destroy(device);
+            self.output.destroy(device);
+            self.upload.destroy(device);
+            self.readback.destroy(device);
+        }
+    }
+}
+
+/// Renders with the Vulkan runtime, on its own instance and device.
+pub struct VulkanRenderer {
+    chain: Option<FilterChain>,
+    slots: Vec<VulkanSlot>,
+    pool: vk::CommandPool,
+    queue: vk::Queue,
+    input_size: Size<u32>,
+    output_size: Size<u32>,
+    submitted: usize,
+    device: ash::Device,
+    instance: ash::Instance,
+    _entry: ash::Entry,
+}
+
+impl VulkanRenderer {
+    pub fn new(
+        preset: &Path,
+        input_size: Size<u32>,
+        output_size: Size<u32>,
+        frames_in_flight: usize,
+    ) -> Result<VulkanRenderer> {
+        let entry = ash::Entry::linked();
+        unsafe {
+            let app_info = vk::ApplicationInfo::builder()
+                .application_name(CStr::from_bytes_with_nul_unchecked(APPLICATION_NAME))
+                .engine_name(CStr::from_bytes_with_nul_unchecked(APPLICATION_NAME))
+                .api_version(vk::make_api_version(0, 1, 3, 0));
+            let instance_info = vk::InstanceCreateInfo::builder().application_info(&app_info);
+            let instance = entry.create_instance(&instance_info, None)?;
+
+            let Some((physical_device, queue_family)) = instance
+                .enumerate_physical_devices()?
+                .into_iter()
+                .find_map(|physical_device| {
+                    instance
+                        .get_physical_device_queue_family_properties(physical_device)
+                        .iter()
+                        .position(|family| {
+                            family.queue_count > 0
+                                && family.queue_flags.contains(vk::QueueFlags::GRAPHICS)
+                        })
+                        .map(|family| (physical_device, family as u32))
+                })
+            else {
+                instance.destroy_instance(None);
+                return Err("there is no Vulkan device with a graphics queue".into());
+            };
+
+            let properties = instance.get_physical_device_properties(physical_device);
+            eprintln!(
+                "rendering with {}",
+                CStr::from_ptr(properties.device_name.as_ptr()).to_string_lossy()
+            );
+
+            let queue_info = [*vk::DeviceQueueCreateInfo::builder()
+                .queue_family_index(queue_family)
+                .queue_priorities(&[1.0])];
+            let device_info = vk::DeviceCreateInfo::builder().queue_create_infos(&queue_info);
+            let device = match instance.create_device(physical_device, &device_info, None) {
+                Ok(device) => device,
+                Err(e) => {
+                    instance.destroy_instance(None);
+                    return Err(e.into());
+                }
+            };
+
+            let queue = device.get_device_queue(queue_family, 0);
+            let pool_info = vk::CommandPoolCreateInfo::builder()
+                .flags(vk::CommandPoolCreateFlags::RESET_COMMAND_BUFFER)
+                .queue_family_index(queue_family);
+
+            // From here on, dropping the renderer cleans up after a failure.
+            let mut renderer = VulkanRenderer {
+                chain: None,
+                slots: Vec::new(),
+                pool: vk::CommandPool::null(),
+                queue,
+                input_size,
+                output_size,
+                submitted: 0,
+                device,
+                instance,
+                _entry: entry,
+            };
+
+            let device = &renderer.device;
+            renderer.pool = device.create_command_pool(&pool_info, None)?;
+
+            let buffer_info = vk::CommandBufferAllocateInfo::builder()
+                .command_pool(renderer.pool)
+                .level(vk::CommandBufferLevel::PRIMARY)
+                .command_buffer_count(frames_in_flight as u32);
+            let memory_properties = renderer
+                .instance
+                .get_physical_device_memory_properties(physical_device);
+            for cmd in device.allocate_command_buffers(&buffer_info)? {
+                let slot =
+                    VulkanSlot::new(device, &memory_properties, cmd, input_size, output_size)?;
+                renderer.slots.push(slot);
+            }
+
+            // Passes draw with render passes, so the device does not need dynamic rendering.
+            renderer.chain = Some(FilterChain::load_from_path(
+                preset,
+                (
+                    physical_device,
+                    renderer.instance.clone(),
+                    renderer.device.clone(),
+                ),
+                Some(&FilterChainOptions {
+                    frames_in_flight: frames_in_flight as u32,
+                    use_render_pass: true,
+                    ..Default::default()
+                }),
+            )?);
+
+            Ok(renderer)
+        }
+    }
+}
+
+impl Renderer for VulkanRenderer {
+    fn submit(
+        &mut self,
+        mut frame: Frame,
+        emit: &mut dyn FnMut(Frame) -> Result<()>,
+    ) -> Result<()> {
+        if frame.size != self.input_size {
+            return Err(format!(
+                "frame {} is {}x{}, but the first frame was {}x{}",
+                frame.index,
+                frame.size.width,
+                frame.size.height,
+                self.input_size.width,
+                self.input_size.height
+            )
+            .into());
+        }
+
+        let device = &self.device;
+        let chain = self
+            .chain
+            .as_mut()
+            .ok_or("the filter chain was not loaded")?;
+        let slot = &mut self.slots[self.submitted % self.slots.len()];
+
+        unsafe {
+            // The filter chain indexes its own frames in flight the same way, so once this fence
+            // has signalled, the resources of the chain for this frame are free as well.
+            if let Some(output) = slot.finish_read_back(device, self.output_size)? {
+                emit(output)?;
+            }
+            device.reset_fences(&[slot.fence])?;
+
+            std::ptr::copy_nonoverlapping(
+                frame.pixels.as_ptr(),
+                slot.upload.mapped,
+                frame.pixels.len(),
+            );
+
+            let cmd = slot.cmd;
+            device.reset_command_buffer(cmd, vk::CommandBufferResetFlags::empty())?;
+            device.begin_command_buffer(
+                cmd,
+                &vk::CommandBufferBeginInfo::builder()
+                    .flags(vk::CommandBufferUsageFlags::ONE_TIME_SUBMIT),
+            )?;
+
+            image_barrier(
+                device,
+                cmd,
+                slot.input.image,
+                vk::ImageLayout::UNDEFINED,
+                vk::ImageLayout::TRANSFER_DST_OPTIMAL,
+                vk::AccessFlags::empty(),
+                vk::AccessFlags::TRANSFER_WRITE,
+                vk::PipelineStageFlags::TOP_OF_PIPE,
+                vk::PipelineStageFlags::TRANSFER,
+            );
+            device.cmd_copy_buffer_to_image(
+                cmd,
+                slot.upload.buffer,
+                slot.input.image,
+                vk::ImageLayout::TRANSFER_DST_OPTIMAL,
+                &[buffer_image_copy(self.input_size)],
+            );
+            image_barrier(
+                device,
+                cmd,
+                slot.input.image,
+                vk::ImageLayout::TRANSFER_DST_OPTIMAL,
+                vk::ImageLayout::SHADER_READ_ONLY_OPTIMAL,
+                vk::AccessFlags::TRANSFER_WRITE,
+                vk::AccessFlags::SHADER_READ,
+                vk::PipelineStageFlags::TRANSFER,
+                vk::PipelineStageFlags::FRAGMENT_SHADER,
+            );
+            image_barrier(
+                device,
+                cmd,
+                slot.output.image,
+                vk::ImageLayout::UNDEFINED,
+                vk::ImageLayout::COLOR_ATTACHMENT_OPTIMAL,
+                vk::AccessFlags::empty(),
+                vk::AccessFlags::COLOR_ATTACHMENT_WRITE,
+                vk::PipelineStageFlags::TOP_OF_PIPE,
+                vk::PipelineStageFlags::COLOR_ATTACHMENT_OUTPUT,
+            );
+
+            let input = VulkanImage {
+                image: slot.input.image,
+                size: self.input_size,
+                format: FORMAT,
+            };
+            let viewport = Viewport {
+                x: 0.0,
+                y: 0.0,
+                mvp: None,
+                output: VulkanImage {
+                    image: slot.output.image,
+                    size: self.output_size,
+                    format: FORMAT,
+                },
+            };
+            chain.frame(&input, &viewport, cmd, self.submitted, None)?;
+
+            image_barrier(
+                device,
+                cmd,
+                slot.output.image,
+                vk::ImageLayout::COLOR_ATTACHMENT_OPTIMAL,
+                vk::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                vk::AccessFlags::COLOR_ATTACHMENT_WRITE,
+                vk::AccessFlags::TRANSFER_READ,
+                vk::PipelineStageFlags::COLOR_ATTACHMENT_OUTPUT,
+                vk::PipelineStageFlags::TRANSFER,
+            );
+            device.cmd_copy_image_to_buffer(
+                cmd,
+                slot.output.image,
+                vk::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                slot.readback.buffer,
+                &[buffer_image_copy(self.output_size)],
+            );
+
+            let readback_barrier = vk::BufferMemoryBarrier::builder()
+                .src_access_mask(vk::AccessFlags::TRANSFER_WRITE)
+                .dst_access_mask(vk::AccessFlags::HOST_READ)
+                .src_queue_family_index(vk::QUEUE_FAMILY_IGNORED)
+                .dst_queue_family_index(vk::QUEUE_FAMILY_IGNORED)
+                .buffer(slot.readback.buffer)
+                .offset(0)
+                .size(vk::WHOLE_SIZE);
+            device.cmd_pipeline_barrier(
+                cmd,
+                vk::PipelineStageFlags::TRANSFER,
+                vk::PipelineStageFlags::HOST,
+                vk::DependencyFlags::empty(),
+                &[],
+                &[*readback_barrier],
+                &[],
+            );
+
+            device.end_command_buffer(cmd)?;
+
+            let buffers = [cmd];
+            let submit_info = vk::SubmitInfo::builder().command_buffers(&buffers);
+            device.queue_submit(self.queue, &[*submit_info], slot.fence)?;
+        }
+
+        frame.pixels = Vec::new();
+        slot.pending = Some(frame);
+        self.submitted += 1;
+        Ok(())
+    }
+
+    fn finish(&mut self, emit: &mut dyn FnMut(Frame) -> Result<()>) -> Result<()> {
+        // The oldest frame in flight is in the slot the next frame would use.
+        for offset in 0..self.slots.len() {
+            let slot = &mut self.slots[(self.submitted + offset) % self.slots.len()];
+            if let Some(output) = unsafe { slot.finish_read_back(&self.device, self.output_size)? }
+            {
+                emit(output)?;
+            }
+        }
+        Ok(())
+    }
+}
+
+impl Drop for VulkanRenderer {
+    fn drop(&mut self) {
+        unsafe {
+            let _ = self.device.device_wait_idle();
+            self.chain = None;
+            for slot in &self.slots {
+                slot.destroy(&self.device);
+            }
+            if self.pool != vk::CommandPool::null() {
+                self.device.destroy_command_pool(self.pool, None);
+            }
+            self.device.destroy_device(None);
+            self.instance.destroy_instance(None);
+        }
+    }
+}
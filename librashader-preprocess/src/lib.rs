@@ -57,6 +57,7 @@ pub struct ShaderParameter {
 impl ShaderSource {
     /// Load the source file at the given path, resolving includes relative to the location of the
     /// source file.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
     pub fn load(file: &librashader_common::ShaderStorage) -> Result<ShaderSource, PreprocessError> {
         load_shader_source(file)
     }
@@ -0,0 +1,52 @@
+//! Compile time of the glslang and naga front ends, from preprocessed source to SPIR-V.
+//!
+//! Run with `cargo bench -p librashader-reflect --features unstable-naga`.
+#![feature(test)]
+
+extern crate test;
+
+use librashader_preprocess::{PreprocessError, ShaderSource};
+use librashader_presets::ShaderPreset;
+use librashader_reflect::back::targets::SPIRV;
+use librashader_reflect::back::{CompileShader, FromCompilation};
+use librashader_reflect::front::{GlslangCompilation, NagaCompilation, ShaderCompilation};
+use librashader_reflect::reflect::presets::preprocess_preset_passes;
+use librashader_reflect::reflect::semantics::ShaderSemantics;
+use librashader_reflect::reflect::ReflectShader;
+use test::{black_box, Bencher};
+
+fn load_preset() -> (Vec<ShaderSource>, ShaderSemantics) {
+    let preset = ShaderPreset::try_parse("../test/basic.slangp").unwrap();
+    let (passes, semantics) =
+        preprocess_preset_passes::<PreprocessError>(preset.shaders, &preset.textures).unwrap();
+    (
+        passes.into_iter().map(|(_, source)| source).collect(),
+        semantics,
+    )
+}
+
+/// Compile, reflect and write SPIR-V for every pass of the preset.
+fn compile_passes<C>(sources: &[ShaderSource], semantics: &ShaderSemantics)
+where
+    C: ShaderCompilation,
+    SPIRV: FromCompilation<C, Target = SPIRV, Options = Option<()>>,
+{
+    for (index, source) in sources.iter().enumerate() {
+        let compilation = C::compile(source).unwrap();
+        let mut backend = SPIRV::from_compilation(compilation).unwrap();
+        black_box(backend.reflect(index, semantics).unwrap());
+        black_box(backend.compile(None).unwrap());
+    }
+}
+
+#[bench]
+fn compile_glslang(b: &mut Bencher) {
+    let (sources, semantics) = load_preset();
+    b.iter(|| compile_passes::<GlslangCompilation>(&sources, &semantics));
+}
+
+#[bench]
+fn compile_naga(b: &mut Bencher) {
+    let (sources, semantics) = load_preset();
+    b.iter(|| compile_passes::<NagaCompilation>(&sources, &semantics));
+}
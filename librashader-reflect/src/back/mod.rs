@@ -1,6 +1,8 @@
 pub mod cross;
 #[cfg(all(target_os = "windows", feature = "dxil"))]
 pub mod dxil;
+#[cfg(feature = "unstable-naga")]
+pub mod naga;
 mod spirv;
 pub mod targets;
 
@@ -0,0 +1,45 @@
+use crate::back::cross::GlslVersion;
+use crate::back::targets::{GLSL, SPIRV};
+use crate::back::{CompileShader, CompilerBackend, FromCompilation};
+use crate::error::ShaderReflectError;
+use crate::front::NagaCompilation;
+use crate::reflect::naga::NagaReflect;
+use crate::reflect::ReflectShader;
+
+/// The context for a GLSL compilation via naga.
+pub struct NagaGlslContext {
+    /// A map of bindings of sampler names to binding locations.
+    pub sampler_bindings: Vec<(String, u32)>,
+}
+
+impl FromCompilation<NagaCompilation> for GLSL {
+    type Target = GLSL;
+    type Options = GlslVersion;
+    type Context = NagaGlslContext;
+    type Output = impl CompileShader<Self::Target, Options = GlslVersion, Context = Self::Context>
+        + ReflectShader;
+
+    fn from_compilation(
+        compile: NagaCompilation,
+    ) -> Result<CompilerBackend<Self::Output>, ShaderReflectError> {
+        Ok(CompilerBackend {
+            backend: NagaReflect::try_from(compile)?,
+        })
+    }
+}
+
+impl FromCompilation<NagaCompilation> for SPIRV {
+    type Target = SPIRV;
+    type Options = Option<()>;
+    type Context = ();
+    type Output = impl CompileShader<Self::Target, Options = Self::Options, Context = Self::Context>
+        + ReflectShader;
+
+    fn from_compilation(
+        compile: NagaCompilation,
+    ) -> Result<CompilerBackend<Self::Output>, ShaderReflectError> {
+        Ok(CompilerBackend {
+            backend: NagaReflect::try_from(compile)?,
+        })
+    }
+}
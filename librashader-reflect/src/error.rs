@@ -10,6 +10,21 @@ pub enum ShaderCompileError {
     #[error("shader")]
     NagaCompileError(Vec<naga::front::glsl::Error>),
 
+    /// Validation error from naga.
+    #[cfg(feature = "unstable-naga")]
+    #[error("naga validation")]
+    NagaValidationError(#[from] naga::WithSpan<naga::valid::ValidationError>),
+
+    /// Error when writing SPIR-V with naga.
+    #[cfg(feature = "unstable-naga")]
+    #[error("naga-spirv")]
+    NagaSpirvError(#[from] naga::back::spv::Error),
+
+    /// Error when writing GLSL with naga.
+    #[cfg(feature = "unstable-naga")]
+    #[error("naga-glsl")]
+    NagaGlslError(#[from] naga::back::glsl::Error),
+
     /// Compilation error from shaderc (glslang).
     #[error("shaderc")]
     ShaderCCompileError(#[from] shaderc::Error),
@@ -15,6 +15,7 @@ pub struct GlslangCompilation {
 
 impl GlslangCompilation {
     /// Tries to compile SPIR-V from the provided shader source.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
     pub fn compile(source: &ShaderSource) -> Result<Self, ShaderCompileError> {
         compile_spirv(source)
     }
@@ -1,9 +1,8 @@
 use crate::error::{SemanticsErrorKind, ShaderCompileError, ShaderReflectError};
 use crate::front::GlslangCompilation;
 use crate::reflect::semantics::{
-    BindingMeta, BindingStage, MemberOffset, PushReflection, ShaderReflection, ShaderSemantics,
-    TextureBinding, TextureSemanticMap, TextureSemantics, TextureSizeMeta, TypeInfo, UboReflection,
-    UniformMemberBlock, UniqueSemanticMap, UniqueSemantics, ValidateTypeSemantics, VariableMeta,
+    BindingMeta, BindingStage, PushReflection, ShaderReflection, ShaderSemantics, TextureSemantics,
+    TypeInfo, UboReflection, UniformMemberBlock, UniqueSemantics, ValidateTypeSemantics,
     MAX_BINDINGS_COUNT, MAX_PUSH_BUFFER_SIZE,
 };
 use crate::reflect::{align_uniform_size, ReflectShader};
@@ -15,7 +14,9 @@ use spirv_cross::{glsl, hlsl, ErrorCode};
 use crate::back::cross::{CrossGlslContext, CrossHlslContext, HlslShaderModel};
 use crate::back::targets::{GLSL, HLSL};
 use crate::back::{CompileShader, ShaderCompilerOutput};
-use crate::reflect::helper::{SemanticErrorBlame, TextureData, UboData};
+use crate::reflect::helper::{
+    reflect_buffer_member, reflect_texture_metas, SemanticErrorBlame, TextureData, UboData,
+};
 
 // This is "probably" OK.
 unsafe impl<T: Send + spirv_cross::spirv::Target> Send for CrossReflect<T> {}
@@ -315,133 +316,16 @@ where
                 _ => return Err(blame.error(SemanticsErrorKind::InvalidResourceType)),
             };
 
-            if let Some(parameter) = semantics.uniform_semantics.get_unique_semantic(&name) {
-                let Some(typeinfo) = parameter.semantics.validate_type(&range_type) else {
-                    return Err(blame.error(SemanticsErrorKind::InvalidTypeForSemantic(name)));
-                };
-
-                match &parameter.semantics {
-                    UniqueSemantics::FloatParameter => {
-                        let offset = range.offset;
-                        if let Some(meta) = meta.parameter_meta.get_mut(&name) {
-                            if let Some(expected) = meta.offset.offset(offset_type)
-                                && expected != offset
-                            {
-                                return Err(ShaderReflectError::MismatchedOffset {
-                                    semantic: name,
-                                    expected,
-                                    received: offset,
-                                    ty: offset_type,
-                                    pass: pass_number
-                                });
-                            }
-                            if meta.size != typeinfo.size {
-                                return Err(ShaderReflectError::MismatchedSize {
-                                    semantic: name,
-                                    vertex: meta.size,
-                                    fragment: typeinfo.size,
-                                    pass: pass_number,
-                                });
-                            }
-
-                            *meta.offset.offset_mut(offset_type) = Some(offset);
-                        } else {
-                            meta.parameter_meta.insert(
-                                name.clone(),
-                                VariableMeta {
-                                    id: name,
-                                    offset: MemberOffset::new(offset, offset_type),
-                                    size: typeinfo.size,
-                                },
-                            );
-                        }
-                    }
-                    semantics => {
-                        let offset = range.offset;
-                        if let Some(meta) = meta.unique_meta.get_mut(semantics) {
-                            if let Some(expected) = meta.offset.offset(offset_type)
-                                && expected != offset
-                            {
-                                return Err(ShaderReflectError::MismatchedOffset {
-                                    semantic: name,
-                                    expected,
-                                    received: offset,
-                                    ty: offset_type,
-                                    pass: pass_number
-                                });
-                            }
-                            if meta.size != typeinfo.size * typeinfo.columns {
-                                return Err(ShaderReflectError::MismatchedSize {
-                                    semantic: name,
-                                    vertex: meta.size,
-                                    fragment: typeinfo.size,
-                                    pass: pass_number,
-                                });
-                            }
-
-                            *meta.offset.offset_mut(offset_type) = Some(offset);
-                        } else {
-                            meta.unique_meta.insert(
-                                *semantics,
-                                VariableMeta {
-                                    id: name,
-                                    offset: MemberOffset::new(offset, offset_type),
-                                    size: typeinfo.size * typeinfo.columns,
-                                },
-                            );
-                        }
-                    }
-                }
-            } else if let Some(texture) = semantics.uniform_semantics.get_texture_semantic(&name) {
-                let Some(_typeinfo) = texture.semantics.validate_type(&range_type) else {
-                    return Err(blame.error(SemanticsErrorKind::InvalidTypeForSemantic(name)));
-                };
-
-                if let TextureSemantics::PassOutput = texture.semantics {
-                    if texture.index >= pass_number {
-                        return Err(ShaderReflectError::NonCausalFilterChain {
-                            pass: pass_number,
-                            target: texture.index,
-                        });
-                    }
-                }
-
-                let offset = range.offset;
-                if let Some(meta) = meta.texture_size_meta.get_mut(&texture) {
-                    if let Some(expected) = meta.offset.offset(offset_type)
-                        && expected != offset
-                    {
-                        return Err(ShaderReflectError::MismatchedOffset {
-                            semantic: name,
-                            expected,
-                            received: offset,
-                            ty: offset_type,
-                            pass: pass_number
-                        });
-                    }
-
-                    meta.stage_mask.insert(match blame {
-                        SemanticErrorBlame::Vertex => BindingStage::VERTEX,
-                        SemanticErrorBlame::Fragment => BindingStage::FRAGMENT,
-                    });
-
-                    *meta.offset.offset_mut(offset_type) = Some(offset);
-                } else {
-                    meta.texture_size_meta.insert(
-                        texture,
-                        TextureSizeMeta {
-                            offset: MemberOffset::new(offset, offset_type),
-                            stage_mask: match blame {
-                                SemanticErrorBlame::Vertex => BindingStage::VERTEX,
-                                SemanticErrorBlame::Fragment => BindingStage::FRAGMENT,
-                            },
-                            id: name,
-                        },
-                    );
-                }
-            } else {
-                return Err(blame.error(SemanticsErrorKind::UnknownSemantics(name)));
-            }
+            reflect_buffer_member(
+                name,
+                &range_type,
+                range.offset,
+                pass_number,
+                semantics,
+                meta,
+                offset_type,
+                blame,
+            )?;
         }
         Ok(())
     }
@@ -503,40 +387,6 @@ where
         }
     }
 
-    fn reflect_texture_metas(
-        &self,
-        texture: TextureData,
-        pass_number: usize,
-        semantics: &ShaderSemantics,
-        meta: &mut BindingMeta,
-    ) -> Result<(), ShaderReflectError> {
-        let Some(semantic) = semantics
-            .texture_semantics
-            .get_texture_semantic(texture.name)
-        else {
-            return Err(
-                SemanticErrorBlame::Fragment.error(SemanticsErrorKind::UnknownSemantics(
-                    texture.name.to_string(),
-                )),
-            );
-        };
-
-        if semantic.semantics == TextureSemantics::PassOutput && semantic.index >= pass_number {
-            return Err(ShaderReflectError::NonCausalFilterChain {
-                pass: pass_number,
-                target: semantic.index,
-            });
-        }
-
-        meta.texture_meta.insert(
-            semantic,
-            TextureBinding {
-                binding: texture.binding,
-            },
-        );
-        Ok(())
-    }
-
     fn reflect_texture<'a>(
         &'a self,
         texture: &'a Resource,
@@ -628,6 +478,7 @@ where
     Ast<T>: spirv_cross::spirv::Compile<T>,
     Ast<T>: spirv_cross::spirv::Parse<T>,
 {
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all, fields(pass = pass_number)))]
     fn reflect(
         &mut self,
         pass_number: usize,
@@ -709,7 +560,7 @@ where
             }
             ubo_bindings |= 1 << texture_data.binding;
 
-            self.reflect_texture_metas(texture_data, pass_number, semantics, &mut meta)?;
+            reflect_texture_metas(texture_data, pass_number, semantics, &mut meta)?;
         }
 
         Ok(ShaderReflection {
@@ -724,6 +575,7 @@ impl CompileShader<GLSL> for CrossReflect<glsl::Target> {
     type Options = glsl::Version;
     type Context = CrossGlslContext;
 
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
     fn compile(
         mut self,
         version: Self::Options,
@@ -857,6 +709,7 @@ impl CompileShader<HLSL> for CrossReflect<hlsl::Target> {
     type Options = Option<HlslShaderModel>;
     type Context = CrossHlslContext;
 
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
     fn compile(
         mut self,
         options: Self::Options,
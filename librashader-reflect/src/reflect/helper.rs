@@ -1,4 +1,9 @@
 use crate::error::{SemanticsErrorKind, ShaderReflectError};
+use crate::reflect::semantics::{
+    BindingMeta, BindingStage, MemberOffset, ShaderSemantics, TextureBinding, TextureSemanticMap,
+    TextureSemantics, TextureSizeMeta, UniformMemberBlock, UniqueSemanticMap, UniqueSemantics,
+    ValidateTypeSemantics, VariableMeta,
+};
 
 pub struct UboData {
     // id: u32,
@@ -30,3 +35,183 @@ impl SemanticErrorBlame {
         }
     }
 }
+
+/// Reflect a single member of a uniform or push constant block against the semantic map.
+///
+/// This is shared between reflection backends, which differ only in how they represent the
+/// type of the member.
+#[allow(clippy::too_many_arguments)]
+pub fn reflect_buffer_member<T>(
+    name: String,
+    ty: &T,
+    offset: usize,
+    pass_number: usize,
+    semantics: &ShaderSemantics,
+    meta: &mut BindingMeta,
+    offset_type: UniformMemberBlock,
+    blame: SemanticErrorBlame,
+) -> Result<(), ShaderReflectError>
+where
+    UniqueSemantics: ValidateTypeSemantics<T>,
+    TextureSemantics: ValidateTypeSemantics<T>,
+{
+    if let Some(parameter) = semantics.uniform_semantics.get_unique_semantic(&name) {
+        let Some(typeinfo) = parameter.semantics.validate_type(ty) else {
+            return Err(blame.error(SemanticsErrorKind::InvalidTypeForSemantic(name)));
+        };
+
+        match &parameter.semantics {
+            UniqueSemantics::FloatParameter => {
+                if let Some(meta) = meta.parameter_meta.get_mut(&name) {
+                    if let Some(expected) = meta.offset.offset(offset_type)
+                        && expected != offset
+                    {
+                        return Err(ShaderReflectError::MismatchedOffset {
+                            semantic: name,
+                            expected,
+                            received: offset,
+                            ty: offset_type,
+                            pass: pass_number
+                        });
+                    }
+                    if meta.size != typeinfo.size {
+                        return Err(ShaderReflectError::MismatchedSize {
+                            semantic: name,
+                            vertex: meta.size,
+                            fragment: typeinfo.size,
+                            pass: pass_number,
+                        });
+                    }
+
+                    *meta.offset.offset_mut(offset_type) = Some(offset);
+                } else {
+                    meta.parameter_meta.insert(
+                        name.clone(),
+                        VariableMeta {
+                            id: name,
+                            offset: MemberOffset::new(offset, offset_type),
+                            size: typeinfo.size,
+                        },
+                    );
+                }
+            }
+            semantics => {
+                if let Some(meta) = meta.unique_meta.get_mut(semantics) {
+                    if let Some(expected) = meta.offset.offset(offset_type)
+                        && expected != offset
+                    {
+                        return Err(ShaderReflectError::MismatchedOffset {
+                            semantic: name,
+                            expected,
+                            received: offset,
+                            ty: offset_type,
+                            pass: pass_number
+                        });
+                    }
+                    if meta.size != typeinfo.size * typeinfo.columns {
+                        return Err(ShaderReflectError::MismatchedSize {
+                            semantic: name,
+                            vertex: meta.size,
+                            fragment: typeinfo.size,
+                            pass: pass_number,
+                        });
+                    }
+
+                    *meta.offset.offset_mut(offset_type) = Some(offset);
+                } else {
+                    meta.unique_meta.insert(
+                        *semantics,
+                        VariableMeta {
+                            id: name,
+                            offset: MemberOffset::new(offset, offset_type),
+                            size: typeinfo.size * typeinfo.columns,
+                        },
+                    );
+                }
+            }
+        }
+    } else if let Some(texture) = semantics.uniform_semantics.get_texture_semantic(&name) {
+        let Some(_typeinfo) = texture.semantics.validate_type(ty) else {
+            return Err(blame.error(SemanticsErrorKind::InvalidTypeForSemantic(name)));
+        };
+
+        if let TextureSemantics::PassOutput = texture.semantics {
+            if texture.index >= pass_number {
+                return Err(ShaderReflectError::NonCausalFilterChain {
+                    pass: pass_number,
+                    target: texture.index,
+                });
+            }
+        }
+
+        if let Some(meta) = meta.texture_size_meta.get_mut(&texture) {
+            if let Some(expected) = meta.offset.offset(offset_type)
+                && expected != offset
+            {
+                return Err(ShaderReflectError::MismatchedOffset {
+                    semantic: name,
+                    expected,
+                    received: offset,
+                    ty: offset_type,
+                    pass: pass_number
+                });
+            }
+
+            meta.stage_mask.insert(match blame {
+                SemanticErrorBlame::Vertex => BindingStage::VERTEX,
+                SemanticErrorBlame::Fragment => BindingStage::FRAGMENT,
+            });
+
+            *meta.offset.offset_mut(offset_type) = Some(offset);
+        } else {
+            meta.texture_size_meta.insert(
+                texture,
+                TextureSizeMeta {
+                    offset: MemberOffset::new(offset, offset_type),
+                    stage_mask: match blame {
+                        SemanticErrorBlame::Vertex => BindingStage::VERTEX,
+                        SemanticErrorBlame::Fragment => BindingStage::FRAGMENT,
+                    },
+                    id: name,
+                },
+            );
+        }
+    } else {
+        return Err(blame.error(SemanticsErrorKind::UnknownSemantics(name)));
+    }
+    Ok(())
+}
+
+/// Reflect a sampled texture against the semantic map.
+pub fn reflect_texture_metas(
+    texture: TextureData,
+    pass_number: usize,
+    semantics: &ShaderSemantics,
+    meta: &mut BindingMeta,
+) -> Result<(), ShaderReflectError> {
+    let Some(semantic) = semantics
+        .texture_semantics
+        .get_texture_semantic(texture.name)
+    else {
+        return Err(
+            SemanticErrorBlame::Fragment.error(SemanticsErrorKind::UnknownSemantics(
+                texture.name.to_string(),
+            )),
+        );
+    };
+
+    if semantic.semantics == TextureSemantics::PassOutput && semantic.index >= pass_number {
+        return Err(ShaderReflectError::NonCausalFilterChain {
+            pass: pass_number,
+            target: semantic.index,
+        });
+    }
+
+    meta.texture_meta.insert(
+        semantic,
+        TextureBinding {
+            binding: texture.binding,
+        },
+    );
+    Ok(())
+}
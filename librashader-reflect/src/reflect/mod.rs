@@ -12,8 +12,9 @@ pub mod presets;
 
 mod helper;
 
+/// Reflection via naga.
 #[cfg(feature = "unstable-naga")]
-mod naga;
+pub mod naga;
 
 /// A trait for compilation outputs that can provide reflection information.
 pub trait ReflectShader {
@@ -1,13 +1,33 @@
-use crate::error::{SemanticsErrorKind, ShaderReflectError};
-use crate::front::GlslangCompilation;
-use crate::front::NagaCompilation;
+use crate::error::{SemanticsErrorKind, ShaderCompileError, ShaderReflectError};
+use crate::front::{GlslangCompilation, NagaCompilation};
+use crate::reflect::helper::{
+    reflect_buffer_member, reflect_texture_metas, SemanticErrorBlame, TextureData, UboData,
+};
+use crate::reflect::semantics::{
+    BindingMeta, BindingStage, PushReflection, ShaderReflection, ShaderSemantics, TextureSemantics,
+    TypeInfo, UboReflection, UniformMemberBlock, UniqueSemantics, ValidateTypeSemantics,
+    MAX_BINDINGS_COUNT, MAX_PUSH_BUFFER_SIZE,
+};
+use crate::reflect::{align_uniform_size, ReflectShader};
+
+use crate::back::cross::GlslVersion;
+use crate::back::naga::NagaGlslContext;
+use crate::back::targets::{GLSL, SPIRV};
+use crate::back::{CompileShader, ShaderCompilerOutput};
 
 use naga::front::spv::Options;
-use naga::{GlobalVariable, Module, StructMember, Type, TypeInner};
-use std::convert::Infallible;
+use naga::valid::{Capabilities, ModuleInfo, ValidationFlags, Validator};
+use naga::{
+    AddressSpace, Binding, Expression, GlobalVariable, Handle, ImageClass, Module, ResourceBinding,
+    ScalarKind, ShaderStage, Type, TypeInner,
+};
+use rustc_hash::FxHashSet;
+
+/// The name of the entry point of both stages of a shader.
+const ENTRY_POINT: &str = "main";
 
 #[derive(Debug)]
-pub struct NagaReflect {
+pub(crate) struct NagaReflect {
     vertex: Module,
     fragment: Module,
 }
@@ -36,75 +56,729 @@ impl TryFrom<&GlslangCompilation> for NagaReflect {
     }
 }
 
-struct UboData {
-    // id: u32,
-    // descriptor_set: u32,
-    binding: u32,
-    size: u32,
+/// Get the scalar kind, vector size and column count of a type.
+fn type_shape(ty: &TypeInner) -> Option<(ScalarKind, u32, u32)> {
+    match *ty {
+        TypeInner::Scalar { kind, .. } => Some((kind, 1, 1)),
+        TypeInner::Vector { kind, size, .. } => Some((kind, size as u32, 1)),
+        TypeInner::Matrix { columns, rows, .. } => {
+            Some((ScalarKind::Float, rows as u32, columns as u32))
+        }
+        _ => None,
+    }
+}
+
+impl ValidateTypeSemantics<TypeInner> for UniqueSemantics {
+    fn validate_type(&self, ty: &TypeInner) -> Option<TypeInfo> {
+        let (kind, vecsize, columns) = type_shape(ty)?;
+
+        let valid = match self {
+            UniqueSemantics::MVP => kind == ScalarKind::Float && vecsize == 4 && columns == 4,
+            UniqueSemantics::FrameCount => kind == ScalarKind::Uint && vecsize == 1 && columns == 1,
+            UniqueSemantics::FrameDirection => {
+                kind == ScalarKind::Sint && vecsize == 1 && columns == 1
+            }
+            UniqueSemantics::FloatParameter => {
+                kind == ScalarKind::Float && vecsize == 1 && columns == 1
+            }
+            _ => kind == ScalarKind::Float && vecsize == 4 && columns == 1,
+        };
+
+        if valid {
+            Some(TypeInfo {
+                size: vecsize,
+                columns,
+            })
+        } else {
+            None
+        }
+    }
+}
+
+impl ValidateTypeSemantics<TypeInner> for TextureSemantics {
+    fn validate_type(&self, ty: &TypeInner) -> Option<TypeInfo> {
+        let (kind, vecsize, columns) = type_shape(ty)?;
+
+        if kind == ScalarKind::Float && vecsize == 4 && columns == 1 {
+            Some(TypeInfo {
+                size: vecsize,
+                columns,
+            })
+        } else {
+            None
+        }
+    }
+}
+
+/// Find the single global variable in the given address space.
+fn find_global(
+    module: &Module,
+    space: AddressSpace,
+    blame: SemanticErrorBlame,
+) -> Result<Option<Handle<GlobalVariable>>, ShaderReflectError> {
+    let mut globals = module
+        .global_variables
+        .iter()
+        .filter(|(_, global)| global.space == space)
+        .map(|(handle, _)| handle);
+
+    let first = globals.next();
+    let count = first.iter().count() + globals.count();
+    if count > 1 {
+        return Err(blame.error(SemanticsErrorKind::InvalidUniformBufferCount(count)));
+    }
+    Ok(first)
 }
 
-struct Ubo {
-    members: Vec<StructMember>,
-    span: u32,
+/// Collect the locations of the varyings bound to an entry point argument or result.
+fn collect_locations(
+    module: &Module,
+    ty: Handle<Type>,
+    binding: Option<&Binding>,
+    locations: &mut Vec<u32>,
+) {
+    match binding {
+        Some(Binding::Location { location, .. }) => locations.push(*location),
+        Some(Binding::BuiltIn(_)) => {}
+        None => {
+            if let TypeInner::Struct { members, .. } = &module.types[ty].inner {
+                for member in members {
+                    collect_locations(module, member.ty, member.binding.as_ref(), locations);
+                }
+            }
+        }
+    }
 }
 
-impl TryFrom<naga::Type> for Ubo {
-    type Error = Infallible;
+/// Get the indices of the members of a global block that are accessed by any function.
+///
+/// This is the equivalent of the active buffer ranges reported by SPIRV-Cross.
+fn used_members(module: &Module, global: Handle<GlobalVariable>) -> FxHashSet<u32> {
+    let mut used = FxHashSet::default();
+    let functions = module
+        .functions
+        .iter()
+        .map(|(_, function)| function)
+        .chain(module.entry_points.iter().map(|entry| &entry.function));
 
-    fn try_from(value: Type) -> Result<Self, Infallible> {
-        match value.inner {
-            TypeInner::Struct { members, span } => Ok(Ubo { members, span }),
-            // todo: make this programmer error
-            _ => panic!(),
+    for function in functions {
+        for (_, expression) in function.expressions.iter() {
+            match *expression {
+                Expression::AccessIndex { base, index } => {
+                    if matches!(function.expressions[base],
+                        Expression::GlobalVariable(handle) if handle == global)
+                    {
+                        used.insert(index);
+                    }
+                }
+                Expression::Load { pointer } => {
+                    if matches!(function.expressions[pointer],
+                        Expression::GlobalVariable(handle) if handle == global)
+                    {
+                        // The whole block is loaded, so every member is used.
+                        let ty = module.global_variables[global].ty;
+                        if let TypeInner::Struct { members, .. } = &module.types[ty].inner {
+                            used.extend(0..members.len() as u32);
+                        }
+                    }
+                }
+                _ => {}
+            }
         }
     }
+    used
 }
 
 impl NagaReflect {
-    // pub fn get_ubo_data(arena: Arena, variable: GlobalVariable, blame: SemanticErrorBlame) -> Result<UboData, ShaderReflectError> {
-    //     let binding = match variable.binding {
-    //         Some(ResourceBinding { group: 0, binding }) => binding,
-    //         Some(ResourceBinding { group, .. }) => return Err(blame.error(SemanticsErrorKind::InvalidDescriptorSet(group))),
-    //         None => return Err(blame.error(SemanticsErrorKind::InvalidDescriptorSet(u32::MAX))),
-    //     };
-    //
-    //     if binding >= MAX_BINDINGS_COUNT {
-    //         return Err(blame.error(SemanticsErrorKind::InvalidBinding(binding)));
-    //     }
-    //
-    //     match variable.ty.as {
-    //         Handle { .. } => {}
-    //     }
-    //     Ok(UboData {
-    //         binding,
-    //
-    //     })
-    // }
-    pub fn reflect_ubos(
-        vertex: GlobalVariable,
-        fragment: GlobalVariable,
-    ) -> Result<(), ShaderReflectError> {
-        match (vertex.binding, fragment.binding) {
-            // todo: should emit for both but whatever
-            (None, None) | (Some(_), None) | (None, Some(_)) => {
-                ShaderReflectError::VertexSemanticError(SemanticsErrorKind::InvalidDescriptorSet(
-                    u32::MAX,
-                ))
+    fn validate(&self) -> Result<(), ShaderReflectError> {
+        for (_, global) in self.vertex.global_variables.iter() {
+            if matches!(
+                global.space,
+                AddressSpace::Storage { .. } | AddressSpace::Handle
+            ) {
+                return Err(ShaderReflectError::VertexSemanticError(
+                    SemanticsErrorKind::InvalidResourceType,
+                ));
             }
-            (Some(_vert), Some(_frag)) => {
-                todo!();
+        }
+
+        for (_, global) in self.fragment.global_variables.iter() {
+            let storage_image = matches!(
+                self.fragment.types[global.ty].inner,
+                TypeInner::Image {
+                    class: ImageClass::Storage { .. },
+                    ..
+                }
+            );
+            if storage_image || matches!(global.space, AddressSpace::Storage { .. }) {
+                return Err(ShaderReflectError::FragmentSemanticError(
+                    SemanticsErrorKind::InvalidResourceType,
+                ));
             }
+        }
+
+        let Some(vertex_entry) = self
+            .vertex
+            .entry_points
+            .iter()
+            .find(|entry| entry.stage == ShaderStage::Vertex)
+        else {
+            return Err(ShaderReflectError::VertexSemanticError(
+                SemanticsErrorKind::InvalidInputCount(0),
+            ));
         };
 
-        todo!();
+        let Some(fragment_entry) = self
+            .fragment
+            .entry_points
+            .iter()
+            .find(|entry| entry.stage == ShaderStage::Fragment)
+        else {
+            return Err(ShaderReflectError::FragmentSemanticError(
+                SemanticsErrorKind::InvalidOutputCount(0),
+            ));
+        };
+
+        let mut vert_inputs = Vec::new();
+        for argument in &vertex_entry.function.arguments {
+            collect_locations(
+                &self.vertex,
+                argument.ty,
+                argument.binding.as_ref(),
+                &mut vert_inputs,
+            );
+        }
+
+        if vert_inputs.len() != 2 {
+            return Err(ShaderReflectError::VertexSemanticError(
+                SemanticsErrorKind::InvalidInputCount(vert_inputs.len()),
+            ));
+        }
+
+        let mut frag_outputs = Vec::new();
+        if let Some(result) = &fragment_entry.function.result {
+            collect_locations(
+                &self.fragment,
+                result.ty,
+                result.binding.as_ref(),
+                &mut frag_outputs,
+            );
+        }
+
+        if frag_outputs.len() != 1 {
+            return Err(ShaderReflectError::FragmentSemanticError(
+                SemanticsErrorKind::InvalidOutputCount(frag_outputs.len()),
+            ));
+        }
+
+        if frag_outputs[0] != 0 {
+            return Err(ShaderReflectError::FragmentSemanticError(
+                SemanticsErrorKind::InvalidLocation(frag_outputs[0]),
+            ));
+        }
+
+        let vert_mask = vert_inputs
+            .iter()
+            .fold(0u32, |mask, location| mask | 1 << location);
+        if vert_mask != 0x3 {
+            return Err(ShaderReflectError::VertexSemanticError(
+                SemanticsErrorKind::InvalidLocation(vert_mask),
+            ));
+        }
+
         Ok(())
     }
+
+    fn get_block_size(
+        module: &Module,
+        global: Handle<GlobalVariable>,
+        blame: SemanticErrorBlame,
+    ) -> Result<u32, ShaderReflectError> {
+        match module.types[module.global_variables[global].ty].inner {
+            TypeInner::Struct { span, .. } => Ok(span),
+            _ => Err(blame.error(SemanticsErrorKind::InvalidResourceType)),
+        }
+    }
+
+    fn get_ubo_data(
+        module: &Module,
+        ubo: Handle<GlobalVariable>,
+        blame: SemanticErrorBlame,
+    ) -> Result<UboData, ShaderReflectError> {
+        let (descriptor_set, binding) = module.global_variables[ubo]
+            .binding
+            .as_ref()
+            .map_or((0, 0), |binding| (binding.group, binding.binding));
+
+        if binding >= MAX_BINDINGS_COUNT {
+            return Err(blame.error(SemanticsErrorKind::InvalidBinding(binding)));
+        }
+        if descriptor_set != 0 {
+            return Err(blame.error(SemanticsErrorKind::InvalidDescriptorSet(descriptor_set)));
+        }
+
+        let size = Self::get_block_size(module, ubo, blame)?;
+        Ok(UboData { binding, size })
+    }
+
+    fn get_push_size(
+        module: &Module,
+        push: Handle<GlobalVariable>,
+        blame: SemanticErrorBlame,
+    ) -> Result<u32, ShaderReflectError> {
+        let size = Self::get_block_size(module, push, blame)?;
+        if size > MAX_PUSH_BUFFER_SIZE {
+            return Err(blame.error(SemanticsErrorKind::InvalidPushBufferSize(size)));
+        }
+        Ok(size)
+    }
+
+    fn reflect_buffer_range_metas(
+        module: &Module,
+        global: Handle<GlobalVariable>,
+        pass_number: usize,
+        semantics: &ShaderSemantics,
+        meta: &mut BindingMeta,
+        offset_type: UniformMemberBlock,
+        blame: SemanticErrorBlame,
+    ) -> Result<(), ShaderReflectError> {
+        let TypeInner::Struct { members, .. } =
+            &module.types[module.global_variables[global].ty].inner
+        else {
+            return Err(blame.error(SemanticsErrorKind::InvalidResourceType));
+        };
+
+        let used = used_members(module, global);
+        for (index, member) in members.iter().enumerate() {
+            if !used.contains(&(index as u32)) {
+                continue;
+            }
+
+            let name = member.name.clone().unwrap_or_default();
+            reflect_buffer_member(
+                name,
+                &module.types[member.ty].inner,
+                member.offset as usize,
+                pass_number,
+                semantics,
+                meta,
+                offset_type,
+                blame,
+            )?;
+        }
+        Ok(())
+    }
+
+    fn reflect_ubos(
+        &mut self,
+        vertex_ubo: Option<Handle<GlobalVariable>>,
+        fragment_ubo: Option<Handle<GlobalVariable>>,
+    ) -> Result<Option<UboReflection>, ShaderReflectError> {
+        // The UBO is always bound at binding 0, in the descriptor set it was declared in.
+        for (module, ubo) in [
+            (&mut self.vertex, vertex_ubo),
+            (&mut self.fragment, fragment_ubo),
+        ] {
+            if let Some(ubo) = ubo {
+                let global = module.global_variables.get_mut(ubo);
+                let group = global.binding.as_ref().map_or(0, |binding| binding.group);
+                global.binding = Some(ResourceBinding { group, binding: 0 });
+            }
+        }
+
+        let vertex_ubo = vertex_ubo
+            .map(|ubo| Self::get_ubo_data(&self.vertex, ubo, SemanticErrorBlame::Vertex))
+            .transpose()?;
+        let fragment_ubo = fragment_ubo
+            .map(|ubo| Self::get_ubo_data(&self.fragment, ubo, SemanticErrorBlame::Fragment))
+            .transpose()?;
+
+        match (vertex_ubo, fragment_ubo) {
+            (None, None) => Ok(None),
+            (Some(vertex_ubo), Some(fragment_ubo)) => {
+                if vertex_ubo.binding != fragment_ubo.binding {
+                    return Err(ShaderReflectError::MismatchedUniformBuffer {
+                        vertex: vertex_ubo.binding,
+                        fragment: fragment_ubo.binding,
+                    });
+                }
+
+                let size = std::cmp::max(vertex_ubo.size, fragment_ubo.size);
+                Ok(Some(UboReflection {
+                    binding: vertex_ubo.binding,
+                    size: align_uniform_size(size),
+                    stage_mask: BindingStage::VERTEX | BindingStage::FRAGMENT,
+                }))
+            }
+            (Some(vertex_ubo), None) => Ok(Some(UboReflection {
+                binding: vertex_ubo.binding,
+                size: align_uniform_size(vertex_ubo.size),
+                stage_mask: BindingStage::VERTEX,
+            })),
+            (None, Some(fragment_ubo)) => Ok(Some(UboReflection {
+                binding: fragment_ubo.binding,
+                size: align_uniform_size(fragment_ubo.size),
+                stage_mask: BindingStage::FRAGMENT,
+            })),
+        }
+    }
+
+    fn reflect_push_constant_buffer(
+        &self,
+        vertex_pcb: Option<Handle<GlobalVariable>>,
+        fragment_pcb: Option<Handle<GlobalVariable>>,
+    ) -> Result<Option<PushReflection>, ShaderReflectError> {
+        let vertex_size = vertex_pcb
+            .map(|push| Self::get_push_size(&self.vertex, push, SemanticErrorBlame::Vertex))
+            .transpose()?;
+        let fragment_size = fragment_pcb
+            .map(|push| Self::get_push_size(&self.fragment, push, SemanticErrorBlame::Fragment))
+            .transpose()?;
+
+        let (size, stage_mask) = match (vertex_size, fragment_size) {
+            (None, None) => return Ok(None),
+            (Some(vertex_size), Some(fragment_size)) => (
+                std::cmp::max(vertex_size, fragment_size),
+                BindingStage::VERTEX | BindingStage::FRAGMENT,
+            ),
+            (Some(vertex_size), None) => (vertex_size, BindingStage::VERTEX),
+            (None, Some(fragment_size)) => (fragment_size, BindingStage::FRAGMENT),
+        };
+
+        Ok(Some(PushReflection {
+            size: align_uniform_size(size),
+            stage_mask,
+        }))
+    }
+
+    fn reflect_texture(global: &GlobalVariable) -> Result<TextureData, ShaderReflectError> {
+        let (descriptor_set, binding) = global
+            .binding
+            .as_ref()
+            .map_or((0, 0), |binding| (binding.group, binding.binding));
+
+        if descriptor_set != 0 {
+            return Err(ShaderReflectError::FragmentSemanticError(
+                SemanticsErrorKind::InvalidDescriptorSet(descriptor_set),
+            ));
+        }
+        if binding >= MAX_BINDINGS_COUNT {
+            return Err(ShaderReflectError::FragmentSemanticError(
+                SemanticsErrorKind::InvalidBinding(binding),
+            ));
+        }
+
+        Ok(TextureData {
+            name: global.name.as_deref().unwrap_or_default(),
+            binding,
+        })
+    }
+}
+
+impl ReflectShader for NagaReflect {
+    fn reflect(
+        &mut self,
+        pass_number: usize,
+        semantics: &ShaderSemantics,
+    ) -> Result<ShaderReflection, ShaderReflectError> {
+        self.validate()?;
+
+        let vertex_ubo = find_global(
+            &self.vertex,
+            AddressSpace::Uniform,
+            SemanticErrorBlame::Vertex,
+        )?;
+        let fragment_ubo = find_global(
+            &self.fragment,
+            AddressSpace::Uniform,
+            SemanticErrorBlame::Fragment,
+        )?;
+
+        let ubo = self.reflect_ubos(vertex_ubo, fragment_ubo)?;
+
+        let vertex_push = find_global(
+            &self.vertex,
+            AddressSpace::PushConstant,
+            SemanticErrorBlame::Vertex,
+        )?;
+        let fragment_push = find_global(
+            &self.fragment,
+            AddressSpace::PushConstant,
+            SemanticErrorBlame::Fragment,
+        )?;
+
+        let push_constant = self.reflect_push_constant_buffer(vertex_push, fragment_push)?;
+
+        let mut meta = BindingMeta::default();
+
+        for (module, global, offset_type, blame) in [
+            (
+                &self.vertex,
+                vertex_ubo,
+                UniformMemberBlock::Ubo,
+                SemanticErrorBlame::Vertex,
+            ),
+            (
+                &self.fragment,
+                fragment_ubo,
+                UniformMemberBlock::Ubo,
+                SemanticErrorBlame::Fragment,
+            ),
+            (
+                &self.vertex,
+                vertex_push,
+                UniformMemberBlock::PushConstant,
+                SemanticErrorBlame::Vertex,
+            ),
+            (
+                &self.fragment,
+                fragment_push,
+                UniformMemberBlock::PushConstant,
+                SemanticErrorBlame::Fragment,
+            ),
+        ] {
+            if let Some(global) = global {
+                Self::reflect_buffer_range_metas(
+                    module,
+                    global,
+                    pass_number,
+                    semantics,
+                    &mut meta,
+                    offset_type,
+                    blame,
+                )?;
+            }
+        }
+
+        let mut ubo_bindings = 0u16;
+        if let Some(ubo) = &ubo {
+            ubo_bindings = 1 << ubo.binding;
+        }
+
+        // Samplers share the binding of the image they are combined with, only
+        // images are reflected.
+        for (_, global) in self.fragment.global_variables.iter() {
+            if !matches!(
+                self.fragment.types[global.ty].inner,
+                TypeInner::Image { .. }
+            ) {
+                continue;
+            }
+
+            let texture_data = Self::reflect_texture(global)?;
+            if ubo_bindings & (1 << texture_data.binding) != 0 {
+                return Err(ShaderReflectError::BindingInUse(texture_data.binding));
+            }
+            ubo_bindings |= 1 << texture_data.binding;
+
+            reflect_texture_metas(texture_data, pass_number, semantics, &mut meta)?;
+        }
+
+        Ok(ShaderReflection {
+            ubo,
+            push_constant,
+            meta,
+        })
+    }
+}
+
+fn validate_module(module: &Module) -> Result<ModuleInfo, ShaderCompileError> {
+    let mut validator = Validator::new(ValidationFlags::all(), Capabilities::all());
+    Ok(validator.validate(module)?)
+}
+
+fn write_spirv(module: &Module, stage: ShaderStage) -> Result<Vec<u32>, ShaderCompileError> {
+    let info = validate_module(module)?;
+    let options = naga::back::spv::Options {
+        lang_version: (1, 0),
+        // Do not flip the Y coordinate, shaders are written for Vulkan already.
+        flags: naga::back::spv::WriterFlags::empty(),
+        ..Default::default()
+    };
+    let pipeline = naga::back::spv::PipelineOptions {
+        shader_stage: stage,
+        entry_point: ENTRY_POINT.to_string(),
+    };
+
+    Ok(naga::back::spv::write_vec(
+        module,
+        &info,
+        &options,
+        Some(&pipeline),
+    )?)
+}
+
+impl CompileShader<SPIRV> for NagaReflect {
+    type Options = Option<()>;
+    type Context = ();
+
+    fn compile(
+        self,
+        _options: Self::Options,
+    ) -> Result<ShaderCompilerOutput<Vec<u32>, Self::Context>, ShaderCompileError> {
+        Ok(ShaderCompilerOutput {
+            vertex: write_spirv(&self.vertex, ShaderStage::Vertex)?,
+            fragment: write_spirv(&self.fragment, ShaderStage::Fragment)?,
+            context: (),
+        })
+    }
+}
+
+fn glsl_version(version: GlslVersion) -> Result<naga::back::glsl::Version, ShaderCompileError> {
+    let version = match version {
+        GlslVersion::V1_10 => 110,
+        GlslVersion::V1_20 => 120,
+        GlslVersion::V1_30 => 130,
+        GlslVersion::V1_40 => 140,
+        GlslVersion::V1_50 => 150,
+        GlslVersion::V3_30 => 330,
+        GlslVersion::V4_00 => 400,
+        GlslVersion::V4_10 => 410,
+        GlslVersion::V4_20 => 420,
+        GlslVersion::V4_30 => 430,
+        GlslVersion::V4_40 => 440,
+        GlslVersion::V4_50 => 450,
+        GlslVersion::V4_60 => 460,
+        _ => return Err(naga::back::glsl::Error::VersionNotSupported.into()),
+    };
+    Ok(naga::back::glsl::Version::Desktop(version))
+}
+
+/// The GLSL output of a single stage, with the names of the uniform blocks and samplers fixed
+/// up to what the OpenGL runtime expects.
+struct GlslStage {
+    source: String,
+    sampler_bindings: Vec<(String, u32)>,
 }
+
+fn write_glsl(
+    mut module: Module,
+    stage: ShaderStage,
+    version: naga::back::glsl::Version,
+) -> Result<GlslStage, ShaderCompileError> {
+    let (ubo_name, push_name, stage_name) = match stage {
+        ShaderStage::Vertex => ("LIBRA_UBO_VERTEX", "LIBRA_PUSH_VERTEX_INSTANCE", "vs"),
+        _ => ("LIBRA_UBO_FRAGMENT", "LIBRA_PUSH_FRAGMENT_INSTANCE", "fs"),
+    };
+
+    // Push constants are emulated with plain uniforms, which are named after the global.
+    for (_, global) in module.global_variables.iter_mut() {
+        if global.space == AddressSpace::PushConstant {
+            global.name = Some(push_name.to_string());
+        }
+    }
+
+    let info = validate_module(&module)?;
+    let options = naga::back::glsl::Options {
+        version,
+        writer_flags: naga::back::glsl::WriterFlags::empty(),
+        binding_map: Default::default(),
+    };
+    let pipeline = naga::back::glsl::PipelineOptions {
+        shader_stage: stage,
+        entry_point: ENTRY_POINT.to_string(),
+        multiview: None,
+    };
+
+    let mut source = String::new();
+    let reflection = naga::back::glsl::Writer::new(
+        &mut source,
+        &module,
+        &info,
+        &options,
+        &pipeline,
+        Default::default(),
+    )?
+    .write()?;
+
+    // naga names uniform blocks and their instances after their binding, rename them
+    // to what the runtime looks up.
+    for (handle, block_name) in &reflection.uniforms {
+        let global = &module.global_variables[*handle];
+        if global.space != AddressSpace::Uniform {
+            continue;
+        }
+
+        if let Some(binding) = &global.binding {
+            let instance = format!(
+                "_group_{}_binding_{}_{stage_name}",
+                binding.group, binding.binding
+            );
+            source = source.replace(&instance, &format!("{ubo_name}_INSTANCE"));
+        }
+        source = source.replace(block_name.as_str(), ubo_name);
+    }
+
+    let sampler_bindings = reflection
+        .texture_mapping
+        .iter()
+        .map(|(name, mapping)| {
+            let binding = module.global_variables[mapping.texture]
+                .binding
+                .as_ref()
+                .map_or(0, |binding| binding.binding);
+            (format!("{name}\0"), binding)
+        })
+        .collect();
+
+    Ok(GlslStage {
+        source,
+        sampler_bindings,
+    })
+}
+
+impl CompileShader<GLSL> for NagaReflect {
+    type Options = GlslVersion;
+    type Context = NagaGlslContext;
+
+    fn compile(
+        self,
+        version: Self::Options,
+    ) -> Result<ShaderCompilerOutput<String, Self::Context>, ShaderCompileError> {
+        let version = glsl_version(version)?;
+        let vertex = write_glsl(self.vertex, ShaderStage::Vertex, version)?;
+        let fragment = write_glsl(self.fragment, ShaderStage::Fragment, version)?;
+
+        Ok(ShaderCompilerOutput {
+            vertex: vertex.source,
+            fragment: fragment.source,
+            context: NagaGlslContext {
+                sampler_bindings: fragment.sampler_bindings,
+            },
+        })
+    }
+}
+
 #[cfg(test)]
 mod test {
+    use crate::back::targets::SPIRV;
+    use crate::back::{CompileShader, FromCompilation};
+    use crate::front::{GlslangCompilation, NagaCompilation};
+    use crate::reflect::naga::NagaReflect;
+    use crate::reflect::semantics::{Semantic, ShaderSemantics, UniformSemantic, UniqueSemantics};
+    use crate::reflect::ReflectShader;
     use librashader_preprocess::ShaderSource;
     use rspirv::dr::Instruction;
     use rspirv::spirv::Op;
+    use rustc_hash::FxHashMap;
+
+    fn parameter_semantics(source: &ShaderSource) -> ShaderSemantics {
+        let mut uniform_semantics: FxHashMap<String, UniformSemantic> = Default::default();
+        for param in source.parameters.values() {
+            uniform_semantics.insert(
+                param.id.clone(),
+                UniformSemantic::Unique(Semantic {
+                    semantics: UniqueSemantics::FloatParameter,
+                    index: (),
+                }),
+            );
+        }
+
+        ShaderSemantics {
+            uniform_semantics,
+            texture_semantics: Default::default(),
+        }
+    }
 
     #[test]
     pub fn test_into() {
@@ -123,4 +797,47 @@ mod test {
 
         println!("{outputs:#?}");
     }
+
+    #[test]
+    pub fn reflect_matches_cross() {
+        let result = ShaderSource::load("../test/basic.slang").unwrap();
+        let semantics = parameter_semantics(&result);
+
+        let glslang = GlslangCompilation::compile(&result).unwrap();
+        let mut cross = SPIRV::from_compilation(glslang).unwrap();
+        let cross = cross.reflect(0, &semantics).unwrap();
+
+        let naga = NagaCompilation::try_from(&result).unwrap();
+        let mut naga = NagaReflect::try_from(naga).unwrap();
+        let reflection = naga.reflect(0, &semantics).unwrap();
+
+        assert_eq!(
+            cross.ubo.map(|ubo| (ubo.binding, ubo.size)),
+            reflection.ubo.map(|ubo| (ubo.binding, ubo.size))
+        );
+        assert_eq!(
+            cross.push_constant.map(|push| push.size),
+            reflection.push_constant.map(|push| push.size)
+        );
+        for (name, meta) in &cross.meta.parameter_meta {
+            assert_eq!(
+                Some(meta.offset),
+                reflection.meta.parameter_meta.get(name).map(|m| m.offset)
+            );
+        }
+    }
+
+    #[test]
+    pub fn compile_spirv() {
+        let result = ShaderSource::load("../test/basic.slang").unwrap();
+        let semantics = parameter_semantics(&result);
+
+        let naga = NagaCompilation::try_from(&result).unwrap();
+        let mut naga = SPIRV::from_compilation(naga).unwrap();
+        naga.reflect(0, &semantics).unwrap();
+        let compiled = naga.compile(None).unwrap();
+
+        let mut loader = rspirv::dr::Loader::new();
+        rspirv::binary::parse_words(&compiled.fragment, &mut loader).unwrap();
+    }
 }
@@ -1,14 +1,19 @@
-use crate::back::targets::OutputTarget;
+use crate::back::targets::{OutputTarget, SPIRV};
 use crate::back::{CompilerBackend, FromCompilation};
 use crate::error::{ShaderCompileError, ShaderReflectError};
 use crate::front::ShaderCompilation;
 use crate::reflect::semantics::{
     Semantic, ShaderSemantics, TextureSemantics, UniformSemantic, UniqueSemantics,
 };
+use crate::reflect::{ReflectShader, ShaderReflection};
 use librashader_preprocess::{PreprocessError, ShaderSource};
 use librashader_presets::{ShaderPassConfig, TextureConfig};
+use rayon::prelude::*;
 use rustc_hash::FxHashMap;
 
+#[cfg(feature = "serialize")]
+use serde::{Deserialize, Serialize};
+
 /// Artifacts of a reflected and compiled shader pass.
 ///
 /// The [`CompileReflectShader`](crate::back::CompileReflectShader) trait allows you to name
@@ -28,6 +33,19 @@ use rustc_hash::FxHashMap;
 /// This allows a runtime to not name the backing type of the compiled artifact if not necessary.
 pub type ShaderPassArtifact<T> = (ShaderPassConfig, ShaderSource, CompilerBackend<T>);
 
+/// A preprocessed shader pass that has not yet been compiled.
+pub type ShaderPassSource = (ShaderPassConfig, ShaderSource);
+
+/// Reflection information for every pass of a shader preset.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
+#[derive(Debug)]
+pub struct PresetReflection {
+    /// The reflection information of each pass, in the order of the passes in the preset.
+    pub passes: Vec<ShaderReflection>,
+    /// The semantics available to the passes of the preset.
+    pub semantics: ShaderSemantics,
+}
+
 impl<T: OutputTarget> CompilePresetTarget for T {}
 
 /// Trait for target shading languages that can compile output with
@@ -55,6 +73,86 @@ pub trait CompilePresetTarget: OutputTarget {
     {
         compile_preset_passes::<Self, C, E>(passes, textures)
     }
+
+    /// Compile a single pass that was preprocessed with [`preprocess_preset_passes`].
+    ///
+    /// This allows a runtime to defer compilation of a pass until it is needed.
+    fn compile_preset_pass<C, E>(
+        pass: ShaderPassSource,
+    ) -> Result<ShaderPassArtifact<<Self as FromCompilation<C>>::Output>, E>
+    where
+        Self: Sized,
+        Self: FromCompilation<C>,
+        C: ShaderCompilation,
+        E: From<ShaderReflectError>,
+        E: From<ShaderCompileError>,
+    {
+        compile_preset_pass::<Self, C, E>(pass)
+    }
+}
+
+/// Preprocess the passes of a shader preset and collect the semantics available
+/// to them, without compiling any pass.
+///
+/// Shader sources are loaded in parallel.
+pub fn preprocess_preset_passes<E>(
+    passes: Vec<ShaderPassConfig>,
+    textures: &[TextureConfig],
+) -> Result<(Vec<ShaderPassSource>, ShaderSemantics), E>
+where
+    E: From<PreprocessError>,
+{
+    let mut uniform_semantics: FxHashMap<String, UniformSemantic> = Default::default();
+    let mut texture_semantics: FxHashMap<String, Semantic<TextureSemantics>> = Default::default();
+
+    let passes = passes
+        .into_par_iter()
+        .map(|shader| {
+            let source: ShaderSource = ShaderSource::load(&shader.name)?;
+            Ok::<_, PreprocessError>((shader, source))
+        })
+        .collect::<Result<Vec<ShaderPassSource>, PreprocessError>>()?;
+
+    for (_, source) in &passes {
+        for parameter in source.parameters.values() {
+            uniform_semantics.insert(
+                parameter.id.clone(),
+                UniformSemantic::Unique(Semantic {
+                    semantics: UniqueSemantics::FloatParameter,
+                    index: (),
+                }),
+            );
+        }
+    }
+
+    for details in &passes {
+        insert_pass_semantics(&mut uniform_semantics, &mut texture_semantics, &details.0)
+    }
+    insert_lut_semantics(textures, &mut uniform_semantics, &mut texture_semantics);
+
+    let semantics = ShaderSemantics {
+        uniform_semantics,
+        texture_semantics,
+    };
+
+    Ok((passes, semantics))
+}
+
+/// Compile a single preprocessed pass given the applicable
+/// shader output target, compilation type, and resulting error.
+fn compile_preset_pass<T, C, E>(
+    (shader, source): ShaderPassSource,
+) -> Result<ShaderPassArtifact<<T as FromCompilation<C>>::Output>, E>
+where
+    T: OutputTarget,
+    T: FromCompilation<C>,
+    C: ShaderCompilation,
+    E: From<ShaderReflectError>,
+    E: From<ShaderCompileError>,
+{
+    let compiled = C::compile(&source)?;
+    let reflect = T::from_compilation(compiled)?;
+    Ok((shader, source, reflect))
 }
 
 /// Compile passes of a shader preset given the applicable
@@ -77,41 +175,44 @@ where
     E: From<ShaderReflectError>,
     E: From<ShaderCompileError>,
 {
-    let mut uniform_semantics: FxHashMap<String, UniformSemantic> = Default::default();
-    let mut texture_semantics: FxHashMap<String, Semantic<TextureSemantics>> = Default::default();
-
+    let (passes, semantics) = preprocess_preset_passes::<E>(passes, textures)?;
     let passes = passes
         .into_iter()
-        .map(|shader| {
-            let source: ShaderSource = ShaderSource::load(&shader.name)?;
+        .map(compile_preset_pass::<T, C, E>)
+        .collect::<Result<Vec<_>, E>>()?;
+
+    Ok((passes, semantics))
+}
 
+/// Reflect the passes of a shader preset without generating code for any output target.
+///
+/// Passes are preprocessed, compiled to SPIR-V and reflected in parallel. No shader is
+/// cross-compiled, so this is suitable for tools that only need the uniform layout and bindings
+/// of a preset, such as validators or parameter editors.
+pub fn reflect_preset_passes<C, E>(
+    passes: Vec<ShaderPassConfig>,
+    textures: &[TextureConfig],
+) -> Result<PresetReflection, E>
+where
+    SPIRV: FromCompilation<C>,
+    C: ShaderCompilation,
+    E: From<PreprocessError>,
+    E: From<ShaderReflectError>,
+    E: From<ShaderCompileError>,
+    E: Send,
+{
+    let (passes, semantics) = preprocess_preset_passes::<E>(passes, textures)?;
+    let passes = passes
+        .into_par_iter()
+        .enumerate()
+        .map(|(index, (_, source))| {
             let compiled = C::compile(&source)?;
-            let reflect = T::from_compilation(compiled)?;
-
-            for parameter in source.parameters.values() {
-                uniform_semantics.insert(
-                    parameter.id.clone(),
-                    UniformSemantic::Unique(Semantic {
-                        semantics: UniqueSemantics::FloatParameter,
-                        index: (),
-                    }),
-                );
-            }
-            Ok::<_, E>((shader, source, reflect))
+            let mut reflect = SPIRV::from_compilation(compiled)?;
+            Ok(reflect.reflect(index, &semantics)?)
         })
-        .collect::<Result<Vec<(ShaderPassConfig, ShaderSource, CompilerBackend<_>)>, E>>()?;
+        .collect::<Result<Vec<ShaderReflection>, E>>()?;
 
-    for details in &passes {
-        insert_pass_semantics(&mut uniform_semantics, &mut texture_semantics, &details.0)
-    }
-    insert_lut_semantics(textures, &mut uniform_semantics, &mut texture_semantics);
-
-    let semantics = ShaderSemantics {
-        uniform_semantics,
-        texture_semantics,
-    };
-
-    Ok((passes, semantics))
+    Ok(PresetReflection { passes, semantics })
 }
 
 /// Insert the available semantics for the input pass config into the provided semantic maps.
@@ -188,3 +289,102 @@ fn insert_lut_semantics(
         );
     }
 }
+
+#[cfg(all(test, feature = "serialize"))]
+mod test {
+    use crate::error::{ShaderCompileError, ShaderReflectError};
+    use crate::front::GlslangCompilation;
+    use crate::reflect::presets::{reflect_preset_passes, PresetReflection};
+    use crate::reflect::semantics::{
+        BindingMeta, Semantic, ShaderReflection, TextureSemantics, UniqueSemantics,
+    };
+    use librashader_preprocess::PreprocessError;
+    use librashader_presets::ShaderPreset;
+
+    #[derive(Debug, thiserror::Error)]
+    enum TestError {
+        #[error(transparent)]
+        Preprocess(#[from] PreprocessError),
+        #[error(transparent)]
+        Compile(#[from] ShaderCompileError),
+        #[error(transparent)]
+        Reflect(#[from] ShaderReflectError),
+    }
+
+    /// Where each uniform and texture of a pass is bound, in a stable order.
+    fn bindings(reflection: &ShaderReflection) -> String {
+        let BindingMeta {
+            parameter_meta,
+            unique_meta,
+            texture_meta,
+            ..
+        } = &reflection.meta;
+
+        let mut parameters: Vec<_> = parameter_meta
+            .iter()
+            .map(|(name, meta)| (name.clone(), meta.offset, meta.size))
+            .collect();
+        parameters.sort_by(|a, b| a.0.cmp(&b.0));
+
+        let mut uniques: Vec<(UniqueSemantics, _, _)> = unique_meta
+            .iter()
+            .map(|(semantic, meta)| (*semantic, meta.offset, meta.size))
+            .collect();
+        uniques.sort_by_key(|unique| unique.0);
+
+        let mut textures: Vec<(TextureSemantics, usize, u32)> = texture_meta
+            .iter()
+            .map(|(Semantic { semantics, index }, texture)| (*semantics, *index, texture.binding))
+            .collect();
+        textures.sort();
+
+        format!(
+            "ubo {:?} push {:?} parameters {parameters:?} uniques {uniques:?} textures {textures:?}",
+            reflection.ubo.as_ref().map(|ubo| (ubo.binding, ubo.size)),
+            reflection.push_constant.as_ref().map(|push| push.size),
+        )
+    }
+
+    #[test]
+    pub fn reflect_preset_round_trip() {
+        let preset = ShaderPreset::try_parse("../test/basic.slangp").unwrap();
+        let reflection = reflect_preset_passes::<GlslangCompilation, TestError>(
+            preset.shaders,
+            &preset.textures,
+        )
+        .unwrap();
+
+        assert_eq!(reflection.passes.len(), 2);
+        for pass in &reflection.passes {
+            assert!(pass.ubo.is_some());
+            assert!(pass.push_constant.is_some());
+            assert!(pass.meta.parameter_meta.contains_key("ColorMod"));
+            assert!(pass.meta.unique_meta.contains_key(&UniqueSemantics::MVP));
+            assert_eq!(
+                pass.meta
+                    .texture_meta
+                    .get(&Semantic {
+                        semantics: TextureSemantics::Source,
+                        index: 0
+                    })
+                    .map(|texture| texture.binding),
+                Some(1)
+            );
+        }
+
+        let json = serde_json::to_string(&reflection).unwrap();
+        let parsed: PresetReflection = serde_json::from_str(&json).unwrap();
+
+        assert_eq!(parsed.passes.len(), reflection.passes.len());
+        for (parsed, reflected) in parsed.passes.iter().zip(&reflection.passes) {
+            assert_eq!(bindings(parsed), bindings(reflected));
+        }
+
+        let mut parsed_semantics: Vec<_> = parsed.semantics.uniform_semantics.keys().collect();
+        let mut reflected_semantics: Vec<_> =
+            reflection.semantics.uniform_semantics.keys().collect();
+        parsed_semantics.sort();
+        reflected_semantics.sort();
+        assert_eq!(parsed_semantics, reflected_semantics);
+    }
+}
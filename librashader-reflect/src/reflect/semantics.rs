@@ -2,6 +2,9 @@ use bitflags::bitflags;
 use rustc_hash::FxHashMap;
 use std::str::FromStr;
 
+#[cfg(feature = "serialize")]
+use serde::{Deserialize, Serialize};
+
 /// The maximum number of bindings allowed in a shader.
 pub const MAX_BINDINGS_COUNT: u32 = 16;
 /// The maximum size of the push constant range.
@@ -24,6 +27,7 @@ pub enum UniformType {
 
 /// Unique semantics are builtin uniforms passed by the shader runtime
 /// that are always available.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug, Ord, PartialOrd, Eq, PartialEq, Copy, Clone, Hash)]
 #[repr(i32)]
 pub enum UniqueSemantics {
@@ -72,6 +76,7 @@ impl UniqueSemantics {
 /// Texture semantics relate to input or output textures.
 ///
 /// Texture semantics are used to relate both texture samplers and `*Size` uniforms.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug, Ord, PartialOrd, Eq, PartialEq, Copy, Clone, Hash)]
 #[repr(i32)]
 pub enum TextureSemantics {
@@ -152,6 +157,7 @@ pub(crate) trait ValidateTypeSemantics<T> {
 }
 
 /// A unit of unique or indexed semantic.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 pub struct Semantic<T, I = usize> {
     /// The semantics of this unit.
@@ -162,6 +168,7 @@ pub struct Semantic<T, I = usize> {
 
 bitflags! {
     /// The pipeline stage for which a uniform is bound.
+    #[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
     pub struct BindingStage: u8 {
         const NONE = 0b00000000;
         const VERTEX = 0b00000001;
@@ -170,6 +177,7 @@ bitflags! {
 }
 
 /// Reflection information for the Uniform Buffer
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug)]
 pub struct UboReflection {
     /// The binding point for this UBO.
@@ -181,6 +189,7 @@ pub struct UboReflection {
 }
 
 /// Reflection information for the Push Constant Block
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug)]
 pub struct PushReflection {
     /// The size of the Push Constant range. The size returned by reflection is always aligned to a 16 byte boundary.
@@ -192,6 +201,7 @@ pub struct PushReflection {
 /// The offset of a uniform member.
 ///
 /// A uniform can be bound to both the UBO, or as a Push Constant.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug, Copy, Clone, PartialEq, Eq)]
 pub struct MemberOffset {
     /// The offset of the uniform member within the UBO.
@@ -245,6 +255,7 @@ impl MemberOffset {
 }
 
 /// Reflection information about a non-texture related uniform variable.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug)]
 pub struct VariableMeta {
     // this might bite us in the back because retroarch keeps separate UBO/push offsets.. eh
@@ -257,6 +268,7 @@ pub struct VariableMeta {
 }
 
 /// Reflection information about a texture size uniform variable.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug)]
 pub struct TextureSizeMeta {
     // this might bite us in the back because retroarch keeps separate UBO/push offsets..
@@ -269,6 +281,7 @@ pub struct TextureSizeMeta {
 }
 
 /// Reflection information about texture samplers.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug)]
 pub struct TextureBinding {
     /// The binding index of the texture.
@@ -276,6 +289,7 @@ pub struct TextureBinding {
 }
 
 /// Reflection information about a shader.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug)]
 pub struct ShaderReflection {
     /// Reflection information about the UBO for this shader.
@@ -422,6 +436,7 @@ impl UniqueSemanticMap for FxHashMap<String, UniformSemantic> {
 }
 
 /// Semantic assignment of a shader uniform to filter chain semantics.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug, Clone)]
 pub enum UniformSemantic {
     /// A unique semantic.
@@ -431,6 +446,7 @@ pub enum UniformSemantic {
 }
 
 /// The runtime provided maps of uniform and texture variables to filter chain semantics.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug, Clone)]
 pub struct ShaderSemantics {
     /// A map of uniform names to filter chain semantics.
@@ -466,6 +482,7 @@ impl From<Semantic<TextureSemantics>> for UniformBinding {
 }
 
 /// Reflection metadata about the various bindings for this shader.
+#[cfg_attr(feature = "serialize", derive(Serialize, Deserialize))]
 #[derive(Debug, Default)]
 pub struct BindingMeta {
     /// A map of parameter names to uniform binding metadata.
@@ -473,7 +490,40 @@ pub struct BindingMeta {
     /// A map of unique semantics to uniform binding metadata.
     pub unique_meta: FxHashMap<UniqueSemantics, VariableMeta>,
     /// A map of texture semantics to texture binding points.
+    #[cfg_attr(feature = "serialize", serde(with = "texture_semantic_map"))]
     pub texture_meta: FxHashMap<Semantic<TextureSemantics>, TextureBinding>,
     /// A map of texture semantics to texture size uniform binding metadata.
+    #[cfg_attr(feature = "serialize", serde(with = "texture_semantic_map"))]
     pub texture_size_meta: FxHashMap<Semantic<TextureSemantics>, TextureSizeMeta>,
 }
+
+/// Maps keyed by texture semantics are serialized as a list of entries, since
+/// formats like JSON only allow string keys.
+#[cfg(feature = "serialize")]
+mod texture_semantic_map {
+    use super::{Semantic, TextureSemantics};
+    use rustc_hash::FxHashMap;
+    use serde::{Deserialize, Deserializer, Serialize, Serializer};
+
+    pub fn serialize<S, V>(
+        map: &FxHashMap<Semantic<TextureSemantics>, V>,
+        serializer: S,
+    ) -> Result<S::Ok, S::Error>
+    where
+        S: Serializer,
+        V: Serialize,
+    {
+        serializer.collect_seq(map.iter())
+    }
+
+    pub fn deserialize<'de, D, V>(
+        deserializer: D,
+    ) -> Result<FxHashMap<Semantic<TextureSemantics>, V>, D::Error>
+    where
+        D: Deserializer<'de>,
+        V: Deserialize<'de>,
+    {
+        let entries = Vec::<(Semantic<TextureSemantics>, V)>::deserialize(deserializer)?;
+        Ok(entries.into_iter().collect())
+    }
+}
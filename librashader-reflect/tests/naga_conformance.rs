@@ -0,0 +1,143 @@
+//! Conformance of the naga front end to the glslang front end over the slang-shaders corpus.
+//!
+//! The corpus is not part of the repository, so the test is ignored by default. Check out
+//! slang-shaders to `test/slang-shaders` and run with
+//! `cargo test -p librashader-reflect --features unstable-naga --release -- --ignored --nocapture`
+//! to see the per-preset results. The compile times of both front ends are compared in the
+//! `front` benchmark.
+#![cfg(feature = "unstable-naga")]
+
+use glob::glob;
+use librashader_preprocess::{PreprocessError, ShaderSource};
+use librashader_presets::ShaderPreset;
+use librashader_reflect::back::targets::SPIRV;
+use librashader_reflect::back::{CompileShader, FromCompilation};
+use librashader_reflect::front::{GlslangCompilation, NagaCompilation, ShaderCompilation};
+use librashader_reflect::reflect::presets::preprocess_preset_passes;
+use librashader_reflect::reflect::semantics::ShaderSemantics;
+use librashader_reflect::reflect::{ReflectShader, ShaderReflection};
+use std::error::Error;
+
+/// Compile, reflect and write SPIR-V for a single pass.
+fn compile_pass<C>(
+    source: &ShaderSource,
+    pass_number: usize,
+    semantics: &ShaderSemantics,
+) -> Result<ShaderReflection, Box<dyn Error>>
+where
+    C: ShaderCompilation,
+    SPIRV: FromCompilation<C, Target = SPIRV, Options = Option<()>>,
+{
+    let compilation = C::compile(source)?;
+    let mut backend = SPIRV::from_compilation(compilation)?;
+    let reflection = backend.reflect(pass_number, semantics)?;
+    backend.compile(None)?;
+    Ok(reflection)
+}
+
+/// A comparable summary of the reflection of a pass, independent of hash map ordering.
+fn reflection_summary(reflection: &ShaderReflection) -> Vec<String> {
+    let meta = &reflection.meta;
+    let mut summary: Vec<String> =
+        meta.parameter_meta
+            .values()
+            .map(|param| format!("parameter {} {:?} {}", param.id, param.offset, param.size))
+            .chain(meta.unique_meta.iter().map(|(semantic, var)| {
+                format!("unique {semantic:?} {:?} {}", var.offset, var.size)
+            }))
+            .chain(
+                meta.texture_meta
+                    .iter()
+                    .map(|(semantic, texture)| format!("texture {semantic:?} {}", texture.binding)),
+            )
+            .chain(
+                meta.texture_size_meta
+                    .iter()
+                    .map(|(semantic, size)| format!("size {semantic:?} {:?}", size.offset)),
+            )
+            .collect();
+    summary.sort();
+
+    summary.push(format!(
+        "ubo {:?}",
+        reflection.ubo.as_ref().map(|ubo| (ubo.binding, ubo.size))
+    ));
+    summary.push(format!(
+        "push {:?}",
+        reflection.push_constant.as_ref().map(|push| push.size)
+    ));
+    summary
+}
+
+#[test]
+#[ignore = "needs the slang-shaders corpus in test/slang-shaders"]
+fn naga_conforms_to_glslang() {
+    let mut passes = 0;
+    let mut naga_failed = 0;
+    let mut mismatched = Vec::new();
+    let mut compatible_presets = 0;
+    let mut presets = 0;
+
+    for entry in glob("../test/slang-shaders/**/*.slangp").unwrap() {
+        let Ok(path) = entry else {
+            continue;
+        };
+        let Ok(preset) = ShaderPreset::try_parse(&path) else {
+            continue;
+        };
+        let Ok((sources, semantics)) =
+            preprocess_preset_passes::<PreprocessError>(preset.shaders, &preset.textures)
+        else {
+            continue;
+        };
+
+        presets += 1;
+        let mut compatible = true;
+        for (index, (config, source)) in sources.iter().enumerate() {
+            let Ok(glslang) = compile_pass::<GlslangCompilation>(source, index, &semantics) else {
+                // Not a conformance failure if the reference front end can not compile it either.
+                continue;
+            };
+
+            let naga = compile_pass::<NagaCompilation>(source, index, &semantics);
+            passes += 1;
+
+            match naga {
+                Ok(naga) => {
+                    if reflection_summary(&glslang) != reflection_summary(&naga) {
+                        compatible = false;
+                        mismatched.push(config.name.clone());
+                    }
+                }
+                Err(e) => {
+                    compatible = false;
+                    naga_failed += 1;
+                    println!(
+                        "naga failed to compile {:?} from preset {}: {e:?}",
+                        config.name,
+                        path.display()
+                    );
+                }
+            }
+        }
+
+        if compatible {
+            compatible_presets += 1;
+        }
+        let front = if compatible { "naga" } else { "glslang" };
+        println!("[{front}] {}", path.display());
+    }
+
+    assert!(
+        presets > 0,
+        "no presets were found in test/slang-shaders, is the corpus checked out?"
+    );
+
+    println!("{compatible_presets} of {presets} presets can use the naga front end");
+    println!("{naga_failed} of {passes} passes failed to compile with naga");
+
+    assert!(
+        mismatched.is_empty(),
+        "naga reflection differs from glslang for {mismatched:#?}"
+    );
+}
@@ -12,6 +12,7 @@ use rustc_hash::FxHashMap;
 use std::collections::VecDeque;
 
 use std::path::Path;
+use std::sync::Arc;
 
 use crate::draw_quad::DrawQuad;
 use crate::error::{assume_d3d11_init, FilterChainError};
@@ -25,12 +26,14 @@ use crate::{error, util, D3D11OutputView};
 use librashader_cache::cache_shader_object;
 use librashader_cache::CachedCompilation;
 use librashader_reflect::reflect::presets::{CompilePresetTarget, ShaderPassArtifact};
-use librashader_runtime::binding::{BindingUtil, TextureInput};
+use librashader_runtime::binding::{BindingPlan, TextureInput};
 use librashader_runtime::framebuffer::FramebufferInit;
+use librashader_runtime::parameters::RuntimeParameters;
 use librashader_runtime::quad::QuadType;
 use librashader_runtime::render_target::RenderTarget;
 use librashader_runtime::scaling::ScaleFramebuffer;
 use librashader_runtime::uniforms::UniformStorage;
+use librashader_runtime::usage::{FrameState, ResourceUsage};
 use rayon::prelude::*;
 use windows::Win32::Graphics::Direct3D11::{
     ID3D11Buffer, ID3D11Device, ID3D11DeviceContext, D3D11_BIND_CONSTANT_BUFFER, D3D11_BUFFER_DESC,
@@ -42,7 +45,7 @@ use windows::Win32::Graphics::Dxgi::Common::DXGI_FORMAT_R8G8B8A8_UNORM;
 
 pub struct FilterMutable {
     pub(crate) passes_enabled: usize,
-    pub(crate) parameters: FxHashMap<String, f32>,
+    pub(crate) parameters: RuntimeParameters,
 }
 
 /// A Direct3D 11 filter chain.
@@ -53,6 +56,7 @@ pub struct FilterChainD3D11 {
     feedback_framebuffers: Box<[OwnedImage]>,
     history_framebuffers: VecDeque<OwnedImage>,
     state: D3D11State,
+    usage: ResourceUsage,
 }
 
 pub(crate) struct Direct3D11 {
@@ -137,16 +141,29 @@ impl FilterChainD3D11 {
         let disable_cache = options.map_or(false, |o| o.disable_cache);
 
         let (passes, semantics) = compile_passes(preset.shaders, &preset.textures, disable_cache)?;
+        let parameters = RuntimeParameters::new(
+            passes.iter().map(|(_, source, _)| source),
+            &preset.parameters,
+        );
 
         let samplers = SamplerSet::new(device)?;
 
         // initialize passes
-        let filters = FilterChainD3D11::init_passes(device, passes, &semantics, disable_cache)?;
+        let filters = FilterChainD3D11::init_passes(
+            device,
+            passes,
+            &semantics,
+            &parameters,
+            disable_cache,
+        )?;
 
         let immediate_context = unsafe { device.GetImmediateContext()? };
 
-        // load luts
-        let luts = FilterChainD3D11::load_luts(device, &ctx, &preset.textures)?;
+        let mut usage = ResourceUsage::new(filters.iter().map(|f| &f.reflection.meta));
+        usage.alias_outputs(&filters);
+
+        // load luts that are used by any pass
+        let luts = FilterChainD3D11::load_luts(device, &ctx, &usage.used_luts(&preset.textures))?;
 
         let framebuffer_gen =
             || OwnedImage::new(device, Size::new(1, 1), ImageFormat::R8G8B8A8Unorm, false);
@@ -174,6 +191,7 @@ impl FilterChainD3D11 {
             output_framebuffers,
             feedback_framebuffers,
             history_framebuffers,
+            usage,
             common: FilterCommon {
                 d3d11: Direct3D11 {
                     _device: device.clone(),
@@ -181,11 +199,7 @@ impl FilterChainD3D11 {
                 },
                 config: FilterMutable {
                     passes_enabled: preset.shader_count as usize,
-                    parameters: preset
-                        .parameters
-                        .into_iter()
-                        .map(|param| (param.name, param.value))
-                        .collect(),
+                    parameters,
                 },
                 disable_mipmaps: options.map_or(false, |o| o.force_no_mipmaps),
                 luts,
@@ -225,6 +239,7 @@ impl FilterChainD3D11 {
         device: &ID3D11Device,
         passes: Vec<ShaderPassMeta>,
         semantics: &ShaderSemantics,
+        parameters: &RuntimeParameters,
         disable_cache: bool,
     ) -> error::Result<Vec<FilterPass>> {
         let device_is_singlethreaded =
@@ -297,14 +312,15 @@ impl FilterChainD3D11 {
                     .map_or(0, |push| push.size as usize),
             );
 
-            let uniform_bindings = reflection.meta.create_binding_map(|param| param.offset());
+            let binding_plan =
+                BindingPlan::new(&reflection.meta, parameters, |param| param.offset());
 
             Ok(FilterPass {
                 reflection,
                 vertex_shader: vs,
                 vertex_layout: vao,
                 pixel_shader: ps,
-                uniform_bindings,
+                binding_plan,
                 uniform_storage,
                 uniform_buffer: ubo_cbuffer,
                 push_buffer: push_cbuffer,
@@ -342,21 +358,22 @@ impl FilterChainD3D11 {
     fn load_luts(
         device: &ID3D11Device,
         context: &ID3D11DeviceContext,
-        textures: &[TextureConfig],
+        textures: &[(usize, &TextureConfig)],
     ) -> error::Result<FxHashMap<usize, LutTexture>> {
         let mut luts = FxHashMap::default();
         let images = textures
             .par_iter()
-            .map(|texture| Image::load(&texture.path, UVDirection::TopLeft))
-            .collect::<Result<Vec<Image>, ImageError>>()?;
+            .map(|(_, texture)| Image::load_shared(&texture.path, UVDirection::TopLeft))
+            .collect::<Result<Vec<Arc<Image>>, ImageError>>()?;
 
-        for (index, (texture, image)) in textures.iter().zip(images).enumerate() {
+        for (&(index, texture), image) in textures.iter().zip(images) {
             let desc = D3D11_TEXTURE2D_DESC {
                 Width: image.size.width,
                 Height: image.size.height,
                 Format: DXGI_FORMAT_R8G8B8A8_UNORM,
                 Usage: D3D11_USAGE_DEFAULT,
-                MiscFlags: if texture.mipmap {
+                MipLevels: image.level_count(texture.mipmap),
+                MiscFlags: if image.needs_mipmap_generation(texture.mipmap) {
                     D3D11_RESOURCE_MISC_GENERATE_MIPS
                 } else {
                     D3D11_RESOURCE_MISC_FLAG(0)
@@ -433,18 +450,24 @@ impl FilterChainD3D11 {
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
             passes,
+            &self.usage,
             None,
         )?;
 
         // Refresh inputs for feedback textures.
         // Don't need to do this for outputs because they are yet to be bound.
-        for ((texture, fbo), pass) in self
+        for (index, ((texture, fbo), pass)) in self
             .common
             .feedback_textures
             .iter_mut()
             .zip(self.feedback_framebuffers.iter())
             .zip(passes.iter())
+            .enumerate()
         {
+            if !self.usage.is_feedback_used(index) {
+                continue;
+            }
+
             *texture = Some(InputTexture::from_framebuffer(
                 fbo,
                 pass.config.wrap_mode,
@@ -457,11 +480,35 @@ impl FilterChainD3D11 {
 
         let state_guard = self.state.enter_filter_state(ctx);
         self.common.draw_quad.bind_vbo_for_frame(ctx);
+        let frame_state = FrameState {
+            input_size: input.size,
+            output_size: viewport.output.size,
+            viewport_scale: 1.0,
+            enabled: passes_len,
+            parameters: self.common.config.parameters.generation(),
+            mvp: viewport.mvp.copied(),
+        };
+        let frame_passes = self
+            .usage
+            .begin_frame(frame_state, options.map_or(false, |o| o.input_unchanged));
 
         for (index, pass) in pass.iter_mut().enumerate() {
+            // skip passes that do not contribute to the final output.
+            if !frame_passes.is_live(index) {
+                continue;
+            }
+
+            // the output of the last frame is still valid if nothing the pass reads changed.
+            if frame_passes.is_reused(index)
+                && let Some(output) = &self.common.output_textures[index]
+            {
+                source = output.clone();
+                continue;
+            }
+
             source.filter = pass.config.filter;
             source.wrap_mode = pass.config.wrap_mode;
-            let target = &self.output_framebuffers[index];
+            let target = &self.output_framebuffers[frame_passes.output_slot(index)];
             let size = target.size;
             pass.draw(
                 ctx,
@@ -506,7 +553,7 @@ impl FilterChainD3D11 {
             )?;
         }
 
-        std::mem::swap(
+        self.usage.swap_feedback(
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
         );
@@ -514,6 +561,7 @@ impl FilterChainD3D11 {
         drop(state_guard);
 
         self.push_history(ctx, &input)?;
+        self.usage.end_frame(frame_state);
 
         Ok(())
     }
@@ -3,13 +3,10 @@ use crate::texture::InputTexture;
 use librashader_common::{ImageFormat, Size, Viewport};
 use librashader_preprocess::ShaderSource;
 use librashader_presets::ShaderPassConfig;
-use librashader_reflect::reflect::semantics::{
-    BindingStage, MemberOffset, TextureBinding, UniformBinding,
-};
+use librashader_reflect::reflect::semantics::{BindingStage, MemberOffset, TextureBinding};
 use librashader_reflect::reflect::ShaderReflection;
-use rustc_hash::FxHashMap;
 
-use librashader_runtime::binding::{BindSemantics, TextureInput};
+use librashader_runtime::binding::{BindSemantics, BindingPlan, TextureInput};
 use librashader_runtime::filter_pass::FilterPassMeta;
 use librashader_runtime::quad::QuadType;
 use librashader_runtime::render_target::RenderTarget;
@@ -37,7 +34,7 @@ pub struct FilterPass {
     pub vertex_layout: ID3D11InputLayout,
     pub pixel_shader: ID3D11PixelShader,
 
-    pub uniform_bindings: FxHashMap<UniformBinding, MemberOffset>,
+    pub binding_plan: BindingPlan<MemberOffset>,
 
     pub uniform_storage: UniformStorage,
     pub uniform_buffer: Option<ConstantBufferBinding>,
@@ -122,15 +119,13 @@ impl FilterPass {
             viewport_size,
             original,
             source,
-            &self.uniform_bindings,
-            &self.reflection.meta.texture_meta,
+            &self.binding_plan,
             parent.output_textures[0..pass_index]
                 .iter()
                 .map(|o| o.as_ref()),
             parent.feedback_textures.iter().map(|o| o.as_ref()),
             parent.history_textures.iter().map(|o| o.as_ref()),
             parent.luts.iter().map(|(u, i)| (*u, i.as_ref())),
-            &self.source.parameters,
             &parent.config.parameters,
         );
     }
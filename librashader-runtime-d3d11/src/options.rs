@@ -9,6 +9,10 @@ pub struct FrameOptionsD3D11 {
     /// The direction of rendering.
     /// -1 indicates that the frames are played in reverse order.
     pub frame_direction: i32,
+    /// Whether the input image is the same as in the last frame.
+    /// Passes that do not read the frame count, history or feedback keep their
+    /// output from the last frame instead of being drawn again.
+    pub input_unchanged: bool,
 }
 
 /// Options for Direct3D 11 filter chain creation.
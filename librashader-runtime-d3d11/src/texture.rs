@@ -99,7 +99,8 @@ impl LutTexture {
             MipLevels: if (desc.MiscFlags & D3D11_RESOURCE_MISC_GENERATE_MIPS).0 != 0 {
                 0
             } else {
-                1
+                // Prebuilt mip levels are uploaded along with the base level.
+                std::cmp::max(desc.MipLevels, 1)
             },
             ArraySize: 1,
             SampleDesc: DXGI_SAMPLE_DESC {
@@ -130,42 +131,65 @@ impl LutTexture {
             assume_d3d11_init!(handle, "CreateTexture2D");
 
             // need a staging texture to defer mipmap generation
+            let uploaded_levels = if (desc.MiscFlags & D3D11_RESOURCE_MISC_GENERATE_MIPS).0 != 0 {
+                1
+            } else {
+                desc.MipLevels
+            };
+
+            let levels = std::iter::once((source.bytes.as_slice(), source.size, source.pitch))
+                .chain(
+                    source
+                        .mipmaps
+                        .iter()
+                        .map(|level| (level.bytes.as_slice(), level.size, level.pitch)),
+                )
+                .take(uploaded_levels as usize)
+                .collect::<Vec<_>>();
+
+            let initial_data = levels
+                .iter()
+                .map(|&(bytes, _, pitch)| D3D11_SUBRESOURCE_DATA {
+                    pSysMem: bytes.as_ptr().cast(),
+                    SysMemPitch: pitch as u32,
+                    SysMemSlicePitch: 0,
+                })
+                .collect::<Vec<_>>();
+
             let mut staging = None;
             device.CreateTexture2D(
                 &D3D11_TEXTURE2D_DESC {
-                    MipLevels: 1,
+                    MipLevels: uploaded_levels,
                     BindFlags: D3D11_BIND_FLAG(0),
                     MiscFlags: D3D11_RESOURCE_MISC_FLAG(0),
                     Usage: D3D11_USAGE_STAGING,
                     CPUAccessFlags: D3D11_CPU_ACCESS_WRITE,
                     ..desc
                 },
-                Some(&D3D11_SUBRESOURCE_DATA {
-                    pSysMem: source.bytes.as_ptr().cast(),
-                    SysMemPitch: source.pitch as u32,
-                    SysMemSlicePitch: 0,
-                }),
+                Some(initial_data.as_ptr()),
                 Some(&mut staging),
             )?;
             assume_d3d11_init!(staging, "CreateTexture2D");
 
-            context.CopySubresourceRegion(
-                &handle,
-                0,
-                0,
-                0,
-                0,
-                &staging,
-                0,
-                Some(&D3D11_BOX {
-                    left: 0,
-                    top: 0,
-                    front: 0,
-                    right: source.size.width,
-                    bottom: source.size.height,
-                    back: 1,
-                }),
-            );
+            for (level, &(_, size, _)) in levels.iter().enumerate() {
+                context.CopySubresourceRegion(
+                    &handle,
+                    level as u32,
+                    0,
+                    0,
+                    0,
+                    &staging,
+                    level as u32,
+                    Some(&D3D11_BOX {
+                        left: 0,
+                        top: 0,
+                        front: 0,
+                        right: size.width,
+                        bottom: size.height,
+                        back: 1,
+                    }),
+                );
+            }
 
             let mut srv = None;
             device.CreateShaderResourceView(
@@ -22,8 +22,9 @@ use librashader_reflect::front::GlslangCompilation;
 use librashader_reflect::reflect::presets::{CompilePresetTarget, ShaderPassArtifact};
 use librashader_reflect::reflect::semantics::{ShaderSemantics, MAX_BINDINGS_COUNT};
 use librashader_reflect::reflect::ReflectShader;
-use librashader_runtime::binding::{BindingUtil, TextureInput};
+use librashader_runtime::binding::{BindingPlan, TextureInput};
 use librashader_runtime::image::{Image, ImageError, UVDirection};
+use librashader_runtime::parameters::RuntimeParameters;
 use librashader_runtime::quad::QuadType;
 use librashader_runtime::uniforms::UniformStorage;
 use rustc_hash::FxHashMap;
@@ -31,6 +32,7 @@ use spirv_cross::hlsl::ShaderModel;
 use std::collections::VecDeque;
 use std::mem::ManuallyDrop;
 use std::path::Path;
+use std::sync::Arc;
 use windows::core::ComInterface;
 use windows::Win32::Foundation::CloseHandle;
 use windows::Win32::Graphics::Direct3D::Dxc::{
@@ -50,13 +52,14 @@ use librashader_cache::CachedCompilation;
 use librashader_runtime::framebuffer::FramebufferInit;
 use librashader_runtime::render_target::RenderTarget;
 use librashader_runtime::scaling::ScaleFramebuffer;
+use librashader_runtime::usage::{FrameState, ResourceUsage};
 use rayon::prelude::*;
 
 const MIPMAP_RESERVED_WORKHEAP_DESCRIPTORS: usize = 4096;
 
 pub struct FilterMutable {
     pub(crate) passes_enabled: usize,
-    pub(crate) parameters: FxHashMap<String, f32>,
+    pub(crate) parameters: RuntimeParameters,
 }
 
 /// A Direct3D 12 filter chain.
@@ -76,6 +79,7 @@ pub struct FilterChainD3D12 {
     mipmap_heap: D3D12DescriptorHeap<ResourceWorkHeap>,
 
     disable_mipmaps: bool,
+    usage: ResourceUsage,
 }
 
 pub(crate) struct FilterCommon {
@@ -252,6 +256,10 @@ impl FilterChainD3D12 {
         let (passes, semantics) =
             compile_passes_dxil(preset.shaders, &preset.textures, disable_cache)?;
         let (hlsl_passes, _) = compile_passes_hlsl(shader_copy, &preset.textures, disable_cache)?;
+        let parameters = RuntimeParameters::new(
+            passes.iter().map(|(_, source, _)| source),
+            &preset.parameters,
+        );
 
         let samplers = SamplerSet::new(device)?;
         let mipmap_gen = D3D12MipmapGen::new(device, false)?;
@@ -278,19 +286,24 @@ impl FilterChainD3D12 {
             passes,
             hlsl_passes,
             &semantics,
+            &parameters,
             options.map_or(false, |o| o.force_hlsl_pipeline),
             disable_cache,
         )?;
 
         let mut residuals = FrameResiduals::new();
 
+        let mut usage = ResourceUsage::new(filters.iter().map(|f| &f.reflection.meta));
+        usage.alias_outputs(&filters);
+
+        // load luts that are used by any pass
         let luts = FilterChainD3D12::load_luts(
             device,
             cmd,
             &mut staging_heap,
             &mut mipmap_heap,
             &mut residuals,
-            &preset.textures,
+            &usage.used_luts(&preset.textures),
         )?;
 
         let framebuffer_gen = || {
@@ -330,11 +343,7 @@ impl FilterChainD3D12 {
                 draw_quad,
                 config: FilterMutable {
                     passes_enabled: preset.shader_count as usize,
-                    parameters: preset
-                        .parameters
-                        .into_iter()
-                        .map(|param| (param.name, param.value))
-                        .collect(),
+                    parameters,
                 },
                 history_textures,
             },
@@ -349,6 +358,7 @@ impl FilterChainD3D12 {
             mipmap_heap,
             disable_mipmaps: options.map_or(false, |o| o.force_no_mipmaps),
             residuals,
+            usage,
         })
     }
 
@@ -358,7 +368,7 @@ impl FilterChainD3D12 {
         staging_heap: &mut D3D12DescriptorHeap<CpuStagingHeap>,
         mipmap_heap: &mut D3D12DescriptorHeap<ResourceWorkHeap>,
         gc: &mut FrameResiduals,
-        textures: &[TextureConfig],
+        textures: &[(usize, &TextureConfig)],
     ) -> error::Result<FxHashMap<usize, LutTexture>> {
         // use separate mipgen to load luts.
         let mipmap_gen = D3D12MipmapGen::new(device, true)?;
@@ -366,10 +376,10 @@ impl FilterChainD3D12 {
         let mut luts = FxHashMap::default();
         let images = textures
             .par_iter()
-            .map(|texture| Image::load(&texture.path, UVDirection::TopLeft))
-            .collect::<Result<Vec<Image>, ImageError>>()?;
+            .map(|(_, texture)| Image::load_shared(&texture.path, UVDirection::TopLeft))
+            .collect::<Result<Vec<Arc<Image>>, ImageError>>()?;
 
-        for (index, (texture, image)) in textures.iter().zip(images).enumerate() {
+        for (&(index, texture), image) in textures.iter().zip(images) {
             let texture = LutTexture::new(
                 device,
                 staging_heap,
@@ -408,6 +418,7 @@ impl FilterChainD3D12 {
         passes: Vec<DxilShaderPassMeta>,
         hlsl_passes: Vec<HlslShaderPassMeta>,
         semantics: &ShaderSemantics,
+        parameters: &RuntimeParameters,
         force_hlsl: bool,
         disable_cache: bool,
     ) -> error::Result<(
@@ -517,15 +528,15 @@ impl FilterChainD3D12 {
                         RawD3D12Buffer::new(D3D12Buffer::new(device, push_size)?)?,
                     );
 
-                    let uniform_bindings =
-                        reflection.meta.create_binding_map(|param| param.offset());
+                    let binding_plan =
+                        BindingPlan::new(&reflection.meta, parameters, |param| param.offset());
 
                     let texture_heap = texture_heap.alloc_range()?;
                     let sampler_heap = sampler_heap.alloc_range()?;
 
                     Ok(FilterPass {
                         reflection,
-                        uniform_bindings,
+                        binding_plan,
                         uniform_storage,
                         pipeline: graphics_pipeline,
                         config,
@@ -619,13 +630,18 @@ impl FilterChainD3D12 {
         let filter = passes[0].config.filter;
         let wrap_mode = passes[0].config.wrap_mode;
 
-        for ((texture, fbo), pass) in self
+        for (index, ((texture, fbo), pass)) in self
             .common
             .feedback_textures
             .iter_mut()
             .zip(self.feedback_framebuffers.iter())
             .zip(passes.iter())
+            .enumerate()
         {
+            if !self.usage.is_feedback_used(index) {
+                continue;
+            }
+
             *texture = Some(fbo.create_shader_resource_view(
                 &mut self.staging_heap,
                 pass.config.filter,
@@ -647,7 +663,7 @@ impl FilterChainD3D12 {
         let mut source = original.clone();
 
         // swap output and feedback **before** recording command buffers
-        std::mem::swap(
+        self.usage.swap_feedback(
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
         );
@@ -659,13 +675,17 @@ impl FilterChainD3D12 {
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
             passes,
+            &self.usage,
             Some(&mut |index, pass, output, feedback| {
                 // refresh inputs
-                self.common.feedback_textures[index] = Some(feedback.create_shader_resource_view(
-                    &mut self.staging_heap,
-                    pass.config.filter,
-                    pass.config.wrap_mode,
-                )?);
+                if self.usage.is_feedback_used(index) {
+                    self.common.feedback_textures[index] =
+                        Some(feedback.create_shader_resource_view(
+                            &mut self.staging_heap,
+                            pass.config.filter,
+                            pass.config.wrap_mode,
+                        )?);
+                }
                 self.common.output_textures[index] = Some(output.create_shader_resource_view(
                     &mut self.staging_heap,
                     pass.config.filter,
@@ -690,12 +710,34 @@ impl FilterChainD3D12 {
         }
 
         self.common.draw_quad.bind_vertices_for_frame(cmd);
+        let frame_state = FrameState {
+            input_size: original.size(),
+            output_size: viewport.output.size,
+            viewport_scale: 1.0,
+            enabled: passes_len,
+            parameters: self.common.config.parameters.generation(),
+            mvp: viewport.mvp.copied(),
+        };
+        let frame_passes = self
+            .usage
+            .begin_frame(frame_state, options.map_or(false, |o| o.input_unchanged));
 
         for (index, pass) in pass.iter_mut().enumerate() {
+            // skip passes that do not contribute to the final output.
+            if !frame_passes.is_live(index) {
+                continue;
+            }
+
+            // the output of the last frame is still valid if nothing the pass reads changed.
+            if frame_passes.is_reused(index) {
+                source = self.common.output_textures[index].as_ref().unwrap().clone();
+                continue;
+            }
+
             source.filter = pass.config.filter;
             source.wrap_mode = pass.config.wrap_mode;
 
-            let target = &self.output_framebuffers[index];
+            let target = &self.output_framebuffers[frame_passes.output_slot(index)];
 
             if pass.pipeline.format != target.format {
                 // eprintln!("recompiling final pipeline");
@@ -793,6 +835,7 @@ impl FilterChainD3D12 {
         }
 
         self.push_history(cmd, &original)?;
+        self.usage.end_frame(frame_state);
 
         Ok(())
     }
@@ -8,14 +8,13 @@ use crate::texture::{D3D12OutputView, InputTexture};
 use librashader_common::{ImageFormat, Size, Viewport};
 use librashader_preprocess::ShaderSource;
 use librashader_presets::ShaderPassConfig;
-use librashader_reflect::reflect::semantics::{MemberOffset, TextureBinding, UniformBinding};
+use librashader_reflect::reflect::semantics::{MemberOffset, TextureBinding};
 use librashader_reflect::reflect::ShaderReflection;
-use librashader_runtime::binding::{BindSemantics, TextureInput};
+use librashader_runtime::binding::{BindSemantics, BindingPlan, TextureInput};
 use librashader_runtime::filter_pass::FilterPassMeta;
 use librashader_runtime::quad::QuadType;
 use librashader_runtime::render_target::RenderTarget;
 use librashader_runtime::uniforms::{NoUniformBinder, UniformStorage};
-use rustc_hash::FxHashMap;
 use std::ops::Deref;
 use windows::core::ComInterface;
 use windows::Win32::Foundation::RECT;
@@ -30,7 +29,7 @@ pub(crate) struct FilterPass {
     pub(crate) pipeline: D3D12GraphicsPipeline,
     pub(crate) reflection: ShaderReflection,
     pub(crate) config: ShaderPassConfig,
-    pub(crate) uniform_bindings: FxHashMap<UniformBinding, MemberOffset>,
+    pub(crate) binding_plan: BindingPlan<MemberOffset>,
     pub uniform_storage:
         UniformStorage<NoUniformBinder, Option<()>, RawD3D12Buffer, RawD3D12Buffer>,
     pub(crate) texture_heap: [D3D12DescriptorHeapSlot<ResourceWorkHeap>; 16],
@@ -111,15 +110,13 @@ impl FilterPass {
             viewport_size,
             original,
             source,
-            &self.uniform_bindings,
-            &self.reflection.meta.texture_meta,
+            &self.binding_plan,
             parent.output_textures[0..pass_index]
                 .iter()
                 .map(|o| o.as_ref()),
             parent.feedback_textures.iter().map(|o| o.as_ref()),
             parent.history_textures.iter().map(|o| o.as_ref()),
             parent.luts.iter().map(|(u, i)| (*u, i.as_ref())),
-            &self.source.parameters,
             &parent.config.parameters,
         );
     }
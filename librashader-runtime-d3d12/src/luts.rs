@@ -7,7 +7,6 @@ use crate::texture::InputTexture;
 use crate::util::{d3d12_get_closest_format, d3d12_resource_transition, d3d12_update_subresources};
 use librashader_common::{FilterMode, ImageFormat, WrapMode};
 use librashader_runtime::image::Image;
-use librashader_runtime::scaling::MipmapSize;
 use std::ops::Deref;
 use windows::Win32::Graphics::Direct3D12::{
     ID3D12Device, ID3D12GraphicsCommandList, ID3D12Resource, D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
@@ -15,12 +14,12 @@ use windows::Win32::Graphics::Direct3D12::{
     D3D12_FORMAT_SUPPORT1_MIP, D3D12_FORMAT_SUPPORT1_SHADER_SAMPLE,
     D3D12_FORMAT_SUPPORT1_TEXTURE2D, D3D12_HEAP_FLAG_NONE, D3D12_HEAP_PROPERTIES,
     D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_TYPE_UPLOAD, D3D12_MEMORY_POOL_UNKNOWN,
-    D3D12_PLACED_SUBRESOURCE_FOOTPRINT, D3D12_RESOURCE_DESC, D3D12_RESOURCE_DIMENSION_BUFFER,
-    D3D12_RESOURCE_DIMENSION_TEXTURE2D, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
-    D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ,
-    D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_SHADER_RESOURCE_VIEW_DESC,
-    D3D12_SHADER_RESOURCE_VIEW_DESC_0, D3D12_SRV_DIMENSION_TEXTURE2D, D3D12_SUBRESOURCE_DATA,
-    D3D12_TEX2D_SRV, D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+    D3D12_RESOURCE_DESC, D3D12_RESOURCE_DIMENSION_BUFFER, D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+    D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST,
+    D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+    D3D12_SHADER_RESOURCE_VIEW_DESC, D3D12_SHADER_RESOURCE_VIEW_DESC_0,
+    D3D12_SRV_DIMENSION_TEXTURE2D, D3D12_SUBRESOURCE_DATA, D3D12_TEX2D_SRV,
+    D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
 };
 use windows::Win32::Graphics::Dxgi::Common::DXGI_SAMPLE_DESC;
 
@@ -42,14 +41,17 @@ impl LutTexture {
         mipmap: bool,
         gc: &mut FrameResiduals,
     ) -> error::Result<LutTexture> {
-        let miplevels = source.size.calculate_miplevels() as u16;
+        let miplevels = source.level_count(mipmap) as u16;
+        let generate_mipmaps = source.needs_mipmap_generation(mipmap);
+        // Prebuilt mip levels are uploaded along with the base level.
+        let uploaded_levels = if generate_mipmaps { 1 } else { miplevels };
         let mut desc = D3D12_RESOURCE_DESC {
             Dimension: D3D12_RESOURCE_DIMENSION_TEXTURE2D,
             Alignment: 0,
             Width: source.size.width as u64,
             Height: source.size.height,
             DepthOrArraySize: 1,
-            MipLevels: if mipmap { miplevels } else { 1 },
+            MipLevels: miplevels,
             Format: ImageFormat::R8G8B8A8Unorm.into(),
             SampleDesc: DXGI_SAMPLE_DESC {
                 Count: 1,
@@ -66,10 +68,13 @@ impl LutTexture {
         };
 
         if mipmap {
-            desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
             format_support.Support1 |= D3D12_FORMAT_SUPPORT1_MIP;
         }
 
+        if generate_mipmaps {
+            desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
+
         desc.Format = d3d12_get_closest_format(device, format_support);
         let descriptor = heap.alloc_slot()?;
 
@@ -117,16 +122,15 @@ impl LutTexture {
             ..Default::default()
         };
 
-        let mut layout = D3D12_PLACED_SUBRESOURCE_FOOTPRINT::default();
         let mut total = 0;
         // texture upload
         unsafe {
             device.GetCopyableFootprints(
                 &desc,
                 0,
-                1,
+                uploaded_levels as u32,
                 0,
-                Some(&mut layout),
+                None,
                 None,
                 None,
                 Some(&mut total),
@@ -159,11 +163,20 @@ impl LutTexture {
         }
         assume_d3d12_init!(upload, "CreateCommittedResource");
 
-        let subresource = [D3D12_SUBRESOURCE_DATA {
-            pData: source.bytes.as_ptr().cast(),
-            RowPitch: 4 * source.size.width as isize,
-            SlicePitch: (4 * source.size.width * source.size.height) as isize,
-        }];
+        let subresources = std::iter::once((source.bytes.as_slice(), source.size))
+            .chain(
+                source
+                    .mipmaps
+                    .iter()
+                    .map(|level| (level.bytes.as_slice(), level.size)),
+            )
+            .take(uploaded_levels as usize)
+            .map(|(bytes, size)| D3D12_SUBRESOURCE_DATA {
+                pData: bytes.as_ptr().cast(),
+                RowPitch: 4 * size.width as isize,
+                SlicePitch: (4 * size.width * size.height) as isize,
+            })
+            .collect::<Vec<_>>();
 
         d3d12_resource_transition(
             cmd,
@@ -172,7 +185,16 @@ impl LutTexture {
             D3D12_RESOURCE_STATE_COPY_DEST,
         );
 
-        d3d12_update_subresources(cmd, &resource, &upload, 0, 0, 1, &subresource, gc)?;
+        d3d12_update_subresources(
+            cmd,
+            &resource,
+            &upload,
+            0,
+            0,
+            uploaded_levels as u32,
+            &subresources,
+            gc,
+        )?;
 
         d3d12_resource_transition(
             cmd,
@@ -193,7 +215,11 @@ impl LutTexture {
             resource,
             _staging: upload,
             view,
-            miplevels: if mipmap { Some(miplevels) } else { None },
+            miplevels: if generate_mipmaps {
+                Some(miplevels)
+            } else {
+                None
+            },
         })
     }
 
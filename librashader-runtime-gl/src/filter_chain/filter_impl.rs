@@ -7,6 +7,7 @@ use crate::gl::{
 use crate::options::{FilterChainOptionsGL, FrameOptionsGL};
 use crate::samplers::SamplerSet;
 use crate::texture::InputTexture;
+use crate::timing::GlPassTimer;
 use crate::util::{gl_get_version, gl_u16_to_version};
 use crate::{error, GLImage};
 use gl::types::GLuint;
@@ -20,14 +21,24 @@ use librashader_reflect::front::GlslangCompilation;
 use librashader_reflect::reflect::semantics::{ShaderSemantics, UniformMeta};
 
 use librashader_cache::CachedCompilation;
-use librashader_reflect::reflect::presets::{CompilePresetTarget, ShaderPassArtifact};
+use librashader_reflect::reflect::presets::{
+    preprocess_preset_passes, CompilePresetTarget, ShaderPassArtifact, ShaderPassSource,
+};
 use librashader_reflect::reflect::ReflectShader;
-use librashader_runtime::binding::BindingUtil;
+use librashader_runtime::binding::BindingPlan;
+use librashader_runtime::deferred::{DeferredCompile, DeferredPasses};
 use librashader_runtime::framebuffer::FramebufferInit;
+use librashader_runtime::history::InputHistory;
+use librashader_runtime::parameters::RuntimeParameters;
 use librashader_runtime::render_target::RenderTarget;
+use librashader_runtime::resolution::AdaptiveResolution;
 use librashader_runtime::scaling::ScaleFramebuffer;
+use librashader_runtime::timing::PassTiming;
+use librashader_runtime::usage::{FrameState, ResourceUsage};
 use rustc_hash::FxHashMap;
 use std::collections::VecDeque;
+use std::sync::Arc;
+use std::time::Duration;
 
 #[rustfmt::skip]
 pub static GL_MVP_DEFAULT: &[f32; 16] = &[
@@ -39,11 +50,25 @@ pub static GL_MVP_DEFAULT: &[f32; 16] = &[
 
 pub(crate) struct FilterChainImpl<T: GLInterface> {
     pub(crate) common: FilterCommon,
-    passes: Box<[FilterPass<T>]>,
+    passes: Vec<FilterPass<T>>,
     draw_quad: T::DrawQuad,
     output_framebuffers: Box<[GLFramebuffer]>,
     feedback_framebuffers: Box<[GLFramebuffer]>,
     history_framebuffers: VecDeque<GLFramebuffer>,
+    input_history: Option<InputHistory<GLImage>>,
+    timer: Option<GlPassTimer>,
+    resolution: AdaptiveResolution,
+    usage: ResourceUsage,
+    deferred: Option<DeferredState>,
+}
+
+/// Passes that have not yet been compiled, and what is needed to initialize them.
+struct DeferredState {
+    passes: DeferredPasses<ShaderPassSource, ShaderPassMeta, FilterChainError>,
+    semantics: ShaderSemantics,
+    textures: Vec<TextureConfig>,
+    version: GlslVersion,
+    disable_cache: bool,
 }
 
 pub(crate) struct FilterCommon {
@@ -59,7 +84,7 @@ pub(crate) struct FilterCommon {
 
 pub struct FilterMutable {
     pub(crate) passes_enabled: usize,
-    pub(crate) parameters: FxHashMap<String, f32>,
+    pub(crate) parameters: RuntimeParameters,
 }
 
 impl<T: GLInterface> FilterChainImpl<T> {
@@ -97,7 +122,8 @@ impl<T: GLInterface> FilterChainImpl<T> {
     }
 }
 
-type ShaderPassMeta = ShaderPassArtifact<impl CompileReflectShader<GLSL, GlslangCompilation>>;
+type ShaderPassMeta =
+    ShaderPassArtifact<impl CompileReflectShader<GLSL, GlslangCompilation> + Send>;
 fn compile_passes(
     shaders: Vec<ShaderPassConfig>,
     textures: &[TextureConfig],
@@ -114,29 +140,119 @@ fn compile_passes(
     Ok((passes, semantics))
 }
 
+fn compile_pass(
+    pass: ShaderPassSource,
+    disable_cache: bool,
+) -> Result<ShaderPassMeta, FilterChainError> {
+    if !disable_cache {
+        GLSL::compile_preset_pass::<CachedCompilation<GlslangCompilation>, FilterChainError>(pass)
+    } else {
+        GLSL::compile_preset_pass::<GlslangCompilation, FilterChainError>(pass)
+    }
+}
+
 impl<T: GLInterface> FilterChainImpl<T> {
     /// Load a filter chain from a pre-parsed `ShaderPreset`.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
     pub(crate) unsafe fn load_from_preset(
         preset: ShaderPreset,
         options: Option<&FilterChainOptionsGL>,
     ) -> error::Result<Self> {
         let disable_cache = options.map_or(false, |o| o.disable_cache);
-        let (passes, semantics) = compile_passes(preset.shaders, &preset.textures, disable_cache)?;
         let version = options.map_or_else(gl_get_version, |o| gl_u16_to_version(o.glsl_version));
 
-        // initialize passes
-        let filters = Self::init_passes(version, passes, &semantics, disable_cache)?;
+        let (filters, deferred, parameters) = if options.map_or(false, |o| o.defer_passes) {
+            // only preprocess here, passes are compiled when they are first enabled.
+            let (passes, semantics) =
+                preprocess_preset_passes::<FilterChainError>(preset.shaders, &preset.textures)?;
+            let parameters =
+                RuntimeParameters::new(passes.iter().map(|(_, source)| source), &preset.parameters);
+
+            let compile: DeferredCompile<ShaderPassSource, ShaderPassMeta, FilterChainError> =
+                Arc::new(move |pass| compile_pass(pass, disable_cache));
+
+            let deferred = DeferredState {
+                passes: DeferredPasses::new(
+                    passes,
+                    compile,
+                    options.map_or(false, |o| o.prefetch_passes),
+                ),
+                semantics,
+                textures: preset.textures.clone(),
+                version,
+                disable_cache,
+            };
+            (Vec::new(), Some(deferred), parameters)
+        } else {
+            let (passes, semantics) =
+                compile_passes(preset.shaders, &preset.textures, disable_cache)?;
+            let parameters = RuntimeParameters::new(
+                passes.iter().map(|(_, source, _)| source),
+                &preset.parameters,
+            );
 
-        let default_filter = filters.first().map(|f| f.config.filter).unwrap_or_default();
-        let default_wrap = filters
-            .first()
-            .map(|f| f.config.wrap_mode)
-            .unwrap_or_default();
+            // initialize passes
+            let filters =
+                Self::init_passes(version, passes, &semantics, &parameters, disable_cache)?;
+            (filters, None, parameters)
+        };
 
         let samplers = SamplerSet::new();
 
-        // load luts
-        let luts = T::LoadLut::load_luts(&preset.textures)?;
+        let mut usage = ResourceUsage::new(filters.iter().map(|f| &f.reflection.meta));
+        usage.alias_outputs(&filters);
+
+        // load luts that are used by any pass
+        let luts = T::LoadLut::load_luts(&usage.used_luts(&preset.textures))?;
+
+        // create vertex objects
+        let draw_quad = T::DrawQuad::new();
+
+        let mut filter_chain = FilterChainImpl {
+            passes: filters,
+            output_framebuffers: Box::new([]),
+            feedback_framebuffers: Box::new([]),
+            history_framebuffers: VecDeque::new(),
+            input_history: options
+                .map_or(false, |o| o.zero_copy_history)
+                .then(|| InputHistory::new(0)),
+            timer: options
+                .map_or(false, |o| o.time_passes)
+                .then(GlPassTimer::new),
+            resolution: AdaptiveResolution::default(),
+            draw_quad,
+            usage,
+            deferred,
+            common: FilterCommon {
+                config: FilterMutable {
+                    passes_enabled: preset.shader_count as usize,
+                    parameters,
+                },
+                disable_mipmaps: options.map_or(false, |o| o.force_no_mipmaps),
+                luts,
+                samplers,
+                output_textures: Box::new([]),
+                feedback_textures: Box::new([]),
+                history_textures: Box::new([]),
+            },
+        };
+
+        filter_chain.init_framebuffers()?;
+        Ok(filter_chain)
+    }
+
+    /// Initialize output, feedback and history framebuffers for the loaded passes.
+    fn init_framebuffers(&mut self) -> error::Result<()> {
+        let default_filter = self
+            .passes
+            .first()
+            .map(|f| f.config.filter)
+            .unwrap_or_default();
+        let default_wrap = self
+            .passes
+            .first()
+            .map(|f| f.config.wrap_mode)
+            .unwrap_or_default();
 
         let framebuffer_gen = || Ok::<_, FilterChainError>(T::FramebufferInterface::new(1));
         let input_gen = || InputTexture {
@@ -147,7 +263,7 @@ impl<T: GLInterface> FilterChainImpl<T> {
         };
 
         let framebuffer_init = FramebufferInit::new(
-            filters.iter().map(|f| &f.reflection.meta),
+            self.passes.iter().map(|f| &f.reflection.meta),
             &framebuffer_gen,
             &input_gen,
         );
@@ -160,89 +276,177 @@ impl<T: GLInterface> FilterChainImpl<T> {
             framebuffer_init.init_output_framebuffers()?;
 
         // initialize history
-        let (history_framebuffers, history_textures) = framebuffer_init.init_history()?;
+        let (history_framebuffers, history_textures) = match &mut self.input_history {
+            Some(input_history) => {
+                let history_textures = framebuffer_init.init_history_views();
+                *input_history = InputHistory::new(history_textures.len());
+                (VecDeque::new(), history_textures)
+            }
+            None => framebuffer_init.init_history()?,
+        };
 
-        // create vertex objects
-        let draw_quad = T::DrawQuad::new();
+        self.output_framebuffers = output_framebuffers;
+        self.feedback_framebuffers = feedback_framebuffers;
+        self.history_framebuffers = history_framebuffers;
+        self.common.output_textures = output_textures;
+        self.common.feedback_textures = feedback_textures;
+        self.common.history_textures = history_textures;
+        Ok(())
+    }
 
-        Ok(FilterChainImpl {
-            passes: filters,
-            output_framebuffers,
-            feedback_framebuffers,
-            history_framebuffers,
-            draw_quad,
-            common: FilterCommon {
-                config: FilterMutable {
-                    passes_enabled: preset.shader_count as usize,
-                    parameters: preset
-                        .parameters
-                        .into_iter()
-                        .map(|param| (param.name, param.value))
-                        .collect(),
-                },
-                disable_mipmaps: options.map_or(false, |o| o.force_no_mipmaps),
-                luts,
-                samplers,
-                output_textures,
-                feedback_textures,
-                history_textures,
-            },
-        })
+    /// Compile and initialize deferred passes until at least `count` passes are loaded.
+    ///
+    /// If a deferred pass or its LUTs fail to load, the error is returned, the filter chain is
+    /// left with the passes it had before, and the pass is retried the next time passes are
+    /// loaded, so every frame fails until it is disabled again.
+    fn load_deferred_passes(&mut self, count: usize) -> error::Result<()> {
+        let Some(deferred) = &mut self.deferred else {
+            return Ok(());
+        };
+
+        let loaded = self.passes.len();
+        if loaded >= count {
+            return Ok(());
+        }
+
+        let parameters = &self.common.config.parameters;
+        let filters = deferred.passes.take(count - loaded).and_then(|passes| {
+            passes
+                .into_iter()
+                .enumerate()
+                .map(|(index, pass)| {
+                    Self::init_pass(
+                        loaded + index,
+                        deferred.version,
+                        pass,
+                        &deferred.semantics,
+                        parameters,
+                        deferred.disable_cache,
+                    )
+                })
+                .collect::<error::Result<Vec<_>>>()
+        });
+
+        let filters = match filters {
+            Ok(filters) => filters,
+            Err(error) => {
+                // Keep the failed passes queued, so the error is reported again the next time
+                // they are loaded instead of silently drawing fewer passes.
+                deferred.passes.restore();
+                return Err(error);
+            }
+        };
+
+        self.passes.extend(filters);
+        let mut usage = ResourceUsage::new(self.passes.iter().map(|f| &f.reflection.meta));
+        usage.alias_outputs(&self.passes);
+        let previous_usage = std::mem::replace(&mut self.usage, usage);
+
+        // load any luts that the new passes use
+        let textures: Vec<_> = self
+            .usage
+            .used_luts(&deferred.textures)
+            .into_iter()
+            .filter(|(index, _)| !self.common.luts.contains_key(index))
+            .collect();
+
+        // history and feedback are reset as the set of passes has changed.
+        let result = T::LoadLut::load_luts(&textures).and_then(|luts| {
+            self.common.luts.extend(luts);
+            self.init_framebuffers()
+        });
+
+        if let Err(error) = result {
+            // Go back to the passes that were loaded before, which the framebuffers still
+            // match, and keep the new passes queued.
+            self.passes.truncate(loaded);
+            self.usage = previous_usage;
+            if let Some(deferred) = &mut self.deferred {
+                deferred.passes.restore();
+            }
+            return Err(error);
+        }
+
+        if self
+            .deferred
+            .as_ref()
+            .is_some_and(|deferred| deferred.passes.remaining() == 0)
+        {
+            self.deferred = None;
+        }
+        Ok(())
     }
 
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
     fn init_passes(
         version: GlslVersion,
         passes: Vec<ShaderPassMeta>,
         semantics: &ShaderSemantics,
+        parameters: &RuntimeParameters,
         disable_cache: bool,
-    ) -> error::Result<Box<[FilterPass<T>]>> {
-        let mut filters = Vec::new();
-
-        // initialize passes
-        for (index, (config, source, mut reflect)) in passes.into_iter().enumerate() {
-            let reflection = reflect.reflect(index, semantics)?;
-            let glsl = reflect.compile(version)?;
+    ) -> error::Result<Vec<FilterPass<T>>> {
+        passes
+            .into_iter()
+            .enumerate()
+            .map(|(index, pass)| {
+                Self::init_pass(index, version, pass, semantics, parameters, disable_cache)
+            })
+            .collect()
+    }
 
-            let (program, ubo_location) = T::CompileShader::compile_program(glsl, !disable_cache)?;
+    fn init_pass(
+        index: usize,
+        version: GlslVersion,
+        (config, source, mut reflect): ShaderPassMeta,
+        semantics: &ShaderSemantics,
+        parameters: &RuntimeParameters,
+        disable_cache: bool,
+    ) -> error::Result<FilterPass<T>> {
+        let reflection = reflect.reflect(index, semantics)?;
+        let glsl = reflect.compile(version)?;
 
-            let ubo_ring = if let Some(ubo) = &reflection.ubo {
-                let ring = UboRing::new(ubo.size);
-                Some(ring)
-            } else {
-                None
-            };
+        let (program, ubo_location) = T::CompileShader::compile_program(glsl, !disable_cache)?;
 
-            let uniform_storage = GlUniformStorage::new(
-                reflection.ubo.as_ref().map_or(0, |ubo| ubo.size as usize),
-                reflection
-                    .push_constant
-                    .as_ref()
-                    .map_or(0, |push| push.size as usize),
-            );
+        let ubo_ring = if let Some(ubo) = &reflection.ubo {
+            let ring = UboRing::new(ubo.size);
+            Some(ring)
+        } else {
+            None
+        };
 
-            let uniform_bindings = reflection.meta.create_binding_map(|param| {
-                UniformOffset::new(
-                    Self::reflect_uniform_location(program, param),
-                    param.offset(),
-                )
-            });
-
-            filters.push(FilterPass {
-                reflection,
-                program,
-                ubo_location,
-                ubo_ring,
-                uniform_storage,
-                uniform_bindings,
-                source,
-                config,
-            });
-        }
+        let uniform_storage = GlUniformStorage::new(
+            reflection.ubo.as_ref().map_or(0, |ubo| ubo.size as usize),
+            reflection
+                .push_constant
+                .as_ref()
+                .map_or(0, |push| push.size as usize),
+        );
 
-        Ok(filters.into_boxed_slice())
+        let binding_plan = BindingPlan::new(&reflection.meta, parameters, |param| {
+            UniformOffset::new(
+                Self::reflect_uniform_location(program, param),
+                param.offset(),
+            )
+        });
+
+        Ok(FilterPass {
+            reflection,
+            program,
+            ubo_location,
+            ubo_ring,
+            uniform_storage,
+            binding_plan,
+            source,
+            config,
+        })
     }
 
     fn push_history(&mut self, input: &GLImage) -> error::Result<()> {
+        if let Some(input_history) = &mut self.input_history {
+            input_history.push(*input);
+            return Ok(());
+        }
+
         if let Some(mut back) = self.history_framebuffers.pop_back() {
             if back.size != input.size || (input.format != 0 && input.format != back.format) {
                 // eprintln!("[history] resizing");
@@ -256,9 +460,35 @@ impl<T: GLInterface> FilterChainImpl<T> {
         Ok(())
     }
 
+    /// The number of previous input images that are bound as history.
+    pub fn history_len(&self) -> usize {
+        self.common.history_textures.len()
+    }
+
+    /// The most recent GPU timings of each pass, if pass timing is enabled.
+    pub fn pass_timings(&self) -> &[PassTiming] {
+        self.timer.as_ref().map_or(&[], |timer| timer.timings())
+    }
+
+    /// Set the GPU time budget of a frame that the viewport scale is chosen for.
+    pub fn set_frame_time_budget(&mut self, budget: Option<Duration>) {
+        self.resolution.set_budget(budget)
+    }
+
+    /// The scale of the viewport that passes with viewport scaling are sized against.
+    pub fn viewport_scale(&self) -> f32 {
+        self.resolution.scale()
+    }
+
+    /// Override the viewport scale, or go back to choosing it from the budget with `None`.
+    pub fn set_viewport_scale(&mut self, scale: Option<f32>) {
+        self.resolution.set_override(scale)
+    }
+
     /// Process a frame with the input image.
     ///
     /// When this frame returns, GL_FRAMEBUFFER is bound to 0.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all, fields(frame = frame_count)))]
     pub unsafe fn frame(
         &mut self,
         frame_count: usize,
@@ -266,6 +496,17 @@ impl<T: GLInterface> FilterChainImpl<T> {
         input: &GLImage,
         options: Option<&FrameOptionsGL>,
     ) -> error::Result<()> {
+        // compile any deferred passes that have since been enabled.
+        self.load_deferred_passes(self.common.config.passes_enabled)?;
+
+        if let Some(timer) = &mut self.timer {
+            let passes = &self.passes;
+            timer.begin_frame(|index| passes.get(index).and_then(|p| p.config.alias.as_deref()));
+            if timer.updated() {
+                self.resolution.update(timer.timings());
+            }
+        }
+
         // limit number of passes to those enabled.
         let max = std::cmp::min(self.passes.len(), self.common.config.passes_enabled);
         let passes = &mut self.passes[0..max];
@@ -275,6 +516,9 @@ impl<T: GLInterface> FilterChainImpl<T> {
                 for framebuffer in &self.history_framebuffers {
                     framebuffer.clear::<T::FramebufferInterface, true>()
                 }
+                if let Some(input_history) = &mut self.input_history {
+                    input_history.clear();
+                }
             }
         }
 
@@ -291,6 +535,12 @@ impl<T: GLInterface> FilterChainImpl<T> {
         let wrap_mode = passes[0].config.wrap_mode;
 
         // update history
+        if let Some(input_history) = &self.input_history {
+            for (index, texture) in self.common.history_textures.iter_mut().enumerate() {
+                texture.image = input_history.get(index).copied().unwrap_or_default();
+            }
+        }
+
         for (texture, fbo) in self
             .common
             .history_textures
@@ -313,22 +563,28 @@ impl<T: GLInterface> FilterChainImpl<T> {
         // rescale render buffers to ensure all bindings are valid.
         <GLFramebuffer as ScaleFramebuffer<T::FramebufferInterface>>::scale_framebuffers(
             source.image.size,
-            viewport.output.size,
+            self.resolution.scale_viewport(viewport.output.size),
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
             passes,
+            &self.usage,
             None,
         )?;
 
         // Refresh inputs for feedback textures.
         // Don't need to do this for outputs because they are yet to be bound.
-        for ((texture, fbo), pass) in self
+        for (index, ((texture, fbo), pass)) in self
             .common
             .feedback_textures
             .iter_mut()
             .zip(self.feedback_framebuffers.iter())
             .zip(passes.iter())
+            .enumerate()
         {
+            if !self.usage.is_feedback_used(index) {
+                continue;
+            }
+
             texture.image = fbo
                 .as_texture(pass.config.filter, pass.config.wrap_mode)
                 .image;
@@ -336,23 +592,48 @@ impl<T: GLInterface> FilterChainImpl<T> {
 
         let passes_len = passes.len();
         let (pass, last) = passes.split_at_mut(passes_len - 1);
+        let frame_state = FrameState {
+            input_size: input.size,
+            output_size: viewport.output.size,
+            viewport_scale: self.resolution.scale(),
+            enabled: passes_len,
+            parameters: self.common.config.parameters.generation(),
+            mvp: viewport.mvp.copied(),
+        };
+        let frame_passes = self
+            .usage
+            .begin_frame(frame_state, options.map_or(false, |o| o.input_unchanged));
 
         for (index, pass) in pass.iter_mut().enumerate() {
-            let target = &self.output_framebuffers[index];
+            // skip passes that do not contribute to the final output.
+            if !frame_passes.is_live(index) {
+                continue;
+            }
+
+            let target = &self.output_framebuffers[frame_passes.output_slot(index)];
             source.filter = pass.config.filter;
             source.mip_filter = pass.config.filter;
             source.wrap_mode = pass.config.wrap_mode;
 
-            pass.draw(
-                index,
-                &self.common,
-                pass.config.get_frame_count(frame_count),
-                frame_direction,
-                viewport,
-                &original,
-                &source,
-                RenderTarget::offscreen(target, viewport.mvp.unwrap_or(GL_MVP_DEFAULT)),
-            );
+            // the output of the last frame is still valid if nothing the pass reads changed.
+            if !frame_passes.is_reused(index) {
+                if let Some(timer) = &mut self.timer {
+                    timer.begin_pass(index);
+                }
+                pass.draw(
+                    index,
+                    &self.common,
+                    pass.config.get_frame_count(frame_count),
+                    frame_direction,
+                    viewport,
+                    &original,
+                    &source,
+                    RenderTarget::offscreen(target, viewport.mvp.unwrap_or(GL_MVP_DEFAULT)),
+                );
+                if let Some(timer) = &self.timer {
+                    timer.end_pass();
+                }
+            }
 
             let target = target.as_texture(pass.config.filter, pass.config.wrap_mode);
             self.common.output_textures[index] = target;
@@ -366,6 +647,9 @@ impl<T: GLInterface> FilterChainImpl<T> {
             source.mip_filter = pass.config.filter;
             source.wrap_mode = pass.config.wrap_mode;
 
+            if let Some(timer) = &mut self.timer {
+                timer.begin_pass(passes_len - 1);
+            }
             pass.draw(
                 passes_len - 1,
                 &self.common,
@@ -376,13 +660,16 @@ impl<T: GLInterface> FilterChainImpl<T> {
                 &source,
                 RenderTarget::viewport(viewport),
             );
+            if let Some(timer) = &self.timer {
+                timer.end_pass();
+            }
             self.common.output_textures[passes_len - 1] = viewport
                 .output
                 .as_texture(pass.config.filter, pass.config.wrap_mode);
         }
 
         // swap feedback framebuffers with output
-        std::mem::swap(
+        self.usage.swap_feedback(
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
         );
@@ -390,6 +677,7 @@ impl<T: GLInterface> FilterChainImpl<T> {
         self.push_history(input)?;
 
         self.draw_quad.unbind_vertices();
+        self.usage.end_frame(frame_state);
 
         Ok(())
     }
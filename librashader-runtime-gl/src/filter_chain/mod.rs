@@ -1,5 +1,6 @@
 use std::panic::catch_unwind;
 use std::path::Path;
+use std::time::Duration;
 
 use crate::error::{FilterChainError, Result};
 use crate::filter_chain::filter_impl::FilterChainImpl;
@@ -7,6 +8,7 @@ use crate::filter_chain::inner::FilterChainDispatch;
 use crate::options::{FilterChainOptionsGL, FrameOptionsGL};
 use crate::{GLFramebuffer, GLImage};
 use librashader_presets::ShaderPreset;
+use librashader_runtime::timing::PassTiming;
 
 mod filter_impl;
 mod inner;
@@ -56,6 +58,59 @@ impl FilterChainGL {
         unsafe { Self::load_from_preset(preset, options) }
     }
 
+    /// The number of previous input images that are bound as `OriginalHistory`.
+    ///
+    /// If `zero_copy_history` is enabled, each input texture must stay alive and unmodified for
+    /// this many frames after it is drawn. This may increase once deferred passes are loaded.
+    pub fn history_len(&self) -> usize {
+        match &self.filter {
+            FilterChainDispatch::DirectStateAccess(p) => p.history_len(),
+            FilterChainDispatch::Compatibility(p) => p.history_len(),
+        }
+    }
+
+    /// The GPU time spent drawing each pass, if `time_passes` is enabled.
+    ///
+    /// Timings are read back without waiting on the GPU, so they are from a frame that was
+    /// drawn a few frames earlier. Passes that were skipped in that frame have no timing.
+    pub fn pass_timings(&self) -> &[PassTiming] {
+        match &self.filter {
+            FilterChainDispatch::DirectStateAccess(p) => p.pass_timings(),
+            FilterChainDispatch::Compatibility(p) => p.pass_timings(),
+        }
+    }
+
+    /// Keep the GPU time of a frame within `budget` by drawing passes with viewport scaling at a
+    /// lower resolution, or stop with `None`.
+    ///
+    /// The final pass is always drawn to the full viewport. The scale is chosen from the pass
+    /// timings, so this has no effect unless `time_passes` is enabled.
+    pub fn set_frame_time_budget(&mut self, budget: Option<Duration>) {
+        match &mut self.filter {
+            FilterChainDispatch::DirectStateAccess(p) => p.set_frame_time_budget(budget),
+            FilterChainDispatch::Compatibility(p) => p.set_frame_time_budget(budget),
+        }
+    }
+
+    /// The scale of the viewport that passes with viewport scaling are sized against.
+    pub fn viewport_scale(&self) -> f32 {
+        match &self.filter {
+            FilterChainDispatch::DirectStateAccess(p) => p.viewport_scale(),
+            FilterChainDispatch::Compatibility(p) => p.viewport_scale(),
+        }
+    }
+
+    /// Override the scale of the viewport that passes with viewport scaling are sized against,
+    /// or go back to choosing it from the frame time budget with `None`.
+    ///
+    /// The scale is clamped between 0.25 and 1.
+    pub fn set_viewport_scale(&mut self, scale: Option<f32>) {
+        match &mut self.filter {
+            FilterChainDispatch::DirectStateAccess(p) => p.set_viewport_scale(scale),
+            FilterChainDispatch::Compatibility(p) => p.set_viewport_scale(scale),
+        }
+    }
+
     /// Process a frame with the input image.
     ///
     /// When this frame returns, `GL_FRAMEBUFFER` is bound to 0 if not using Direct State Access.
@@ -76,4 +131,36 @@ impl FilterChainGL {
             },
         }
     }
+
+    /// Process a batch of frames, as if [`frame`](Self::frame) was called for each of them in order.
+    ///
+    /// Each frame is an input texture and the viewport to draw it to. The frames are drawn with
+    /// consecutive frame counts starting at `frame_count`, and history and feedback advance
+    /// between them. The options apply to every frame, except that history is only cleared
+    /// before the first frame. Nothing is flushed between frames, so the driver can submit the
+    /// whole batch at once.
+    pub unsafe fn frame_batch(
+        &mut self,
+        frames: &[(&GLImage, &Viewport<&GLFramebuffer>)],
+        frame_count: usize,
+        options: Option<&FrameOptionsGL>,
+    ) -> Result<()> {
+        let mut options = options.cloned();
+        for (index, (input, viewport)) in frames.iter().enumerate() {
+            unsafe {
+                self.frame(
+                    input,
+                    viewport,
+                    frame_count.wrapping_add(index),
+                    options.as_ref(),
+                )?;
+            }
+
+            if let Some(options) = &mut options {
+                options.clear_history = false;
+            }
+        }
+
+        Ok(())
+    }
 }
@@ -2,8 +2,7 @@ use crate::filter_chain::filter_impl::FilterChainImpl;
 use crate::filter_chain::inner::FilterChainDispatch;
 use crate::gl::GLInterface;
 use crate::FilterChainGL;
-use librashader_runtime::parameters::FilterChainParameters;
-use std::collections::hash_map::Iter;
+use librashader_runtime::parameters::{FilterChainParameters, ParameterHandle, ParameterIter};
 
 impl AsRef<dyn FilterChainParameters + 'static> for FilterChainDispatch {
     fn as_ref<'a>(&'a self) -> &'a (dyn FilterChainParameters + 'static) {
@@ -32,7 +31,7 @@ impl FilterChainParameters for FilterChainGL {
         self.filter.as_mut().set_enabled_pass_count(count)
     }
 
-    fn enumerate_parameters(&self) -> Iter<String, f32> {
+    fn enumerate_parameters(&self) -> ParameterIter<'_> {
         self.filter.as_ref().enumerate_parameters()
     }
 
@@ -43,6 +42,20 @@ impl FilterChainParameters for FilterChainGL {
     fn set_parameter(&mut self, parameter: &str, new_value: f32) -> Option<f32> {
         self.filter.as_mut().set_parameter(parameter, new_value)
     }
+
+    fn get_parameter_handle(&self, parameter: &str) -> Option<ParameterHandle> {
+        self.filter.as_ref().get_parameter_handle(parameter)
+    }
+
+    fn get_parameter_by_handle(&self, handle: ParameterHandle) -> Option<f32> {
+        self.filter.as_ref().get_parameter_by_handle(handle)
+    }
+
+    fn set_parameter_by_handle(&mut self, handle: ParameterHandle, new_value: f32) -> Option<f32> {
+        self.filter
+            .as_mut()
+            .set_parameter_by_handle(handle, new_value)
+    }
 }
 
 impl<T: GLInterface> FilterChainParameters for FilterChainImpl<T> {
@@ -54,30 +67,30 @@ impl<T: GLInterface> FilterChainParameters for FilterChainImpl<T> {
         self.common.config.passes_enabled = count
     }
 
-    fn enumerate_parameters(&self) -> Iter<String, f32> {
+    fn enumerate_parameters(&self) -> ParameterIter<'_> {
         self.common.config.parameters.iter()
     }
 
     fn get_parameter(&self, parameter: &str) -> Option<f32> {
-        self.common
-            .config
-            .parameters
-            .get::<str>(parameter.as_ref())
-            .copied()
+        self.common.config.parameters.get(parameter)
     }
 
     fn set_parameter(&mut self, parameter: &str, new_value: f32) -> Option<f32> {
-        if let Some(value) = self
-            .common
+        self.common.config.parameters.set(parameter, new_value)
+    }
+
+    fn get_parameter_handle(&self, parameter: &str) -> Option<ParameterHandle> {
+        self.common.config.parameters.handle(parameter)
+    }
+
+    fn get_parameter_by_handle(&self, handle: ParameterHandle) -> Option<f32> {
+        self.common.config.parameters.get_by_handle(handle)
+    }
+
+    fn set_parameter_by_handle(&mut self, handle: ParameterHandle, new_value: f32) -> Option<f32> {
+        self.common
             .config
             .parameters
-            .get_mut::<str>(parameter.as_ref())
-        {
-            let old = *value;
-            *value = new_value;
-            Some(old)
-        } else {
-            None
-        }
+            .set_by_handle(handle, new_value)
     }
 }
@@ -4,11 +4,10 @@ use librashader_reflect::reflect::ShaderReflection;
 use librashader_common::{ImageFormat, Size, Viewport};
 use librashader_preprocess::ShaderSource;
 use librashader_presets::ShaderPassConfig;
-use librashader_reflect::reflect::semantics::{MemberOffset, TextureBinding, UniformBinding};
-use librashader_runtime::binding::{BindSemantics, ContextOffset, TextureInput};
+use librashader_reflect::reflect::semantics::{MemberOffset, TextureBinding};
+use librashader_runtime::binding::{BindSemantics, BindingPlan, ContextOffset, TextureInput};
 use librashader_runtime::filter_pass::FilterPassMeta;
 use librashader_runtime::render_target::RenderTarget;
-use rustc_hash::FxHashMap;
 
 use crate::binding::{GlUniformBinder, GlUniformStorage, UniformLocation, VariableLocation};
 use crate::filter_chain::FilterCommon;
@@ -35,7 +34,7 @@ pub(crate) struct FilterPass<T: GLInterface> {
     pub ubo_location: UniformLocation<GLuint>,
     pub ubo_ring: Option<T::UboRing>,
     pub(crate) uniform_storage: GlUniformStorage,
-    pub uniform_bindings: FxHashMap<UniformBinding, UniformOffset>,
+    pub binding_plan: BindingPlan<UniformOffset>,
     pub source: ShaderSource,
     pub config: ShaderPassConfig,
 }
@@ -113,7 +112,7 @@ impl<T: GLInterface> FilterPass<T> {
             && self.ubo_location.fragment != gl::INVALID_INDEX
         {
             if let (Some(ubo), Some(ring)) = (&self.reflection.ubo, &mut self.ubo_ring) {
-                ring.bind_for_frame(ubo, &self.ubo_location, &self.uniform_storage)
+                ring.bind_for_frame(ubo, &self.ubo_location, &mut self.uniform_storage)
             }
         }
 
@@ -181,15 +180,13 @@ impl<T: GLInterface> FilterPass<T> {
             viewport.output.size,
             original,
             source,
-            &self.uniform_bindings,
-            &self.reflection.meta.texture_meta,
+            &self.binding_plan,
             parent.output_textures[0..pass_index]
                 .iter()
                 .map(|o| o.bound()),
             parent.feedback_textures.iter().map(|o| o.bound()),
             parent.history_textures.iter().map(|o| o.bound()),
             parent.luts.iter().map(|(u, i)| (*u, i)),
-            &self.source.parameters,
             &parent.config.parameters,
         );
     }
@@ -2,16 +2,17 @@ use crate::error::Result;
 use crate::framebuffer::GLImage;
 use crate::gl::LoadLut;
 use crate::texture::InputTexture;
-use gl::types::{GLsizei, GLuint};
+use gl::types::{GLint, GLsizei, GLuint};
 use librashader_presets::TextureConfig;
 use librashader_runtime::image::{Image, ImageError, UVDirection};
-use librashader_runtime::scaling::MipmapSize;
 use rayon::prelude::*;
 use rustc_hash::FxHashMap;
+use std::sync::Arc;
 
 pub struct Gl3LutLoad;
 impl LoadLut for Gl3LutLoad {
-    fn load_luts(textures: &[TextureConfig]) -> Result<FxHashMap<usize, InputTexture>> {
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
+    fn load_luts(textures: &[(usize, &TextureConfig)]) -> Result<FxHashMap<usize, InputTexture>> {
         let mut luts = FxHashMap::default();
         let pixel_unpack = unsafe {
             let mut binding = 0;
@@ -21,15 +22,11 @@ impl LoadLut for Gl3LutLoad {
 
         let images = textures
             .par_iter()
-            .map(|texture| Image::load(&texture.path, UVDirection::BottomLeft))
-            .collect::<std::result::Result<Vec<Image>, ImageError>>()?;
+            .map(|(_, texture)| Image::load_shared(&texture.path, UVDirection::BottomLeft))
+            .collect::<std::result::Result<Vec<Arc<Image>>, ImageError>>()?;
 
-        for (index, (texture, image)) in textures.iter().zip(images).enumerate() {
-            let levels = if texture.mipmap {
-                image.size.calculate_miplevels()
-            } else {
-                1u32
-            };
+        for (&(index, texture), image) in textures.iter().zip(images) {
+            let levels = image.level_count(texture.mipmap);
 
             let mut handle = 0;
             unsafe {
@@ -58,8 +55,21 @@ impl LoadLut for Gl3LutLoad {
                     image.bytes.as_ptr().cast(),
                 );
 
-                let mipmap = levels > 1;
-                if mipmap {
+                for (level, mip) in image.mipmaps.iter().take(levels as usize - 1).enumerate() {
+                    gl::TexSubImage2D(
+                        gl::TEXTURE_2D,
+                        level as GLint + 1,
+                        0,
+                        0,
+                        mip.size.width as GLsizei,
+                        mip.size.height as GLsizei,
+                        gl::RGBA,
+                        gl::UNSIGNED_BYTE,
+                        mip.bytes.as_ptr().cast(),
+                    );
+                }
+
+                if image.needs_mipmap_generation(texture.mipmap) {
                     gl::GenerateMipmap(gl::TEXTURE_2D);
                 }
 
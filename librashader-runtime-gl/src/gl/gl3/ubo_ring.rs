@@ -1,6 +1,6 @@
 use crate::binding::UniformLocation;
-use crate::gl::UboRing;
-use gl::types::{GLsizei, GLsizeiptr, GLuint};
+use crate::gl::{UboRing, UboRingState};
+use gl::types::{GLintptr, GLsizei, GLsizeiptr, GLuint};
 use librashader_reflect::reflect::semantics::UboReflection;
 use librashader_runtime::ringbuffer::InlineRingBuffer;
 use librashader_runtime::ringbuffer::RingBuffer;
@@ -8,6 +8,7 @@ use librashader_runtime::uniforms::UniformStorageAccess;
 
 pub struct Gl3UboRing<const SIZE: usize> {
     ring: InlineRingBuffer<GLuint, SIZE>,
+    state: UboRingState<SIZE>,
 }
 
 impl<const SIZE: usize> UboRing<SIZE> for Gl3UboRing<SIZE> {
@@ -26,27 +27,34 @@ impl<const SIZE: usize> UboRing<SIZE> for Gl3UboRing<SIZE> {
             }
             gl::BindBuffer(gl::UNIFORM_BUFFER, 0);
         }
-        Gl3UboRing { ring }
+        Gl3UboRing {
+            ring,
+            state: UboRingState::new(buffer_size),
+        }
     }
 
     fn bind_for_frame(
         &mut self,
-        ubo: &UboReflection,
+        _ubo: &UboReflection,
         ubo_location: &UniformLocation<GLuint>,
-        storage: &impl UniformStorageAccess,
+        storage: &mut impl UniformStorageAccess,
     ) {
-        let size = ubo.size;
-        let buffer = self.ring.current();
+        let slot = self
+            .state
+            .next(self.ring.current_index(), storage.take_ubo_dirty());
+        let buffer = &self.ring.items()[slot.index];
 
         unsafe {
-            gl::BindBuffer(gl::UNIFORM_BUFFER, *buffer);
-            gl::BufferSubData(
-                gl::UNIFORM_BUFFER,
-                0,
-                size as GLsizeiptr,
-                storage.ubo_pointer().cast(),
-            );
-            gl::BindBuffer(gl::UNIFORM_BUFFER, 0);
+            if let Some(range) = slot.upload {
+                gl::BindBuffer(gl::UNIFORM_BUFFER, *buffer);
+                gl::BufferSubData(
+                    gl::UNIFORM_BUFFER,
+                    range.start as GLintptr,
+                    range.len() as GLsizeiptr,
+                    storage.ubo_pointer().add(range.start).cast(),
+                );
+                gl::BindBuffer(gl::UNIFORM_BUFFER, 0);
+            }
 
             if ubo_location.vertex != gl::INVALID_INDEX {
                 gl::BindBufferBase(gl::UNIFORM_BUFFER, ubo_location.vertex, *buffer);
@@ -55,6 +63,9 @@ impl<const SIZE: usize> UboRing<SIZE> for Gl3UboRing<SIZE> {
                 gl::BindBufferBase(gl::UNIFORM_BUFFER, ubo_location.fragment, *buffer);
             }
         }
-        self.ring.next()
+
+        if slot.advance {
+            self.ring.next()
+        }
     }
 }
@@ -14,11 +14,12 @@ use librashader_presets::{Scale2D, TextureConfig};
 use librashader_reflect::back::cross::CrossGlslContext;
 use librashader_reflect::back::ShaderCompilerOutput;
 use librashader_reflect::reflect::semantics::{TextureBinding, UboReflection};
-use librashader_runtime::uniforms::UniformStorageAccess;
+use librashader_runtime::uniforms::{DirtyRange, UniformStorageAccess};
 use rustc_hash::FxHashMap;
+use std::ops::Range;
 
 pub(crate) trait LoadLut {
-    fn load_luts(textures: &[TextureConfig]) -> Result<FxHashMap<usize, InputTexture>>;
+    fn load_luts(textures: &[(usize, &TextureConfig)]) -> Result<FxHashMap<usize, InputTexture>>;
 }
 
 pub(crate) trait CompileProgram {
@@ -40,10 +41,66 @@ pub(crate) trait UboRing<const SIZE: usize> {
         &mut self,
         ubo: &UboReflection,
         ubo_location: &UniformLocation<GLuint>,
-        storage: &impl UniformStorageAccess,
+        storage: &mut impl UniformStorageAccess,
     );
 }
 
+/// Tracks the bytes of each buffer in a UBO ring that are out of date with the uniform storage.
+///
+/// Each buffer in the ring holds the uniforms as they were the last time it was uploaded to,
+/// so every change to the storage since then has to be uploaded when the buffer comes around again.
+pub(crate) struct UboRingState<const SIZE: usize> {
+    stale: [DirtyRange; SIZE],
+    latest: Option<usize>,
+}
+
+/// The buffer in a UBO ring to bind for a frame.
+pub(crate) struct UboRingSlot {
+    /// The index of the buffer in the ring.
+    pub index: usize,
+    /// The range of bytes that must be uploaded to the buffer before it is bound.
+    pub upload: Option<Range<usize>>,
+    /// Whether the ring should advance to the next buffer.
+    pub advance: bool,
+}
+
+impl<const SIZE: usize> UboRingState<SIZE> {
+    pub fn new(buffer_size: u32) -> Self {
+        Self {
+            stale: [DirtyRange::full(buffer_size as usize); SIZE],
+            latest: None,
+        }
+    }
+
+    /// Get the buffer to bind for this frame given the bytes of the uniform storage that
+    /// changed since the last frame.
+    ///
+    /// If nothing changed, the most recently uploaded buffer is bound again without an upload.
+    pub fn next(&mut self, current: usize, dirty: Option<Range<usize>>) -> UboRingSlot {
+        match (dirty, self.latest) {
+            (None, Some(latest)) => UboRingSlot {
+                index: latest,
+                upload: None,
+                advance: false,
+            },
+            (dirty, _) => {
+                if let Some(dirty) = dirty {
+                    for stale in self.stale.iter_mut() {
+                        stale.mark(dirty.clone());
+                    }
+                }
+
+                self.latest = Some(current);
+                UboRingSlot {
+                    index: current,
+                    upload: self.stale[current].take(),
+                    advance: true,
+                }
+            }
+        }
+    }
+}
+
 pub(crate) trait FramebufferInterface {
     fn new(max_levels: u32) -> GLFramebuffer;
     fn scale(
@@ -17,6 +17,7 @@ mod util;
 mod gl;
 mod samplers;
 mod texture;
+mod timing;
 
 pub mod error;
 pub mod options;
@@ -0,0 +1,104 @@
+use gl::types::{GLint, GLuint, GLuint64};
+use librashader_runtime::timing::{PassTimer, PassTiming};
+use std::time::Duration;
+
+/// The number of frames that timer queries are kept for before they are read back.
+const TIMER_SLOTS: usize = 4;
+
+/// Per-pass GPU timing with `GL_TIME_ELAPSED` queries.
+pub(crate) struct GlPassTimer {
+    timer: PassTimer,
+    queries: Box<[Vec<GLuint>]>,
+    slot: usize,
+}
+
+impl GlPassTimer {
+    pub fn new() -> Self {
+        let timer = PassTimer::new(TIMER_SLOTS);
+        let mut queries = Vec::new();
+        queries.resize_with(timer.slots(), Vec::new);
+
+        Self {
+            timer,
+            queries: queries.into_boxed_slice(),
+            slot: 0,
+        }
+    }
+
+    /// Read back the timings of an earlier frame if they are available, and start timing a new frame.
+    pub fn begin_frame<'a>(&mut self, alias: impl Fn(usize) -> Option<&'a str>) {
+        let queries = &self.queries;
+        let slot = self.timer.begin_frame(
+            |slot, count| {
+                let queries = &queries[slot][..count];
+
+                // Queries finish in order, so the rest are available if the last one is.
+                let mut available: GLint = 0;
+                unsafe {
+                    gl::GetQueryObjectiv(
+                        queries[count - 1],
+                        gl::QUERY_RESULT_AVAILABLE,
+                        &mut available,
+                    );
+                }
+
+                if available == 0 {
+                    return Ok(None);
+                }
+
+                let durations = queries
+                    .iter()
+                    .map(|&query| {
+                        let mut elapsed: GLuint64 = 0;
+                        unsafe {
+                            gl::GetQueryObjectui64v(query, gl::QUERY_RESULT, &mut elapsed);
+                        }
+                        Duration::from_nanos(elapsed)
+                    })
+                    .collect();
+                Ok(Some(durations))
+            },
+            alias,
+        );
+
+        self.slot = slot.unwrap_or_else(|never: std::convert::Infallible| match never {});
+    }
+
+    /// Start timing a pass.
+    pub fn begin_pass(&mut self, index: usize) {
+        let position = self.timer.record(index);
+        let queries = &mut self.queries[self.slot];
+        if queries.len() <= position {
+            let mut query = 0;
+            unsafe { gl::GenQueries(1, &mut query) };
+            queries.push(query);
+        }
+
+        unsafe { gl::BeginQuery(gl::TIME_ELAPSED, queries[position]) };
+    }
+
+    /// Stop timing the current pass.
+    pub fn end_pass(&self) {
+        unsafe { gl::EndQuery(gl::TIME_ELAPSED) };
+    }
+
+    /// The most recent timings that were read back.
+    pub fn timings(&self) -> &[PassTiming] {
+        self.timer.timings()
+    }
+
+    /// Whether new timings were read back when this frame began.
+    pub fn updated(&self) -> bool {
+        self.timer.updated()
+    }
+}
+
+impl Drop for GlPassTimer {
+    fn drop(&mut self) {
+        for queries in self.queries.iter() {
+            if !queries.is_empty() {
+                unsafe { gl::DeleteQueries(queries.len() as i32, queries.as_ptr()) };
+            }
+        }
+    }
+}
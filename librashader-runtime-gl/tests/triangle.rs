@@ -15,6 +15,10 @@ fn triangle_gl() {
                 use_dsa: false,
                 force_no_mipmaps: false,
                 disable_cache: false,
+                defer_passes: false,
+                prefetch_passes: false,
+                zero_copy_history: false,
+                time_passes: false,
             }),
         )
         // FilterChain::load_from_path("../test/slang-shaders/bezel/Mega_Bezel/Presets/MBZ__0__SMOOTH-ADV.slangp", None)
@@ -37,6 +41,10 @@ fn triangle_gl46() {
                 use_dsa: true,
                 force_no_mipmaps: false,
                 disable_cache: false,
+                defer_passes: false,
+                prefetch_passes: false,
+                zero_copy_history: false,
+                time_passes: false,
             }),
         )
         // FilterChain::load_from_path("../test/slang-shaders/bezel/Mega_Bezel/Presets/MBZ__0__SMOOTH-ADV.slangp", None)
@@ -0,0 +1,165 @@
+use crate::draw_quad::DrawQuad;
+use crate::error;
+use crate::error::FilterChainError;
+use crate::filter_chain::VulkanObjects;
+use crate::graphics_pipeline::CompiledPipeline;
+use crate::luts::LutTexture;
+use crate::samplers::SamplerSet;
+use ash::vk;
+use librashader_common::{FilterMode, WrapMode};
+use librashader_presets::TextureConfig;
+use librashader_reflect::back::ShaderCompilerOutput;
+use librashader_runtime::image::{Image, BGRA8};
+use parking_lot::Mutex;
+use rustc_hash::{FxHashMap, FxHasher};
+use std::hash::{Hash, Hasher};
+use std::sync::{Arc, Weak};
+
+#[derive(Clone, Copy, PartialEq, Eq, Hash)]
+struct PipelineKey {
+    // A hash of the SPIR-V of both stages, so that looking up a pipeline does not copy it.
+    shader: u64,
+    render_pass_format: vk::Format,
+}
+
+impl PipelineKey {
+    fn new(shader: &ShaderCompilerOutput<Vec<u32>>, render_pass_format: vk::Format) -> Self {
+        let mut hasher = FxHasher::default();
+        shader.vertex.hash(&mut hasher);
+        shader.fragment.hash(&mut hasher);
+        PipelineKey {
+            shader: hasher.finish(),
+            render_pass_format,
+        }
+    }
+}
+
+struct PipelineEntry {
+    vertex: Vec<u32>,
+    fragment: Vec<u32>,
+    pipeline: Weak<CompiledPipeline>,
+}
+
+impl PipelineEntry {
+    fn is_shader(&self, shader: &ShaderCompilerOutput<Vec<u32>>) -> bool {
+        self.vertex == shader.vertex && self.fragment == shader.fragment
+    }
+}
+
+#[derive(Clone, Copy, PartialEq, Eq, Hash)]
+struct LutKey {
+    // The address of the decoded image, which can not be reused while the entry holds a weak
+    // reference to it.
+    image: usize,
+    mipmap: bool,
+    filter_mode: FilterMode,
+    wrap_mode: WrapMode,
+}
+
+struct LutEntry {
+    _image: Weak<Image<BGRA8>>,
+    texture: Weak<LutTexture>,
+}
+
+/// A Vulkan device and the objects that are shared between filter chains on it.
+///
+/// Filter chains created from the same context share the allocator, samplers and vertex buffer of
+/// the context. Identical passes share their compiled pipeline, and identical LUTs share their
+/// texture, for as long as any filter chain is using them.
+///
+/// A LUT texture is uploaded with the command buffer of the filter chain that first loaded it,
+/// so that command buffer must be executed before any filter chain using the LUT draws a frame.
+pub struct VulkanContext {
+    pub(crate) vulkan: VulkanObjects,
+    pub(crate) samplers: SamplerSet,
+    pub(crate) draw_quad: DrawQuad,
+    // Pipelines whose SPIR-V has the same hash are told apart by comparing the SPIR-V.
+    pipelines: Mutex<FxHashMap<PipelineKey, Vec<PipelineEntry>>>,
+    luts: Mutex<FxHashMap<LutKey, LutEntry>>,
+}
+
+impl VulkanContext {
+    /// Create a context for the given device.
+    pub fn new<V, E>(vulkan: V) -> error::Result<Arc<VulkanContext>>
+    where
+        V: TryInto<VulkanObjects, Error = E>,
+        FilterChainError: From<E>,
+    {
+        let vulkan: VulkanObjects = vulkan.try_into().map_err(From::from)?;
+        Ok(Arc::new(VulkanContext {
+            samplers: SamplerSet::new(&vulkan.device)?,
+            draw_quad: DrawQuad::new(&vulkan.device, &vulkan.alloc)?,
+            vulkan,
+            pipelines: Mutex::new(FxHashMap::default()),
+            luts: Mutex::new(FxHashMap::default()),
+        }))
+    }
+
+    /// Get the compiled pipeline for the shader, or compile it if no filter chain is using it.
+    pub(crate) fn compiled_pipeline(
+        &self,
+        shader: &ShaderCompilerOutput<Vec<u32>>,
+        render_pass_format: vk::Format,
+        compile: impl FnOnce() -> error::Result<CompiledPipeline>,
+    ) -> error::Result<Arc<CompiledPipeline>> {
+        let key = PipelineKey::new(shader, render_pass_format);
+
+        if let Some(pipeline) = self
+            .pipelines
+            .lock()
+            .get(&key)
+            .and_then(|entries| entries.iter().find(|entry| entry.is_shader(shader)))
+            .and_then(|entry| entry.pipeline.upgrade())
+        {
+            return Ok(pipeline);
+        }
+
+        // Passes are compiled in parallel, so the lock is not held while compiling.
+        let pipeline = Arc::new(compile()?);
+        let mut pipelines = self.pipelines.lock();
+        pipelines.retain(|_, entries| {
+            entries.retain(|entry| entry.pipeline.strong_count() > 0);
+            !entries.is_empty()
+        });
+
+        let entries = pipelines.entry(key).or_default();
+        entries.retain(|entry| !entry.is_shader(shader));
+        entries.push(PipelineEntry {
+            vertex: shader.vertex.clone(),
+            fragment: shader.fragment.clone(),
+            pipeline: Arc::downgrade(&pipeline),
+        });
+        Ok(pipeline)
+    }
+
+    /// Get the texture for the LUT image, or create it if no filter chain is using it.
+    pub(crate) fn lut_texture(
+        &self,
+        image: &Arc<Image<BGRA8>>,
+        config: &TextureConfig,
+        create: impl FnOnce() -> error::Result<LutTexture>,
+    ) -> error::Result<Arc<LutTexture>> {
+        let key = LutKey {
+            image: Arc::as_ptr(image) as usize,
+            mipmap: config.mipmap,
+            filter_mode: config.filter_mode,
+            wrap_mode: config.wrap_mode,
+        };
+
+        let mut luts = self.luts.lock();
+        if let Some(texture) = luts.get(&key).and_then(|entry| entry.texture.upgrade()) {
+            return Ok(texture);
+        }
+
+        let texture = Arc::new(create()?);
+        luts.retain(|_, entry| entry.texture.strong_count() > 0);
+        luts.insert(
+            key,
+            LutEntry {
+                _image: Arc::downgrade(image),
+                texture: Arc::downgrade(&texture),
+            },
+        );
+        Ok(texture)
+    }
+}
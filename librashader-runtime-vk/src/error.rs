@@ -30,6 +30,12 @@ pub enum FilterChainError {
     AllocationError(#[from] AllocationError),
     #[error("allocation is already freed")]
     AllocationDoesNotExist,
+    #[error("filter chain loading was cancelled")]
+    Cancelled,
+    #[error("the filter chain was loaded for a different device or number of frames in flight")]
+    IncompatibleFilterChain,
+    #[error("a batch can not have more frames than there are frames in flight")]
+    BatchTooLarge,
 }
 
 impl From<Infallible> for FilterChainError {
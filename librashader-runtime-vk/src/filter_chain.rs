@@ -1,4 +1,4 @@
-use crate::draw_quad::DrawQuad;
+use crate::context::VulkanContext;
 use crate::error::FilterChainError;
 use crate::filter_pass::FilterPass;
 use crate::framebuffer::OutputImage;
@@ -7,8 +7,8 @@ use crate::luts::LutTexture;
 use crate::memory::RawVulkanBuffer;
 use crate::options::{FilterChainOptionsVulkan, FrameOptionsVulkan};
 use crate::queue_selection::get_graphics_queue;
-use crate::samplers::SamplerSet;
 use crate::texture::{InputImage, OwnedImage, OwnedImageLayout, VulkanImage};
+use crate::timing::VulkanPassTimer;
 use crate::{error, util};
 use ash::vk;
 use librashader_common::{ImageFormat, Size, Viewport};
@@ -18,31 +18,43 @@ use librashader_presets::{ShaderPassConfig, ShaderPreset, TextureConfig};
 use librashader_reflect::back::targets::SPIRV;
 use librashader_reflect::back::{CompileReflectShader, CompileShader};
 use librashader_reflect::front::GlslangCompilation;
-use librashader_reflect::reflect::presets::{CompilePresetTarget, ShaderPassArtifact};
+use librashader_reflect::reflect::presets::{
+    preprocess_preset_passes, CompilePresetTarget, ShaderPassArtifact, ShaderPassSource,
+};
 use librashader_reflect::reflect::semantics::ShaderSemantics;
 use librashader_reflect::reflect::ReflectShader;
-use librashader_runtime::binding::BindingUtil;
+use librashader_runtime::binding::BindingPlan;
+use librashader_runtime::deferred::{DeferredCompile, DeferredPasses};
 use librashader_runtime::image::{Image, ImageError, UVDirection, BGRA8};
+use librashader_runtime::parameters::RuntimeParameters;
 use librashader_runtime::quad::QuadType;
-use librashader_runtime::uniforms::UniformStorage;
+use librashader_runtime::uniforms::{DirtyRange, UniformStorage};
 use parking_lot::RwLock;
 use rustc_hash::FxHashMap;
+use std::any::Any;
 use std::collections::VecDeque;
-use std::convert::Infallible;
 use std::path::Path;
 use std::sync::Arc;
+use std::time::Duration;
 
 use librashader_cache::CachedCompilation;
 use librashader_runtime::framebuffer::FramebufferInit;
+use librashader_runtime::history::InputHistory;
+use librashader_runtime::loader::{BackgroundLoad, LoadProgress, LoadTracker};
 use librashader_runtime::render_target::RenderTarget;
+use librashader_runtime::resolution::AdaptiveResolution;
 use librashader_runtime::scaling::ScaleFramebuffer;
+use librashader_runtime::timing::PassTiming;
+use librashader_runtime::usage::{FrameState, ResourceUsage};
 use rayon::prelude::*;
 
 /// A Vulkan device and metadata that is required by the shader runtime.
+#[derive(Clone)]
 pub struct VulkanObjects {
     pub(crate) device: Arc<ash::Device>,
     pub(crate) alloc: Arc<RwLock<Allocator>>,
     queue: vk::Queue,
+    timestamp_period: Option<f32>,
     // pub(crate) memory_properties: vk::PhysicalDeviceMemoryProperties,
 }
 
@@ -78,12 +90,14 @@ impl TryFrom<VulkanInstance> for VulkanObjects {
             // let memory_properties =
             //     instance.get_physical_device_memory_properties(vulkan.physical_device);
 
+            let timestamp_period = util::timestamp_period(&instance, vulkan.physical_device);
             let alloc = util::create_allocator(device.clone(), instance, vulkan.physical_device)?;
 
             Ok(VulkanObjects {
                 device: Arc::new(device),
                 alloc,
                 queue,
+                timestamp_period,
                 // memory_properties,
                 // debug,
             })
@@ -101,12 +115,14 @@ impl TryFrom<(vk::PhysicalDevice, ash::Instance, ash::Device)> for VulkanObjects
 
         // let memory_properties = value.1.get_physical_device_memory_properties(value.0);
 
+        let timestamp_period = util::timestamp_period(&value.1, value.0);
         let alloc = util::create_allocator(device.clone(), value.1, value.0)?;
 
         Ok(VulkanObjects {
             alloc,
             device: Arc::new(device),
             queue,
+            timestamp_period,
             // memory_properties,
             // debug: value.3,
         })
@@ -116,24 +132,96 @@ impl TryFrom<(vk::PhysicalDevice, ash::Instance, ash::Device)> for VulkanObjects
 /// A Vulkan filter chain.
 pub struct FilterChainVulkan {
     pub(crate) common: FilterCommon,
-    passes: Box<[FilterPass]>,
+    passes: Vec<FilterPass>,
     vulkan: VulkanObjects,
     output_framebuffers: Box<[OwnedImage]>,
     feedback_framebuffers: Box<[OwnedImage]>,
     history_framebuffers: VecDeque<OwnedImage>,
+    input_history: Option<InputHistory<InputImage>>,
     disable_mipmaps: bool,
+    resize_hysteresis: bool,
+    timer: Option<VulkanPassTimer>,
+    resolution: AdaptiveResolution,
     residuals: Box<[FrameResiduals]>,
+    usage: ResourceUsage,
+    deferred: Option<DeferredState>,
+}
+
+/// Passes that have not yet been compiled, and what is needed to initialize them.
+struct DeferredState {
+    passes: DeferredPasses<ShaderPassSource, ShaderPassMeta, FilterChainError>,
+    semantics: ShaderSemantics,
+    textures: Vec<TextureConfig>,
+    frames_in_flight: u32,
+    use_render_pass: bool,
+    disable_cache: bool,
+}
+
+/// A lookup texture that has been decoded but not yet uploaded.
+type DecodedLut = (usize, TextureConfig, Arc<Image<BGRA8>>);
+
+/// A filter chain whose passes and pipelines are ready, waiting for its lookup textures to be
+/// uploaded with a command buffer.
+struct PreparedFilterChain {
+    context: Arc<VulkanContext>,
+    filters: Vec<FilterPass>,
+    deferred: Option<DeferredState>,
+    parameters: RuntimeParameters,
+    usage: ResourceUsage,
+    luts: Vec<DecodedLut>,
+    pass_count: usize,
+    frames_in_flight: u32,
+    options: FilterChainOptionsVulkan,
+}
+
+/// A Vulkan filter chain that is loading in the background.
+///
+/// Dropping a pending filter chain before it is finished cancels loading, and blocks until the
+/// background work has stopped using the device.
+pub struct PendingFilterChainVulkan {
+    load: BackgroundLoad<error::Result<PreparedFilterChain>>,
+}
+
+impl PendingFilterChainVulkan {
+    /// The progress of compiling the passes of the filter chain.
+    pub fn progress(&self) -> LoadProgress {
+        self.load.progress()
+    }
+
+    /// Whether loading has finished, so that [`finish`](Self::finish) will not block.
+    pub fn is_ready(&self) -> bool {
+        self.load.is_finished()
+    }
+
+    /// Cancel loading. Finishing a cancelled filter chain returns [`FilterChainError::Cancelled`],
+    /// unless loading had already finished.
+    pub fn cancel(&self) {
+        self.load.cancel()
+    }
+
+    /// Finish loading the filter chain, waiting for the background work if it is not ready yet.
+    ///
+    /// Only the lookup textures are uploaded here, and only framebuffers are created.
+    ///
+    /// ## Safety
+    /// The provided command buffer must be ready for recording.
+    /// The caller is responsible for submitting the command buffer to a graphics queue.
+    /// The command buffer must be completely executed before calling [`frame`](FilterChainVulkan::frame)
+    /// on this or any other filter chain created from the same context.
+    pub unsafe fn finish(self, cmd: vk::CommandBuffer) -> error::Result<FilterChainVulkan> {
+        let prepared = self.load.wait()?;
+        unsafe { FilterChainVulkan::finish_prepared(prepared, cmd) }
+    }
 }
 
 pub struct FilterMutable {
     pub(crate) passes_enabled: usize,
-    pub(crate) parameters: FxHashMap<String, f32>,
+    pub(crate) parameters: RuntimeParameters,
 }
 
 pub(crate) struct FilterCommon {
-    pub(crate) luts: FxHashMap<usize, LutTexture>,
-    pub samplers: SamplerSet,
-    pub(crate) draw_quad: DrawQuad,
+    pub(crate) luts: FxHashMap<usize, Arc<LutTexture>>,
+    pub(crate) context: Arc<VulkanContext>,
     pub output_textures: Box<[Option<InputImage>]>,
     pub feedback_textures: Box<[Option<InputImage>]>,
     pub history_textures: Box<[Option<InputImage>]>,
@@ -153,6 +241,7 @@ struct FrameResiduals {
     image_views: Vec<vk::ImageView>,
     owned: Vec<OwnedImage>,
     framebuffers: Vec<Option<vk::Framebuffer>>,
+    retired: Vec<Box<dyn Any + Send + Sync>>,
 }
 
 impl FrameResiduals {
@@ -162,6 +251,7 @@ impl FrameResiduals {
             image_views: Vec::new(),
             owned: Vec::new(),
             framebuffers: Vec::new(),
+            retired: Vec::new(),
         }
     }
 
@@ -169,6 +259,10 @@ impl FrameResiduals {
         self.image_views.push(output_framebuffer.image_view);
     }
 
+    pub(crate) fn dispose_input(&mut self, input: InputImage) {
+        self.image_views.push(input.image_view);
+    }
+
     pub(crate) fn dispose_owned(&mut self, owned: OwnedImage) {
         self.owned.push(owned)
     }
@@ -177,6 +271,12 @@ impl FrameResiduals {
         self.framebuffers.push(fb)
     }
 
+    /// Dispose of objects from passes that were swapped out, which are dropped once the frames
+    /// that used them are no longer in flight.
+    pub(crate) fn dispose_retired(&mut self, object: impl Any + Send + Sync) {
+        self.retired.push(Box::new(object))
+    }
+
     /// Dispose of the intermediate objects created during a frame.
     pub fn dispose(&mut self) {
         for image_view in self.image_views.drain(0..) {
@@ -194,7 +294,8 @@ impl FrameResiduals {
                 }
             }
         }
-        self.owned.clear()
+        self.owned.clear();
+        self.retired.clear();
     }
 }
 
@@ -205,6 +306,19 @@ impl Drop for FrameResiduals {
     }
 }
 
+impl Drop for FilterChainVulkan {
+    fn drop(&mut self) {
+        // The views of previous inputs are released along with the residuals.
+        if let Some(input_history) = &mut self.input_history
+            && let Some(residuals) = self.residuals.first_mut()
+        {
+            for input in input_history.drain() {
+                residuals.dispose_input(input);
+            }
+        }
+    }
+}
+
 type ShaderPassMeta =
     ShaderPassArtifact<impl CompileReflectShader<SPIRV, GlslangCompilation> + Send>;
 fn compile_passes(
@@ -223,6 +337,17 @@ fn compile_passes(
     Ok((passes, semantics))
 }
 
+fn compile_pass(
+    pass: ShaderPassSource,
+    disable_cache: bool,
+) -> Result<ShaderPassMeta, FilterChainError> {
+    if !disable_cache {
+        SPIRV::compile_preset_pass::<CachedCompilation<GlslangCompilation>, FilterChainError>(pass)
+    } else {
+        SPIRV::compile_preset_pass::<GlslangCompilation, FilterChainError>(pass)
+    }
+}
+
 impl FilterChainVulkan {
     /// Load the shader preset at the given path into a filter chain.
     pub unsafe fn load_from_path<V, E>(
@@ -250,9 +375,19 @@ impl FilterChainVulkan {
         V: TryInto<VulkanObjects, Error = E>,
         FilterChainError: From<E>,
     {
-        let vulkan = vulkan.try_into().map_err(|e| e.into())?;
-        let device = Arc::clone(&vulkan.device);
-        let queue = vulkan.queue.clone();
+        let context = VulkanContext::new(vulkan)?;
+        unsafe { Self::load_from_preset_shared(preset, &context, options) }
+    }
+
+    /// Load a filter chain from a pre-parsed `ShaderPreset`, sharing device objects with the other
+    /// filter chains created from the context.
+    pub unsafe fn load_from_preset_shared(
+        preset: ShaderPreset,
+        context: &Arc<VulkanContext>,
+        options: Option<&FilterChainOptionsVulkan>,
+    ) -> error::Result<FilterChainVulkan> {
+        let device = Arc::clone(&context.vulkan.device);
+        let queue = context.vulkan.queue.clone();
 
         let command_pool = unsafe {
             device.create_command_pool(
@@ -281,12 +416,7 @@ impl FilterChainVulkan {
         }
 
         let filter_chain = unsafe {
-            Self::load_from_preset_deferred::<_, Infallible>(
-                preset,
-                vulkan,
-                command_buffer,
-                options,
-            )?
+            Self::load_from_preset_deferred_shared(preset, context, command_buffer, options)?
         };
 
         unsafe {
@@ -321,167 +451,721 @@ impl FilterChainVulkan {
         V: TryInto<VulkanObjects, Error = E>,
         FilterChainError: From<E>,
     {
-        let disable_cache = options.map_or(false, |o| o.disable_cache);
-        let (passes, semantics) = compile_passes(preset.shaders, &preset.textures, disable_cache)?;
+        let context = VulkanContext::new(vulkan)?;
+        unsafe { Self::load_from_preset_deferred_shared(preset, &context, cmd, options) }
+    }
+
+    /// Load a filter chain from a pre-parsed `ShaderPreset`, sharing device objects with the other
+    /// filter chains created from the context, and deferring GPU-side initialization to the caller.
+    ///
+    /// ## Safety
+    /// The provided command buffer must be ready for recording and contain no prior commands.
+    /// The caller is responsible for ending the command buffer and immediately submitting it to a
+    /// graphics queue. The command buffer must be completely executed before calling [`frame`](Self::frame)
+    /// on this or any other filter chain created from the context.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
+    pub unsafe fn load_from_preset_deferred_shared(
+        preset: ShaderPreset,
+        context: &Arc<VulkanContext>,
+        cmd: vk::CommandBuffer,
+        options: Option<&FilterChainOptionsVulkan>,
+    ) -> error::Result<FilterChainVulkan> {
+        let prepared = Self::prepare(preset, context, options, &LoadTracker::default())?;
+        unsafe { Self::finish_prepared(prepared, cmd) }
+    }
+
+    /// Load the shader preset at the given path into a filter chain in the background.
+    ///
+    /// The preset is parsed, its passes compiled and their pipelines created on other threads.
+    /// The returned [`PendingFilterChainVulkan`] can be polled for progress, and is finished
+    /// into a filter chain with [`finish`](PendingFilterChainVulkan::finish).
+    pub unsafe fn load_from_path_async(
+        path: impl AsRef<Path>,
+        context: &Arc<VulkanContext>,
+        options: Option<&FilterChainOptionsVulkan>,
+    ) -> PendingFilterChainVulkan {
+        let path = path.as_ref().to_path_buf();
+        let context = Arc::clone(context);
+        let options = options.cloned();
+
+        PendingFilterChainVulkan {
+            load: BackgroundLoad::spawn(move |tracker| {
+                let preset = ShaderPreset::try_parse(path)?;
+                Self::prepare(preset, &context, options.as_ref(), tracker)
+            }),
+        }
+    }
+
+    /// Load a filter chain from a pre-parsed `ShaderPreset` in the background.
+    ///
+    /// The passes are compiled and their pipelines created on other threads.
+    /// The returned [`PendingFilterChainVulkan`] can be polled for progress, and is finished
+    /// into a filter chain with [`finish`](PendingFilterChainVulkan::finish).
+    pub unsafe fn load_from_preset_async(
+        preset: ShaderPreset,
+        context: &Arc<VulkanContext>,
+        options: Option<&FilterChainOptionsVulkan>,
+    ) -> PendingFilterChainVulkan {
+        let context = Arc::clone(context);
+        let options = options.cloned();
+
+        PendingFilterChainVulkan {
+            load: BackgroundLoad::spawn(move |tracker| {
+                Self::prepare(preset, &context, options.as_ref(), tracker)
+            }),
+        }
+    }
 
-        let device = vulkan.try_into().map_err(From::from)?;
+    /// Do the work of loading a filter chain that does not need a command buffer.
+    fn prepare(
+        preset: ShaderPreset,
+        context: &Arc<VulkanContext>,
+        options: Option<&FilterChainOptionsVulkan>,
+        tracker: &LoadTracker,
+    ) -> error::Result<PreparedFilterChain> {
+        let options = options.cloned().unwrap_or_default();
+        let disable_cache = options.disable_cache;
+        let use_render_pass = options.use_render_pass;
 
-        let mut frames_in_flight = options.map_or(0, |o| o.frames_in_flight);
+        let mut frames_in_flight = options.frames_in_flight;
         if frames_in_flight == 0 {
             frames_in_flight = 3;
         }
 
-        // initialize passes
-        let filters = Self::init_passes(
-            &device,
-            passes,
-            &semantics,
-            frames_in_flight,
-            options.map_or(false, |o| o.use_render_pass),
-            disable_cache,
-        )?;
+        let (filters, deferred, parameters) = if options.defer_passes {
+            // only preprocess here, passes are compiled when they are first enabled.
+            let (passes, semantics) =
+                preprocess_preset_passes::<FilterChainError>(preset.shaders, &preset.textures)?;
+            let parameters =
+                RuntimeParameters::new(passes.iter().map(|(_, source)| source), &preset.parameters);
+
+            let compile: DeferredCompile<ShaderPassSource, ShaderPassMeta, FilterChainError> =
+                Arc::new(move |pass| compile_pass(pass, disable_cache));
+
+            let deferred = DeferredState {
+                passes: DeferredPasses::new(passes, compile, options.prefetch_passes),
+                semantics,
+                textures: preset.textures.clone(),
+                frames_in_flight,
+                use_render_pass,
+                disable_cache,
+            };
+            (Vec::new(), Some(deferred), parameters)
+        } else {
+            tracker.set_pass_count(preset.shader_count as usize);
+            let (passes, semantics) =
+                compile_passes(preset.shaders, &preset.textures, disable_cache)?;
+            let parameters = RuntimeParameters::new(
+                passes.iter().map(|(_, source, _)| source),
+                &preset.parameters,
+            );
 
-        let luts = FilterChainVulkan::load_luts(&device, cmd, &preset.textures)?;
-        let samplers = SamplerSet::new(&device.device)?;
+            // initialize passes
+            let filters = Self::init_passes(
+                context,
+                passes,
+                &semantics,
+                &parameters,
+                frames_in_flight,
+                use_render_pass,
+                disable_cache,
+                tracker,
+            )?;
+            (filters, None, parameters)
+        };
 
-        let framebuffer_gen =
-            || OwnedImage::new(&device, Size::new(1, 1), ImageFormat::R8G8B8A8Unorm, 1);
-        let input_gen = || None;
-        let framebuffer_init = FramebufferInit::new(
-            filters.iter().map(|f| &f.reflection.meta),
-            &framebuffer_gen,
-            &input_gen,
-        );
+        let mut usage = ResourceUsage::new(filters.iter().map(|f| &f.reflection.meta));
+        usage.alias_outputs(&filters);
 
-        // initialize output framebuffers
-        let (output_framebuffers, output_textures) = framebuffer_init.init_output_framebuffers()?;
+        if tracker.is_cancelled() {
+            return Err(FilterChainError::Cancelled);
+        }
 
-        // initialize feedback framebuffers
-        let (feedback_framebuffers, feedback_textures) =
-            framebuffer_init.init_output_framebuffers()?;
+        // decode luts that are used by any pass
+        let luts = FilterChainVulkan::decode_luts(&usage.used_luts(&preset.textures))?;
+
+        Ok(PreparedFilterChain {
+            context: Arc::clone(context),
+            filters,
+            deferred,
+            parameters,
+            usage,
+            luts,
+            pass_count: preset.shader_count as usize,
+            frames_in_flight,
+            options,
+        })
+    }
 
-        // initialize history
-        let (history_framebuffers, history_textures) = framebuffer_init.init_history()?;
+    /// Upload the lookup textures of a prepared filter chain and create its framebuffers.
+    unsafe fn finish_prepared(
+        prepared: PreparedFilterChain,
+        cmd: vk::CommandBuffer,
+    ) -> error::Result<FilterChainVulkan> {
+        let PreparedFilterChain {
+            context,
+            filters,
+            deferred,
+            parameters,
+            usage,
+            luts,
+            pass_count,
+            frames_in_flight,
+            options,
+        } = prepared;
+
+        let luts = FilterChainVulkan::upload_luts(&context, cmd, &luts)?;
+        let device = context.vulkan.clone();
 
         let mut intermediates = Vec::new();
         intermediates.resize_with(frames_in_flight as usize, || {
             FrameResiduals::new(&device.device)
         });
 
-        Ok(FilterChainVulkan {
+        // pass timing is silently unavailable if the queue does not support timestamps.
+        let timer = match device.timestamp_period {
+            Some(timestamp_period) if options.time_passes => Some(VulkanPassTimer::new(
+                &device.device,
+                frames_in_flight,
+                pass_count,
+                timestamp_period,
+            )?),
+            _ => None,
+        };
+
+        let mut filter_chain = FilterChainVulkan {
             common: FilterCommon {
                 luts,
-                samplers,
+                context,
                 config: FilterMutable {
-                    passes_enabled: preset.shader_count as usize,
-                    parameters: preset
-                        .parameters
-                        .into_iter()
-                        .map(|param| (param.name, param.value))
-                        .collect(),
+                    passes_enabled: pass_count,
+                    parameters,
                 },
-                draw_quad: DrawQuad::new(&device.device, &device.alloc)?,
                 device: device.device.clone(),
-                output_textures,
-                feedback_textures,
-                history_textures,
+                output_textures: Box::new([]),
+                feedback_textures: Box::new([]),
+                history_textures: Box::new([]),
                 internal_frame_count: 0,
             },
             passes: filters,
             vulkan: device,
-            output_framebuffers,
-            feedback_framebuffers,
-            history_framebuffers,
+            output_framebuffers: Box::new([]),
+            feedback_framebuffers: Box::new([]),
+            history_framebuffers: VecDeque::new(),
+            input_history: options.zero_copy_history.then(|| InputHistory::new(0)),
             residuals: intermediates.into_boxed_slice(),
-            disable_mipmaps: options.map_or(false, |o| o.force_no_mipmaps),
-        })
+            disable_mipmaps: options.force_no_mipmaps,
+            resize_hysteresis: options.resize_hysteresis,
+            timer,
+            resolution: AdaptiveResolution::default(),
+            usage,
+            deferred,
+        };
+
+        filter_chain.init_framebuffers()?;
+        Ok(filter_chain)
     }
 
-    fn init_passes(
+    /// Replace the passes of this filter chain with those of a filter chain that was loaded in
+    /// the background, waiting for it if it is not ready yet.
+    ///
+    /// The new passes are drawn from the next frame on, without waiting on the GPU. History is
+    /// kept, and a new pass keeps the feedback of the pass it replaces if both use the same shader.
+    /// Other framebuffers are reused by the new passes where possible. Everything else is released
+    /// once the last frame that was drawn is no longer in flight.
+    ///
+    /// The pending filter chain must have been loaded for the same device with the same
+    /// `frames_in_flight`. Options that do not apply to compiling passes are kept from this
+    /// filter chain. If the new passes are deferred, history and feedback are reset once they
+    /// are loaded.
+    ///
+    /// ## Safety
+    /// The provided command buffer must be ready for recording, and is used to upload the lookup
+    /// textures of the new passes. The caller is responsible for submitting the command buffer to
+    /// a graphics queue before the next frame is drawn, which recording the next frame to the
+    /// same command buffer satisfies.
+    pub unsafe fn swap(
+        &mut self,
+        pending: PendingFilterChainVulkan,
+        cmd: vk::CommandBuffer,
+    ) -> error::Result<()> {
+        let PreparedFilterChain {
+            context,
+            filters,
+            deferred,
+            parameters,
+            usage,
+            luts,
+            pass_count,
+            frames_in_flight,
+            options: _,
+        } = pending.load.wait()?;
+
+        if context.vulkan.device.handle() != self.vulkan.device.handle()
+            || frames_in_flight as usize != self.residuals.len()
+        {
+            return Err(FilterChainError::IncompatibleFilterChain);
+        }
+
+        // everything that can fail is done before the filter chain is changed, so that it is
+        // left as it was if swapping fails.
+        let timer = match (&self.timer, self.vulkan.timestamp_period) {
+            (Some(_), Some(timestamp_period)) => Some(VulkanPassTimer::new(
+                &self.vulkan.device,
+                frames_in_flight,
+                pass_count,
+                timestamp_period,
+            )?),
+            _ => None,
+        };
+
+        // a pass with the same shader as the old pass at its index keeps its framebuffers,
+        // so that its feedback carries over.
+        let unchanged: Vec<bool> = filters
+            .iter()
+            .enumerate()
+            .map(|(index, pass)| {
+                self.passes.get(index).is_some_and(|old| {
+                    old.source.vertex == pass.source.vertex
+                        && old.source.fragment == pass.source.fragment
+                })
+            })
+            .collect();
+
+        // the rest of the old framebuffers are resized for the new passes when they are drawn,
+        // and only the framebuffers that are missing are created.
+        let kept = unchanged.iter().filter(|&&unchanged| unchanged).count();
+        let needed = 2 * (filters.len() - kept);
+        let spare_len = 2 * (self.passes.len() - kept);
+        let created = (spare_len..needed)
+            .map(|_| Self::create_framebuffer(&self.vulkan, self.resize_hysteresis))
+            .collect::<error::Result<Vec<_>>>()?;
+
+        // keep the most recent history that the new passes read.
+        let framebuffer_gen = || Self::create_framebuffer(&self.vulkan, self.resize_hysteresis);
+        let input_gen = || None;
+        let framebuffer_init = FramebufferInit::new(
+            filters.iter().map(|f| &f.reflection.meta),
+            &framebuffer_gen,
+            &input_gen,
+        );
+        let (history_framebuffers, history_textures) = match &self.input_history {
+            Some(_) => (None, framebuffer_init.init_history_views()),
+            None => {
+                let (history_framebuffers, history_textures) = framebuffer_init.init_history()?;
+                (Some(history_framebuffers), history_textures)
+            }
+        };
+
+        let luts = FilterChainVulkan::upload_luts(&context, cmd, &luts)?;
+
+        // the last frame may still be in flight, so anything it used is released with its residuals.
+        let old_passes = std::mem::replace(&mut self.passes, filters);
+        let mut old_output: Vec<_> = std::mem::take(&mut self.output_framebuffers)
+            .into_vec()
+            .into_iter()
+            .map(Some)
+            .collect();
+        let mut old_feedback: Vec<_> = std::mem::take(&mut self.feedback_framebuffers)
+            .into_vec()
+            .into_iter()
+            .map(Some)
+            .collect();
+
+        let mut output_framebuffers = Vec::with_capacity(self.passes.len());
+        let mut feedback_framebuffers = Vec::with_capacity(self.passes.len());
+        for (index, &unchanged) in unchanged.iter().enumerate() {
+            if unchanged {
+                output_framebuffers.push(old_output[index].take());
+                feedback_framebuffers.push(old_feedback[index].take());
+            } else {
+                output_framebuffers.push(None);
+                feedback_framebuffers.push(None);
+            }
+        }
+
+        let mut spare = old_output.into_iter().chain(old_feedback).flatten();
+        let mut created = created.into_iter();
+        let mut reuse = |framebuffer: Option<OwnedImage>, clear: bool| {
+            if let Some(framebuffer) = framebuffer {
+                return framebuffer;
+            }
+
+            match spare.next() {
+                Some(framebuffer) => {
+                    // feedback from a different shader is not carried over.
+                    if clear {
+                        framebuffer.clear(cmd);
+                    }
+                    framebuffer
+                }
+                // panic safety: enough framebuffers were created for those that are not spare.
+                None => created.next().unwrap(),
+            }
+        };
+
+        let output_framebuffers: Vec<_> = output_framebuffers
+            .into_iter()
+            .map(|framebuffer| reuse(framebuffer, false))
+            .collect();
+        let feedback_framebuffers: Vec<_> = feedback_framebuffers
+            .into_iter()
+            .map(|framebuffer| reuse(framebuffer, true))
+            .collect();
+        let spare: Vec<_> = spare.collect();
+
+        let mut old_inputs = Vec::new();
+        let mut old_history = Vec::new();
+        match (&mut self.input_history, history_framebuffers) {
+            (Some(input_history), _) => {
+                old_inputs.extend(input_history.set_capacity(history_textures.len()));
+            }
+            (None, Some(mut history_framebuffers)) => {
+                let kept =
+                    std::cmp::min(history_framebuffers.len(), self.history_framebuffers.len());
+                old_history.extend(self.history_framebuffers.drain(kept..));
+                history_framebuffers.truncate(history_framebuffers.len() - kept);
+                self.history_framebuffers.extend(history_framebuffers);
+            }
+            (None, None) => {}
+        }
+
+        let residuals_len = self.residuals.len();
+        let residuals = &mut self.residuals
+            [(self.common.internal_frame_count + residuals_len - 1) % residuals_len];
+        for image in spare.into_iter().chain(old_history) {
+            residuals.dispose_owned(image);
+        }
+        for input in old_inputs {
+            residuals.dispose_input(input);
+        }
+        residuals.dispose_retired(old_passes);
+        residuals.dispose_retired(std::mem::replace(&mut self.common.luts, luts));
+        residuals.dispose_retired(std::mem::replace(&mut self.common.context, context));
+        if let Some(old_timer) = std::mem::replace(&mut self.timer, timer) {
+            residuals.dispose_retired(old_timer);
+        }
+
+        self.output_framebuffers = output_framebuffers.into_boxed_slice();
+        self.feedback_framebuffers = feedback_framebuffers.into_boxed_slice();
+        self.common.output_textures = vec![None; self.passes.len()].into_boxed_slice();
+        self.common.feedback_textures = vec![None; self.passes.len()].into_boxed_slice();
+        self.common.history_textures = history_textures;
+        self.common.config = FilterMutable {
+            passes_enabled: pass_count,
+            parameters,
+        };
+        self.usage = usage;
+        self.deferred = deferred;
+        Ok(())
+    }
+
+    /// Create a framebuffer that is resized before it is first drawn to.
+    fn create_framebuffer(
         vulkan: &VulkanObjects,
+        resize_hysteresis: bool,
+    ) -> error::Result<OwnedImage> {
+        if resize_hysteresis {
+            OwnedImage::new_with_hysteresis(vulkan, Size::new(1, 1), ImageFormat::R8G8B8A8Unorm, 1)
+        } else {
+            OwnedImage::new(vulkan, Size::new(1, 1), ImageFormat::R8G8B8A8Unorm, 1)
+        }
+    }
+
+    /// Initialize output, feedback and history framebuffers for the loaded passes.
+    ///
+    /// Any previous framebuffers are released once the current frame is no longer in flight.
+    fn init_framebuffers(&mut self) -> error::Result<()> {
+        let framebuffer_gen = || Self::create_framebuffer(&self.vulkan, self.resize_hysteresis);
+        let input_gen = || None;
+        let framebuffer_init = FramebufferInit::new(
+            self.passes.iter().map(|f| &f.reflection.meta),
+            &framebuffer_gen,
+            &input_gen,
+        );
+
+        // initialize output framebuffers
+        let (output_framebuffers, output_textures) = framebuffer_init.init_output_framebuffers()?;
+
+        // initialize feedback framebuffers
+        let (feedback_framebuffers, feedback_textures) =
+            framebuffer_init.init_output_framebuffers()?;
+
+        // initialize history
+        let mut old_inputs = Vec::new();
+        let (history_framebuffers, history_textures) = match &mut self.input_history {
+            Some(input_history) => {
+                let history_textures = framebuffer_init.init_history_views();
+                old_inputs.extend(input_history.drain());
+                *input_history = InputHistory::new(history_textures.len());
+                (VecDeque::new(), history_textures)
+            }
+            None => framebuffer_init.init_history()?,
+        };
+
+        let old_output = std::mem::replace(&mut self.output_framebuffers, output_framebuffers);
+        let old_feedback =
+            std::mem::replace(&mut self.feedback_framebuffers, feedback_framebuffers);
+        let old_history = std::mem::replace(&mut self.history_framebuffers, history_framebuffers);
+
+        let residuals =
+            &mut self.residuals[self.common.internal_frame_count % self.residuals.len()];
+        for image in old_output
+            .into_vec()
+            .into_iter()
+            .chain(old_feedback.into_vec())
+            .chain(old_history)
+        {
+            residuals.dispose_owned(image);
+        }
+        for input in old_inputs {
+            residuals.dispose_input(input);
+        }
+
+        self.common.output_textures = output_textures;
+        self.common.feedback_textures = feedback_textures;
+        self.common.history_textures = history_textures;
+        Ok(())
+    }
+
+    /// Compile and initialize deferred passes until every enabled pass is loaded.
+    ///
+    /// Lookup textures used by the new passes are uploaded with the given command buffer.
+    /// If a deferred pass or its LUTs fail to load, the error is returned, the filter chain is
+    /// left with the passes it had before, and the pass is retried the next time passes are
+    /// loaded, so every frame fails until it is disabled again.
+    fn load_deferred_passes(&mut self, cmd: vk::CommandBuffer) -> error::Result<()> {
+        let Some(deferred) = &mut self.deferred else {
+            return Ok(());
+        };
+
+        let loaded = self.passes.len();
+        let count = self.common.config.passes_enabled;
+        if loaded >= count {
+            return Ok(());
+        }
+
+        let context = &self.common.context;
+        let parameters = &self.common.config.parameters;
+        let filters = deferred.passes.take(count - loaded).and_then(|passes| {
+            passes
+                .into_par_iter()
+                .enumerate()
+                .map(|(index, pass)| {
+                    Self::init_pass(
+                        context,
+                        loaded + index,
+                        pass,
+                        &deferred.semantics,
+                        parameters,
+                        deferred.frames_in_flight,
+                        deferred.use_render_pass,
+                        deferred.disable_cache,
+                    )
+                })
+                .collect::<error::Result<Vec<_>>>()
+        });
+
+        let filters = match filters {
+            Ok(filters) => filters,
+            Err(error) => {
+                // Keep the failed passes queued, so the error is reported again the next time
+                // they are loaded instead of silently drawing fewer passes.
+                deferred.passes.restore();
+                return Err(error);
+            }
+        };
+
+        self.passes.extend(filters);
+        let mut usage = ResourceUsage::new(self.passes.iter().map(|f| &f.reflection.meta));
+        usage.alias_outputs(&self.passes);
+        let previous_usage = std::mem::replace(&mut self.usage, usage);
+
+        // load any luts that the new passes use
+        let textures: Vec<_> = self
+            .usage
+            .used_luts(&deferred.textures)
+            .into_iter()
+            .filter(|(index, _)| !self.common.luts.contains_key(index))
+            .collect();
+
+        // history and feedback are reset as the set of passes has changed.
+        let result =
+            FilterChainVulkan::load_luts(&self.common.context, cmd, &textures).and_then(|luts| {
+                self.common.luts.extend(luts);
+                self.init_framebuffers()
+            });
+
+        if let Err(error) = result {
+            // Go back to the passes that were loaded before, which the framebuffers still
+            // match, and keep the new passes queued.
+            self.passes.truncate(loaded);
+            self.usage = previous_usage;
+            if let Some(deferred) = &mut self.deferred {
+                deferred.passes.restore();
+            }
+            return Err(error);
+        }
+
+        if self
+            .deferred
+            .as_ref()
+            .is_some_and(|deferred| deferred.passes.remaining() == 0)
+        {
+            self.deferred = None;
+        }
+        Ok(())
+    }
+
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
+    fn init_passes(
+        context: &VulkanContext,
         passes: Vec<ShaderPassMeta>,
         semantics: &ShaderSemantics,
+        parameters: &RuntimeParameters,
         frames_in_flight: u32,
         use_render_pass: bool,
         disable_cache: bool,
-    ) -> error::Result<Box<[FilterPass]>> {
-        let frames_in_flight = std::cmp::max(1, frames_in_flight);
-
+        tracker: &LoadTracker,
+    ) -> error::Result<Vec<FilterPass>> {
         let filters: Vec<error::Result<FilterPass>> = passes
             .into_par_iter()
             .enumerate()
-            .map(|(index, (config, source, mut reflect))| {
-                let reflection = reflect.reflect(index, semantics)?;
-                let spirv_words = reflect.compile(None)?;
+            .map(|(index, pass)| {
+                if tracker.is_cancelled() {
+                    return Err(FilterChainError::Cancelled);
+                }
+
+                let filter = Self::init_pass(
+                    context,
+                    index,
+                    pass,
+                    semantics,
+                    parameters,
+                    frames_in_flight,
+                    use_render_pass,
+                    disable_cache,
+                )?;
+                tracker.pass_loaded();
+                Ok(filter)
+            })
+            .collect();
+
+        filters.into_iter().collect()
+    }
+
+    fn init_pass(
+        context: &VulkanContext,
+        index: usize,
+        (config, source, mut reflect): ShaderPassMeta,
+        semantics: &ShaderSemantics,
+        parameters: &RuntimeParameters,
+        frames_in_flight: u32,
+        use_render_pass: bool,
+        disable_cache: bool,
+    ) -> error::Result<FilterPass> {
+        let vulkan = &context.vulkan;
+        let frames_in_flight = std::cmp::max(1, frames_in_flight);
 
-                let ubo_size = reflection.ubo.as_ref().map_or(0, |ubo| ubo.size as usize);
-                let uniform_storage = UniformStorage::new_with_ubo_storage(
+        let reflection = reflect.reflect(index, semantics)?;
+        let spirv_words = reflect.compile(None)?;
+
+        let ubo_size = reflection.ubo.as_ref().map_or(0, |ubo| ubo.size as usize);
+        let uniform_storage = UniformStorage::new(
+            ubo_size,
+            reflection
+                .push_constant
+                .as_ref()
+                .map_or(0, |push| push.size as usize),
+        );
+
+        let uniform_buffers = match &reflection.ubo {
+            Some(_) => (0..frames_in_flight)
+                .map(|_| {
                     RawVulkanBuffer::new(
                         &vulkan.device,
                         &vulkan.alloc,
                         vk::BufferUsageFlags::UNIFORM_BUFFER,
                         ubo_size,
-                    )?,
-                    reflection
-                        .push_constant
-                        .as_ref()
-                        .map_or(0, |push| push.size as usize),
-                );
-
-                let uniform_bindings = reflection.meta.create_binding_map(|param| param.offset());
-
-                let render_pass_format = if !use_render_pass {
-                    vk::Format::UNDEFINED
-                } else if let Some(format) = config.get_format_override() {
-                    format.into()
-                } else if source.format != ImageFormat::Unknown {
-                    source.format.into()
-                } else {
-                    ImageFormat::R8G8B8A8Unorm.into()
-                };
-
-                let graphics_pipeline = VulkanGraphicsPipeline::new(
-                    &vulkan.device,
-                    &spirv_words,
-                    &reflection,
-                    frames_in_flight,
-                    render_pass_format,
-                    disable_cache,
-                )?;
-
-                Ok(FilterPass {
-                    device: vulkan.device.clone(),
-                    reflection,
-                    // compiled: spirv_words,
-                    uniform_storage,
-                    uniform_bindings,
-                    source,
-                    config,
-                    graphics_pipeline,
-                    // ubo_ring,
-                    frames_in_flight,
+                    )
                 })
-            })
-            .collect();
+                .collect::<error::Result<Vec<_>>>()?
+                .into_boxed_slice(),
+            None => Box::new([]),
+        };
+        let uniform_stale =
+            vec![DirtyRange::full(ubo_size); uniform_buffers.len()].into_boxed_slice();
+
+        let binding_plan = BindingPlan::new(&reflection.meta, parameters, |param| param.offset());
+
+        let render_pass_format = if !use_render_pass {
+            vk::Format::UNDEFINED
+        } else if let Some(format) = config.get_format_override() {
+            format.into()
+        } else if source.format != ImageFormat::Unknown {
+            source.format.into()
+        } else {
+            ImageFormat::R8G8B8A8Unorm.into()
+        };
+
+        let graphics_pipeline = VulkanGraphicsPipeline::new(
+            context,
+            &spirv_words,
+            &reflection,
+            frames_in_flight,
+            render_pass_format,
+            disable_cache,
+        )?;
 
-        let filters: error::Result<Vec<FilterPass>> = filters.into_iter().collect();
-        let filters = filters?;
-        Ok(filters.into_boxed_slice())
+        Ok(FilterPass {
+            device: vulkan.device.clone(),
+            reflection,
+            // compiled: spirv_words,
+            uniform_storage,
+            uniform_buffers,
+            uniform_stale,
+            binding_plan,
+            source,
+            config,
+            graphics_pipeline,
+            frames_in_flight,
+        })
     }
 
     fn load_luts(
-        vulkan: &VulkanObjects,
+        context: &VulkanContext,
         command_buffer: vk::CommandBuffer,
-        textures: &[TextureConfig],
-    ) -> error::Result<FxHashMap<usize, LutTexture>> {
-        let mut luts = FxHashMap::default();
+        textures: &[(usize, &TextureConfig)],
+    ) -> error::Result<FxHashMap<usize, Arc<LutTexture>>> {
+        let images = Self::decode_luts(textures)?;
+        Self::upload_luts(context, command_buffer, &images)
+    }
+
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
+    fn decode_luts(textures: &[(usize, &TextureConfig)]) -> error::Result<Vec<DecodedLut>> {
         let images = textures
             .par_iter()
-            .map(|texture| Image::load(&texture.path, UVDirection::TopLeft))
-            .collect::<Result<Vec<Image<BGRA8>>, ImageError>>()?;
-        for (index, (texture, image)) in textures.iter().zip(images).enumerate() {
-            let texture = LutTexture::new(vulkan, command_buffer, image, texture)?;
-            luts.insert(index, texture);
+            .map(|(_, texture)| Image::load_shared(&texture.path, UVDirection::TopLeft))
+            .collect::<Result<Vec<Arc<Image<BGRA8>>>, ImageError>>()?;
+        Ok(textures
+            .iter()
+            .zip(images)
+            .map(|(&(index, texture), image)| (index, texture.clone(), image))
+            .collect())
+    }
+
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all))]
+    fn upload_luts(
+        context: &VulkanContext,
+        command_buffer: vk::CommandBuffer,
+        images: &[DecodedLut],
+    ) -> error::Result<FxHashMap<usize, Arc<LutTexture>>> {
+        let mut luts = FxHashMap::default();
+        for (index, texture, image) in images {
+            let texture = context.lut_texture(image, texture, || {
+                LutTexture::new(&context.vulkan, command_buffer, image, texture)
+            })?;
+            luts.insert(*index, texture);
         }
         Ok(luts)
     }
@@ -541,6 +1225,46 @@ impl FilterChainVulkan {
 
         Ok(())
     }
+    /// The number of previous input images that are bound as `OriginalHistory`.
+    ///
+    /// If `zero_copy_history` is enabled, each input image must stay alive and unmodified for
+    /// this many frames after it is drawn, and be in the `VK_SHADER_READ_ONLY_OPTIMAL` layout
+    /// whenever a frame is recorded. This may increase once deferred passes are loaded.
+    pub fn history_len(&self) -> usize {
+        self.common.history_textures.len()
+    }
+
+    /// The GPU time spent drawing each pass, if `time_passes` is enabled.
+    ///
+    /// Timings are read back once the frame they were recorded in is no longer in flight,
+    /// so they are a few frames old. Passes that were skipped in that frame have no timing.
+    /// Timing is not available if the device does not support timestamps on graphics queues.
+    pub fn pass_timings(&self) -> &[PassTiming] {
+        self.timer.as_ref().map_or(&[], |timer| timer.timings())
+    }
+
+    /// Keep the GPU time of a frame within `budget` by drawing passes with viewport scaling at a
+    /// lower resolution, or stop with `None`.
+    ///
+    /// The final pass is always drawn to the full viewport. The scale is chosen from the pass
+    /// timings, so this has no effect unless `time_passes` is enabled and supported.
+    pub fn set_frame_time_budget(&mut self, budget: Option<Duration>) {
+        self.resolution.set_budget(budget)
+    }
+
+    /// The scale of the viewport that passes with viewport scaling are sized against.
+    pub fn viewport_scale(&self) -> f32 {
+        self.resolution.scale()
+    }
+
+    /// Override the scale of the viewport that passes with viewport scaling are sized against,
+    /// or go back to choosing it from the frame time budget with `None`.
+    ///
+    /// The scale is clamped between 0.25 and 1.
+    pub fn set_viewport_scale(&mut self, scale: Option<f32>) {
+        self.resolution.set_override(scale)
+    }
+
     /// Records shader rendering commands to the provided command buffer.
     ///
     /// * The input image must be in the `VK_SHADER_READ_ONLY_OPTIMAL` layout.
@@ -549,6 +1273,7 @@ impl FilterChainVulkan {
     /// librashader **will not** create a pipeline barrier for the final pass. The output image will
     /// remain in `VK_COLOR_ATTACHMENT_OPTIMAL` after all shader passes. The caller must transition
     /// the output image to the final layout.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all, fields(frame = frame_count)))]
     pub unsafe fn frame(
         &mut self,
         input: &VulkanImage,
@@ -557,9 +1282,13 @@ impl FilterChainVulkan {
         frame_count: usize,
         options: Option<&FrameOptionsVulkan>,
     ) -> error::Result<()> {
+        self.residuals[self.common.internal_frame_count % self.residuals.len()].dispose();
+
+        // compile any deferred passes that have since been enabled.
+        self.load_deferred_passes(cmd)?;
+
         let intermediates =
             &mut self.residuals[self.common.internal_frame_count % self.residuals.len()];
-        intermediates.dispose();
 
         // limit number of passes to those enabled.
         let max = std::cmp::min(self.passes.len(), self.common.config.passes_enabled);
@@ -570,6 +1299,11 @@ impl FilterChainVulkan {
                 for history in &mut self.history_framebuffers {
                     history.clear(cmd);
                 }
+                if let Some(input_history) = &mut self.input_history {
+                    for input in input_history.drain() {
+                        intermediates.dispose_input(input);
+                    }
+                }
             }
         }
 
@@ -577,6 +1311,16 @@ impl FilterChainVulkan {
             return Ok(());
         }
 
+        if let Some(timer) = &mut self.timer {
+            let passes = &*passes;
+            timer.begin_frame(cmd, |index| {
+                passes.get(index).and_then(|p| p.config.alias.as_deref())
+            })?;
+            if timer.updated() {
+                self.resolution.update(timer.timings());
+            }
+        }
+
         let original_image_view = unsafe {
             let create_info = vk::ImageViewCreateInfo::builder()
                 .image(input.image)
@@ -603,6 +1347,12 @@ impl FilterChainVulkan {
         let wrap_mode = passes[0].config.wrap_mode;
 
         // update history
+        if let Some(input_history) = &self.input_history {
+            for (index, texture) in self.common.history_textures.iter_mut().enumerate() {
+                *texture = input_history.get(index).cloned();
+            }
+        }
+
         for (texture, image) in self
             .common
             .history_textures
@@ -623,7 +1373,7 @@ impl FilterChainVulkan {
         let mut source = original.clone();
 
         // swap output and feedback **before** recording command buffers
-        std::mem::swap(
+        self.usage.swap_feedback(
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
         );
@@ -631,10 +1381,11 @@ impl FilterChainVulkan {
         // rescale render buffers to ensure all bindings are valid.
         OwnedImage::scale_framebuffers_with_context(
             source.image.size,
-            viewport.output.size,
+            self.resolution.scale_viewport(viewport.output.size),
             &mut self.output_framebuffers,
             &mut self.feedback_framebuffers,
             passes,
+            &self.usage,
             &Some(OwnedImageLayout {
                 dst_layout: vk::ImageLayout::SHADER_READ_ONLY_OPTIMAL,
                 dst_access: vk::AccessFlags::SHADER_READ,
@@ -647,22 +1398,65 @@ impl FilterChainVulkan {
                        output: &OwnedImage,
                        feedback: &OwnedImage| {
                 // refresh inputs
-                self.common.feedback_textures[index] =
-                    Some(feedback.as_input(pass.config.filter, pass.config.wrap_mode));
+                if self.usage.is_feedback_used(index) {
+                    self.common.feedback_textures[index] =
+                        Some(feedback.as_input(pass.config.filter, pass.config.wrap_mode));
+                }
                 self.common.output_textures[index] =
                     Some(output.as_input(pass.config.filter, pass.config.wrap_mode));
                 Ok(())
             }),
         )?;
 
+        // Images recreated in place may still be used by frames in flight.
+        let mut recreated = false;
+        for image in self
+            .output_framebuffers
+            .iter_mut()
+            .chain(self.feedback_framebuffers.iter_mut())
+        {
+            for retired in image.take_retired() {
+                intermediates.dispose_retired(retired);
+            }
+            recreated |= image.take_recreated();
+        }
+
+        // Resized framebuffers no longer hold the output of the last frame, which can happen
+        // with the same frame state once resize hysteresis shrinks their memory.
+        if recreated {
+            self.usage.invalidate_frame();
+        }
+
         let passes_len = passes.len();
         let (pass, last) = passes.split_at_mut(passes_len - 1);
 
         let frame_direction = options.map_or(1, |f| f.frame_direction);
+        let frame_state = FrameState {
+            input_size: input.size,
+            output_size: viewport.output.size,
+            viewport_scale: self.resolution.scale(),
+            enabled: passes_len,
+            parameters: self.common.config.parameters.generation(),
+            mvp: viewport.mvp.copied(),
+        };
+        let frame_passes = self
+            .usage
+            .begin_frame(frame_state, options.map_or(false, |o| o.input_unchanged));
 
-        self.common.draw_quad.bind_vbo_for_frame(cmd);
+        self.common.context.draw_quad.bind_vbo_for_frame(cmd);
         for (index, pass) in pass.iter_mut().enumerate() {
-            let target = &self.output_framebuffers[index];
+            // skip passes that do not contribute to the final output.
+            if !frame_passes.is_live(index) {
+                continue;
+            }
+
+            // the output of the last frame is still valid if nothing the pass reads changed.
+            if frame_passes.is_reused(index) {
+                source = self.common.output_textures[index].clone().unwrap();
+                continue;
+            }
+
+            let target = &self.output_framebuffers[frame_passes.output_slot(index)];
             source.filter_mode = pass.config.filter;
             source.wrap_mode = pass.config.wrap_mode;
             source.mip_filter = pass.config.filter;
@@ -670,6 +1464,10 @@ impl FilterChainVulkan {
             let output_image = OutputImage::new(&self.vulkan, target.image.clone())?;
             let out = RenderTarget::identity(&output_image);
 
+            let timed = self
+                .timer
+                .as_mut()
+                .map_or(false, |timer| timer.begin_pass(cmd, index));
             let residual_fb = pass.draw(
                 cmd,
                 index,
@@ -689,6 +1487,10 @@ impl FilterChainVulkan {
                 out.output.end_pass(cmd);
             }
 
+            if timed && let Some(timer) = &mut self.timer {
+                timer.end_pass(cmd);
+            }
+
             source = self.common.output_textures[index].clone().unwrap();
             intermediates.dispose_outputs(output_image);
             intermediates.dispose_framebuffers(residual_fb);
@@ -697,7 +1499,7 @@ impl FilterChainVulkan {
         // try to hint the optimizer
         assert_eq!(last.len(), 1);
         if let Some(pass) = last.iter_mut().next() {
-            if let Some(format) = pass.graphics_pipeline.render_pass.as_ref().map(|r| r.format)
+            if let Some(format) = pass.graphics_pipeline.compiled.render_pass.as_ref().map(|r| r.format)
                 && format != viewport.output.format {
                 // need to recompile
                 pass.graphics_pipeline.recompile(viewport.output.format)?;
@@ -710,6 +1512,10 @@ impl FilterChainVulkan {
             let output_image = OutputImage::new(&self.vulkan, viewport.output.clone())?;
             let out = RenderTarget::viewport_with_output(&output_image, viewport);
 
+            let timed = self
+                .timer
+                .as_mut()
+                .map_or(false, |timer| timer.begin_pass(cmd, passes_len - 1));
             let residual_fb = pass.draw(
                 cmd,
                 passes_len - 1,
@@ -723,12 +1529,67 @@ impl FilterChainVulkan {
                 QuadType::Final,
             )?;
 
+            if timed && let Some(timer) = &mut self.timer {
+                timer.end_pass(cmd);
+            }
+
             intermediates.dispose_outputs(output_image);
             intermediates.dispose_framebuffers(residual_fb);
         }
 
-        self.push_history(input, cmd)?;
+        if let Some(input_history) = &mut self.input_history {
+            if let Some(input) = input_history.push(original) {
+                intermediates.dispose_input(input);
+            }
+        } else {
+            self.push_history(input, cmd)?;
+        }
         self.common.internal_frame_count = self.common.internal_frame_count.wrapping_add(1);
+        self.usage.end_frame(frame_state);
+        Ok(())
+    }
+
+    /// Records shader rendering commands for a batch of frames to the provided command buffer,
+    /// as if [`frame`](Self::frame) was called for each of them in order.
+    ///
+    /// Each frame is an input image and the viewport to draw it to. The frames are drawn with
+    /// consecutive frame counts starting at `frame_count`, and history and feedback advance
+    /// between them. The options apply to every frame, except that history is only cleared
+    /// before the first frame.
+    ///
+    /// Every frame of a batch uses one of the frames in flight of the filter chain, so a batch
+    /// can not have more than `frames_in_flight` frames. As with separate frames, the command
+    /// buffer must be completely executed before those frames in flight are used again.
+    /// The layout requirements of [`frame`](Self::frame) apply to every input and output image.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all, fields(frames = frames.len())))]
+    pub unsafe fn frame_batch(
+        &mut self,
+        frames: &[(&VulkanImage, &Viewport<VulkanImage>)],
+        cmd: vk::CommandBuffer,
+        frame_count: usize,
+        options: Option<&FrameOptionsVulkan>,
+    ) -> error::Result<()> {
+        if frames.len() > self.residuals.len() {
+            return Err(FilterChainError::BatchTooLarge);
+        }
+
+        let mut options = options.cloned();
+        for (index, (input, viewport)) in frames.iter().enumerate() {
+            unsafe {
+                self.frame(
+                    input,
+                    viewport,
+                    cmd,
+                    frame_count.wrapping_add(index),
+                    options.as_ref(),
+                )?;
+            }
+
+            if let Some(options) = &mut options {
+                options.clear_history = false;
+            }
+        }
+
         Ok(())
     }
 }
@@ -9,28 +9,29 @@ use ash::vk;
 use librashader_common::{ImageFormat, Size, Viewport};
 use librashader_preprocess::ShaderSource;
 use librashader_presets::ShaderPassConfig;
-use librashader_reflect::reflect::semantics::{
-    BindingStage, MemberOffset, TextureBinding, UniformBinding,
-};
+use librashader_reflect::reflect::semantics::{BindingStage, MemberOffset, TextureBinding};
 use librashader_reflect::reflect::ShaderReflection;
-use librashader_runtime::binding::{BindSemantics, TextureInput};
+use librashader_runtime::binding::{BindSemantics, BindingPlan, TextureInput};
 use librashader_runtime::filter_pass::FilterPassMeta;
 use librashader_runtime::quad::QuadType;
 use librashader_runtime::render_target::RenderTarget;
-use librashader_runtime::uniforms::{NoUniformBinder, UniformStorage, UniformStorageAccess};
-use rustc_hash::FxHashMap;
+use librashader_runtime::uniforms::{
+    DirtyRange, NoUniformBinder, UniformStorage, UniformStorageAccess,
+};
 use std::sync::Arc;
 
 pub struct FilterPass {
     pub device: Arc<ash::Device>,
     pub reflection: ShaderReflection,
     // pub(crate) compiled: ShaderCompilerOutput<Vec<u32>>,
-    pub(crate) uniform_storage: UniformStorage<NoUniformBinder, Option<()>, RawVulkanBuffer>,
-    pub uniform_bindings: FxHashMap<UniformBinding, MemberOffset>,
+    pub(crate) uniform_storage: UniformStorage<NoUniformBinder, Option<()>>,
+    pub(crate) uniform_buffers: Box<[RawVulkanBuffer]>,
+    /// The bytes of each uniform buffer that are out of date with the uniform storage.
+    pub(crate) uniform_stale: Box<[DirtyRange]>,
+    pub binding_plan: BindingPlan<MemberOffset>,
     pub source: ShaderSource,
     pub config: ShaderPassConfig,
     pub graphics_pipeline: VulkanGraphicsPipeline,
-    // pub ubo_ring: VkUboRing,
     pub frames_in_flight: u32,
 }
 
@@ -40,7 +41,7 @@ impl TextureInput for InputImage {
     }
 }
 
-impl BindSemantics<NoUniformBinder, Option<()>, RawVulkanBuffer> for FilterPass {
+impl BindSemantics<NoUniformBinder, Option<()>> for FilterPass {
     type InputTexture = InputImage;
     type SamplerSet = SamplerSet;
     type DescriptorSet<'a> = vk::DescriptorSet;
@@ -98,7 +99,7 @@ impl FilterPass {
         output: &RenderTarget<OutputImage>,
         vbo_type: QuadType,
     ) -> error::Result<Option<vk::Framebuffer>> {
-        let mut descriptor = self.graphics_pipeline.layout.descriptor_sets
+        let mut descriptor = self.graphics_pipeline.descriptors.descriptor_sets
             [parent.internal_frame_count % self.frames_in_flight as usize];
 
         self.build_semantics(
@@ -115,11 +116,22 @@ impl FilterPass {
         );
 
         if let Some(ubo) = &self.reflection.ubo {
-            self.uniform_storage.inner_ubo().bind_to_descriptor_set(
-                descriptor,
-                ubo.binding,
-                &self.uniform_storage,
-            )?;
+            // each frame in flight has its own uniform buffer, so that the uniforms of this
+            // frame do not overwrite those of an earlier frame the GPU has yet to draw.
+            // only the bytes that changed since this buffer was last written are copied.
+            if let Some(dirty) = self.uniform_storage.take_ubo_dirty() {
+                for stale in self.uniform_stale.iter_mut() {
+                    stale.mark(dirty.clone());
+                }
+            }
+
+            let slot = parent.internal_frame_count % self.frames_in_flight as usize;
+            let buffer = &mut self.uniform_buffers[slot];
+            if let Some(range) = self.uniform_stale[slot].take() {
+                let uniforms = self.uniform_storage.ubo_slice();
+                buffer[range.clone()].copy_from_slice(&uniforms[range]);
+            }
+            buffer.bind_to_descriptor_set(descriptor, ubo.binding, &self.uniform_storage)?;
         }
 
         output.output.begin_pass(cmd);
@@ -132,13 +144,13 @@ impl FilterPass {
             parent.device.cmd_bind_pipeline(
                 cmd,
                 vk::PipelineBindPoint::GRAPHICS,
-                self.graphics_pipeline.pipeline,
+                self.graphics_pipeline.compiled.pipeline,
             );
 
             parent.device.cmd_bind_descriptor_sets(
                 cmd,
                 vk::PipelineBindPoint::GRAPHICS,
-                self.graphics_pipeline.layout.layout,
+                self.graphics_pipeline.compiled.shaders.layout.layout,
                 0,
                 &[descriptor],
                 &[],
@@ -155,7 +167,7 @@ impl FilterPass {
 
                 parent.device.cmd_push_constants(
                     cmd,
-                    self.graphics_pipeline.layout.layout,
+                    self.graphics_pipeline.compiled.shaders.layout.layout,
                     stage_mask,
                     0,
                     self.uniform_storage.push_slice(),
@@ -177,7 +189,7 @@ impl FilterPass {
             parent
                 .device
                 .cmd_set_viewport(cmd, 0, &[output.output.size.into()]);
-            parent.draw_quad.draw_quad(cmd, vbo_type);
+            parent.context.draw_quad.draw_quad(cmd, vbo_type);
             self.graphics_pipeline.end_rendering(&parent.device, cmd);
         }
         Ok(residual)
@@ -198,7 +210,7 @@ impl FilterPass {
     ) {
         Self::bind_semantics(
             &self.device,
-            &parent.samplers,
+            &parent.context.samplers,
             &mut self.uniform_storage,
             descriptor_set,
             mvp,
@@ -208,15 +220,13 @@ impl FilterPass {
             viewport_size,
             original,
             source,
-            &self.uniform_bindings,
-            &self.reflection.meta.texture_meta,
+            &self.binding_plan,
             parent.output_textures[0..pass_index]
                 .iter()
                 .map(|o| o.as_ref()),
             parent.feedback_textures.iter().map(|o| o.as_ref()),
             parent.history_textures.iter().map(|o| o.as_ref()),
-            parent.luts.iter().map(|(u, i)| (*u, i.as_ref())),
-            &self.source.parameters,
+            parent.luts.iter().map(|(u, i)| (*u, (**i).as_ref())),
             &parent.config.parameters,
         );
     }
@@ -1,6 +1,7 @@
 use crate::{error, util};
 use ash::vk;
 
+use crate::context::VulkanContext;
 use crate::error::FilterChainError;
 use crate::framebuffer::OutputImage;
 use crate::render_pass::VulkanRenderPass;
@@ -87,21 +88,15 @@ impl PipelineDescriptors {
 
 pub struct PipelineLayoutObjects {
     pub layout: vk::PipelineLayout,
-    pub pool: vk::DescriptorPool,
-    pub descriptor_sets: Vec<vk::DescriptorSet>,
     pub descriptor_set_layout: [vk::DescriptorSetLayout; 1],
 }
 
 impl PipelineLayoutObjects {
     pub fn new(
         reflection: &ShaderReflection,
-        replicas: u32,
+        descriptors: &PipelineDescriptors,
         device: &ash::Device,
     ) -> error::Result<Self> {
-        let mut descriptors = PipelineDescriptors::new(replicas);
-        descriptors.add_ubo_binding(reflection.ubo.as_ref());
-        descriptors.add_texture_bindings(reflection.meta.texture_meta.values());
-
         let descriptor_set_layout = [descriptors.create_descriptor_set_layout(device)?];
 
         let pipeline_create_info =
@@ -133,8 +128,27 @@ impl PipelineLayoutObjects {
 
         let layout = unsafe { device.create_pipeline_layout(&pipeline_create_info, None)? };
 
+        Ok(PipelineLayoutObjects {
+            layout,
+            descriptor_set_layout,
+        })
+    }
+}
+
+/// The descriptor sets of a pipeline for each frame in flight, which belong to a single filter chain.
+pub struct PipelineDescriptorSets {
+    pub pool: vk::DescriptorPool,
+    pub descriptor_sets: Vec<vk::DescriptorSet>,
+}
+
+impl PipelineDescriptorSets {
+    pub fn new(
+        descriptors: &PipelineDescriptors,
+        layout: &PipelineLayoutObjects,
+        device: &ash::Device,
+    ) -> error::Result<Self> {
         let pool_info = vk::DescriptorPoolCreateInfo::builder()
-            .max_sets(replicas)
+            .max_sets(descriptors.replicas)
             .pool_sizes(&descriptors.pool_sizes);
 
         let pool = unsafe { device.create_descriptor_pool(&pool_info, None)? };
@@ -142,9 +156,9 @@ impl PipelineLayoutObjects {
         let mut descriptor_sets = Vec::new();
         let alloc_info = vk::DescriptorSetAllocateInfo::builder()
             .descriptor_pool(pool)
-            .set_layouts(&descriptor_set_layout);
+            .set_layouts(&layout.descriptor_set_layout);
 
-        for _ in 0..replicas {
+        for _ in 0..descriptors.replicas {
             let set = unsafe { device.allocate_descriptor_sets(&alloc_info)? };
             descriptor_sets.push(set)
         }
@@ -152,11 +166,9 @@ impl PipelineLayoutObjects {
         let descriptor_sets: Vec<vk::DescriptorSet> =
             descriptor_sets.into_iter().flatten().collect();
 
-        Ok(PipelineLayoutObjects {
-            layout,
-            descriptor_set_layout,
-            descriptor_sets,
+        Ok(PipelineDescriptorSets {
             pool,
+            descriptor_sets,
         })
     }
 }
@@ -184,16 +196,141 @@ impl Drop for VulkanShaderModule {
     }
 }
 
-pub struct VulkanGraphicsPipeline {
+/// The pipeline layout and shader modules of a pass.
+pub struct PipelineShaders {
     pub layout: PipelineLayoutObjects,
-    pub pipeline: vk::Pipeline,
-    pub render_pass: Option<VulkanRenderPass>,
     device: Arc<ash::Device>,
     vertex: VulkanShaderModule,
     fragment: VulkanShaderModule,
     cache: vk::PipelineCache,
 }
 
+impl Drop for PipelineShaders {
+    fn drop(&mut self) {
+        if self.cache != vk::PipelineCache::null() {
+            unsafe { self.device.destroy_pipeline_cache(self.cache, None) }
+        }
+    }
+}
+
+/// A pipeline compiled for a render pass format.
+///
+/// Compiled pipelines do not depend on the filter chain, so identical passes in filter chains
+/// created from the same [`VulkanContext`](crate::VulkanContext) share them.
+pub struct CompiledPipeline {
+    pub shaders: Arc<PipelineShaders>,
+    pub pipeline: vk::Pipeline,
+    pub render_pass: Option<VulkanRenderPass>,
+}
+
+impl CompiledPipeline {
+    fn new(
+        device: &Arc<ash::Device>,
+        shader_assembly: &ShaderCompilerOutput<Vec<u32>>,
+        reflection: &ShaderReflection,
+        descriptors: &PipelineDescriptors,
+        render_pass_format: vk::Format,
+        bypass_cache: bool,
+    ) -> error::Result<CompiledPipeline> {
+        let pipeline_layout = PipelineLayoutObjects::new(reflection, descriptors, device)?;
+
+        let vertex_info =
+            vk::ShaderModuleCreateInfo::builder().code(shader_assembly.vertex.as_ref());
+        let fragment_info =
+            vk::ShaderModuleCreateInfo::builder().code(shader_assembly.fragment.as_ref());
+
+        let vertex_module = VulkanShaderModule::new(device, &vertex_info)?;
+        let fragment_module = VulkanShaderModule::new(device, &fragment_info)?;
+
+        let mut render_pass = None;
+        if render_pass_format != vk::Format::UNDEFINED {
+            render_pass = Some(VulkanRenderPass::create_render_pass(
+                device,
+                render_pass_format,
+            )?);
+        }
+
+        let (pipeline, pipeline_cache) = cache_pipeline(
+            "vulkan",
+            &[&shader_assembly.vertex, &shader_assembly.fragment],
+            |pipeline_data| {
+                let mut cache_info = vk::PipelineCacheCreateInfo::builder();
+                if let Some(pipeline_data) = pipeline_data.as_ref() {
+                    cache_info = cache_info.initial_data(pipeline_data);
+                }
+                let cache_info = cache_info;
+
+                let pipeline_cache = unsafe { device.create_pipeline_cache(&cache_info, None)? };
+
+                let pipeline = VulkanGraphicsPipeline::create_pipeline(
+                    &device,
+                    &pipeline_cache,
+                    &pipeline_layout,
+                    &vertex_module,
+                    &fragment_module,
+                    render_pass.as_ref(),
+                )?;
+                Ok::<_, FilterChainError>((pipeline, pipeline_cache))
+            },
+            |(_pipeline, cache)| unsafe { Ok(device.get_pipeline_cache_data(*cache)?) },
+            bypass_cache,
+        )?;
+
+        Ok(CompiledPipeline {
+            shaders: Arc::new(PipelineShaders {
+                layout: pipeline_layout,
+                device: Arc::clone(device),
+                vertex: vertex_module,
+                fragment: fragment_module,
+                cache: pipeline_cache,
+            }),
+            pipeline,
+            render_pass,
+        })
+    }
+
+    /// Compile the shaders of this pipeline for a different render pass format.
+    fn recompile(&self, format: vk::Format) -> error::Result<CompiledPipeline> {
+        let shaders = &self.shaders;
+        let render_pass = if self.render_pass.is_some() {
+            Some(VulkanRenderPass::create_render_pass(
+                &shaders.device,
+                format,
+            )?)
+        } else {
+            None
+        };
+
+        let pipeline = VulkanGraphicsPipeline::create_pipeline(
+            &shaders.device,
+            &shaders.cache,
+            &shaders.layout,
+            &shaders.vertex,
+            &shaders.fragment,
+            render_pass.as_ref(),
+        )?;
+
+        Ok(CompiledPipeline {
+            shaders: Arc::clone(shaders),
+            pipeline,
+            render_pass,
+        })
+    }
+}
+
+impl Drop for CompiledPipeline {
+    fn drop(&mut self) {
+        if self.pipeline != vk::Pipeline::null() {
+            unsafe { self.shaders.device.destroy_pipeline(self.pipeline, None) }
+        }
+    }
+}
+
+pub struct VulkanGraphicsPipeline {
+    pub compiled: Arc<CompiledPipeline>,
+    pub descriptors: PipelineDescriptorSets,
+}
+
 impl VulkanGraphicsPipeline {
     fn create_pipeline(
         device: &ash::Device,
@@ -304,95 +441,49 @@ impl VulkanGraphicsPipeline {
         Ok(pipeline)
     }
 
+    /// Create the pipeline for a pass, reusing the compiled pipeline of an identical pass
+    /// from the context if there is one.
     pub fn new(
-        device: &Arc<ash::Device>,
+        context: &VulkanContext,
         shader_assembly: &ShaderCompilerOutput<Vec<u32>>,
         reflection: &ShaderReflection,
         replicas: u32,
         render_pass_format: vk::Format,
         bypass_cache: bool,
     ) -> error::Result<VulkanGraphicsPipeline> {
-        let pipeline_layout = PipelineLayoutObjects::new(reflection, replicas, device)?;
-
-        let vertex_info =
-            vk::ShaderModuleCreateInfo::builder().code(shader_assembly.vertex.as_ref());
-        let fragment_info =
-            vk::ShaderModuleCreateInfo::builder().code(shader_assembly.fragment.as_ref());
-
-        let vertex_module = VulkanShaderModule::new(device, &vertex_info)?;
-        let fragment_module = VulkanShaderModule::new(device, &fragment_info)?;
+        let device = &context.vulkan.device;
+        let mut descriptors = PipelineDescriptors::new(replicas);
+        descriptors.add_ubo_binding(reflection.ubo.as_ref());
+        descriptors.add_texture_bindings(reflection.meta.texture_meta.values());
 
-        let mut render_pass = None;
-        if render_pass_format != vk::Format::UNDEFINED {
-            render_pass = Some(VulkanRenderPass::create_render_pass(
+        let compiled = context.compiled_pipeline(shader_assembly, render_pass_format, || {
+            CompiledPipeline::new(
                 device,
+                shader_assembly,
+                reflection,
+                &descriptors,
                 render_pass_format,
-            )?);
-        }
-
-        let (pipeline, pipeline_cache) = cache_pipeline(
-            "vulkan",
-            &[&shader_assembly.vertex, &shader_assembly.fragment],
-            |pipeline_data| {
-                let mut cache_info = vk::PipelineCacheCreateInfo::builder();
-                if let Some(pipeline_data) = pipeline_data.as_ref() {
-                    cache_info = cache_info.initial_data(pipeline_data);
-                }
-                let cache_info = cache_info;
-
-                let pipeline_cache = unsafe { device.create_pipeline_cache(&cache_info, None)? };
+                bypass_cache,
+            )
+        })?;
 
-                let pipeline = Self::create_pipeline(
-                    &device,
-                    &pipeline_cache,
-                    &pipeline_layout,
-                    &vertex_module,
-                    &fragment_module,
-                    render_pass.as_ref(),
-                )?;
-                Ok::<_, FilterChainError>((pipeline, pipeline_cache))
-            },
-            |(_pipeline, cache)| unsafe { Ok(device.get_pipeline_cache_data(*cache)?) },
-            bypass_cache,
-        )?;
+        let descriptors =
+            PipelineDescriptorSets::new(&descriptors, &compiled.shaders.layout, device)?;
 
         Ok(VulkanGraphicsPipeline {
-            device: Arc::clone(device),
-            layout: pipeline_layout,
-            pipeline,
-            render_pass,
-            vertex: vertex_module,
-            fragment: fragment_module,
-            cache: pipeline_cache,
+            compiled,
+            descriptors,
         })
     }
 
+    /// Recompile the pipeline for a different output format.
+    ///
+    /// The recompiled pipeline belongs to this filter chain alone.
     pub(crate) fn recompile(&mut self, format: vk::Format) -> error::Result<()> {
-        let mut new_renderpass = if self.render_pass.is_some() {
-            Some(VulkanRenderPass::create_render_pass(&self.device, format)?)
-        } else {
-            None
-        };
-
-        let mut new_pipeline = Self::create_pipeline(
-            &self.device,
-            &self.cache,
-            &self.layout,
-            &self.vertex,
-            &self.fragment,
-            new_renderpass.as_ref(),
-        )?;
-
-        std::mem::swap(&mut self.render_pass, &mut new_renderpass);
-        std::mem::swap(&mut self.pipeline, &mut new_pipeline);
-
-        unsafe {
-            if new_pipeline != vk::Pipeline::null() {
-                self.device.destroy_pipeline(new_pipeline, None)
-            }
-        }
+        self.compiled = Arc::new(self.compiled.recompile(format)?);
         Ok(())
     }
+
     #[inline(always)]
     pub(crate) fn begin_rendering(
         &self,
@@ -400,7 +491,7 @@ impl VulkanGraphicsPipeline {
         output: &RenderTarget<OutputImage>,
         cmd: vk::CommandBuffer,
     ) -> error::Result<Option<vk::Framebuffer>> {
-        if let Some(render_pass) = &self.render_pass {
+        if let Some(render_pass) = &self.compiled.render_pass {
             let attachments = [output.output.image_view];
             let framebuffer = unsafe {
                 device.create_framebuffer(
@@ -458,7 +549,7 @@ impl VulkanGraphicsPipeline {
 
     pub(crate) fn end_rendering(&self, device: &ash::Device, cmd: vk::CommandBuffer) {
         unsafe {
-            if self.render_pass.is_none() {
+            if self.compiled.render_pass.is_none() {
                 device.cmd_end_rendering(cmd);
             } else {
                 device.cmd_end_render_pass(cmd)
@@ -466,17 +557,3 @@ impl VulkanGraphicsPipeline {
         }
     }
 }
-
-impl Drop for VulkanGraphicsPipeline {
-    fn drop(&mut self) {
-        unsafe {
-            if self.pipeline != vk::Pipeline::null() {
-                self.device.destroy_pipeline(self.pipeline, None)
-            }
-
-            if self.cache != vk::PipelineCache::null() {
-                self.device.destroy_pipeline_cache(self.cache, None)
-            }
-        }
-    }
-}
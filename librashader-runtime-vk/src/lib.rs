@@ -7,6 +7,7 @@
 #![feature(let_chains)]
 #![feature(strict_provenance)]
 
+mod context;
 mod draw_quad;
 mod filter_chain;
 mod filter_pass;
@@ -18,9 +19,12 @@ mod parameters;
 mod queue_selection;
 mod samplers;
 mod texture;
+mod timing;
 mod util;
 
+pub use context::VulkanContext;
 pub use filter_chain::FilterChainVulkan;
+pub use filter_chain::PendingFilterChainVulkan;
 pub use filter_chain::VulkanInstance;
 pub use filter_chain::VulkanObjects;
 pub use texture::VulkanImage;
@@ -17,18 +17,14 @@ impl LutTexture {
     pub fn new(
         vulkan: &VulkanObjects,
         cmd: vk::CommandBuffer,
-        image: Image<BGRA8>,
+        image: &Image<BGRA8>,
         config: &TextureConfig,
     ) -> error::Result<LutTexture> {
         let image_info = vk::ImageCreateInfo::builder()
             .image_type(vk::ImageType::TYPE_2D)
             .format(vk::Format::B8G8R8A8_UNORM)
             .extent(image.size.into())
-            .mip_levels(if config.mipmap {
-                image.size.calculate_miplevels()
-            } else {
-                1
-            })
+            .mip_levels(image.level_count(config.mipmap))
             .array_layers(1)
             .samples(vk::SampleCountFlags::TYPE_1)
             .tiling(vk::ImageTiling::OPTIMAL)
@@ -66,14 +62,47 @@ impl LutTexture {
 
         let texture_view = unsafe { vulkan.device.create_image_view(&view_info, None)? };
 
+        // Prebuilt mip levels are copied from the staging buffer after the base level.
+        let prebuilt = image.prebuilt_levels(config.mipmap);
+        let staging_size = image.bytes.len()
+            + prebuilt
+                .iter()
+                .map(|level| level.bytes.len())
+                .sum::<usize>();
+
         let mut staging = VulkanBuffer::new(
             &vulkan.device,
             &vulkan.alloc,
             vk::BufferUsageFlags::TRANSFER_SRC,
-            image.bytes.len(),
+            staging_size,
         )?;
 
-        staging.as_mut_slice()?.copy_from_slice(&image.bytes);
+        let mut regions = Vec::with_capacity(prebuilt.len() + 1);
+        {
+            let staging = staging.as_mut_slice()?;
+            let mut offset = 0;
+            let levels = std::iter::once((image.bytes.as_slice(), image.size)).chain(
+                prebuilt
+                    .iter()
+                    .map(|level| (level.bytes.as_slice(), level.size)),
+            );
+            for (mip_level, (bytes, size)) in levels.enumerate() {
+                staging[offset..][..bytes.len()].copy_from_slice(bytes);
+                regions.push(
+                    *vk::BufferImageCopy::builder()
+                        .buffer_offset(offset as vk::DeviceSize)
+                        .image_subresource(
+                            *vk::ImageSubresourceLayers::builder()
+                                .aspect_mask(vk::ImageAspectFlags::COLOR)
+                                .mip_level(mip_level as u32)
+                                .base_array_layer(0)
+                                .layer_count(1),
+                        )
+                        .image_extent(size.into()),
+                );
+                offset += bytes.len();
+            }
+        }
 
         unsafe {
             util::vulkan_image_layout_transition_levels(
@@ -95,16 +124,6 @@ impl LutTexture {
                 vk::QUEUE_FAMILY_IGNORED,
             );
 
-            let builder = vk::BufferImageCopy::builder()
-                .image_subresource(
-                    *vk::ImageSubresourceLayers::builder()
-                        .aspect_mask(vk::ImageAspectFlags::COLOR)
-                        .mip_level(0)
-                        .base_array_layer(0)
-                        .layer_count(1),
-                )
-                .image_extent(image.size.into());
-
             vulkan.device.cmd_copy_buffer_to_image(
                 cmd,
                 staging.handle,
@@ -114,12 +133,18 @@ impl LutTexture {
                 } else {
                     vk::ImageLayout::TRANSFER_DST_OPTIMAL
                 },
-                &[*builder],
+                &regions,
             )
         }
 
-        // generate mipmaps
-        for level in 1..image_info.mip_levels {
+        // generate mipmaps if the image did not come with them
+        let generated_levels = if image.needs_mipmap_generation(config.mipmap) {
+            1..image_info.mip_levels
+        } else {
+            1..1
+        };
+
+        for level in generated_levels {
             let source_size = image.size.scale_mipmap(level - 1);
             let target_size = image.size.scale_mipmap(level);
 
@@ -15,6 +15,8 @@ use std::sync::Arc;
 pub struct VulkanImageMemory {
     allocation: Option<Allocation>,
     allocator: Arc<RwLock<Allocator>>,
+    /// The memory types the allocation was allowed to be made from.
+    memory_type_bits: u32,
 }
 
 impl VulkanImageMemory {
@@ -37,9 +39,52 @@ impl VulkanImageMemory {
             Ok(VulkanImageMemory {
                 allocation: Some(allocation),
                 allocator: Arc::clone(allocator),
+                memory_type_bits: requirements.memory_type_bits,
             })
         }
     }
+
+    /// Allocate memory that can be bound to more than one image over its lifetime.
+    pub fn new_shared(
+        allocator: &Arc<RwLock<Allocator>>,
+        requirements: vk::MemoryRequirements,
+    ) -> error::Result<VulkanImageMemory> {
+        let allocation = allocator.write().allocate(&AllocationCreateDesc {
+            name: "imagemem",
+            requirements,
+            location: MemoryLocation::GpuOnly,
+            linear: false,
+            allocation_scheme: AllocationScheme::GpuAllocatorManaged,
+        })?;
+
+        Ok(VulkanImageMemory {
+            allocation: Some(allocation),
+            allocator: Arc::clone(allocator),
+            memory_type_bits: requirements.memory_type_bits,
+        })
+    }
+
+    /// Whether an image with the given requirements can be bound to this memory.
+    ///
+    /// The allocation was made from one of the memory types it was allowed to use, so the
+    /// image must allow all of those types to be sure that it allows the one in use.
+    pub fn fits(&self, requirements: &vk::MemoryRequirements) -> bool {
+        self.allocation.as_ref().map_or(false, |allocation| {
+            requirements.size <= allocation.size()
+                && allocation.offset() % requirements.alignment == 0
+                && requirements.memory_type_bits & self.memory_type_bits == self.memory_type_bits
+        })
+    }
+
+    /// Bind an image to this memory.
+    pub fn bind(&self, device: &ash::Device, image: &vk::Image) -> error::Result<()> {
+        if let Some(allocation) = &self.allocation {
+            unsafe {
+                device.bind_image_memory(*image, allocation.memory(), allocation.offset())?;
+            }
+        }
+        Ok(())
+    }
 }
 
 impl Drop for VulkanImageMemory {
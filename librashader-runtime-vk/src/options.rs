@@ -9,6 +9,10 @@ pub struct FrameOptionsVulkan {
     /// The direction of rendering.
     /// -1 indicates that the frames are played in reverse order.
     pub frame_direction: i32,
+    /// Whether the input image is the same as in the last frame.
+    /// Passes that do not read the frame count, history or feedback keep their
+    /// output from the last frame instead of being drawn again.
+    pub input_unchanged: bool,
 }
 
 /// Options for filter chain creation.
@@ -25,4 +29,25 @@ pub struct FilterChainOptionsVulkan {
     /// Disable the shader object cache. Shaders will be
     /// recompiled rather than loaded from the cache.
     pub disable_cache: bool,
+    /// Defer compiling passes and creating their pipelines until they are enabled and first drawn.
+    ///
+    /// Every pass is enabled when the filter chain is created, so the number of enabled passes
+    /// must be lowered with
+    /// [`set_enabled_pass_count`](librashader_runtime::parameters::FilterChainParameters::set_enabled_pass_count)
+    /// before the first frame, or every pass is compiled when the first frame is drawn.
+    pub defer_passes: bool,
+    /// Compile deferred passes in the background ahead of when they are needed.
+    /// Only applies if `defer_passes` is enabled.
+    pub prefetch_passes: bool,
+    /// Bind the input images of previous frames as history instead of copying them.
+    /// The caller must keep each input image alive and unmodified for
+    /// [`history_len`](crate::FilterChainVulkan::history_len) frames after it is drawn.
+    pub zero_copy_history: bool,
+    /// Round the memory of intermediate framebuffers up to size buckets, so that they can be
+    /// resized within a bucket without reallocating. Memory is only shrunk after the
+    /// framebuffer has been smaller for a number of frames.
+    pub resize_hysteresis: bool,
+    /// Measure the GPU time spent drawing each pass with timestamp queries.
+    /// The results are available from [`pass_timings`](crate::FilterChainVulkan::pass_timings).
+    pub time_passes: bool,
 }
@@ -1,6 +1,5 @@
 use crate::FilterChainVulkan;
-use librashader_runtime::parameters::FilterChainParameters;
-use std::collections::hash_map::Iter;
+use librashader_runtime::parameters::{FilterChainParameters, ParameterHandle, ParameterIter};
 
 impl FilterChainParameters for FilterChainVulkan {
     fn get_enabled_pass_count(&self) -> usize {
@@ -11,30 +10,30 @@ impl FilterChainParameters for FilterChainVulkan {
         self.common.config.passes_enabled = count
     }
 
-    fn enumerate_parameters(&self) -> Iter<String, f32> {
+    fn enumerate_parameters(&self) -> ParameterIter<'_> {
         self.common.config.parameters.iter()
     }
 
     fn get_parameter(&self, parameter: &str) -> Option<f32> {
-        self.common
-            .config
-            .parameters
-            .get::<str>(parameter.as_ref())
-            .copied()
+        self.common.config.parameters.get(parameter)
     }
 
     fn set_parameter(&mut self, parameter: &str, new_value: f32) -> Option<f32> {
-        if let Some(value) = self
-            .common
+        self.common.config.parameters.set(parameter, new_value)
+    }
+
+    fn get_parameter_handle(&self, parameter: &str) -> Option<ParameterHandle> {
+        self.common.config.parameters.handle(parameter)
+    }
+
+    fn get_parameter_by_handle(&self, handle: ParameterHandle) -> Option<f32> {
+        self.common.config.parameters.get_by_handle(handle)
+    }
+
+    fn set_parameter_by_handle(&mut self, handle: ParameterHandle, new_value: f32) -> Option<f32> {
+        self.common
             .config
             .parameters
-            .get_mut::<str>(parameter.as_ref())
-        {
-            let old = *value;
-            *value = new_value;
-            Some(old)
-        } else {
-            None
-        }
+            .set_by_handle(handle, new_value)
     }
 }
@@ -9,7 +9,7 @@ use std::sync::Arc;
 use crate::error::FilterChainError;
 use librashader_common::{FilterMode, ImageFormat, Size, WrapMode};
 use librashader_presets::Scale2D;
-use librashader_runtime::scaling::{MipmapSize, ScaleFramebuffer, ViewportSize};
+use librashader_runtime::scaling::{MipmapSize, ResizeHysteresis, ScaleFramebuffer, ViewportSize};
 
 pub struct OwnedImage {
     pub device: Arc<ash::Device>,
@@ -19,6 +19,28 @@ pub struct OwnedImage {
     pub memory: VulkanImageMemory,
     pub max_miplevels: u32,
     pub levels: u32,
+    pub hysteresis: Option<ResizeHysteresis>,
+    /// Images that were replaced by recreating the image in place, which may still be in use
+    /// by frames in flight.
+    retired: Vec<RetiredImage>,
+    /// Whether the image was created since it was last drawn to, so its contents are undefined.
+    recreated: bool,
+}
+
+/// An image and view that are destroyed once dropped, leaving the memory bound to them alone.
+pub(crate) struct RetiredImage {
+    device: Arc<ash::Device>,
+    image: vk::Image,
+    image_view: vk::ImageView,
+}
+
+impl Drop for RetiredImage {
+    fn drop(&mut self) {
+        unsafe {
+            self.device.destroy_image_view(self.image_view, None);
+            self.device.destroy_image(self.image, None);
+        }
+    }
 }
 
 #[derive(Clone)]
@@ -31,20 +53,14 @@ pub struct OwnedImageLayout {
 }
 
 impl OwnedImage {
-    fn new_internal(
-        device: Arc<ash::Device>,
-        alloc: &Arc<RwLock<Allocator>>,
+    fn image_create_info(
         size: Size<u32>,
-        mut format: ImageFormat,
+        format: vk::Format,
         max_miplevels: u32,
-    ) -> error::Result<OwnedImage> {
-        // default to something sane
-        if format == ImageFormat::Unknown {
-            format = ImageFormat::R8G8B8A8Unorm
-        }
-        let image_create_info = vk::ImageCreateInfo::builder()
+    ) -> vk::ImageCreateInfo {
+        *vk::ImageCreateInfo::builder()
             .image_type(vk::ImageType::TYPE_2D)
-            .format(format.into())
+            .format(format)
             .extent(size.into())
             .mip_levels(std::cmp::min(max_miplevels, size.calculate_miplevels()))
             .array_layers(1)
@@ -58,16 +74,19 @@ impl OwnedImage {
                     | vk::ImageUsageFlags::TRANSFER_SRC,
             )
             .sharing_mode(vk::SharingMode::EXCLUSIVE)
-            .initial_layout(vk::ImageLayout::UNDEFINED);
-
-        let image = unsafe { device.create_image(&image_create_info, None)? };
-        let mem_reqs = unsafe { device.get_image_memory_requirements(image) };
+            .initial_layout(vk::ImageLayout::UNDEFINED)
+    }
 
-        let memory = VulkanImageMemory::new(&device, alloc, mem_reqs, &image)?;
+    fn create_image_view(
+        device: &ash::Device,
+        image: vk::Image,
+        format: vk::Format,
+        levels: u32,
+    ) -> error::Result<vk::ImageView> {
         let image_subresource = vk::ImageSubresourceRange::builder()
             .base_mip_level(0)
             .base_array_layer(0)
-            .level_count(image_create_info.mip_levels)
+            .level_count(levels)
             .layer_count(1)
             .aspect_mask(vk::ImageAspectFlags::COLOR);
 
@@ -79,12 +98,53 @@ impl OwnedImage {
 
         let view_info = vk::ImageViewCreateInfo::builder()
             .view_type(vk::ImageViewType::TYPE_2D)
-            .format(format.into())
+            .format(format)
             .image(image)
             .subresource_range(*image_subresource)
             .components(*swizzle_components);
 
-        let image_view = unsafe { device.create_image_view(&view_info, None)? };
+        Ok(unsafe { device.create_image_view(&view_info, None)? })
+    }
+
+    fn new_internal(
+        device: Arc<ash::Device>,
+        alloc: &Arc<RwLock<Allocator>>,
+        size: Size<u32>,
+        mut format: ImageFormat,
+        max_miplevels: u32,
+        hysteresis: Option<ResizeHysteresis>,
+    ) -> error::Result<OwnedImage> {
+        // default to something sane
+        if format == ImageFormat::Unknown {
+            format = ImageFormat::R8G8B8A8Unorm
+        }
+        let image_create_info = Self::image_create_info(size, format.into(), max_miplevels);
+
+        let image = unsafe { device.create_image(&image_create_info, None)? };
+        let mem_reqs = unsafe { device.get_image_memory_requirements(image) };
+
+        let memory = match &hysteresis {
+            None => VulkanImageMemory::new(&device, alloc, mem_reqs, &image)?,
+            Some(hysteresis) => {
+                // Size the memory for the largest image in the bucket, so that the
+                // image can be recreated in place while it stays in the bucket.
+                let capacity_info =
+                    Self::image_create_info(hysteresis.capacity(), format.into(), max_miplevels);
+                let capacity_reqs = unsafe {
+                    let capacity_image = device.create_image(&capacity_info, None)?;
+                    let reqs = device.get_image_memory_requirements(capacity_image);
+                    device.destroy_image(capacity_image, None);
+                    reqs
+                };
+
+                let memory = VulkanImageMemory::new_shared(alloc, capacity_reqs)?;
+                memory.bind(&device, &image)?;
+                memory
+            }
+        };
+
+        let image_view =
+            Self::create_image_view(&device, image, format.into(), image_create_info.mip_levels)?;
 
         Ok(OwnedImage {
             device,
@@ -97,7 +157,10 @@ impl OwnedImage {
             },
             memory,
             max_miplevels,
-            levels: std::cmp::min(max_miplevels, size.calculate_miplevels()),
+            levels: image_create_info.mip_levels,
+            hysteresis,
+            retired: Vec::new(),
+            recreated: true,
         })
     }
 
@@ -113,9 +176,102 @@ impl OwnedImage {
             size,
             format,
             max_miplevels,
+            None,
         )
     }
 
+    /// Create an image whose memory is rounded up to a size bucket, so that it can be
+    /// rescaled without reallocating while it stays within the bucket.
+    pub fn new_with_hysteresis(
+        vulkan: &VulkanObjects,
+        size: Size<u32>,
+        format: ImageFormat,
+        max_miplevels: u32,
+    ) -> error::Result<OwnedImage> {
+        Self::new_internal(
+            vulkan.device.clone(),
+            &vulkan.alloc,
+            size,
+            format,
+            max_miplevels,
+            Some(ResizeHysteresis::new(size)),
+        )
+    }
+
+    /// Recreate the image with a new size in the memory that already backs it.
+    ///
+    /// The previous image is kept until it is taken with [`OwnedImage::take_retired`].
+    /// Returns false if the image does not fit in the memory.
+    fn recreate_in_place(&mut self, size: Size<u32>) -> error::Result<bool> {
+        let create_info = Self::image_create_info(size, self.image.format, self.max_miplevels);
+        let image = unsafe { self.device.create_image(&create_info, None)? };
+        let mem_reqs = unsafe { self.device.get_image_memory_requirements(image) };
+
+        if !self.memory.fits(&mem_reqs) {
+            unsafe { self.device.destroy_image(image, None) };
+            return Ok(false);
+        }
+
+        self.memory.bind(&self.device, &image)?;
+        let image_view = Self::create_image_view(
+            &self.device,
+            image,
+            self.image.format,
+            create_info.mip_levels,
+        )?;
+
+        self.retired.push(RetiredImage {
+            device: Arc::clone(&self.device),
+            image: self.image.image,
+            image_view: self.image_view,
+        });
+
+        self.image_view = image_view;
+        self.image = VulkanImage {
+            image,
+            size,
+            format: self.image.format,
+        };
+        self.levels = create_info.mip_levels;
+        Ok(true)
+    }
+
+    /// Take the images that were replaced when this image was recreated in place.
+    ///
+    /// They must be kept alive until the frames that used them are no longer in flight.
+    pub(crate) fn take_retired(&mut self) -> Vec<RetiredImage> {
+        std::mem::take(&mut self.retired)
+    }
+
+    /// Whether the image was reallocated or recreated since this was last called.
+    ///
+    /// The contents of such an image are undefined until it is drawn to again.
+    pub(crate) fn take_recreated(&mut self) -> bool {
+        std::mem::take(&mut self.recreated)
+    }
+
+    fn reallocate(
+        &mut self,
+        size: Size<u32>,
+        format: ImageFormat,
+        mipmap: bool,
+    ) -> error::Result<()> {
+        let max_levels = if mipmap { u32::MAX } else { 1 };
+
+        let new = OwnedImage::new_internal(
+            self.device.clone(),
+            &self.allocator,
+            size,
+            format,
+            max_levels,
+            self.hysteresis,
+        )?;
+
+        let old = std::mem::replace(self, new);
+        drop(old);
+        Ok(())
+    }
+
     pub(crate) fn scale(
         &mut self,
         scaling: Scale2D,
@@ -126,45 +282,65 @@ impl OwnedImage {
         layout: Option<OwnedImageLayout>,
     ) -> error::Result<Size<u32>> {
         let size = source_size.scale_viewport(scaling, *viewport_size);
-        if self.image.size != size
-            || (mipmap && self.max_miplevels == 1)
+        let format = if format == ImageFormat::Unknown {
+            ImageFormat::R8G8B8A8Unorm
+        } else {
+            format
+        };
+
+        let reformat = (mipmap && self.max_miplevels == 1)
             || (!mipmap && self.max_miplevels != 1)
-            || vk::Format::from(format) != self.image.format
-        {
-            let max_levels = if mipmap { u32::MAX } else { 1 };
+            || vk::Format::from(format) != self.image.format;
 
-            let new = OwnedImage::new_internal(
-                self.device.clone(),
-                &self.allocator,
-                size,
-                if format == ImageFormat::Unknown {
-                    ImageFormat::R8G8B8A8Unorm
-                } else {
-                    format
-                },
-                max_levels,
-            )?;
-
-            let old = std::mem::replace(self, new);
-            drop(old);
-
-            if let Some(layout) = layout {
-                unsafe {
-                    util::vulkan_image_layout_transition_levels(
-                        &self.device,
-                        layout.cmd,
-                        self.image.image,
-                        self.levels,
-                        vk::ImageLayout::UNDEFINED,
-                        layout.dst_layout,
-                        vk::AccessFlags::empty(),
-                        layout.dst_access,
-                        layout.src_stage,
-                        layout.dst_stage,
-                        vk::QUEUE_FAMILY_IGNORED,
-                        vk::QUEUE_FAMILY_IGNORED,
-                    )
-                }
+        let reallocate = match &mut self.hysteresis {
+            Some(hysteresis) if !reformat => hysteresis.resize(size).is_some(),
+            Some(hysteresis) => {
+                *hysteresis = ResizeHysteresis::new(size);
+                true
+            }
+            None => reformat || self.image.size != size,
+        };
+
+        let mut aliased = false;
+        if reallocate {
+            self.reallocate(size, format, mipmap)?;
+        } else if self.image.size != size {
+            aliased = self.recreate_in_place(size)?;
+            if !aliased {
+                self.hysteresis = self.hysteresis.map(|_| ResizeHysteresis::new(size));
+                self.reallocate(size, format, mipmap)?;
+            }
+        } else {
+            return Ok(size);
+        }
+        self.recreated = true;
+
+        if let Some(layout) = layout {
+            // Memory that is recreated in place may still be in use by the previous image.
+            let (src_access, src_stage) = if aliased {
+                (
+                    vk::AccessFlags::COLOR_ATTACHMENT_WRITE | vk::AccessFlags::TRANSFER_WRITE,
+                    vk::PipelineStageFlags::ALL_COMMANDS,
+                )
+            } else {
+                (vk::AccessFlags::empty(), layout.src_stage)
+            };
+
+            unsafe {
+                util::vulkan_image_layout_transition_levels(
+                    &self.device,
+                    layout.cmd,
+                    self.image.image,
+                    self.levels,
+                    vk::ImageLayout::UNDEFINED,
+                    layout.dst_layout,
+                    src_access,
+                    layout.dst_access,
+                    src_stage,
+                    layout.dst_stage,
+                    vk::QUEUE_FAMILY_IGNORED,
+                    vk::QUEUE_FAMILY_IGNORED,
+                )
             }
         }
         Ok(size)
@@ -0,0 +1,157 @@
+use crate::error;
+use ash::vk;
+use librashader_runtime::timing::{PassTimer, PassTiming};
+use std::sync::Arc;
+use std::time::Duration;
+
+/// Per-pass GPU timing with timestamp queries.
+///
+/// There is one slot of queries for each frame in flight, so the timings of a frame are read
+/// back once the caller has waited on it to reuse its resources.
+pub(crate) struct VulkanPassTimer {
+    device: Arc<ash::Device>,
+    timer: PassTimer,
+    pool: vk::QueryPool,
+    passes_per_slot: u32,
+    timestamp_period: f32,
+    slot: usize,
+    position: u32,
+}
+
+impl VulkanPassTimer {
+    /// Create a timer for up to `passes` passes a frame.
+    pub fn new(
+        device: &Arc<ash::Device>,
+        frames_in_flight: u32,
+        passes: usize,
+        timestamp_period: f32,
+    ) -> error::Result<Self> {
+        let timer = PassTimer::new(frames_in_flight as usize);
+        let passes_per_slot = passes as u32;
+
+        let create_info = vk::QueryPoolCreateInfo::builder()
+            .query_type(vk::QueryType::TIMESTAMP)
+            .query_count(std::cmp::max(2 * passes_per_slot * timer.slots() as u32, 1));
+        let pool = unsafe { device.create_query_pool(&create_info, None)? };
+
+        Ok(Self {
+            device: Arc::clone(device),
+            timer,
+            pool,
+            passes_per_slot,
+            timestamp_period,
+            slot: 0,
+            position: 0,
+        })
+    }
+
+    fn first_query(&self, slot: usize) -> u32 {
+        2 * self.passes_per_slot * slot as u32
+    }
+
+    /// Read back the timings of an earlier frame if they are available, and reset the queries
+    /// for a new frame.
+    pub fn begin_frame<'a>(
+        &mut self,
+        cmd: vk::CommandBuffer,
+        alias: impl Fn(usize) -> Option<&'a str>,
+    ) -> error::Result<()> {
+        let device = &self.device;
+        let pool = self.pool;
+        let passes_per_slot = self.passes_per_slot;
+        let timestamp_period = self.timestamp_period as f64;
+
+        self.slot = self.timer.begin_frame(
+            |slot, count| {
+                let mut timestamps = vec![0u64; 2 * count];
+                let result = unsafe {
+                    device.get_query_pool_results(
+                        pool,
+                        2 * passes_per_slot * slot as u32,
+                        timestamps.len() as u32,
+                        &mut timestamps,
+                        vk::QueryResultFlags::TYPE_64,
+                    )
+                };
+
+                match result {
+                    Ok(()) => Ok(Some(
+                        timestamps
+                            .chunks_exact(2)
+                            .map(|pass| {
+                                let ticks = pass[1].wrapping_sub(pass[0]) as f64;
+                                Duration::from_nanos((ticks * timestamp_period) as u64)
+                            })
+                            .collect(),
+                    )),
+                    Err(vk::Result::NOT_READY) => Ok(None),
+                    Err(error) => Err(error),
+                }
+            },
+            alias,
+        )?;
+        self.position = 0;
+
+        unsafe {
+            self.device.cmd_reset_query_pool(
+                cmd,
+                self.pool,
+                self.first_query(self.slot),
+                2 * self.passes_per_slot,
+            );
+        }
+
+        Ok(())
+    }
+
+    /// Write the timestamp for the start of a pass.
+    ///
+    /// Returns false if there are no queries left for the pass.
+    pub fn begin_pass(&mut self, cmd: vk::CommandBuffer, index: usize) -> bool {
+        if self.position >= self.passes_per_slot {
+            return false;
+        }
+
+        self.timer.record(index);
+        unsafe {
+            self.device.cmd_write_timestamp(
+                cmd,
+                vk::PipelineStageFlags::TOP_OF_PIPE,
+                self.pool,
+                self.first_query(self.slot) + 2 * self.position,
+            );
+        }
+        true
+    }
+
+    /// Write the timestamp for the end of the pass that was started last.
+    pub fn end_pass(&mut self, cmd: vk::CommandBuffer) {
+        unsafe {
+            self.device.cmd_write_timestamp(
+                cmd,
+                vk::PipelineStageFlags::BOTTOM_OF_PIPE,
+                self.pool,
+                self.first_query(self.slot) + 2 * self.position + 1,
+            );
+        }
+        self.position += 1;
+    }
+
+    /// The most recent timings that were read back.
+    pub fn timings(&self) -> &[PassTiming] {
+        self.timer.timings()
+    }
+
+    /// Whether new timings were read back when this frame began.
+    pub fn updated(&self) -> bool {
+        self.timer.updated()
+    }
+}
+
+impl Drop for VulkanPassTimer {
+    fn drop(&mut self) {
+        unsafe {
+            self.device.destroy_query_pool(self.pool, None);
+        }
+    }
+}
@@ -104,3 +104,13 @@ pub fn create_allocator(
     })?;
     Ok(Arc::new(RwLock::new(alloc)))
 }
+
+/// Get the number of nanoseconds per timestamp tick, if timestamps are supported on all
+/// graphics queues.
+pub fn timestamp_period(
+    instance: &ash::Instance,
+    physical_device: vk::PhysicalDevice,
+) -> Option<f32> {
+    let limits = unsafe { instance.get_physical_device_properties(physical_device) }.limits;
+    (limits.timestamp_compute_and_graphics == vk::TRUE).then_some(limits.timestamp_period)
+}
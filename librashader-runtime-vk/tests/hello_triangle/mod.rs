@@ -262,6 +262,7 @@ impl VulkanWindow {
                     Some(&FrameOptionsVulkan {
                         clear_history: frame == 0,
                         frame_direction: 0,
+                        input_unchanged: false,
                     }),
                 )
                 .unwrap();
@@ -21,6 +21,11 @@ fn triangle_vk() {
                 force_no_mipmaps: false,
                 use_render_pass: true,
                 disable_cache: false,
+                defer_passes: false,
+                prefetch_passes: false,
+                zero_copy_history: false,
+                resize_hysteresis: false,
+                time_passes: false,
             }),
         )
             .unwrap();
@@ -0,0 +1,191 @@
+//! CPU benchmark of semantic binding for a long filter chain.
+//!
+//! Run with `cargo bench -p librashader-runtime`.
+#![feature(test)]
+
+extern crate test;
+
+use librashader_common::Size;
+use librashader_presets::ParameterConfig;
+use librashader_reflect::reflect::semantics::{
+    BindingMeta, BindingStage, MemberOffset, TextureBinding, TextureSemantics, TextureSizeMeta,
+    UniqueSemantics, VariableMeta,
+};
+use librashader_runtime::binding::{BindSemantics, BindingPlan, TextureInput};
+use librashader_runtime::parameters::RuntimeParameters;
+use librashader_runtime::uniforms::UniformStorage;
+use test::{black_box, Bencher};
+
+const PASSES: usize = 30;
+const PARAMETERS: usize = 16;
+
+struct Texture(Size<u32>);
+
+impl TextureInput for Texture {
+    fn size(&self) -> Size<u32> {
+        self.0
+    }
+}
+
+impl AsRef<Texture> for Texture {
+    fn as_ref(&self) -> &Texture {
+        self
+    }
+}
+
+struct Pass {
+    binding_plan: BindingPlan<MemberOffset>,
+    uniform_storage: UniformStorage,
+}
+
+impl BindSemantics for Pass {
+    type InputTexture = Texture;
+    type SamplerSet = ();
+    type DescriptorSet<'a> = [u32; 16];
+    type DeviceContext = ();
+    type UniformOffset = MemberOffset;
+
+    fn bind_texture<'a>(
+        descriptors: &mut Self::DescriptorSet<'a>,
+        _samplers: &Self::SamplerSet,
+        binding: &TextureBinding,
+        texture: &Self::InputTexture,
+        _device: &Self::DeviceContext,
+    ) {
+        descriptors[binding.binding as usize] = texture.0.width;
+    }
+}
+
+/// Reflection for a pass that reads the original, its source, the two passes before it,
+/// its own feedback, and a set of parameters, similar to a typical CRT preset.
+fn pass_meta(index: usize) -> (BindingMeta, usize) {
+    let mut meta = BindingMeta::default();
+    let mut offset = 0;
+    let mut next_offset = |size: usize| {
+        let current = offset;
+        offset += size;
+        MemberOffset {
+            ubo: Some(current),
+            push: None,
+        }
+    };
+
+    for (semantics, size) in [
+        (UniqueSemantics::MVP, 64),
+        (UniqueSemantics::Output, 16),
+        (UniqueSemantics::FinalViewport, 16),
+        (UniqueSemantics::FrameCount, 4),
+        (UniqueSemantics::FrameDirection, 4),
+    ] {
+        meta.unique_meta.insert(
+            semantics,
+            VariableMeta {
+                offset: next_offset(size),
+                size: size as u32,
+                id: format!("{semantics:?}"),
+            },
+        );
+    }
+
+    let mut textures = vec![
+        TextureSemantics::Original.semantics(0),
+        TextureSemantics::Source.semantics(0),
+        TextureSemantics::PassFeedback.semantics(index),
+    ];
+    textures.extend(
+        (index.saturating_sub(2)..index).map(|pass| TextureSemantics::PassOutput.semantics(pass)),
+    );
+
+    for (binding, semantic) in textures.into_iter().enumerate() {
+        meta.texture_meta.insert(
+            semantic,
+            TextureBinding {
+                binding: binding as u32,
+            },
+        );
+        meta.texture_size_meta.insert(
+            semantic,
+            TextureSizeMeta {
+                offset: next_offset(16),
+                stage_mask: BindingStage::VERTEX | BindingStage::FRAGMENT,
+                id: format!("{semantic:?}Size"),
+            },
+        );
+    }
+
+    for parameter in 0..PARAMETERS {
+        let id = format!("PARAMETER_{parameter}");
+        meta.parameter_meta.insert(
+            id.clone(),
+            VariableMeta {
+                offset: next_offset(4),
+                size: 4,
+                id,
+            },
+        );
+    }
+
+    (meta, offset)
+}
+
+#[bench]
+fn bind_semantics_30_passes(b: &mut Bencher) {
+    let parameters: Vec<ParameterConfig> = (0..PARAMETERS)
+        .map(|parameter| ParameterConfig {
+            name: format!("PARAMETER_{parameter}"),
+            value: parameter as f32,
+        })
+        .collect();
+    let parameters = RuntimeParameters::new(std::iter::empty(), &parameters);
+
+    let mut passes: Vec<Pass> = (0..PASSES)
+        .map(|index| {
+            let (meta, ubo_size) = pass_meta(index);
+            Pass {
+                binding_plan: BindingPlan::new(&meta, &parameters, |param| param.offset()),
+                uniform_storage: UniformStorage::new(ubo_size, 0),
+            }
+        })
+        .collect();
+
+    let size = Size::new(1920, 1080);
+    let original = Texture(Size::new(320, 240));
+    let outputs: Vec<Texture> = (0..PASSES).map(|_| Texture(size)).collect();
+    let feedback: Vec<Texture> = (0..PASSES).map(|_| Texture(size)).collect();
+    let mvp = [0f32; 16];
+    let mut frame_count = 0;
+
+    b.iter(|| {
+        frame_count += 1;
+        for (index, pass) in passes.iter_mut().enumerate() {
+            let source = if index == 0 {
+                &original
+            } else {
+                &outputs[index - 1]
+            };
+            let mut descriptors = [0u32; 16];
+
+            Pass::bind_semantics(
+                &(),
+                &(),
+                &mut pass.uniform_storage,
+                &mut descriptors,
+                &mvp,
+                frame_count,
+                1,
+                size,
+                size,
+                &original,
+                source,
+                &pass.binding_plan,
+                outputs[0..index].iter().map(Some),
+                feedback.iter().map(Some),
+                std::iter::empty::<Option<&Texture>>(),
+                std::iter::empty::<(usize, &Texture)>(),
+                &parameters,
+            );
+
+            black_box(&descriptors);
+        }
+    });
+}
@@ -0,0 +1,58 @@
+//! CPU benchmark of converting a decoded lookup texture for upload.
+//!
+//! Run with `cargo bench -p librashader-runtime`.
+#![feature(test)]
+#![feature(array_chunks)]
+
+extern crate test;
+
+use image::{DynamicImage, RgbaImage};
+use librashader_runtime::image::{Image, UVDirection, BGRA8};
+use test::{black_box, Bencher};
+
+/// The size of a large LUT, such as a mask or bezel background.
+const SIZE: u32 = 2048;
+
+fn decoded() -> DynamicImage {
+    DynamicImage::ImageRgba8(RgbaImage::from_fn(SIZE, SIZE, |x, y| {
+        image::Rgba([x as u8, y as u8, (x ^ y) as u8, 0xff])
+    }))
+}
+
+/// Flip, copy and swizzle the image in separate passes.
+fn separate_passes(image: DynamicImage) -> Vec<u8> {
+    let image = image.flipv().to_rgba8();
+    let mut bytes = image.into_raw();
+    for [r, _g, b, _a] in bytes.array_chunks_mut::<4>() {
+        std::mem::swap(b, r)
+    }
+    bytes
+}
+
+#[bench]
+fn flip_bgra8_separate(b: &mut Bencher) {
+    let image = decoded();
+    b.iter(|| black_box(separate_passes(black_box(image.clone()))));
+}
+
+#[bench]
+fn flip_bgra8_fused(b: &mut Bencher) {
+    let image = decoded();
+    b.iter(|| {
+        black_box(Image::<BGRA8>::from_image(
+            black_box(image.clone()),
+            UVDirection::BottomLeft,
+        ))
+    });
+}
+
+#[bench]
+fn bgra8_fused(b: &mut Bencher) {
+    let image = decoded();
+    b.iter(|| {
+        black_box(Image::<BGRA8>::from_image(
+            black_box(image.clone()),
+            UVDirection::TopLeft,
+        ))
+    });
+}
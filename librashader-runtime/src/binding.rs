@@ -1,13 +1,11 @@
+use crate::parameters::{ParameterHandle, RuntimeParameters};
 use crate::uniforms::{BindUniform, NoUniformBinder, UniformStorage};
 use librashader_common::Size;
-use librashader_preprocess::ShaderParameter;
 use librashader_reflect::reflect::semantics::{
     BindingMeta, MemberOffset, Semantic, TextureBinding, TextureSemantics, UniformBinding,
     UniformMeta, UniqueSemantics,
 };
 use rustc_hash::FxHashMap;
-use std::collections::HashMap;
-use std::hash::BuildHasher;
 use std::ops::{Deref, DerefMut};
 
 /// Trait for input textures used during uniform binding,
@@ -99,172 +97,233 @@ where
         viewport_size: Size<u32>,
         original: &Self::InputTexture,
         source: &Self::InputTexture,
-        uniform_bindings: &HashMap<UniformBinding, Self::UniformOffset, impl BuildHasher>,
-        texture_meta: &HashMap<Semantic<TextureSemantics>, TextureBinding, impl BuildHasher>,
+        binding_plan: &BindingPlan<Self::UniformOffset>,
         pass_outputs: impl Iterator<Item = Option<impl AsRef<Self::InputTexture>>>,
         pass_feedback: impl Iterator<Item = Option<impl AsRef<Self::InputTexture>>>,
         original_history: impl Iterator<Item = Option<impl AsRef<Self::InputTexture>>>,
         lookup_textures: impl Iterator<Item = (usize, impl AsRef<Self::InputTexture>)>,
-        parameter_defaults: &HashMap<String, ShaderParameter, impl BuildHasher>,
-        runtime_parameters: &HashMap<String, f32, impl BuildHasher>,
+        runtime_parameters: &RuntimeParameters,
     ) {
-        // Bind MVP
-        if let Some(offset) = uniform_bindings.get(&UniqueSemantics::MVP.into()) {
-            uniform_storage.bind_mat4(offset.offset(), mvp, offset.context());
-        }
-
-        // Bind OutputSize
-        if let Some(offset) = uniform_bindings.get(&UniqueSemantics::Output.into()) {
-            uniform_storage.bind_vec4(offset.offset(), framebuffer_size, offset.context());
-        }
-
-        // bind FinalViewportSize
-        if let Some(offset) = uniform_bindings.get(&UniqueSemantics::FinalViewport.into()) {
-            uniform_storage.bind_vec4(offset.offset(), viewport_size, offset.context());
-        }
-
-        // bind FrameCount
-        if let Some(offset) = uniform_bindings.get(&UniqueSemantics::FrameCount.into()) {
-            uniform_storage.bind_scalar(offset.offset(), frame_count, offset.context());
-        }
-
-        // bind FrameDirection
-        if let Some(offset) = uniform_bindings.get(&UniqueSemantics::FrameDirection.into()) {
-            uniform_storage.bind_scalar(offset.offset(), frame_direction, offset.context());
-        }
-
-        // bind Original sampler
-        if let Some(binding) = texture_meta.get(&TextureSemantics::Original.semantics(0)) {
-            Self::bind_texture(descriptor_set, sampler_set, binding, original, device);
+        // bind builtin uniforms
+        for (semantics, offset) in binding_plan.unique.iter() {
+            match semantics {
+                UniqueSemantics::MVP => {
+                    uniform_storage.bind_mat4(offset.offset(), mvp, offset.context())
+                }
+                UniqueSemantics::Output => {
+                    uniform_storage.bind_vec4(offset.offset(), framebuffer_size, offset.context())
+                }
+                UniqueSemantics::FinalViewport => {
+                    uniform_storage.bind_vec4(offset.offset(), viewport_size, offset.context())
+                }
+                UniqueSemantics::FrameCount => {
+                    uniform_storage.bind_scalar(offset.offset(), frame_count, offset.context())
+                }
+                UniqueSemantics::FrameDirection => {
+                    uniform_storage.bind_scalar(offset.offset(), frame_direction, offset.context())
+                }
+                // Parameters are planned separately.
+                UniqueSemantics::FloatParameter => {}
+            }
         }
 
-        // bind OriginalSize
-        if let Some(offset) = uniform_bindings.get(&TextureSemantics::Original.semantics(0).into())
-        {
-            uniform_storage.bind_vec4(offset.offset(), original.size(), offset.context());
-        }
+        // bind User parameters
+        for parameter in binding_plan.parameters.iter() {
+            let Some(value) = runtime_parameters.get_by_handle(parameter.handle) else {
+                continue;
+            };
 
-        // bind Source sampler
-        if let Some(binding) = texture_meta.get(&TextureSemantics::Source.semantics(0)) {
-            Self::bind_texture(descriptor_set, sampler_set, binding, source, device);
+            uniform_storage.bind_scalar(
+                parameter.offset.offset(),
+                value,
+                parameter.offset.context(),
+            );
         }
 
-        // bind SourcelSize
-        if let Some(offset) = uniform_bindings.get(&TextureSemantics::Source.semantics(0).into()) {
-            uniform_storage.bind_vec4(offset.offset(), source.size(), offset.context());
-        }
+        let mut bind = |planned: &PlannedTexture<Self::UniformOffset>,
+                        texture: &Self::InputTexture| {
+            if let Some(binding) = &planned.binding {
+                Self::bind_texture(descriptor_set, sampler_set, binding, texture, device);
+            }
 
-        // OriginalHistory0 aliases OriginalHistory
+            if let Some(offset) = &planned.size {
+                uniform_storage.bind_vec4(offset.offset(), texture.size(), offset.context());
+            }
+        };
 
-        // bind OriginalHistory0 sampler
-        if let Some(binding) = texture_meta.get(&TextureSemantics::OriginalHistory.semantics(0)) {
-            Self::bind_texture(descriptor_set, sampler_set, binding, original, device);
+        // bind Original and OriginalHistory0, which aliases Original
+        for planned in binding_plan.original.iter() {
+            bind(planned, original);
         }
 
-        // bind OriginalHistory0Size
-        if let Some(offset) =
-            uniform_bindings.get(&TextureSemantics::OriginalHistory.semantics(0).into())
-        {
-            uniform_storage.bind_vec4(offset.offset(), original.size(), offset.context());
+        // bind Source
+        for planned in binding_plan.source.iter() {
+            bind(planned, source);
         }
 
         // bind OriginalHistory1-..
-        for (index, history) in original_history.enumerate() {
-            let Some(history) = history else {
-                continue;
-            };
-
-            let history = history.as_ref();
-
-            if let Some(binding) =
-                texture_meta.get(&TextureSemantics::OriginalHistory.semantics(index + 1))
-            {
-                Self::bind_texture(descriptor_set, sampler_set, binding, history, device);
-            }
-
-            if let Some(offset) = uniform_bindings.get(
-                &TextureSemantics::OriginalHistory
-                    .semantics(index + 1)
-                    .into(),
-            ) {
-                uniform_storage.bind_vec4(offset.offset(), history.size(), offset.context());
-            }
+        for (planned, history) in planned_textures(&binding_plan.history, original_history) {
+            bind(planned, history.as_ref());
         }
 
         // bind PassOutput0..
         // The caller should be responsible for limiting this up to
         // pass_index
-        for (index, output) in pass_outputs.enumerate() {
-            let Some(output) = output else {
-                continue;
-            };
-
-            let output = output.as_ref();
-
-            if let Some(binding) = texture_meta.get(&TextureSemantics::PassOutput.semantics(index))
-            {
-                Self::bind_texture(descriptor_set, sampler_set, binding, output, device);
-            }
-
-            if let Some(offset) =
-                uniform_bindings.get(&TextureSemantics::PassOutput.semantics(index).into())
-            {
-                uniform_storage.bind_vec4(offset.offset(), output.size(), offset.context());
-            }
+        for (planned, output) in planned_textures(&binding_plan.pass_outputs, pass_outputs) {
+            bind(planned, output.as_ref());
         }
 
         // bind PassFeedback0..
-        for (index, feedback) in pass_feedback.enumerate() {
-            let Some(output) = feedback else {
+        for (planned, feedback) in planned_textures(&binding_plan.pass_feedback, pass_feedback) {
+            bind(planned, feedback.as_ref());
+        }
+
+        // bind luts
+        for (index, lut) in lookup_textures {
+            let Ok(position) = binding_plan
+                .luts
+                .binary_search_by_key(&index, |planned| planned.index)
+            else {
                 continue;
             };
 
-            let feedback = output.as_ref();
+            bind(&binding_plan.luts[position], lut.as_ref());
+        }
+    }
+}
 
-            if let Some(binding) =
-                texture_meta.get(&TextureSemantics::PassFeedback.semantics(index))
-            {
-                Self::bind_texture(descriptor_set, sampler_set, binding, feedback, device);
-            }
+/// A texture semantic used by a shader pass, with its texture and size uniform bindings.
+#[derive(Debug)]
+struct PlannedTexture<T> {
+    /// The position of the texture in the input textures for its semantics.
+    index: usize,
+    /// The binding of the texture sampler, if it is sampled.
+    binding: Option<TextureBinding>,
+    /// The offset of the size uniform, if it is used.
+    size: Option<T>,
+}
 
-            if let Some(offset) =
-                uniform_bindings.get(&TextureSemantics::PassFeedback.semantics(index).into())
-            {
-                uniform_storage.bind_vec4(offset.offset(), feedback.size(), offset.context());
-            }
-        }
+/// A user parameter used by a shader pass.
+#[derive(Debug)]
+struct PlannedParameter<T> {
+    handle: ParameterHandle,
+    offset: T,
+}
 
-        // bind User parameters
-        for (id, offset) in uniform_bindings
+/// The uniforms and textures used by a shader pass, resolved ahead of time.
+///
+/// The semantics used by a pass are fixed once it is reflected, so the binding plan
+/// resolves every binding once when the filter chain is created. Binding semantics per frame
+/// is then a linear walk over the plan, without needing to look up any semantic in a map.
+#[derive(Debug)]
+pub struct BindingPlan<T> {
+    unique: Vec<(UniqueSemantics, T)>,
+    parameters: Vec<PlannedParameter<T>>,
+    original: Vec<PlannedTexture<T>>,
+    source: Vec<PlannedTexture<T>>,
+    history: Vec<PlannedTexture<T>>,
+    pass_outputs: Vec<PlannedTexture<T>>,
+    pass_feedback: Vec<PlannedTexture<T>>,
+    luts: Vec<PlannedTexture<T>>,
+}
+
+impl<T> BindingPlan<T> {
+    /// Create the binding plan for a shader pass with the given reflection information.
+    ///
+    /// The offset for each uniform is produced by `f`, and parameters are resolved
+    /// to their handles in the runtime parameters of the filter chain.
+    pub fn new(
+        meta: &BindingMeta,
+        runtime_parameters: &RuntimeParameters,
+        f: impl Fn(&dyn UniformMeta) -> T,
+    ) -> Self {
+        let mut unique: Vec<_> = meta
+            .unique_meta
             .iter()
-            .filter_map(|(binding, value)| match binding {
-                UniformBinding::Parameter(id) => Some((id, value)),
-                _ => None,
+            .map(|(semantics, param)| (*semantics, f(param)))
+            .collect();
+        unique.sort_by_key(|(semantics, _)| *semantics);
+
+        let mut parameters: Vec<_> = meta
+            .parameter_meta
+            .values()
+            .filter_map(|param| {
+                Some(PlannedParameter {
+                    handle: runtime_parameters.handle(&param.id)?,
+                    offset: f(param),
+                })
             })
-        {
-            let id = id.as_str();
-
-            let default = parameter_defaults.get(id).map_or(0f32, |f| f.initial);
-
-            let value = *runtime_parameters.get(id).unwrap_or(&default);
+            .collect();
+        parameters.sort_by_key(|parameter| parameter.handle.as_raw());
+
+        let mut textures: Vec<Semantic<TextureSemantics>> = meta
+            .texture_meta
+            .keys()
+            .chain(meta.texture_size_meta.keys())
+            .copied()
+            .collect();
+        textures.sort_by_key(|semantic| (semantic.semantics, semantic.index));
+        textures.dedup();
+
+        let mut plan = BindingPlan {
+            unique,
+            parameters,
+            original: Vec::new(),
+            source: Vec::new(),
+            history: Vec::new(),
+            pass_outputs: Vec::new(),
+            pass_feedback: Vec::new(),
+            luts: Vec::new(),
+        };
+
+        for semantic in textures {
+            let (planned, index) = match semantic.semantics {
+                TextureSemantics::Original => (&mut plan.original, semantic.index),
+                TextureSemantics::Source => (&mut plan.source, semantic.index),
+                // OriginalHistory0 aliases Original
+                TextureSemantics::OriginalHistory if semantic.index == 0 => (&mut plan.original, 0),
+                // The input history textures start at OriginalHistory1
+                TextureSemantics::OriginalHistory => (&mut plan.history, semantic.index - 1),
+                TextureSemantics::PassOutput => (&mut plan.pass_outputs, semantic.index),
+                TextureSemantics::PassFeedback => (&mut plan.pass_feedback, semantic.index),
+                TextureSemantics::User => (&mut plan.luts, semantic.index),
+            };
 
-            uniform_storage.bind_scalar(offset.offset(), value, offset.context());
+            planned.push(PlannedTexture {
+                index,
+                binding: meta
+                    .texture_meta
+                    .get(&semantic)
+                    .map(|texture| TextureBinding {
+                        binding: texture.binding,
+                    }),
+                size: meta.texture_size_meta.get(&semantic).map(|param| f(param)),
+            });
         }
 
-        // bind luts
-        for (index, lut) in lookup_textures {
-            let lut = lut.as_ref();
-            if let Some(binding) = texture_meta.get(&TextureSemantics::User.semantics(index)) {
-                Self::bind_texture(descriptor_set, sampler_set, binding, lut, device);
-            }
+        plan
+    }
+}
 
-            if let Some(offset) =
-                uniform_bindings.get(&TextureSemantics::User.semantics(index).into())
-            {
-                uniform_storage.bind_vec4(offset.offset(), lut.size(), offset.context());
-            }
+/// Walk the planned textures of a semantic alongside the input textures for that semantic.
+///
+/// The planned textures must be sorted by index. Only the input textures that are used by the
+/// plan are yielded, and input textures that are not available are skipped.
+fn planned_textures<'p, T, I>(
+    planned: &'p [PlannedTexture<T>],
+    mut textures: impl Iterator<Item = Option<I>>,
+) -> impl Iterator<Item = (&'p PlannedTexture<T>, I)> {
+    let mut planned = planned.iter();
+    let mut next = 0;
+    std::iter::from_fn(move || loop {
+        let entry = planned.next()?;
+        let texture = textures.nth(entry.index - next)?;
+        next = entry.index + 1;
+
+        if let Some(texture) = texture {
+            return Some((entry, texture));
         }
-    }
+    })
 }
 
 /// Trait for objects that can be used to create a binding map.
@@ -0,0 +1,122 @@
+use std::collections::VecDeque;
+use std::sync::mpsc::{channel, Receiver};
+use std::sync::{Arc, Mutex};
+
+/// The function used to compile a deferred shader pass.
+pub type DeferredCompile<S, A, E> = Arc<dyn Fn(S) -> Result<A, E> + Send + Sync>;
+
+/// A queue of shader passes whose compilation is deferred until they are first needed.
+///
+/// Passes are always taken in order. If prefetching is enabled, passes are compiled
+/// in order on a background thread, and taking a pass will wait for it to finish if
+/// it is not yet ready.
+pub struct DeferredPasses<S, A, E> {
+    pending: VecDeque<S>,
+    // The passes returned by the last call to `take`, so that they can be restored.
+    taken: Vec<S>,
+    compile: DeferredCompile<S, A, E>,
+    // Receiver is not Sync, but filter chains must be.
+    prefetch: Option<Mutex<Receiver<Result<A, E>>>>,
+}
+
+impl<S, A, E> DeferredPasses<S, A, E>
+where
+    S: Clone + Send + 'static,
+    A: Send + 'static,
+    E: Send + 'static,
+{
+    /// Create a new queue of deferred passes, optionally starting to compile them
+    /// in the background immediately.
+    pub fn new(passes: Vec<S>, compile: DeferredCompile<S, A, E>, prefetch: bool) -> Self {
+        let pending = VecDeque::from(passes);
+
+        let prefetch = if prefetch && !pending.is_empty() {
+            let (sender, receiver) = channel();
+            let passes = pending.clone();
+            let compile = Arc::clone(&compile);
+            std::thread::spawn(move || {
+                for pass in passes {
+                    let result = compile(pass);
+                    let failed = result.is_err();
+
+                    // The receiver is gone if the filter chain was dropped.
+                    if sender.send(result).is_err() || failed {
+                        break;
+                    }
+                }
+            });
+            Some(Mutex::new(receiver))
+        } else {
+            None
+        };
+
+        Self {
+            pending,
+            taken: Vec::new(),
+            compile,
+            prefetch,
+        }
+    }
+
+    /// The number of passes that have not yet been taken.
+    pub fn remaining(&self) -> usize {
+        self.pending.len()
+    }
+
+    /// Take up to `count` compiled passes from the front of the queue.
+    ///
+    /// If a pass fails to compile, every pass taken by this call is put back at the front of
+    /// the queue, so that compilation can be retried with the order of passes preserved.
+    pub fn take(&mut self, count: usize) -> Result<Vec<A>, E> {
+        let count = std::cmp::min(count, self.pending.len());
+        let mut compiled = Vec::with_capacity(count);
+        self.taken.clear();
+
+        for _ in 0..count {
+            let Some(pass) = self.pending.pop_front() else {
+                break;
+            };
+
+            let prefetched = self
+                .prefetch
+                .as_mut()
+                .and_then(|r| r.get_mut().ok())
+                .and_then(|r| r.recv().ok());
+            let result = match prefetched {
+                Some(result) => result,
+                None => {
+                    // The background thread stopped early, compile the rest on demand.
+                    self.prefetch = None;
+                    (self.compile)(pass.clone())
+                }
+            };
+
+            self.taken.push(pass);
+            match result {
+                Ok(artifact) => compiled.push(artifact),
+                Err(error) => {
+                    self.restore();
+                    return Err(error);
+                }
+            }
+        }
+
+        Ok(compiled)
+    }
+
+    /// Put the passes returned by the last call to [`take`](Self::take) back at the front of
+    /// the queue, if the compiled passes could not be used.
+    ///
+    /// Restored passes are compiled again on demand when they are next taken.
+    pub fn restore(&mut self) {
+        if self.taken.is_empty() {
+            return;
+        }
+
+        // The background thread compiles in queue order, which no longer matches.
+        self.prefetch = None;
+        for pass in self.taken.drain(..).rev() {
+            self.pending.push_front(pass);
+        }
+    }
+}
@@ -37,6 +37,19 @@ impl<'a, F, I, E> FramebufferInit<'a, F, I, E> {
         )
     }
 
+    /// Initialize history views without allocating history framebuffers.
+    ///
+    /// This is used when previous input images are bound as history directly.
+    pub fn init_history_views(&self) -> Box<[I]> {
+        if self.required_history <= 1 {
+            return Box::new([]);
+        }
+
+        let mut history_textures = Vec::new();
+        history_textures.resize_with(self.required_history, self.input_generator);
+        history_textures.into_boxed_slice()
+    }
+
     /// Initialize output framebuffers and views.
     pub fn init_output_framebuffers(&self) -> Result<(Box<[F]>, Box<[I]>), E> {
         init_output_framebuffers(
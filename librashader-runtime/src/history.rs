@@ -0,0 +1,66 @@
+use std::collections::VecDeque;
+
+/// The input images of previous frames, for filter chains that do not copy their input into
+/// history framebuffers.
+///
+/// The most recent input is at index 0, which is bound as `OriginalHistory1`. Inputs are only
+/// referenced, so the caller must keep each input image alive and unmodified until it is evicted.
+pub struct InputHistory<I> {
+    inputs: VecDeque<I>,
+    capacity: usize,
+}
+
+impl<I> InputHistory<I> {
+    /// Create an empty history that keeps up to `capacity` previous inputs.
+    pub fn new(capacity: usize) -> Self {
+        Self {
+            inputs: VecDeque::with_capacity(capacity + 1),
+            capacity,
+        }
+    }
+
+    /// The number of previous inputs that are kept.
+    pub fn capacity(&self) -> usize {
+        self.capacity
+    }
+
+    /// Push the input of the frame that was just drawn.
+    ///
+    /// Returns the oldest input if it is no longer needed.
+    pub fn push(&mut self, input: I) -> Option<I> {
+        if self.capacity == 0 {
+            return Some(input);
+        }
+
+        self.inputs.push_front(input);
+        if self.inputs.len() > self.capacity {
+            self.inputs.pop_back()
+        } else {
+            None
+        }
+    }
+
+    /// Get the input from `index + 1` frames ago.
+    pub fn get(&self, index: usize) -> Option<&I> {
+        self.inputs.get(index)
+    }
+
+    /// Change the number of previous inputs that are kept.
+    ///
+    /// The most recent inputs are kept, and the inputs that no longer fit are removed.
+    pub fn set_capacity(&mut self, capacity: usize) -> impl Iterator<Item = I> + '_ {
+        self.capacity = capacity;
+        let kept = std::cmp::min(capacity, self.inputs.len());
+        self.inputs.drain(kept..)
+    }
+
+    /// Forget every previous input.
+    pub fn clear(&mut self) {
+        self.inputs.clear()
+    }
+
+    /// Remove every previous input from the history.
+    pub fn drain(&mut self) -> impl Iterator<Item = I> + '_ {
+        self.inputs.drain(..)
+    }
+}
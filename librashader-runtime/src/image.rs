@@ -1,8 +1,18 @@
+use crate::scaling::MipmapSize;
+use image::DynamicImage;
 pub use image::ImageError;
 use librashader_common::Size;
+use rustc_hash::FxHashMap;
+use std::any::{Any, TypeId};
 use std::marker::PhantomData;
+use std::simd::{simd_swizzle, Simd};
+use std::sync::{Arc, Mutex, OnceLock};
+use std::time::SystemTime;
 
-use std::path::Path;
+use std::path::{Path, PathBuf};
+
+mod container;
+pub use container::convert_luts_to_ktx2;
 
 /// An uncompressed raw image ready to upload to GPU buffers.
 pub struct Image<P: PixelFormat = RGBA8> {
@@ -12,9 +22,22 @@ pub struct Image<P: PixelFormat = RGBA8> {
     pub size: Size<u32>,
     /// The byte pitch of the image.
     pub pitch: usize,
+    /// Prebuilt mip levels following the base level, if the image was loaded
+    /// from a texture container that has them.
+    pub mipmaps: Vec<MipLevel>,
     _pd: PhantomData<P>,
 }
 
+/// A prebuilt mip level of an image.
+pub struct MipLevel {
+    /// The raw bytes of the mip level.
+    pub bytes: Vec<u8>,
+    /// The size dimensions of the mip level.
+    pub size: Size<u32>,
+    /// The byte pitch of the mip level.
+    pub pitch: usize,
+}
+
 /// R8G8B8A8 pixel format.
 ///
 /// Every RGB with alpha pixel is represented with 32 bits.
@@ -28,23 +51,48 @@ pub struct BGRA8;
 /// Represents an image pixel format to convert images into.
 pub trait PixelFormat {
     #[doc(hidden)]
-    fn convert(pixels: &mut Vec<u8>);
+    fn convert(pixels: &mut [u8]);
 }
 
 impl PixelFormat for RGBA8 {
-    fn convert(_pixels: &mut Vec<u8>) {}
+    #[inline(always)]
+    fn convert(_pixels: &mut [u8]) {}
 }
 
+/// The number of bytes swizzled at once when converting between RGBA8 and BGRA8.
+const SWIZZLE_LANES: usize = 32;
+
+/// Swaps the first and third byte of every pixel in a vector of RGBA8 or BGRA8 pixels.
+const SWAP_RB: [usize; SWIZZLE_LANES] = {
+    let mut index = [0; SWIZZLE_LANES];
+    let mut pixel = 0;
+    while pixel < SWIZZLE_LANES {
+        index[pixel] = pixel + 2;
+        index[pixel + 1] = pixel + 1;
+        index[pixel + 2] = pixel;
+        index[pixel + 3] = pixel + 3;
+        pixel += 4;
+    }
+    index
+};
+
 impl PixelFormat for BGRA8 {
-    fn convert(pixels: &mut Vec<u8>) {
-        for [r, _g, b, _a] in pixels.array_chunks_mut::<4>() {
+    #[inline(always)]
+    fn convert(pixels: &mut [u8]) {
+        let mut chunks = pixels.chunks_exact_mut(SWIZZLE_LANES);
+        for chunk in &mut chunks {
+            let pixels = Simd::<u8, SWIZZLE_LANES>::from_slice(chunk);
+            simd_swizzle!(pixels, SWAP_RB).copy_to_slice(chunk);
+        }
+
+        for [r, _g, b, _a] in chunks.into_remainder().array_chunks_mut::<4>() {
             std::mem::swap(b, r)
         }
     }
 }
 
 /// The direction of UV coordinates to load the image for.
-#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+#[derive(Copy, Clone, Debug, Eq, PartialEq, Hash)]
 pub enum UVDirection {
     /// Origin is at the top left (Direct3D, Vulkan)
     TopLeft,
@@ -54,14 +102,55 @@ pub enum UVDirection {
 
 impl<P: PixelFormat> Image<P> {
     /// Load the image from the path as RGBA8.
+    ///
+    /// KTX2 and DDS containers with uncompressed 8-bit RGBA or BGRA pixels are loaded
+    /// with all of their mip levels. Other images are decoded without mip levels.
+    #[cfg_attr(feature = "tracing", tracing::instrument(skip_all, fields(path = %path.as_ref().display())))]
     pub fn load(path: impl AsRef<Path>, direction: UVDirection) -> Result<Self, ImageError> {
-        let mut image = image::open(path.as_ref())?;
+        if let Some(image) = Self::load_container(path.as_ref(), direction)? {
+            return Ok(image);
+        }
 
-        if direction == UVDirection::BottomLeft {
-            image = image.flipv();
+        let image = image::open(path.as_ref())?;
+        Ok(Self::from_image(image, direction))
+    }
+
+    /// The number of mip levels the texture for this image should have.
+    ///
+    /// If the image has prebuilt mip levels, only those levels are used.
+    pub fn level_count(&self, mipmap: bool) -> u32 {
+        if !mipmap {
+            1
+        } else if !self.mipmaps.is_empty() {
+            self.mipmaps.len() as u32 + 1
+        } else {
+            self.size.calculate_miplevels()
         }
+    }
+
+    /// Whether mip levels for the texture need to be generated on the GPU.
+    pub fn needs_mipmap_generation(&self, mipmap: bool) -> bool {
+        mipmap && self.mipmaps.is_empty() && self.level_count(mipmap) > 1
+    }
+
+    /// The prebuilt mip levels to upload after the base level.
+    ///
+    /// This is empty if the image has no prebuilt mip levels, or if `mipmap` is false.
+    pub fn prebuilt_levels(&self, mipmap: bool) -> &[MipLevel] {
+        if !mipmap || self.needs_mipmap_generation(mipmap) {
+            return &[];
+        }
+
+        let len = std::cmp::min(self.level_count(mipmap) as usize - 1, self.mipmaps.len());
+        &self.mipmaps[..len]
+    }
 
-        let image = image.to_rgba8();
+    /// Convert a decoded image into the pixel format.
+    ///
+    /// Images that are already RGBA8 are converted in place. Flipping the image and
+    /// converting pixels is done together, one pair of rows at a time.
+    pub fn from_image(image: DynamicImage, direction: UVDirection) -> Self {
+        let image = image.into_rgba8();
 
         let height = image.height();
         let width = image.width();
@@ -71,12 +160,379 @@ impl<P: PixelFormat> Image<P> {
             .max(image.sample_layout().width_stride);
 
         let mut bytes = image.into_raw();
-        P::convert(&mut bytes);
-        Ok(Image {
+        if direction == UVDirection::BottomLeft {
+            Self::flip_and_convert(&mut bytes, pitch);
+        } else {
+            P::convert(&mut bytes);
+        }
+
+        Image {
             bytes,
             pitch,
             size: Size { height, width },
+            mipmaps: Vec::new(),
             _pd: Default::default(),
+        }
+    }
+
+    fn flip_and_convert(bytes: &mut [u8], pitch: usize) {
+        if pitch == 0 {
+            return;
+        }
+
+        let rows = bytes.len() / pitch;
+        let (top, bottom) = bytes.split_at_mut(rows / 2 * pitch);
+        let (middle, bottom) = bottom.split_at_mut(bottom.len() - rows / 2 * pitch);
+
+        // The rows are still in cache after being swapped, so converting them
+        // right away only reads the image from memory once.
+        for (top, bottom) in top
+            .chunks_exact_mut(pitch)
+            .zip(bottom.chunks_exact_mut(pitch).rev())
+        {
+            top.swap_with_slice(bottom);
+            P::convert(top);
+            P::convert(bottom);
+        }
+
+        P::convert(middle);
+    }
+}
+
+impl<P: PixelFormat + Send + Sync + 'static> Image<P> {
+    /// Load the image from the path, sharing the decoded image with every filter chain
+    /// in the process through the [`ImageCache`].
+    pub fn load_shared(
+        path: impl AsRef<Path>,
+        direction: UVDirection,
+    ) -> Result<Arc<Self>, ImageError> {
+        let path = path.as_ref().canonicalize()?;
+        let modified = path.metadata()?.modified().ok();
+        let key = ImageKey {
+            path,
+            modified,
+            direction,
+            format: TypeId::of::<P>(),
+        };
+
+        if let Some(image) = ImageCache::get(&key) {
+            if let Ok(image) = image.downcast::<Self>() {
+                return Ok(image);
+            }
+        }
+
+        let image = Arc::new(Self::load(&key.path, direction)?);
+        let size = image.bytes.len()
+            + image
+                .mipmaps
+                .iter()
+                .map(|level| level.bytes.len())
+                .sum::<usize>();
+        ImageCache::insert(key, Arc::clone(&image) as _, size);
+        Ok(image)
+    }
+}
+
+#[derive(Debug, Clone, Eq, PartialEq, Hash)]
+struct ImageKey {
+    path: PathBuf,
+    modified: Option<SystemTime>,
+    direction: UVDirection,
+    format: TypeId,
+}
+
+struct CachedImage {
+    image: Arc<dyn Any + Send + Sync>,
+    size: usize,
+    last_used: u64,
+}
+
+/// A process-wide cache of decoded images loaded with [`Image::load_shared`].
+///
+/// Images are keyed by their canonical path, modification time, UV direction and pixel
+/// format, so an image that changed on disk is decoded again. Once the decoded images
+/// exceed the capacity of the cache, the least recently used images are evicted. Evicted
+/// images stay alive until every filter chain using them drops them.
+pub struct ImageCache {
+    entries: FxHashMap<ImageKey, CachedImage>,
+    size: usize,
+    capacity: usize,
+    clock: u64,
+}
+
+impl ImageCache {
+    /// The default capacity of the cache in bytes.
+    pub const DEFAULT_CAPACITY: usize = 256 * 1024 * 1024;
+
+    fn new(capacity: usize) -> Self {
+        ImageCache {
+            entries: FxHashMap::default(),
+            size: 0,
+            capacity,
+            clock: 0,
+        }
+    }
+
+    fn instance() -> &'static Mutex<ImageCache> {
+        static CACHE: OnceLock<Mutex<ImageCache>> = OnceLock::new();
+        CACHE.get_or_init(|| Mutex::new(ImageCache::new(Self::DEFAULT_CAPACITY)))
+    }
+
+    fn with<T>(f: impl FnOnce(&mut ImageCache) -> T) -> T {
+        // The cache is always left consistent, so a panic while it was locked is harmless.
+        let mut cache = Self::instance()
+            .lock()
+            .unwrap_or_else(|poison| poison.into_inner());
+        f(&mut cache)
+    }
+
+    fn get(key: &ImageKey) -> Option<Arc<dyn Any + Send + Sync>> {
+        Self::with(|cache| cache.lookup(key))
+    }
+
+    fn insert(key: ImageKey, image: Arc<dyn Any + Send + Sync>, size: usize) {
+        Self::with(|cache| cache.store(key, image, size))
+    }
+
+    fn lookup(&mut self, key: &ImageKey) -> Option<Arc<dyn Any + Send + Sync>> {
+        self.clock += 1;
+        let clock = self.clock;
+        let entry = self.entries.get_mut(key)?;
+        entry.last_used = clock;
+        Some(Arc::clone(&entry.image))
+    }
+
+    fn store(&mut self, key: ImageKey, image: Arc<dyn Any + Send + Sync>, size: usize) {
+        // An image that would evict everything else is not worth keeping.
+        if size > self.capacity {
+            return;
+        }
+
+        self.clock += 1;
+        let entry = CachedImage {
+            image,
+            size,
+            last_used: self.clock,
+        };
+        if let Some(old) = self.entries.insert(key, entry) {
+            self.size -= old.size;
+        }
+        self.size += size;
+        self.evict();
+    }
+
+    fn evict(&mut self) {
+        while self.size > self.capacity {
+            let Some(key) = self
+                .entries
+                .iter()
+                .min_by_key(|(_, entry)| entry.last_used)
+                .map(|(key, _)| key.clone())
+            else {
+                break;
+            };
+
+            if let Some(entry) = self.entries.remove(&key) {
+                self.size -= entry.size;
+            }
+        }
+    }
+
+    fn resize(&mut self, capacity: usize) {
+        self.capacity = capacity;
+        self.evict();
+    }
+
+    /// Set the maximum number of bytes of decoded images kept in the cache.
+    pub fn set_capacity(capacity: usize) {
+        Self::with(|cache| cache.resize(capacity))
+    }
+
+    /// Remove every image from the cache.
+    pub fn clear() {
+        Self::with(|cache| {
+            cache.entries.clear();
+            cache.size = 0;
         })
     }
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use image::RgbaImage;
+
+    fn image(width: u32, height: u32) -> Image<RGBA8> {
+        let image = RgbaImage::from_fn(width, height, |x, y| {
+            image::Rgba([x as u8, y as u8, (x * y) as u8, 255])
+        });
+        Image::from_image(DynamicImage::ImageRgba8(image), UVDirection::TopLeft)
+    }
+
+    #[test]
+    pub fn decoded_images_have_no_prebuilt_levels() {
+        let image = image(5, 3);
+        assert_eq!(image.level_count(false), 1);
+        assert_eq!(image.level_count(true), 3);
+        assert!(image.needs_mipmap_generation(true));
+        assert!(image.prebuilt_levels(true).is_empty());
+        assert!(image.prebuilt_levels(false).is_empty());
+    }
+
+    #[test]
+    pub fn prebuilt_levels_are_uploaded() {
+        let mut image = image(4, 4);
+        image.mipmaps = [2, 1]
+            .into_iter()
+            .map(|size| MipLevel {
+                bytes: vec![0; size * size * 4],
+                size: Size::new(size as u32, size as u32),
+                pitch: size * 4,
+            })
+            .collect();
+
+        assert_eq!(image.level_count(true), 3);
+        assert!(!image.needs_mipmap_generation(true));
+        assert_eq!(image.prebuilt_levels(true).len(), 2);
+        assert!(image.prebuilt_levels(false).is_empty());
+    }
+
+    fn bgra8(image: &DynamicImage, direction: UVDirection) -> Vec<u8> {
+        let image = match direction {
+            UVDirection::TopLeft => image.to_rgba8(),
+            UVDirection::BottomLeft => image.flipv().to_rgba8(),
+        };
+
+        let mut bytes = image.into_raw();
+        for pixel in bytes.chunks_exact_mut(4) {
+            pixel.swap(0, 2);
+        }
+        bytes
+    }
+
+    #[test]
+    pub fn bgra8_images_are_flipped_and_converted() {
+        // odd heights have a middle row that is not swapped, and widths that are not a
+        // multiple of 8 pixels leave a remainder after the swizzled chunks.
+        for (width, height) in [(13, 5), (3, 7), (8, 1), (1, 4), (21, 9)] {
+            let image = DynamicImage::ImageRgba8(RgbaImage::from_fn(width, height, |x, y| {
+                image::Rgba([x as u8, y as u8, (x * 7 + y) as u8, (x ^ y) as u8])
+            }));
+
+            for direction in [UVDirection::TopLeft, UVDirection::BottomLeft] {
+                let converted = Image::<BGRA8>::from_image(image.clone(), direction);
+                assert_eq!(converted.size, Size::new(width, height));
+                assert_eq!(converted.pitch, width as usize * 4);
+                assert_eq!(
+                    converted.bytes,
+                    bgra8(&image, direction),
+                    "{width}x{height} {direction:?}"
+                );
+            }
+        }
+    }
+
+    #[test]
+    pub fn rgba8_images_are_flipped() {
+        let image = DynamicImage::ImageRgba8(RgbaImage::from_fn(13, 5, |x, y| {
+            image::Rgba([x as u8, y as u8, 0, 255])
+        }));
+
+        let converted = Image::<RGBA8>::from_image(image.clone(), UVDirection::BottomLeft);
+        assert_eq!(converted.bytes, image.flipv().to_rgba8().into_raw());
+    }
+
+    fn key(path: &str) -> ImageKey {
+        ImageKey {
+            path: PathBuf::from(path),
+            modified: None,
+            direction: UVDirection::TopLeft,
+            format: TypeId::of::<RGBA8>(),
+        }
+    }
+
+    fn cached(cache: &ImageCache, path: &str) -> bool {
+        cache.entries.contains_key(&key(path))
+    }
+
+    #[test]
+    pub fn cache_evicts_least_recently_used() {
+        let mut cache = ImageCache::new(3);
+        for path in ["a", "b", "c"] {
+            cache.store(key(path), Arc::new(()), 1);
+        }
+        assert!(cache.lookup(&key("a")).is_some());
+
+        cache.store(key("d"), Arc::new(()), 1);
+        assert!(cached(&cache, "a"));
+        assert!(!cached(&cache, "b"));
+        assert!(cached(&cache, "c"));
+        assert!(cached(&cache, "d"));
+        assert_eq!(cache.size, 3);
+
+        // replacing an image does not count it twice.
+        cache.store(key("c"), Arc::new(()), 2);
+        assert!(!cached(&cache, "a"));
+        assert!(cached(&cache, "c"));
+        assert!(cached(&cache, "d"));
+        assert_eq!(cache.size, 3);
+    }
+
+    #[test]
+    pub fn cache_shrinks_to_capacity() {
+        let mut cache = ImageCache::new(4);
+        for path in ["a", "b", "c", "d"] {
+            cache.store(key(path), Arc::new(()), 1);
+        }
+        assert!(cache.lookup(&key("b")).is_some());
+
+        cache.resize(2);
+        assert!(cached(&cache, "b"));
+        assert!(cached(&cache, "d"));
+        assert_eq!(cache.entries.len(), 2);
+        assert_eq!(cache.size, 2);
+
+        cache.resize(0);
+        assert!(cache.entries.is_empty());
+        assert_eq!(cache.size, 0);
+    }
+
+    #[test]
+    pub fn cache_skips_images_larger_than_capacity() {
+        let mut cache = ImageCache::new(4);
+        cache.store(key("a"), Arc::new(()), 2);
+        cache.store(key("b"), Arc::new(()), 5);
+        assert!(cached(&cache, "a"));
+        assert!(!cached(&cache, "b"));
+        assert_eq!(cache.size, 2);
+    }
+
+    #[test]
+    pub fn cache_keys_on_modification_time_and_format() {
+        let mut cache = ImageCache::new(4);
+        cache.store(key("a"), Arc::new(()), 1);
+
+        let modified = ImageKey {
+            modified: Some(SystemTime::UNIX_EPOCH),
+            ..key("a")
+        };
+        let bgra8 = ImageKey {
+            format: TypeId::of::<BGRA8>(),
+            ..key("a")
+        };
+        assert!(cache.lookup(&modified).is_none());
+        assert!(cache.lookup(&bgra8).is_none());
+        assert!(cache.lookup(&key("a")).is_some());
+    }
+
+    #[test]
+    pub fn shared_images_are_loaded_once() {
+        let first = Image::<RGBA8>::load_shared("../test/sf2.png", UVDirection::TopLeft).unwrap();
+        let second = Image::<RGBA8>::load_shared("../test/sf2.png", UVDirection::TopLeft).unwrap();
+        assert!(Arc::ptr_eq(&first, &second));
+
+        let flipped =
+            Image::<RGBA8>::load_shared("../test/sf2.png", UVDirection::BottomLeft).unwrap();
+        assert!(!Arc::ptr_eq(&first, &flipped));
+    }
+}
@@ -0,0 +1,505 @@
+//! Loading and writing of LUTs in KTX2 and DDS texture containers with prebuilt mip chains.
+//!
+//! Only uncompressed 8-bit RGBA and BGRA textures are read from containers. Block compressed
+//! DDS textures are left to the `image` decoder, which decompresses the base level.
+use crate::image::{Image, MipLevel, PixelFormat, UVDirection, BGRA8, RGBA8};
+use crate::scaling::MipmapSize;
+use image::error::{DecodingError, EncodingError, ImageFormatHint};
+use image::ImageError;
+use librashader_common::Size;
+use librashader_presets::TextureConfig;
+use std::marker::PhantomData;
+use std::path::Path;
+
+const KTX2_IDENTIFIER: [u8; 12] = [
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A,
+];
+const KTX2_HEADER_LEN: usize = 80;
+const KTX2_LEVEL_INDEX_LEN: usize = 24;
+
+const VK_FORMAT_R8G8B8A8_UNORM: u32 = 37;
+const VK_FORMAT_R8G8B8A8_SRGB: u32 = 43;
+const VK_FORMAT_B8G8R8A8_UNORM: u32 = 44;
+const VK_FORMAT_B8G8R8A8_SRGB: u32 = 50;
+
+const DDS_MAGIC: [u8; 4] = *b"DDS ";
+const DDS_HEADER_LEN: usize = 128;
+const DDS_DX10_HEADER_LEN: usize = 20;
+const DDPF_FOURCC: u32 = 0x4;
+const DDPF_RGB: u32 = 0x40;
+const DDSD_MIPMAPCOUNT: u32 = 0x20000;
+const DDSCAPS2_CUBEMAP: u32 = 0x200;
+const DDSCAPS2_VOLUME: u32 = 0x200000;
+const DDS_RESOURCE_MISC_TEXTURECUBE: u32 = 0x4;
+
+const DXGI_FORMAT_R8G8B8A8_UNORM: u32 = 28;
+const DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: u32 = 29;
+const DXGI_FORMAT_B8G8R8A8_UNORM: u32 = 87;
+const DXGI_FORMAT_B8G8R8A8_UNORM_SRGB: u32 = 91;
+
+/// The order of channels of the pixels in a container.
+#[derive(Copy, Clone, Eq, PartialEq)]
+enum Channels {
+    Rgba,
+    Bgra,
+}
+
+/// The mip levels of a texture container, largest first.
+struct Levels<'a> {
+    channels: Channels,
+    size: Size<u32>,
+    levels: Vec<&'a [u8]>,
+}
+
+fn error(format: &str, message: &'static str) -> ImageError {
+    ImageError::Decoding(DecodingError::new(
+        ImageFormatHint::Name(format.to_string()),
+        message,
+    ))
+}
+
+fn read_u32(bytes: &[u8], offset: usize) -> Option<u32> {
+    Some(u32::from_le_bytes(
+        bytes.get(offset..offset + 4)?.try_into().ok()?,
+    ))
+}
+
+fn read_u64(bytes: &[u8], offset: usize) -> Option<u64> {
+    Some(u64::from_le_bytes(
+        bytes.get(offset..offset + 8)?.try_into().ok()?,
+    ))
+}
+
+fn level_len(size: Size<u32>, level: u32) -> usize {
+    let size = size.scale_mipmap(level);
+    size.width as usize * size.height as usize * 4
+}
+
+/// Parse the mip levels of a KTX2 container.
+///
+/// Returns `None` if the container holds a format that is not supported.
+fn parse_ktx2(bytes: &[u8]) -> Result<Option<Levels>, ImageError> {
+    let invalid = || error("KTX2", "invalid KTX2 header");
+    if bytes.len() < KTX2_HEADER_LEN || bytes[..12] != KTX2_IDENTIFIER {
+        return Err(invalid());
+    }
+
+    let header = |index: usize| read_u32(bytes, 12 + index * 4).ok_or_else(invalid);
+    let channels = match header(0)? {
+        VK_FORMAT_R8G8B8A8_UNORM | VK_FORMAT_R8G8B8A8_SRGB => Channels::Rgba,
+        VK_FORMAT_B8G8R8A8_UNORM | VK_FORMAT_B8G8R8A8_SRGB => Channels::Bgra,
+        _ => return Ok(None),
+    };
+
+    let size = Size::new(header(2)?, header(3)?);
+    let depth = header(4)?;
+    let layers = header(5)?;
+    let faces = header(6)?;
+    let level_count = std::cmp::max(header(7)?, 1);
+    let supercompression = header(8)?;
+
+    if depth > 1 || layers > 1 || faces != 1 || supercompression != 0 {
+        return Ok(None);
+    }
+
+    if size.width == 0 || size.height == 0 || level_count > size.calculate_miplevels() {
+        return Err(invalid());
+    }
+
+    let mut levels = Vec::with_capacity(level_count as usize);
+    for level in 0..level_count {
+        let index = KTX2_HEADER_LEN + level as usize * KTX2_LEVEL_INDEX_LEN;
+        let offset = read_u64(bytes, index).ok_or_else(invalid)? as usize;
+        let length = read_u64(bytes, index + 8).ok_or_else(invalid)? as usize;
+
+        if length != level_len(size, level) {
+            return Err(error("KTX2", "unexpected mip level size"));
+        }
+
+        let data = offset
+            .checked_add(length)
+            .and_then(|end| bytes.get(offset..end))
+            .ok_or_else(|| error("KTX2", "mip level is out of bounds"))?;
+        levels.push(data);
+    }
+
+    Ok(Some(Levels {
+        channels,
+        size,
+        levels,
+    }))
+}
+
+/// Parse the mip levels of a DDS container.
+///
+/// Returns `None` if the container holds a format that is not supported.
+fn parse_dds(bytes: &[u8]) -> Result<Option<Levels>, ImageError> {
+    let invalid = || error("DDS", "invalid DDS header");
+    if bytes.len() < DDS_HEADER_LEN || bytes[..4] != DDS_MAGIC {
+        return Err(invalid());
+    }
+
+    let field = |offset: usize| read_u32(bytes, offset).ok_or_else(invalid);
+    let flags = field(8)?;
+    let size = Size::new(field(16)?, field(12)?);
+    let level_count = if flags & DDSD_MIPMAPCOUNT != 0 {
+        std::cmp::max(field(28)?, 1)
+    } else {
+        1
+    };
+
+    // Cube maps and volume textures are not LUTs.
+    if field(112)? & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME) != 0 {
+        return Ok(None);
+    }
+
+    let format_flags = field(80)?;
+    let (channels, data_offset) = if format_flags & DDPF_FOURCC != 0 {
+        if field(84)?.to_le_bytes() != *b"DX10" {
+            return Ok(None);
+        }
+
+        // Texture arrays and cube maps are not LUTs.
+        if field(DDS_HEADER_LEN + 8)? & DDS_RESOURCE_MISC_TEXTURECUBE != 0
+            || field(DDS_HEADER_LEN + 12)? > 1
+        {
+            return Ok(None);
+        }
+
+        let channels = match field(DDS_HEADER_LEN)? {
+            DXGI_FORMAT_R8G8B8A8_UNORM | DXGI_FORMAT_R8G8B8A8_UNORM_SRGB => Channels::Rgba,
+            DXGI_FORMAT_B8G8R8A8_UNORM | DXGI_FORMAT_B8G8R8A8_UNORM_SRGB => Channels::Bgra,
+            _ => return Ok(None),
+        };
+        (channels, DDS_HEADER_LEN + DDS_DX10_HEADER_LEN)
+    } else if format_flags & DDPF_RGB != 0 && field(88)? == 32 {
+        let channels = match (field(92)?, field(96)?, field(100)?) {
+            (0x000000ff, 0x0000ff00, 0x00ff0000) => Channels::Rgba,
+            (0x00ff0000, 0x0000ff00, 0x000000ff) => Channels::Bgra,
+            _ => return Ok(None),
+        };
+        (channels, DDS_HEADER_LEN)
+    } else {
+        return Ok(None);
+    };
+
+    if size.width == 0 || size.height == 0 || level_count > size.calculate_miplevels() {
+        return Err(invalid());
+    }
+
+    let mut levels = Vec::with_capacity(level_count as usize);
+    let mut offset = data_offset;
+    for level in 0..level_count {
+        let length = level_len(size, level);
+        let data = bytes
+            .get(offset..offset + length)
+            .ok_or_else(|| error("DDS", "mip level is out of bounds"))?;
+        levels.push(data);
+        offset += length;
+    }
+
+    Ok(Some(Levels {
+        channels,
+        size,
+        levels,
+    }))
+}
+
+impl<P: PixelFormat> Image<P> {
+    /// Load an image from a KTX2 or DDS container, including any prebuilt mip levels.
+    ///
+    /// Returns `None` if the path is not a container, or if the container holds a format
+    /// that must be decoded with the `image` crate instead.
+    pub(crate) fn load_container(
+        path: &Path,
+        direction: UVDirection,
+    ) -> Result<Option<Self>, ImageError> {
+        let extension = path
+            .extension()
+            .and_then(|ext| ext.to_str())
+            .map(str::to_ascii_lowercase);
+
+        let parse = match extension.as_deref() {
+            Some("ktx2") => parse_ktx2,
+            Some("dds") => parse_dds,
+            _ => return Ok(None),
+        };
+
+        let bytes = std::fs::read(path)?;
+        let Some(container) = parse(&bytes)? else {
+            return Ok(None);
+        };
+
+        let mut levels = container
+            .levels
+            .iter()
+            .enumerate()
+            .map(|(level, data)| {
+                let size = container.size.scale_mipmap(level as u32);
+                let pitch = size.width as usize * 4;
+                let mut bytes = data.to_vec();
+
+                // Containers store pixels from the top left.
+                if container.channels == Channels::Bgra {
+                    BGRA8::convert(&mut bytes);
+                }
+                if direction == UVDirection::BottomLeft {
+                    Self::flip_and_convert(&mut bytes, pitch);
+                } else {
+                    P::convert(&mut bytes);
+                }
+
+                MipLevel { bytes, size, pitch }
+            })
+            .collect::<Vec<_>>();
+
+        let base = levels.remove(0);
+        Ok(Some(Image {
+            bytes: base.bytes,
+            size: base.size,
+            pitch: base.pitch,
+            mipmaps: levels,
+            _pd: PhantomData,
+        }))
+    }
+}
+
+/// Downsample an RGBA8 mip level by half with a box filter.
+fn downsample(source: &MipLevel, size: Size<u32>) -> MipLevel {
+    let (width, height) = (size.width as usize, size.height as usize);
+    let (source_width, source_height) = (source.size.width as usize, source.size.height as usize);
+    let mut bytes = Vec::with_capacity(width * height * 4);
+
+    for y in 0..height {
+        let rows = [
+            std::cmp::min(y * 2, source_height - 1),
+            std::cmp::min(y * 2 + 1, source_height - 1),
+        ];
+        for x in 0..width {
+            let columns = [
+                std::cmp::min(x * 2, source_width - 1),
+                std::cmp::min(x * 2 + 1, source_width - 1),
+            ];
+            for channel in 0..4 {
+                let mut sum = 0u32;
+                for row in rows {
+                    for column in columns {
+                        sum += source.bytes[row * source.pitch + column * 4 + channel] as u32;
+                    }
+                }
+                bytes.push(((sum + 2) / 4) as u8);
+            }
+        }
+    }
+
+    MipLevel {
+        bytes,
+        size,
+        pitch: width * 4,
+    }
+}
+
+/// The data format descriptor of an 8-bit RGBA KTX2 texture in linear color.
+fn ktx2_rgba8_dfd() -> Vec<u8> {
+    const BLOCK_LEN: u16 = 24 + 16 * 4;
+    let mut dfd = Vec::with_capacity(4 + BLOCK_LEN as usize);
+    dfd.extend_from_slice(&(4 + BLOCK_LEN as u32).to_le_bytes());
+    // Khronos basic descriptor block, version 2.
+    dfd.extend_from_slice(&0u32.to_le_bytes());
+    dfd.extend_from_slice(&2u16.to_le_bytes());
+    dfd.extend_from_slice(&BLOCK_LEN.to_le_bytes());
+    // RGBSDA color model, BT.709 primaries, linear transfer, straight alpha.
+    dfd.extend_from_slice(&[1, 1, 1, 0]);
+    // 1x1x1x1 texel blocks of 4 bytes.
+    dfd.extend_from_slice(&[0, 0, 0, 0]);
+    dfd.extend_from_slice(&[4, 0, 0, 0, 0, 0, 0, 0]);
+
+    for (index, channel) in [0u8, 1, 2, 15].into_iter().enumerate() {
+        dfd.extend_from_slice(&(index as u16 * 8).to_le_bytes());
+        dfd.push(7);
+        dfd.push(channel);
+        dfd.extend_from_slice(&[0, 0, 0, 0]);
+        dfd.extend_from_slice(&0u32.to_le_bytes());
+        dfd.extend_from_slice(&255u32.to_le_bytes());
+    }
+    dfd
+}
+
+impl Image<RGBA8> {
+    /// Write the image to a KTX2 container as uncompressed RGBA8.
+    ///
+    /// The image must have been loaded with [`UVDirection::TopLeft`]. If `mipmap` is true
+    /// and the image has no prebuilt mip levels, the full mip chain is generated with a box filter.
+    pub fn write_ktx2(&self, path: impl AsRef<Path>, mipmap: bool) -> Result<(), ImageError> {
+        let base = MipLevel {
+            bytes: self.bytes.clone(),
+            size: self.size,
+            pitch: self.pitch,
+        };
+        let mut levels = vec![base];
+        if mipmap {
+            if self.mipmaps.is_empty() {
+                for level in 1..self.size.calculate_miplevels() {
+                    let next = downsample(&levels[levels.len() - 1], self.size.scale_mipmap(level));
+                    levels.push(next);
+                }
+            } else {
+                levels.extend(self.mipmaps.iter().map(|level| MipLevel {
+                    bytes: level.bytes.clone(),
+                    size: level.size,
+                    pitch: level.pitch,
+                }));
+            }
+        }
+
+        let dfd = ktx2_rgba8_dfd();
+        let dfd_offset = KTX2_HEADER_LEN + levels.len() * KTX2_LEVEL_INDEX_LEN;
+        let mut data_offset = dfd_offset + dfd.len();
+
+        let mut file = Vec::new();
+        file.extend_from_slice(&KTX2_IDENTIFIER);
+        for value in [
+            VK_FORMAT_R8G8B8A8_UNORM,
+            1,
+            self.size.width,
+            self.size.height,
+            0,
+            0,
+            1,
+            levels.len() as u32,
+            0,
+            dfd_offset as u32,
+            dfd.len() as u32,
+            0,
+            0,
+        ] {
+            file.extend_from_slice(&value.to_le_bytes());
+        }
+        // No supercompression global data.
+        file.extend_from_slice(&0u64.to_le_bytes());
+        file.extend_from_slice(&0u64.to_le_bytes());
+
+        // Mip levels are stored smallest first, but indexed largest first.
+        let mut offsets = vec![0; levels.len()];
+        for (level, data) in levels.iter().enumerate().rev() {
+            // Mip levels are aligned to 4 bytes, the size of an RGBA8 texel.
+            data_offset = (data_offset + 3) & !3;
+            offsets[level] = data_offset;
+            data_offset += data.bytes.len();
+        }
+
+        for (level, data) in levels.iter().enumerate() {
+            let length = data.bytes.len() as u64;
+            file.extend_from_slice(&(offsets[level] as u64).to_le_bytes());
+            file.extend_from_slice(&length.to_le_bytes());
+            file.extend_from_slice(&length.to_le_bytes());
+        }
+
+        file.extend_from_slice(&dfd);
+        for (level, data) in levels.iter().enumerate().rev() {
+            file.resize(offsets[level], 0);
+            file.extend_from_slice(&data.bytes);
+        }
+
+        std::fs::write(path, file).map_err(|err| {
+            ImageError::Encoding(EncodingError::new(
+                ImageFormatHint::Name("KTX2".to_string()),
+                err,
+            ))
+        })
+    }
+}
+
+/// Convert the LUTs of a preset into KTX2 containers in the output directory.
+///
+/// LUTs that request mipmaps get a prebuilt mip chain. Returns the texture configs
+/// of the preset, pointing at the converted LUTs.
+pub fn convert_luts_to_ktx2(
+    textures: &[TextureConfig],
+    out_dir: impl AsRef<Path>,
+) -> Result<Vec<TextureConfig>, ImageError> {
+    let out_dir = out_dir.as_ref();
+    std::fs::create_dir_all(out_dir)?;
+
+    textures
+        .iter()
+        .map(|texture| {
+            let image = Image::<RGBA8>::load(&texture.path, UVDirection::TopLeft)?;
+            let path = out_dir.join(format!("{}.ktx2", texture.name));
+            image.write_ktx2(&path, texture.mipmap)?;
+
+            Ok(TextureConfig {
+                path,
+                ..texture.clone()
+            })
+        })
+        .collect()
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    /// A legacy DDS header for an RGBA8 texture without mip levels.
+    fn dds_header(size: Size<u32>, caps2: u32) -> Vec<u8> {
+        let mut header = vec![0u8; DDS_HEADER_LEN];
+        header[..4].copy_from_slice(&DDS_MAGIC);
+        let mut set = |offset: usize, value: u32| {
+            header[offset..offset + 4].copy_from_slice(&value.to_le_bytes());
+        };
+        set(4, 124);
+        set(12, size.height);
+        set(16, size.width);
+        set(76, 32);
+        set(80, DDPF_RGB);
+        set(88, 32);
+        set(92, 0x000000ff);
+        set(96, 0x0000ff00);
+        set(100, 0x00ff0000);
+        set(112, caps2);
+        header
+    }
+
+    #[test]
+    pub fn ktx2_round_trip() {
+        let image = Image::<RGBA8>::load("../test/sf2.png", UVDirection::TopLeft).unwrap();
+        let path = std::env::temp_dir().join(format!(
+            "librashader-ktx2-round-trip-{}.ktx2",
+            std::process::id()
+        ));
+        image.write_ktx2(&path, true).unwrap();
+        let bytes = std::fs::read(&path).unwrap();
+
+        assert_eq!(read_u32(&bytes, 12), Some(VK_FORMAT_R8G8B8A8_UNORM));
+        let container = parse_ktx2(&bytes).unwrap().unwrap();
+        assert!(container.channels == Channels::Rgba);
+        assert_eq!(container.size, image.size);
+        assert_eq!(
+            container.levels.len() as u32,
+            image.size.calculate_miplevels()
+        );
+        assert_eq!(container.levels[0], image.bytes.as_slice());
+
+        let loaded = Image::<RGBA8>::load(&path, UVDirection::TopLeft).unwrap();
+        std::fs::remove_file(&path).unwrap();
+        assert_eq!(loaded.size, image.size);
+        assert_eq!(loaded.level_count(true), image.size.calculate_miplevels());
+        assert_eq!(loaded.bytes, image.bytes);
+    }
+
+    #[test]
+    pub fn dds_rejects_cubemaps_and_volumes() {
+        let size = Size::new(2, 2);
+        let mut dds = dds_header(size, 0);
+        dds.resize(DDS_HEADER_LEN + level_len(size, 0), 0xff);
+        let container = parse_dds(&dds).unwrap().unwrap();
+        assert_eq!(container.size, size);
+        assert_eq!(container.levels.len(), 1);
+
+        for caps2 in [DDSCAPS2_CUBEMAP | 0xfc00, DDSCAPS2_VOLUME] {
+            let mut dds = dds_header(size, caps2);
+            dds.resize(DDS_HEADER_LEN + level_len(size, 0) * 6, 0xff);
+            assert!(parse_dds(&dds).unwrap().is_none());
+        }
+    }
+}
@@ -7,6 +7,7 @@
 //! If you are _writing_ a librashader runtime implementation, using these traits and helpers will
 //! help in maintaining consistent behaviour in binding semantics and image handling.
 #![feature(array_chunks)]
+#![feature(portable_simd)]
 
 /// Scaling helpers.
 pub mod scaling;
@@ -23,6 +24,9 @@ pub mod image;
 /// Ringbuffer helpers
 pub mod ringbuffer;
 
+/// Helpers for binding previous input images as history without copying.
+pub mod history;
+
 /// Generic implementation of semantics binding.
 pub mod binding;
 
@@ -37,3 +41,18 @@ pub mod render_target;
 
 /// Helpers for handling framebuffers.
 pub mod framebuffer;
+
+/// Dependency analysis of pass outputs and lookup textures.
+pub mod usage;
+
+/// Helpers for deferred compilation of shader passes.
+pub mod deferred;
+
+/// Helpers for loading filter chains in the background.
+pub mod loader;
+
+/// Per-pass GPU timing helpers.
+pub mod timing;
+
+/// Adaptive resolution helpers.
+pub mod resolution;
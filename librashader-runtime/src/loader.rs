@@ -0,0 +1,116 @@
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::thread::JoinHandle;
+
+/// The progress of a filter chain that is loading in the background.
+#[derive(Debug, Default, Copy, Clone, PartialEq, Eq)]
+pub struct LoadProgress {
+    /// The number of passes that have been compiled.
+    pub passes_loaded: usize,
+    /// The number of passes that will be compiled, or zero if the preset has not been parsed yet.
+    /// Deferred passes are not counted, since they are compiled when they are first drawn.
+    pub pass_count: usize,
+}
+
+#[derive(Default)]
+struct LoadState {
+    passes_loaded: AtomicUsize,
+    pass_count: AtomicUsize,
+    cancelled: AtomicBool,
+}
+
+/// Reports the progress of loading a filter chain, and whether loading was cancelled.
+///
+/// A tracker that does not belong to a [`BackgroundLoad`] is never cancelled.
+#[derive(Default, Clone)]
+pub struct LoadTracker {
+    state: Arc<LoadState>,
+}
+
+impl LoadTracker {
+    /// Set the number of passes that will be compiled.
+    pub fn set_pass_count(&self, count: usize) {
+        self.state.pass_count.store(count, Ordering::Relaxed);
+    }
+
+    /// Record that a pass has been compiled.
+    pub fn pass_loaded(&self) {
+        self.state.passes_loaded.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Whether loading was cancelled, in which case the work should stop as soon as possible.
+    pub fn is_cancelled(&self) -> bool {
+        self.state.cancelled.load(Ordering::Relaxed)
+    }
+
+    /// The current progress.
+    pub fn progress(&self) -> LoadProgress {
+        LoadProgress {
+            passes_loaded: self.state.passes_loaded.load(Ordering::Relaxed),
+            pass_count: self.state.pass_count.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// The CPU-side work of loading a filter chain, running on a background thread.
+///
+/// Dropping the handle before the work has been waited on cancels it, and blocks until the
+/// work has stopped, so that nothing it uses is released while it is still running.
+/// The work stops the next time it checks for cancellation.
+pub struct BackgroundLoad<T> {
+    tracker: LoadTracker,
+    thread: Option<JoinHandle<T>>,
+}
+
+impl<T: Send + 'static> BackgroundLoad<T> {
+    /// Start loading on a new thread.
+    pub fn spawn(load: impl FnOnce(&LoadTracker) -> T + Send + 'static) -> Self {
+        let tracker = LoadTracker::default();
+        let thread = {
+            let tracker = tracker.clone();
+            std::thread::spawn(move || load(&tracker))
+        };
+
+        Self {
+            tracker,
+            thread: Some(thread),
+        }
+    }
+
+    /// The current progress.
+    pub fn progress(&self) -> LoadProgress {
+        self.tracker.progress()
+    }
+
+    /// Ask the work to stop as soon as possible.
+    pub fn cancel(&self) {
+        self.tracker.state.cancelled.store(true, Ordering::Relaxed);
+    }
+
+    /// Whether the work has finished, so that [`wait`](Self::wait) will not block.
+    pub fn is_finished(&self) -> bool {
+        self.thread.as_ref().map_or(true, JoinHandle::is_finished)
+    }
+
+    /// Wait for the work to finish and return its result.
+    ///
+    /// If the work panicked, the panic is resumed on this thread.
+    pub fn wait(mut self) -> T {
+        // panic safety: the thread is only taken here, which consumes self.
+        let thread = self.thread.take().unwrap();
+        match thread.join() {
+            Ok(result) => result,
+            Err(panic) => std::panic::resume_unwind(panic),
+        }
+    }
+}
+
+impl<T> Drop for BackgroundLoad<T> {
+    fn drop(&mut self) {
+        if let Some(thread) = self.thread.take() {
+            self.tracker.state.cancelled.store(true, Ordering::Relaxed);
+            // The result is discarded, including any panic, since the work was cancelled.
+            let _ = thread.join();
+        }
+    }
+}
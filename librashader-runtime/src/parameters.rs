@@ -1,3 +1,146 @@
+use librashader_preprocess::ShaderSource;
+use librashader_presets::ParameterConfig;
+use rustc_hash::FxHashMap;
+
+/// A handle to a shader parameter of a filter chain.
+///
+/// A handle is only meaningful for the filter chain it was retrieved from, and
+/// allows a parameter to be read or written without looking up its name.
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+#[repr(transparent)]
+pub struct ParameterHandle(u32);
+
+impl ParameterHandle {
+    /// Create a handle from its raw value.
+    pub const fn from_raw(raw: u32) -> Self {
+        ParameterHandle(raw)
+    }
+
+    /// Get the raw value of this handle.
+    pub const fn as_raw(&self) -> u32 {
+        self.0
+    }
+
+    #[inline(always)]
+    fn index(&self) -> usize {
+        self.0 as usize
+    }
+}
+
+/// An iterator over the names and values of the parameters of a filter chain.
+pub type ParameterIter<'a> =
+    std::iter::Zip<std::slice::Iter<'a, String>, std::iter::Copied<std::slice::Iter<'a, f32>>>;
+
+/// The runtime values of the shader parameters of a filter chain.
+///
+/// Parameter names are interned into a dense table when the filter chain is loaded,
+/// so that values can be bound and set by handle without hashing the name.
+#[derive(Debug, Clone, Default)]
+pub struct RuntimeParameters {
+    handles: FxHashMap<String, ParameterHandle>,
+    names: Vec<String>,
+    values: Vec<f32>,
+    generation: u64,
+}
+
+impl RuntimeParameters {
+    /// Create the parameter table for the given shader sources.
+    ///
+    /// Every parameter declared by a pass starts with its initial value, unless it
+    /// is overridden by the preset.
+    pub fn new<'a>(
+        sources: impl IntoIterator<Item = &'a ShaderSource>,
+        preset: &[ParameterConfig],
+    ) -> Self {
+        let mut parameters = RuntimeParameters::default();
+
+        for source in sources {
+            let mut declared: Vec<_> = source.parameters.values().collect();
+            declared.sort_by(|a, b| a.id.cmp(&b.id));
+            for parameter in declared {
+                parameters.insert(&parameter.id, parameter.initial);
+            }
+        }
+
+        for parameter in preset {
+            let handle = parameters.insert(&parameter.name, parameter.value);
+            parameters.values[handle.index()] = parameter.value;
+        }
+
+        parameters
+    }
+
+    fn insert(&mut self, name: &str, value: f32) -> ParameterHandle {
+        if let Some(handle) = self.handles.get(name) {
+            return *handle;
+        }
+
+        let handle = ParameterHandle(self.values.len() as u32);
+        self.handles.insert(name.to_string(), handle);
+        self.names.push(name.to_string());
+        self.values.push(value);
+        handle
+    }
+
+    /// The number of parameters in the filter chain.
+    pub fn len(&self) -> usize {
+        self.values.len()
+    }
+
+    /// Whether the filter chain has no parameters.
+    pub fn is_empty(&self) -> bool {
+        self.values.is_empty()
+    }
+
+    /// Get the handle of the parameter with the given name.
+    pub fn handle(&self, name: &str) -> Option<ParameterHandle> {
+        self.handles.get(name).copied()
+    }
+
+    /// Get the value of the parameter with the given name.
+    pub fn get(&self, name: &str) -> Option<f32> {
+        self.handle(name)
+            .and_then(|handle| self.get_by_handle(handle))
+    }
+
+    /// Set the value of the parameter with the given name.
+    ///
+    /// Returns `None` if the parameter did not exist, or the old value if successful.
+    pub fn set(&mut self, name: &str, new_value: f32) -> Option<f32> {
+        let handle = self.handle(name)?;
+        self.set_by_handle(handle, new_value)
+    }
+
+    /// Get the value of the parameter with the given handle.
+    #[inline(always)]
+    pub fn get_by_handle(&self, handle: ParameterHandle) -> Option<f32> {
+        self.values.get(handle.index()).copied()
+    }
+
+    /// Set the value of the parameter with the given handle.
+    ///
+    /// Returns `None` if the handle is not valid, or the old value if successful.
+    #[inline(always)]
+    pub fn set_by_handle(&mut self, handle: ParameterHandle, new_value: f32) -> Option<f32> {
+        let value = self.values.get_mut(handle.index())?;
+        if *value != new_value {
+            self.generation = self.generation.wrapping_add(1);
+        }
+        Some(std::mem::replace(value, new_value))
+    }
+
+    /// A counter that changes whenever the value of any parameter changes.
+    #[inline(always)]
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// Iterate over the names and values of all parameters.
+    pub fn iter(&self) -> ParameterIter<'_> {
+        self.names.iter().zip(self.values.iter().copied())
+    }
+}
+
 /// Trait for filter chains that allow runtime reflection of shader parameters.
 pub trait FilterChainParameters {
     /// Gets the number of shader passes enabled at runtime.
@@ -7,7 +150,7 @@ pub trait FilterChainParameters {
     fn set_enabled_pass_count(&mut self, count: usize);
 
     /// Enumerates the active parameters as well as their values in the current filter chain.
-    fn enumerate_parameters(&self) -> std::collections::hash_map::Iter<String, f32>;
+    fn enumerate_parameters(&self) -> ParameterIter<'_>;
 
     /// Get the value of the given parameter if present.
     fn get_parameter(&self, parameter: &str) -> Option<f32>;
@@ -16,4 +159,17 @@ pub trait FilterChainParameters {
     ///
     /// Returns `None` if the parameter did not exist, or the old value if successful.
     fn set_parameter(&mut self, parameter: &str, new_value: f32) -> Option<f32>;
+
+    /// Get a handle to the given parameter if present.
+    ///
+    /// The handle can be used to get or set the parameter without looking up its name.
+    fn get_parameter_handle(&self, parameter: &str) -> Option<ParameterHandle>;
+
+    /// Get the value of the parameter with the given handle.
+    fn get_parameter_by_handle(&self, handle: ParameterHandle) -> Option<f32>;
+
+    /// Set the value of the parameter with the given handle.
+    ///
+    /// Returns `None` if the handle is not valid, or the old value if successful.
+    fn set_parameter_by_handle(&mut self, handle: ParameterHandle, new_value: f32) -> Option<f32>;
 }
@@ -0,0 +1,284 @@
+use crate::timing::PassTiming;
+use librashader_common::Size;
+use std::time::Duration;
+
+/// Chooses the scale of the viewport that intermediate passes are sized against, to keep the
+/// GPU time of a frame within a budget.
+///
+/// Only passes with viewport scaling are affected, and the final pass is always drawn to the
+/// full viewport. The scale is lowered once the frame time has been over budget for
+/// [`LOWER_DELAY`](Self::LOWER_DELAY) readings in a row, and raised by one step once it has been
+/// well under budget for [`RAISE_DELAY`](Self::RAISE_DELAY) readings in a row, so that it does
+/// not flicker between two sizes.
+#[derive(Debug, Clone)]
+pub struct AdaptiveResolution {
+    budget: Option<Duration>,
+    scale: f32,
+    override_scale: Option<f32>,
+    over_budget: u32,
+    under_budget: u32,
+}
+
+impl Default for AdaptiveResolution {
+    fn default() -> Self {
+        Self {
+            budget: None,
+            scale: 1.0,
+            override_scale: None,
+            over_budget: 0,
+            under_budget: 0,
+        }
+    }
+}
+
+impl AdaptiveResolution {
+    /// The lowest scale that is chosen.
+    pub const MIN_SCALE: f32 = 0.25;
+
+    /// The scale is always a multiple of this step, so that framebuffers are not resized for
+    /// every small change in frame time.
+    pub const STEP: f32 = 0.05;
+
+    /// The number of readings over budget in a row before the scale is lowered.
+    pub const LOWER_DELAY: u32 = 3;
+
+    /// The number of readings under [`HEADROOM`](Self::HEADROOM) in a row before the scale
+    /// is raised.
+    pub const RAISE_DELAY: u32 = 30;
+
+    /// The fraction of the budget a frame has to stay under for the scale to be raised.
+    pub const HEADROOM: f32 = 0.8;
+
+    /// The GPU time budget of a frame, if any.
+    pub fn budget(&self) -> Option<Duration> {
+        self.budget
+    }
+
+    /// Set the GPU time budget of a frame.
+    ///
+    /// Without a budget, the scale returns to 1 unless it is overridden.
+    pub fn set_budget(&mut self, budget: Option<Duration>) {
+        self.budget = budget;
+        self.over_budget = 0;
+        self.under_budget = 0;
+        if budget.is_none() {
+            self.scale = 1.0;
+        }
+    }
+
+    /// The current scale of the viewport.
+    pub fn scale(&self) -> f32 {
+        self.override_scale.unwrap_or(self.scale)
+    }
+
+    /// Override the chosen scale, or go back to choosing it from the budget with `None`.
+    ///
+    /// The scale is clamped between [`MIN_SCALE`](Self::MIN_SCALE) and 1.
+    pub fn set_override(&mut self, scale: Option<f32>) {
+        self.override_scale = scale.map(|scale| scale.clamp(Self::MIN_SCALE, 1.0));
+    }
+
+    /// Update the scale with the timings of a frame that were just read back.
+    pub fn update(&mut self, timings: &[PassTiming]) {
+        let Some(budget) = self.budget else {
+            return;
+        };
+
+        if timings.is_empty() {
+            return;
+        }
+
+        let total: Duration = timings.iter().map(|timing| timing.gpu_time).sum();
+        if total > budget {
+            self.under_budget = 0;
+            self.over_budget += 1;
+            if self.over_budget < Self::LOWER_DELAY {
+                return;
+            }
+
+            // the cost of most passes grows with the area they draw, so the scale of each
+            // dimension goes with the square root of the time.
+            let ratio = budget.as_secs_f32() / total.as_secs_f32();
+            let target = (self.scale * ratio.sqrt() / Self::STEP).floor() * Self::STEP;
+            self.scale = Self::snap(target.min(self.scale - Self::STEP)).max(Self::MIN_SCALE);
+            self.over_budget = 0;
+        } else if total.as_secs_f32() < budget.as_secs_f32() * Self::HEADROOM {
+            self.over_budget = 0;
+            self.under_budget += 1;
+            if self.under_budget < Self::RAISE_DELAY {
+                return;
+            }
+
+            self.scale = Self::snap(self.scale + Self::STEP).min(1.0);
+            self.under_budget = 0;
+        } else {
+            self.over_budget = 0;
+            self.under_budget = 0;
+        }
+    }
+
+    /// Round a scale to the nearest step, so that steps do not accumulate rounding errors.
+    fn snap(scale: f32) -> f32 {
+        (scale / Self::STEP).round() * Self::STEP
+    }
+
+    /// Scale the size of the viewport.
+    pub fn scale_viewport(&self, viewport: Size<u32>) -> Size<u32> {
+        let scale = self.scale();
+        if scale >= 1.0 {
+            return viewport;
+        }
+
+        Size::new(
+            std::cmp::max((viewport.width as f32 * scale).round() as u32, 1),
+            std::cmp::max((viewport.height as f32 * scale).round() as u32, 1),
+        )
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    fn frame(millis: u64) -> [PassTiming; 2] {
+        // the time of a frame is split across its passes.
+        [
+            PassTiming {
+                index: 0,
+                alias: None,
+                gpu_time: Duration::from_millis(millis / 2),
+            },
+            PassTiming {
+                index: 1,
+                alias: None,
+                gpu_time: Duration::from_millis(millis - millis / 2),
+            },
+        ]
+    }
+
+    fn adaptive(budget: u64) -> AdaptiveResolution {
+        let mut adaptive = AdaptiveResolution::default();
+        adaptive.set_budget(Some(Duration::from_millis(budget)));
+        adaptive
+    }
+
+    fn assert_scale(adaptive: &AdaptiveResolution, scale: f32) {
+        assert!(
+            (adaptive.scale() - scale).abs() < 1e-4,
+            "{} != {scale}",
+            adaptive.scale()
+        );
+    }
+
+    fn assert_snapped(adaptive: &AdaptiveResolution) {
+        let steps = adaptive.scale() / AdaptiveResolution::STEP;
+        assert!((steps - steps.round()).abs() < 1e-4, "{}", adaptive.scale());
+    }
+
+    #[test]
+    pub fn lowers_after_delay() {
+        let mut adaptive = adaptive(10);
+        for _ in 1..AdaptiveResolution::LOWER_DELAY {
+            adaptive.update(&frame(20));
+            assert_scale(&adaptive, 1.0);
+        }
+
+        // twice the budget is about 1/sqrt(2) of the size, rounded down to a step.
+        adaptive.update(&frame(20));
+        assert_scale(&adaptive, 0.7);
+        assert_snapped(&adaptive);
+    }
+
+    #[test]
+    pub fn frames_within_budget_reset_the_delay() {
+        let mut adaptive = adaptive(10);
+        for _ in 0..4 {
+            for _ in 1..AdaptiveResolution::LOWER_DELAY {
+                adaptive.update(&frame(20));
+            }
+            adaptive.update(&frame(9));
+        }
+        assert_scale(&adaptive, 1.0);
+    }
+
+    #[test]
+    pub fn raises_one_step_after_delay() {
+        let mut adaptive = adaptive(10);
+        for _ in 0..AdaptiveResolution::LOWER_DELAY {
+            adaptive.update(&frame(20));
+        }
+        assert_scale(&adaptive, 0.7);
+
+        for _ in 1..AdaptiveResolution::RAISE_DELAY {
+            adaptive.update(&frame(5));
+            assert_scale(&adaptive, 0.7);
+        }
+
+        adaptive.update(&frame(5));
+        assert_scale(&adaptive, 0.75);
+        assert_snapped(&adaptive);
+
+        // the scale never goes over 1.
+        for _ in 0..AdaptiveResolution::RAISE_DELAY * 10 {
+            adaptive.update(&frame(5));
+            assert_snapped(&adaptive);
+        }
+        assert_scale(&adaptive, 1.0);
+    }
+
+    #[test]
+    pub fn clamps_to_min_scale() {
+        let mut adaptive = adaptive(10);
+        for _ in 0..AdaptiveResolution::LOWER_DELAY * 4 {
+            adaptive.update(&frame(1000));
+        }
+        assert_scale(&adaptive, AdaptiveResolution::MIN_SCALE);
+        assert_snapped(&adaptive);
+    }
+
+    #[test]
+    pub fn lowers_at_least_one_step() {
+        let mut adaptive = adaptive(10);
+        for _ in 0..AdaptiveResolution::LOWER_DELAY {
+            adaptive.update(&frame(11));
+        }
+        assert_scale(&adaptive, 1.0 - AdaptiveResolution::STEP);
+        assert_snapped(&adaptive);
+    }
+
+    #[test]
+    pub fn override_is_clamped() {
+        let mut adaptive = adaptive(10);
+        for _ in 0..AdaptiveResolution::LOWER_DELAY {
+            adaptive.update(&frame(20));
+        }
+
+        adaptive.set_override(Some(0.1));
+        assert_scale(&adaptive, AdaptiveResolution::MIN_SCALE);
+        adaptive.set_override(Some(2.0));
+        assert_scale(&adaptive, 1.0);
+        adaptive.set_override(Some(0.5));
+        assert_scale(&adaptive, 0.5);
+
+        adaptive.set_override(None);
+        assert_scale(&adaptive, 0.7);
+    }
+
+    #[test]
+    pub fn removing_budget_resets_scale() {
+        let mut adaptive = adaptive(10);
+        for _ in 0..AdaptiveResolution::LOWER_DELAY {
+            adaptive.update(&frame(20));
+        }
+        assert_scale(&adaptive, 0.7);
+
+        adaptive.set_budget(None);
+        assert_eq!(adaptive.scale(), 1.0);
+
+        // without a budget, timings are ignored.
+        for _ in 0..AdaptiveResolution::LOWER_DELAY {
+            adaptive.update(&frame(20));
+        }
+        assert_eq!(adaptive.scale(), 1.0);
+    }
+}
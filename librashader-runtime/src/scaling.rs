@@ -1,5 +1,6 @@
 use crate::filter_pass::FilterPassMeta;
 use crate::scaling;
+use crate::usage::ResourceUsage;
 use librashader_common::{ImageFormat, Size};
 use librashader_presets::{Scale2D, ScaleFactor, ScaleType, Scaling};
 use num_traits::AsPrimitive;
@@ -57,6 +58,73 @@ impl MipmapSize<u32> for Size<u32> {
     }
 }
 
+/// Hysteresis for the size of the memory that backs a framebuffer.
+///
+/// The framebuffer itself always has the size the pass asks for, but the memory behind it is
+/// rounded up to a bucket so that a framebuffer that is resized a little at a time can be
+/// recreated in place. Memory that is larger than needed is only shrunk once the framebuffer
+/// has been in a smaller bucket for [`SHRINK_DELAY`](Self::SHRINK_DELAY) frames in a row.
+#[derive(Debug, Clone, Copy)]
+pub struct ResizeHysteresis {
+    capacity: Size<u32>,
+    oversized_frames: u32,
+}
+
+impl ResizeHysteresis {
+    /// The number of frames memory is kept before it is shrunk.
+    pub const SHRINK_DELAY: u32 = 60;
+
+    /// Create the hysteresis for a framebuffer that is first allocated with the given size.
+    pub fn new(size: Size<u32>) -> Self {
+        Self {
+            capacity: Self::bucket(size),
+            oversized_frames: 0,
+        }
+    }
+
+    /// Round a size up to its bucket.
+    ///
+    /// There are four buckets for every power of two, so each dimension is rounded up
+    /// by at most a quarter.
+    pub fn bucket(size: Size<u32>) -> Size<u32> {
+        fn round(extent: u32) -> u32 {
+            let step = std::cmp::max(extent.next_power_of_two() / 8, 16);
+            extent.div_ceil(step) * step
+        }
+
+        Size::new(round(size.width), round(size.height))
+    }
+
+    /// The size that the backing memory is allocated for.
+    pub fn capacity(&self) -> Size<u32> {
+        self.capacity
+    }
+
+    /// Update the hysteresis with the size of the framebuffer for this frame.
+    ///
+    /// Returns the new capacity if the backing memory needs to be reallocated.
+    pub fn resize(&mut self, size: Size<u32>) -> Option<Size<u32>> {
+        let bucket = Self::bucket(size);
+        if size.width > self.capacity.width || size.height > self.capacity.height {
+            *self = Self::new(size);
+            return Some(bucket);
+        }
+
+        if bucket == self.capacity {
+            self.oversized_frames = 0;
+            return None;
+        }
+
+        self.oversized_frames += 1;
+        if self.oversized_frames < Self::SHRINK_DELAY {
+            return None;
+        }
+
+        *self = Self::new(size);
+        Some(bucket)
+    }
+}
+
 fn scale<T>(scaling: Scale2D, source: Size<T>, viewport: Size<T>) -> Size<T>
 where
     T: Mul<ScaleFactor, Output = f32> + Copy + 'static,
@@ -121,6 +189,7 @@ pub trait ScaleFramebuffer<T = ()> {
         output: &mut [Self],
         feedback: &mut [Self],
         passes: &[P],
+        usage: &ResourceUsage,
         callback: Option<&mut dyn FnMut(usize, &P, &Self, &Self) -> Result<(), Self::Error>>,
     ) -> Result<(), Self::Error>
     where
@@ -134,6 +203,7 @@ pub trait ScaleFramebuffer<T = ()> {
             output,
             feedback,
             passes,
+            usage,
             &Self::Context::default(),
             callback,
         )
@@ -147,6 +217,7 @@ pub trait ScaleFramebuffer<T = ()> {
         output: &mut [Self],
         feedback: &mut [Self],
         passes: &[P],
+        usage: &ResourceUsage,
         context: &Self::Context,
         callback: Option<&mut dyn FnMut(usize, &P, &Self, &Self) -> Result<(), Self::Error>>,
     ) -> Result<(), Self::Error>
@@ -160,6 +231,7 @@ pub trait ScaleFramebuffer<T = ()> {
             output,
             feedback,
             passes,
+            usage,
             context,
             callback,
         )
@@ -168,6 +240,12 @@ pub trait ScaleFramebuffer<T = ()> {
 
 /// Scale framebuffers according to the pass configs, source and viewport size
 /// passing a context into the scale function and a callback for each framebuffer rescale.
+///
+/// Framebuffers that are not read by any pass are left untouched. The callback is not
+/// invoked for unused outputs, and is passed a placeholder for unused feedback framebuffers.
+///
+/// Passes whose output is aliased with an earlier pass are passed the framebuffer of
+/// that pass, which is only scaled by the pass that owns it.
 #[inline(always)]
 fn scale_framebuffers_with_context_callback<T, F, E, C, P>(
     source_size: Size<u32>,
@@ -175,6 +253,7 @@ fn scale_framebuffers_with_context_callback<T, F, E, C, P>(
     output: &mut [F],
     feedback: &mut [F],
     passes: &[P],
+    usage: &ResourceUsage,
     context: &C,
     mut callback: Option<&mut dyn FnMut(usize, &P, &F, &F) -> Result<(), E>>,
 ) -> Result<(), E>
@@ -190,6 +269,23 @@ where
             .peek()
             .map_or(false, |(_, p)| p.config().mipmap_input);
 
+        if !usage.is_output_used(index) {
+            // Nothing reads this framebuffer, but later passes may still be scaled
+            // relative to its size.
+            target_size = target_size.scale_viewport(pass.config().scaling.clone(), viewport_size);
+            continue;
+        }
+
+        let slot = usage.output_slot(index);
+        if slot != index {
+            // The framebuffer is already scaled to the same size by the pass that owns it.
+            target_size = target_size.scale_viewport(pass.config().scaling.clone(), viewport_size);
+            if let Some(callback) = callback.as_mut() {
+                callback(index, pass, &output[slot], &feedback[index])?;
+            }
+            continue;
+        }
+
         let next_size = output[index].scale(
             pass.config().scaling.clone(),
             pass.get_format(),
@@ -199,14 +295,17 @@ where
             context,
         )?;
 
-        feedback[index].scale(
-            pass.config().scaling.clone(),
-            pass.get_format(),
-            &viewport_size,
-            &target_size,
-            should_mipmap,
-            context,
-        )?;
+        // Feedback framebuffers that are never sampled can stay as placeholders.
+        if usage.is_feedback_used(index) {
+            feedback[index].scale(
+                pass.config().scaling.clone(),
+                pass.get_format(),
+                &viewport_size,
+                &target_size,
+                should_mipmap,
+                context,
+            )?;
+        }
 
         target_size = next_size;
 
@@ -217,3 +316,48 @@ where
 
     Ok(())
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    #[test]
+    pub fn hysteresis_grows_immediately() {
+        let mut hysteresis = ResizeHysteresis::new(Size::new(1000, 1000));
+        assert_eq!(hysteresis.capacity(), Size::new(1024, 1024));
+
+        let grown = hysteresis.resize(Size::new(1100, 1000));
+        assert_eq!(grown, Some(Size::new(1280, 1024)));
+        assert_eq!(hysteresis.capacity(), Size::new(1280, 1024));
+    }
+
+    #[test]
+    pub fn hysteresis_keeps_sizes_in_the_bucket() {
+        let mut hysteresis = ResizeHysteresis::new(Size::new(1000, 1000));
+        for _ in 0..ResizeHysteresis::SHRINK_DELAY * 2 {
+            assert_eq!(hysteresis.resize(Size::new(950, 1010)), None);
+            assert_eq!(hysteresis.resize(Size::new(1024, 900)), None);
+        }
+        assert_eq!(hysteresis.capacity(), Size::new(1024, 1024));
+    }
+
+    #[test]
+    pub fn hysteresis_shrinks_after_a_delay() {
+        let small = Size::new(500, 500);
+        let mut hysteresis = ResizeHysteresis::new(Size::new(1000, 1000));
+        for _ in 1..ResizeHysteresis::SHRINK_DELAY {
+            assert_eq!(hysteresis.resize(small), None);
+        }
+
+        // Going back to the bucket restarts the delay.
+        assert_eq!(hysteresis.resize(Size::new(1000, 1000)), None);
+        for _ in 1..ResizeHysteresis::SHRINK_DELAY {
+            assert_eq!(hysteresis.resize(small), None);
+        }
+        assert_eq!(hysteresis.capacity(), Size::new(1024, 1024));
+
+        assert_eq!(hysteresis.resize(small), Some(Size::new(512, 512)));
+        assert_eq!(hysteresis.capacity(), Size::new(512, 512));
+        assert_eq!(hysteresis.resize(small), None);
+    }
+}
@@ -0,0 +1,101 @@
+use std::sync::Arc;
+use std::time::Duration;
+
+/// The GPU time spent drawing a shader pass.
+#[derive(Debug, Clone)]
+pub struct PassTiming {
+    /// The index of the pass in the preset.
+    pub index: usize,
+    /// The alias of the pass, if it has one.
+    pub alias: Option<Arc<str>>,
+    /// The GPU time spent drawing the pass.
+    pub gpu_time: Duration,
+}
+
+/// Bookkeeping for GPU timer queries that are read back a few frames after they are recorded,
+/// so that reading them never waits on the GPU.
+///
+/// Each frame records its passes into one of a ring of query slots. A slot is read back when
+/// it is next used, and the results are skipped if the GPU has not finished with them yet.
+pub struct PassTimer {
+    recorded: Box<[Vec<usize>]>,
+    slot: usize,
+    aliases: Vec<Option<Arc<str>>>,
+    timings: Vec<PassTiming>,
+    updated: bool,
+}
+
+impl PassTimer {
+    /// Create a timer with the given number of query slots.
+    pub fn new(slots: usize) -> Self {
+        let mut recorded = Vec::new();
+        recorded.resize_with(std::cmp::max(slots, 1), Vec::new);
+
+        Self {
+            recorded: recorded.into_boxed_slice(),
+            slot: 0,
+            aliases: Vec::new(),
+            timings: Vec::new(),
+            updated: false,
+        }
+    }
+
+    /// The number of query slots.
+    pub fn slots(&self) -> usize {
+        self.recorded.len()
+    }
+
+    /// Move on to the next query slot, returning it.
+    ///
+    /// If passes were recorded into the slot, `read` is called with the slot and the number of
+    /// passes, and returns the GPU time of each pass in the order they were recorded, or `None`
+    /// if the results are not available yet. `alias` returns the alias of a pass by its index.
+    pub fn begin_frame<'a, E>(
+        &mut self,
+        read: impl FnOnce(usize, usize) -> Result<Option<Vec<Duration>>, E>,
+        alias: impl Fn(usize) -> Option<&'a str>,
+    ) -> Result<usize, E> {
+        self.slot = (self.slot + 1) % self.recorded.len();
+        self.updated = false;
+        let recorded = &mut self.recorded[self.slot];
+
+        if !recorded.is_empty() {
+            if let Some(durations) = read(self.slot, recorded.len())? {
+                self.timings.clear();
+                for (&index, gpu_time) in recorded.iter().zip(durations) {
+                    while self.aliases.len() <= index {
+                        let alias = alias(self.aliases.len()).map(Arc::from);
+                        self.aliases.push(alias);
+                    }
+
+                    self.timings.push(PassTiming {
+                        index,
+                        alias: self.aliases[index].clone(),
+                        gpu_time,
+                    });
+                }
+                self.updated = true;
+            }
+        }
+
+        recorded.clear();
+        Ok(self.slot)
+    }
+
+    /// Record a pass into the current slot, returning its position in the slot.
+    pub fn record(&mut self, index: usize) -> usize {
+        let recorded = &mut self.recorded[self.slot];
+        recorded.push(index);
+        recorded.len() - 1
+    }
+
+    /// The most recent timings that were read back.
+    pub fn timings(&self) -> &[PassTiming] {
+        &self.timings
+    }
+
+    /// Whether the last call to [`begin_frame`](Self::begin_frame) read back new timings.
+    pub fn updated(&self) -> bool {
+        self.updated
+    }
+}
@@ -1,6 +1,6 @@
 use librashader_reflect::reflect::semantics::{MemberOffset, UniformMemberBlock};
 use std::marker::PhantomData;
-use std::ops::{Deref, DerefMut};
+use std::ops::{Deref, DerefMut, Range};
 
 /// A scalar value that is valid as a uniform member
 pub trait UniformScalar: Copy + bytemuck::Pod {}
@@ -35,6 +35,61 @@ pub trait UniformStorageAccess {
     /// Get a slice to the backing Push Constant buffer storage.
     /// This pointer must be valid for the lifetime of the implementing struct.
     fn push_slice(&self) -> &[u8];
+
+    /// Get the byte range of the UBO storage that changed since it was last taken,
+    /// and mark the UBO storage as clean.
+    ///
+    /// Returns `None` if nothing in the UBO storage has changed.
+    fn take_ubo_dirty(&mut self) -> Option<Range<usize>>;
+
+    /// Get the byte range of the Push Constant buffer storage that changed since it was last taken,
+    /// and mark the Push Constant buffer storage as clean.
+    ///
+    /// Returns `None` if nothing in the Push Constant buffer storage has changed.
+    fn take_push_dirty(&mut self) -> Option<Range<usize>>;
+}
+
+/// A byte range of a uniform buffer that has been written to.
+#[derive(Debug, Default, Copy, Clone, PartialEq, Eq)]
+pub struct DirtyRange {
+    start: usize,
+    end: usize,
+}
+
+impl DirtyRange {
+    /// A range that covers the first `len` bytes of a buffer.
+    pub fn full(len: usize) -> Self {
+        DirtyRange { start: 0, end: len }
+    }
+
+    /// Whether no bytes are covered by this range.
+    #[inline(always)]
+    pub fn is_clean(&self) -> bool {
+        self.start >= self.end
+    }
+
+    /// Extend the range to cover the given bytes.
+    #[inline(always)]
+    pub fn mark(&mut self, range: Range<usize>) {
+        if range.is_empty() {
+            return;
+        }
+
+        if self.is_clean() {
+            self.start = range.start;
+            self.end = range.end;
+        } else {
+            self.start = std::cmp::min(self.start, range.start);
+            self.end = std::cmp::max(self.end, range.end);
+        }
+    }
+
+    /// Get the covered bytes, leaving the range clean.
+    #[inline(always)]
+    pub fn take(&mut self) -> Option<Range<usize>> {
+        let range = std::mem::take(self);
+        (!range.is_clean()).then_some(range.start..range.end)
+    }
 }
 
 impl<T, H, U, P> UniformStorageAccess for UniformStorage<T, H, U, P>
@@ -57,6 +112,14 @@ where
     fn push_slice(&self) -> &[u8] {
         &self.push
     }
+
+    fn take_ubo_dirty(&mut self) -> Option<Range<usize>> {
+        self.ubo_dirty.take()
+    }
+
+    fn take_push_dirty(&mut self) -> Option<Range<usize>> {
+        self.push_dirty.take()
+    }
 }
 
 /// A uniform binder that always returns `None`, and does not do any binding of uniforms.
@@ -69,6 +132,14 @@ impl<T> BindUniform<Option<()>, T> for NoUniformBinder {
 }
 
 /// A helper to bind uniform variables to UBO or Push Constant Buffers.
+///
+/// Values are only written to the backing storage if they differ from what is already
+/// there, and the range of bytes that changed is tracked for each buffer so that
+/// runtimes can skip uploading buffers that have not changed.
+///
+/// Backing storage provided by the runtime may be mapped GPU memory, which is slow or
+/// uncached to read from. Such storage is compared against a copy of its contents kept in
+/// host memory instead of being read back.
 pub struct UniformStorage<H = NoUniformBinder, C = Option<()>, U = Box<[u8]>, P = Box<[u8]>>
 where
     U: Deref<Target = [u8]> + DerefMut,
@@ -76,6 +147,10 @@ where
 {
     ubo: U,
     push: P,
+    ubo_dirty: DirtyRange,
+    push_dirty: DirtyRange,
+    ubo_shadow: Option<Box<[u8]>>,
+    push_shadow: Option<Box<[u8]>>,
     _h: PhantomData<H>,
     _c: PhantomData<C>,
 }
@@ -95,10 +170,39 @@ where
         &self.push
     }
 
-    pub(crate) fn buffer(&mut self, ty: UniformMemberBlock) -> &mut [u8] {
-        match ty {
-            UniformMemberBlock::Ubo => self.ubo.deref_mut(),
-            UniformMemberBlock::PushConstant => self.push.deref_mut(),
+    /// Write the bytes to the given offset of a buffer, marking them as dirty if they changed.
+    #[inline(always)]
+    pub(crate) fn write_bytes(&mut self, ty: UniformMemberBlock, offset: usize, bytes: &[u8]) {
+        let (buffer, shadow, dirty) = match ty {
+            UniformMemberBlock::Ubo => (
+                self.ubo.deref_mut(),
+                self.ubo_shadow.as_deref_mut(),
+                &mut self.ubo_dirty,
+            ),
+            UniformMemberBlock::PushConstant => (
+                self.push.deref_mut(),
+                self.push_shadow.as_deref_mut(),
+                &mut self.push_dirty,
+            ),
+        };
+
+        let range = offset..offset + bytes.len();
+        match shadow {
+            Some(shadow) => {
+                let shadow = &mut shadow[range.clone()];
+                if shadow != bytes {
+                    shadow.copy_from_slice(bytes);
+                    buffer[range.clone()].copy_from_slice(bytes);
+                    dirty.mark(range);
+                }
+            }
+            None => {
+                let target = &mut buffer[range.clone()];
+                if target != bytes {
+                    target.copy_from_slice(bytes);
+                    dirty.mark(range);
+                }
+            }
         }
     }
 }
@@ -109,12 +213,6 @@ where
     U: Deref<Target = [u8]> + DerefMut,
     P: Deref<Target = [u8]> + DerefMut,
 {
-    #[inline(always)]
-    fn write_scalar_inner<T: UniformScalar>(buffer: &mut [u8], value: T) {
-        let buffer = bytemuck::cast_slice_mut(buffer);
-        buffer[0] = value;
-    }
-
     /// Bind a scalar to the given offset.
     #[inline(always)]
     pub fn bind_scalar<T: UniformScalar>(&mut self, offset: MemberOffset, value: T, ctx: C)
@@ -127,15 +225,20 @@ where
             }
 
             if let Some(offset) = offset.offset(ty) {
-                let buffer = self.buffer(ty);
-                Self::write_scalar_inner(&mut buffer[offset..][..std::mem::size_of::<T>()], value)
+                self.write_bytes(ty, offset, bytemuck::bytes_of(&value))
             }
         }
     }
 
-    /// Create a new `UniformStorage` with the given backing storage
+    /// Create a new `UniformStorage` with the given backing storage.
+    ///
+    /// The storage is read once here, and never again afterwards.
     pub fn new_with_storage(ubo: U, push: P) -> UniformStorage<H, C, U, P> {
         UniformStorage {
+            ubo_dirty: DirtyRange::full(ubo.len()),
+            push_dirty: DirtyRange::full(push.len()),
+            ubo_shadow: Some(Box::from(&*ubo)),
+            push_shadow: Some(Box::from(&*push)),
             ubo,
             push,
             _h: Default::default(),
@@ -149,12 +252,18 @@ where
     C: Copy,
     U: Deref<Target = [u8]> + DerefMut,
 {
-    /// Create a new `UniformStorage` with the given backing storage
+    /// Create a new `UniformStorage` with the given backing storage.
+    ///
+    /// The storage is read once here, and never again afterwards.
     pub fn new_with_ubo_storage(
         storage: U,
         push_size: usize,
     ) -> UniformStorage<H, C, U, Box<[u8]>> {
         UniformStorage {
+            ubo_dirty: DirtyRange::full(storage.len()),
+            push_dirty: DirtyRange::full(push_size),
+            ubo_shadow: Some(Box::from(&*storage)),
+            push_shadow: None,
             ubo: storage,
             push: vec![0u8; push_size].into_boxed_slice(),
             _h: Default::default(),
@@ -169,6 +278,10 @@ impl<H, C> UniformStorage<H, C, Box<[u8]>, Box<[u8]>> {
         UniformStorage {
             ubo: vec![0u8; ubo_size].into_boxed_slice(),
             push: vec![0u8; push_size].into_boxed_slice(),
+            ubo_dirty: DirtyRange::full(ubo_size),
+            push_dirty: DirtyRange::full(push_size),
+            ubo_shadow: None,
+            push_shadow: None,
             _h: Default::default(),
             _c: Default::default(),
         }
@@ -182,11 +295,6 @@ where
     P: Deref<Target = [u8]> + DerefMut,
     H: for<'a> BindUniform<C, &'a [f32; 4]>,
 {
-    #[inline(always)]
-    fn write_vec4_inner(buffer: &mut [u8], vec4: &[f32; 4]) {
-        let vec4 = bytemuck::cast_slice(vec4);
-        buffer.copy_from_slice(vec4);
-    }
     /// Bind a `vec4` to the given offset.
     #[inline(always)]
     pub fn bind_vec4(&mut self, offset: MemberOffset, value: impl Into<[f32; 4]>, ctx: C) {
@@ -197,11 +305,7 @@ where
                 continue;
             }
             if let Some(offset) = offset.offset(ty) {
-                let buffer = self.buffer(ty);
-                Self::write_vec4_inner(
-                    &mut buffer[offset..][..4 * std::mem::size_of::<f32>()],
-                    &vec4,
-                );
+                self.write_bytes(ty, offset, bytemuck::cast_slice(&vec4));
             }
         }
     }
@@ -214,12 +318,6 @@ where
     P: Deref<Target = [u8]> + DerefMut,
     H: for<'a> BindUniform<C, &'a [f32; 16]>,
 {
-    #[inline(always)]
-    fn write_mat4_inner(buffer: &mut [u8], mat4: &[f32; 16]) {
-        let mat4 = bytemuck::cast_slice(mat4);
-        buffer.copy_from_slice(mat4);
-    }
-
     /// Bind a `mat4` to the given offset.
     #[inline(always)]
     pub fn bind_mat4(&mut self, offset: MemberOffset, value: &[f32; 16], ctx: C) {
@@ -228,11 +326,7 @@ where
                 continue;
             }
             if let Some(offset) = offset.offset(ty) {
-                let buffer = self.buffer(ty);
-                Self::write_mat4_inner(
-                    &mut buffer[offset..][..16 * std::mem::size_of::<f32>()],
-                    value,
-                );
+                self.write_bytes(ty, offset, bytemuck::cast_slice(value));
             }
         }
     }
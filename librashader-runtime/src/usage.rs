@@ -0,0 +1,592 @@
+use crate::filter_pass::FilterPassMeta;
+use librashader_common::{ImageFormat, Size};
+use librashader_presets::{ScaleType, Scaling, TextureConfig};
+use librashader_reflect::reflect::semantics::{BindingMeta, TextureSemantics, UniqueSemantics};
+use rustc_hash::{FxHashMap, FxHashSet};
+
+/// Dependency information between the passes and lookup textures of a filter chain.
+///
+/// Intermediate framebuffers and lookup textures that are not read by any pass do not
+/// need to be allocated, and passes whose output never reaches the final pass do not
+/// need to be drawn.
+///
+/// Passes whose output only depends on the original image, lookup textures and other
+/// such passes do not need to be drawn again if the input of a frame did not change.
+///
+/// Passes whose outputs are never read at the same time can render to the same
+/// framebuffer.
+#[derive(Debug, Clone)]
+pub struct ResourceUsage {
+    /// The passes whose output or feedback is read by each pass.
+    dependencies: Box<[Box<[usize]>]>,
+    outputs: Box<[bool]>,
+    feedback: Box<[bool]>,
+    frame_dependent: Box<[bool]>,
+    /// The index of the output framebuffer each pass renders to.
+    output_slots: Box<[usize]>,
+    /// Whether the output of each pass stays in its framebuffer until the next frame.
+    reusable: Box<[bool]>,
+    luts: FxHashSet<usize>,
+    live: Box<[bool]>,
+    live_enabled: Option<usize>,
+    last_frame: Option<FrameState>,
+}
+
+/// The state a frame is drawn with, other than the input image and frame count.
+///
+/// The outputs of passes drawn in the last frame can only be reused if the state is
+/// the same.
+#[derive(Debug, Copy, Clone, PartialEq)]
+pub struct FrameState {
+    /// The size of the input image.
+    pub input_size: Size<u32>,
+    /// The size of the viewport.
+    pub output_size: Size<u32>,
+    /// The scale of the viewport that intermediate passes are sized against.
+    pub viewport_scale: f32,
+    /// The number of passes enabled.
+    pub enabled: usize,
+    /// The generation of the shader parameters.
+    pub parameters: u64,
+    /// The MVP of the viewport, if any.
+    pub mvp: Option<[f32; 16]>,
+}
+
+impl ResourceUsage {
+    /// Analyze the texture semantics used by each pass in the filter chain.
+    pub fn new<'a>(pass_meta: impl Iterator<Item = &'a BindingMeta> + ExactSizeIterator) -> Self {
+        let len = pass_meta.len();
+        let mut outputs = vec![false; len];
+        let mut feedback = vec![false; len];
+        let mut frame_dependent = vec![false; len];
+        let mut luts = FxHashSet::default();
+        let mut dependencies = Vec::with_capacity(len);
+
+        for (index, meta) in pass_meta.enumerate() {
+            let mut reads = Vec::new();
+
+            frame_dependent[index] = [UniqueSemantics::FrameCount, UniqueSemantics::FrameDirection]
+                .iter()
+                .any(|semantic| meta.unique_meta.contains_key(semantic));
+
+            // If a shader uses the size of a texture, but not the texture, the texture
+            // still needs to exist at the right size.
+            for semantic in meta
+                .texture_meta
+                .keys()
+                .chain(meta.texture_size_meta.keys())
+            {
+                match semantic.semantics {
+                    TextureSemantics::Source if index > 0 => {
+                        outputs[index - 1] = true;
+                        reads.push(index - 1);
+                    }
+                    TextureSemantics::PassOutput if semantic.index < index => {
+                        outputs[semantic.index] = true;
+                        reads.push(semantic.index);
+                    }
+                    TextureSemantics::PassFeedback if semantic.index < len => {
+                        // Feedback is the output of the previous frame, so the pass
+                        // must still render to its own framebuffer.
+                        outputs[semantic.index] = true;
+                        feedback[semantic.index] = true;
+                        frame_dependent[index] = true;
+                        reads.push(semantic.index);
+                    }
+                    TextureSemantics::OriginalHistory if semantic.index > 0 => {
+                        frame_dependent[index] = true;
+                    }
+                    TextureSemantics::User => {
+                        luts.insert(semantic.index);
+                    }
+                    _ => {}
+                }
+            }
+
+            reads.sort_unstable();
+            reads.dedup();
+            dependencies.push(reads.into_boxed_slice());
+        }
+
+        // Passes read as feedback swap framebuffers every frame, so they must always be
+        // drawn. Passes that read the output of a frame dependent pass are also frame
+        // dependent, and outputs are only read from earlier passes.
+        for index in 0..len {
+            frame_dependent[index] = frame_dependent[index]
+                || feedback[index]
+                || dependencies[index]
+                    .iter()
+                    .any(|&dependency| dependency < index && frame_dependent[dependency]);
+        }
+
+        Self {
+            dependencies: dependencies.into_boxed_slice(),
+            outputs: outputs.into_boxed_slice(),
+            feedback: feedback.into_boxed_slice(),
+            reusable: frame_dependent
+                .iter()
+                .map(|&dependent| !dependent)
+                .collect(),
+            frame_dependent: frame_dependent.into_boxed_slice(),
+            output_slots: (0..len).collect(),
+            luts,
+            live: vec![false; len].into_boxed_slice(),
+            live_enabled: None,
+            last_frame: None,
+        }
+    }
+
+    /// Whether the output framebuffer of the pass at the given index is read by any pass.
+    #[inline(always)]
+    pub fn is_output_used(&self, index: usize) -> bool {
+        self.outputs.get(index).copied().unwrap_or(false)
+    }
+
+    /// Whether the feedback framebuffer of the pass at the given index is read by any pass.
+    #[inline(always)]
+    pub fn is_feedback_used(&self, index: usize) -> bool {
+        self.feedback.get(index).copied().unwrap_or(false)
+    }
+
+    /// Whether the output of the pass at the given index can change between frames
+    /// with the same input.
+    ///
+    /// This is the case if the pass reads the frame count or direction, history, or
+    /// feedback, or reads the output of such a pass.
+    #[inline(always)]
+    pub fn is_frame_dependent(&self, index: usize) -> bool {
+        self.frame_dependent.get(index).copied().unwrap_or(true)
+    }
+
+    /// Begin drawing a frame with the given state, getting the passes that need to be drawn.
+    ///
+    /// Passes that are not frame dependent can keep their output from the last frame
+    /// if the caller marked the input as unchanged, and the last frame was fully drawn
+    /// with the same state. [`ResourceUsage::end_frame`] must be called once the frame
+    /// is drawn.
+    pub fn begin_frame(&mut self, state: FrameState, input_unchanged: bool) -> FramePasses<'_> {
+        let reuse_outputs = self.last_frame.take() == Some(state) && input_unchanged;
+        self.live_passes(state.enabled);
+        FramePasses {
+            live: &self.live,
+            reusable: &self.reusable,
+            output_slots: &self.output_slots,
+            reuse_outputs,
+        }
+    }
+
+    /// Finish drawing a frame with the given state, allowing its outputs to be reused
+    /// by the next frame.
+    pub fn end_frame(&mut self, state: FrameState) {
+        self.last_frame = Some(state);
+    }
+
+    /// Forget the last frame, so that no outputs are reused by the next frame.
+    ///
+    /// This must be called if output framebuffers were recreated since the last frame,
+    /// since their contents are then undefined.
+    pub fn invalidate_frame(&mut self) {
+        self.last_frame = None;
+    }
+
+    /// Get the index of the output framebuffer the pass at the given index renders to.
+    ///
+    /// This is the index of the pass itself, unless its output is aliased with the
+    /// output of an earlier pass.
+    #[inline(always)]
+    pub fn output_slot(&self, index: usize) -> usize {
+        self.output_slots.get(index).copied().unwrap_or(index)
+    }
+
+    /// Let passes whose outputs are never read at the same time render to the same
+    /// output framebuffer.
+    ///
+    /// The output of a pass is read from when the pass is drawn until the last pass
+    /// that reads it. A pass renders to the framebuffer of an earlier pass once that
+    /// output is no longer read, if both framebuffers always have the same size,
+    /// format and mipmaps. Outputs read as feedback are never aliased.
+    ///
+    /// Aliased outputs are overwritten within a frame, so they are never kept for the
+    /// next frame.
+    pub fn alias_outputs<P: FilterPassMeta>(&mut self, passes: &[P]) {
+        let len = std::cmp::min(passes.len(), self.output_slots.len());
+
+        let mut last_read = vec![None; len];
+        for (reader, reads) in self.dependencies.iter().enumerate().take(len) {
+            for &pass in reads.iter().filter(|&&pass| pass < reader) {
+                last_read[pass] = Some(reader);
+            }
+        }
+
+        let mut extents = FxHashMap::default();
+        let mut source = (Extent::Original, Extent::Original);
+        // Framebuffers that are no longer read, and those still being read along with
+        // the last pass to read them.
+        let mut free: Vec<(OutputKey, usize)> = Vec::new();
+        let mut reading: Vec<(OutputKey, usize, usize)> = Vec::new();
+
+        for (index, pass) in passes.iter().enumerate().take(len) {
+            let scaling = &pass.config().scaling;
+            let extent = (
+                Extent::scaled(&mut extents, source.0, &scaling.x),
+                Extent::scaled(&mut extents, source.1, &scaling.y),
+            );
+            source = extent;
+
+            reading.retain(|&(key, slot, last)| {
+                if last < index {
+                    free.push((key, slot));
+                }
+                last >= index
+            });
+
+            let Some(last) = last_read[index] else {
+                continue;
+            };
+
+            if self.is_feedback_used(index) {
+                continue;
+            }
+
+            let key = OutputKey {
+                extent,
+                format: pass.get_format(),
+                mipmap: passes
+                    .get(index + 1)
+                    .map_or(false, |next| next.config().mipmap_input),
+            };
+
+            let slot = match free.iter().position(|(free, _)| *free == key) {
+                Some(position) => free.swap_remove(position).1,
+                None => index,
+            };
+
+            self.output_slots[index] = slot;
+            reading.push((key, slot, last));
+        }
+
+        for index in 0..len {
+            let slot = self.output_slots[index];
+            let shared = self
+                .output_slots
+                .iter()
+                .enumerate()
+                .any(|(other, &other_slot)| other != index && other_slot == slot);
+            self.reusable[index] = !self.frame_dependent[index] && !shared;
+        }
+    }
+
+    /// Whether the lookup texture at the given index is read by any pass.
+    #[inline(always)]
+    pub fn is_lut_used(&self, index: usize) -> bool {
+        self.luts.contains(&index)
+    }
+
+    /// Swap the output and feedback framebuffers of every pass whose feedback is read.
+    ///
+    /// Passes whose feedback is never read keep rendering to the same output framebuffer,
+    /// and their feedback framebuffer remains a placeholder.
+    pub fn swap_feedback<F>(&self, output: &mut [F], feedback: &mut [F]) {
+        for (index, (output, feedback)) in output.iter_mut().zip(feedback.iter_mut()).enumerate() {
+            if self.is_feedback_used(index) {
+                std::mem::swap(output, feedback);
+            }
+        }
+    }
+
+    /// Get the lookup textures that are read by any pass, along with their index in the preset.
+    pub fn used_luts<'a>(&self, textures: &'a [TextureConfig]) -> Vec<(usize, &'a TextureConfig)> {
+        textures
+            .iter()
+            .enumerate()
+            .filter(|(index, _)| self.is_lut_used(*index))
+            .collect()
+    }
+
+    /// Get the passes that contribute to the final output when only the first
+    /// `enabled` passes are drawn.
+    ///
+    /// The last enabled pass is always live. The result is cached until the number
+    /// of enabled passes changes.
+    pub fn live_passes(&mut self, enabled: usize) -> &[bool] {
+        let enabled = std::cmp::min(enabled, self.live.len());
+        if self.live_enabled == Some(enabled) {
+            return &self.live;
+        }
+
+        self.live.fill(false);
+        if enabled > 0 {
+            let mut stack = vec![enabled - 1];
+            self.live[enabled - 1] = true;
+            while let Some(pass) = stack.pop() {
+                for &dependency in self.dependencies[pass].iter() {
+                    if dependency < enabled && !self.live[dependency] {
+                        self.live[dependency] = true;
+                        stack.push(dependency);
+                    }
+                }
+            }
+        }
+
+        self.live_enabled = Some(enabled);
+        &self.live
+    }
+}
+
+/// The extent of an output framebuffer along one axis, in terms of the sizes it is
+/// scaled from.
+///
+/// Framebuffers with equal extents always have the same size. Scaled extents refer to
+/// the interned id of the extent they are scaled from.
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+enum Extent {
+    Original,
+    Absolute(u32),
+    Viewport(u32),
+    Input(usize, u32),
+}
+
+impl Extent {
+    fn scaled(extents: &mut FxHashMap<Extent, usize>, source: Extent, scaling: &Scaling) -> Extent {
+        let factor = f32::from(scaling.factor).to_bits();
+        match scaling.scale_type {
+            ScaleType::Absolute => Extent::Absolute(factor),
+            ScaleType::Viewport => Extent::Viewport(factor),
+            ScaleType::Input => {
+                let next = extents.len();
+                let source = *extents.entry(source).or_insert(next);
+                Extent::Input(source, factor)
+            }
+        }
+    }
+}
+
+/// The properties output framebuffers must share to be aliased.
+#[derive(Debug, Copy, Clone, PartialEq)]
+struct OutputKey {
+    extent: (Extent, Extent),
+    format: ImageFormat,
+    mipmap: bool,
+}
+
+/// The passes that need to be drawn in a frame.
+#[derive(Debug, Copy, Clone)]
+pub struct FramePasses<'a> {
+    live: &'a [bool],
+    reusable: &'a [bool],
+    output_slots: &'a [usize],
+    reuse_outputs: bool,
+}
+
+impl FramePasses<'_> {
+    /// Whether the pass at the given index contributes to the final output.
+    #[inline(always)]
+    pub fn is_live(&self, index: usize) -> bool {
+        self.live.get(index).copied().unwrap_or(false)
+    }
+
+    /// Whether the pass at the given index keeps its output from the last frame
+    /// instead of being drawn.
+    #[inline(always)]
+    pub fn is_reused(&self, index: usize) -> bool {
+        self.reuse_outputs && self.reusable.get(index).copied().unwrap_or(false)
+    }
+
+    /// Get the index of the output framebuffer the pass at the given index renders to.
+    #[inline(always)]
+    pub fn output_slot(&self, index: usize) -> usize {
+        self.output_slots.get(index).copied().unwrap_or(index)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use librashader_common::{FilterMode, WrapMode};
+    use librashader_presets::{Scale2D, ScaleFactor, ShaderPassConfig};
+    use librashader_reflect::reflect::semantics::{
+        MemberOffset, Semantic, TextureBinding, VariableMeta,
+    };
+
+    struct TestPass(ShaderPassConfig);
+
+    impl FilterPassMeta for TestPass {
+        fn framebuffer_format(&self) -> ImageFormat {
+            ImageFormat::R8G8B8A8Unorm
+        }
+
+        fn config(&self) -> &ShaderPassConfig {
+            &self.0
+        }
+    }
+
+    /// Passes that render at the size of the viewport.
+    fn passes(len: usize) -> Vec<TestPass> {
+        let scaling = Scaling {
+            scale_type: ScaleType::Viewport,
+            factor: ScaleFactor::Float(1.0),
+        };
+
+        (0..len)
+            .map(|id| {
+                TestPass(ShaderPassConfig {
+                    id: id as i32,
+                    name: librashader_common::ShaderStorage::String(String::new()),
+                    alias: None,
+                    filter: FilterMode::Linear,
+                    wrap_mode: WrapMode::ClampToEdge,
+                    frame_count_mod: 0,
+                    srgb_framebuffer: false,
+                    float_framebuffer: false,
+                    mipmap_input: false,
+                    scaling: Scale2D {
+                        valid: true,
+                        x: scaling.clone(),
+                        y: scaling.clone(),
+                    },
+                })
+            })
+            .collect()
+    }
+
+    /// A pass that reads the given textures.
+    fn reads(textures: &[(TextureSemantics, usize)]) -> BindingMeta {
+        let mut meta = BindingMeta::default();
+        for (binding, &(semantics, index)) in textures.iter().enumerate() {
+            meta.texture_meta.insert(
+                Semantic { semantics, index },
+                TextureBinding {
+                    binding: binding as u32,
+                },
+            );
+        }
+        meta
+    }
+
+    /// A chain of passes that each read the output of the pass before.
+    fn chain(len: usize) -> Vec<BindingMeta> {
+        (0..len)
+            .map(|index| {
+                if index == 0 {
+                    reads(&[(TextureSemantics::Original, 0)])
+                } else {
+                    reads(&[(TextureSemantics::Source, 0)])
+                }
+            })
+            .collect()
+    }
+
+    fn state() -> FrameState {
+        FrameState {
+            input_size: Size::new(256, 224),
+            output_size: Size::new(1024, 896),
+            viewport_scale: 1.0,
+            enabled: 4,
+            parameters: 0,
+            mvp: None,
+        }
+    }
+
+    #[test]
+    pub fn disjoint_outputs_share_a_slot() {
+        let meta = chain(4);
+        let mut usage = ResourceUsage::new(meta.iter());
+        usage.alias_outputs(&passes(4));
+
+        // The output of the first pass is no longer read once the third pass is drawn.
+        assert_eq!(usage.output_slot(2), usage.output_slot(0));
+    }
+
+    #[test]
+    pub fn overlapping_outputs_do_not_share_a_slot() {
+        let mut meta = chain(4);
+        // The last pass reads the output of the first pass, so it is read while the
+        // second and third passes are drawn.
+        meta[3] = reads(&[
+            (TextureSemantics::Source, 0),
+            (TextureSemantics::PassOutput, 0),
+        ]);
+        let mut usage = ResourceUsage::new(meta.iter());
+        usage.alias_outputs(&passes(4));
+
+        let slots: Vec<_> = (0..3).map(|index| usage.output_slot(index)).collect();
+        assert_eq!(slots, vec![0, 1, 2]);
+    }
+
+    #[test]
+    pub fn feedback_outputs_are_not_aliased() {
+        let mut meta = chain(4);
+        meta[3] = reads(&[
+            (TextureSemantics::Source, 0),
+            (TextureSemantics::PassFeedback, 0),
+        ]);
+        let mut usage = ResourceUsage::new(meta.iter());
+        usage.alias_outputs(&passes(4));
+
+        assert!(usage.is_feedback_used(0));
+        assert_eq!(usage.output_slot(0), 0);
+        assert!((1..4).all(|index| usage.output_slot(index) != 0));
+    }
+
+    #[test]
+    pub fn frame_dependent_passes_are_not_reused() {
+        let mut meta = chain(4);
+        meta[1].unique_meta.insert(
+            UniqueSemantics::FrameCount,
+            VariableMeta {
+                offset: MemberOffset {
+                    ubo: Some(0),
+                    push: None,
+                },
+                size: 4,
+                id: String::from("FrameCount"),
+            },
+        );
+        let mut usage = ResourceUsage::new(meta.iter());
+
+        assert!(!usage.is_frame_dependent(0));
+        assert!((1..4).all(|index| usage.is_frame_dependent(index)));
+
+        let frame = usage.begin_frame(state(), true);
+        assert!((0..4).all(|index| !frame.is_reused(index)));
+        usage.end_frame(state());
+
+        let frame = usage.begin_frame(state(), true);
+        assert!(frame.is_reused(0));
+        assert!((1..4).all(|index| !frame.is_reused(index)));
+        usage.end_frame(state());
+
+        let frame = usage.begin_frame(state(), false);
+        assert!((0..4).all(|index| !frame.is_reused(index)));
+    }
+
+    #[test]
+    pub fn invalidated_frames_are_not_reused() {
+        let meta = chain(4);
+        let mut usage = ResourceUsage::new(meta.iter());
+
+        usage.begin_frame(state(), true);
+        usage.end_frame(state());
+        usage.invalidate_frame();
+        let frame = usage.begin_frame(state(), true);
+        assert!((0..4).all(|index| !frame.is_reused(index)));
+        usage.end_frame(state());
+
+        let frame = usage.begin_frame(state(), true);
+        assert!((0..4).all(|index| frame.is_reused(index)));
+    }
+
+    #[test]
+    pub fn aliased_passes_are_not_reused() {
+        let meta = chain(4);
+        let mut usage = ResourceUsage::new(meta.iter());
+        usage.alias_outputs(&passes(4));
+
+        usage.begin_frame(state(), true);
+        usage.end_frame(state());
+        let frame = usage.begin_frame(state(), true);
+        assert!(!frame.is_reused(0));
+        assert!(!frame.is_reused(2));
+        assert!(frame.is_reused(1));
+    }
+}
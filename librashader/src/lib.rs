@@ -182,7 +182,9 @@ pub mod reflect {
 
     pub use librashader_reflect::reflect::semantics::BindingMeta;
 
-    pub use librashader_reflect::reflect::presets::{CompilePresetTarget, ShaderPassArtifact};
+    pub use librashader_reflect::reflect::presets::{
+        reflect_preset_passes, CompilePresetTarget, PresetReflection, ShaderPassArtifact,
+    };
 
     pub use librashader_reflect::front::ShaderCompilation;
     #[doc(hidden)]
@@ -200,7 +202,9 @@ pub mod reflect {
 #[doc(cfg(feature = "runtime"))]
 pub mod runtime {
     pub use librashader_common::{Size, Viewport};
-    pub use librashader_runtime::parameters::FilterChainParameters;
+    pub use librashader_runtime::loader::LoadProgress;
+    pub use librashader_runtime::parameters::{FilterChainParameters, ParameterHandle};
+    pub use librashader_runtime::timing::PassTiming;
 
     #[cfg(feature = "runtime-gl")]
     #[doc(cfg(feature = "runtime-gl"))]
@@ -280,7 +284,8 @@ pub mod runtime {
             options::{
                 FilterChainOptionsVulkan as FilterChainOptions, FrameOptionsVulkan as FrameOptions,
             },
-            FilterChainVulkan as FilterChain, VulkanImage, VulkanInstance, VulkanObjects,
+            FilterChainVulkan as FilterChain, PendingFilterChainVulkan as PendingFilterChain,
+            VulkanContext, VulkanImage, VulkanInstance, VulkanObjects,
         };
 
         #[doc(hidden)]